@@ -12,17 +12,27 @@ TARGET = AuTerm
 TEMPLATE = app
 
 SOURCES += main.cpp\
+    AutCrc.cpp \
     AutEscape.cpp \
+    AutFileStream.cpp \
+    AutFileTransfer.cpp \
     AutMainWindow.cpp \
+    AutModemMonitor.cpp \
     AutPlugin.cpp \
     AutScrollEdit.cpp \
+    AutSerialLatency.cpp \
     UwxPopup.cpp \
     LrdLogger.cpp
 
 HEADERS  += \
+    AutCrc.h \
     AutEscape.h \
+    AutFileStream.h \
+    AutFileTransfer.h \
     AutMainWindow.h \
+    AutModemMonitor.h \
     AutScrollEdit.h \
+    AutSerialLatency.h \
     UwxPopup.h \
     LrdLogger.h \
 
@@ -56,6 +66,22 @@ RESOURCES += \
     FORMS += UwxScripting.ui
 }
 
+# Speed test
+!contains(DEFINES, SKIPSPEEDTEST) {
+    SOURCES += \
+    AutLatency.cpp \
+    AutPrbs.cpp \
+    AutSpeedEngine.cpp \
+    AutSpeedGraph.cpp \
+    AutSpeedRecorder.cpp
+    HEADERS += \
+    AutLatency.h \
+    AutPrbs.h \
+    AutSpeedEngine.h \
+    AutSpeedGraph.h \
+    AutSpeedRecorder.h
+}
+
 # Error code form
 !contains(DEFINES, SKIPERRORCODEFORM) {
     SOURCES += \
@@ -84,7 +110,9 @@ CONFIG(release, debug|release) {
 
 # Plugins
 !contains(DEFINES, SKIPPLUGINS) {
-    HEADERS += AutPlugin.h
+    HEADERS += AutPlugin.h \
+    AutPluginBus.h
+    SOURCES += AutPluginBus.cpp
 
     contains(CONFIG, static) {
 	QT += $$ADDITIONAL_MODULES
@@ -0,0 +1,105 @@
+/******************************************************************************
+** Copyright (C) 2023 Jamie M.
+**
+** Project: AuTerm
+**
+** Module:  AutCrc.cpp
+**
+** Notes:
+**
+** License: This program is free software: you can redistribute it and/or
+**          modify it under the terms of the GNU General Public License as
+**          published by the Free Software Foundation, version 3.
+**
+**          This program is distributed in the hope that it will be useful,
+**          but WITHOUT ANY WARRANTY; without even the implied warranty of
+**          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**          GNU General Public License for more details.
+**
+**          You should have received a copy of the GNU General Public License
+**          along with this program.  If not, see http://www.gnu.org/licenses/
+**
+*******************************************************************************/
+
+/******************************************************************************/
+// Include Files
+/******************************************************************************/
+#include "AutCrc.h"
+
+/******************************************************************************/
+// Local Functions or Private Members
+/******************************************************************************/
+//Tables are generated by the first call, function local statics are initialised once even if several threads calculate CRCs
+struct crc_tables
+{
+    quint16 crc16[256];
+    quint32 crc32[256];
+
+    crc_tables()
+    {
+        quint32 i = 0;
+
+        while (i < 256)
+        {
+            quint16 crc16_value = (quint16)(i << 8);
+            quint32 crc32_value = i;
+            quint8 bit = 0;
+
+            while (bit < 8)
+            {
+                crc16_value = ((crc16_value & 0x8000) ? (quint16)((crc16_value << 1) ^ 0x1021) : (quint16)(crc16_value << 1));
+                crc32_value = ((crc32_value & 1) ? ((crc32_value >> 1) ^ 0xedb88320U) : (crc32_value >> 1));
+                ++bit;
+            }
+
+            crc16[i] = crc16_value;
+            crc32[i] = crc32_value;
+            ++i;
+        }
+    }
+};
+
+static const crc_tables &tables()
+{
+    static const crc_tables generated_tables;
+
+    return generated_tables;
+}
+
+//=============================================================================
+//=============================================================================
+quint16 AutCrc::crc16(const quint8 *data, qint64 length, quint16 crc)
+{
+    qint64 i = 0;
+    const quint16 *table = tables().crc16;
+
+    while (i < length)
+    {
+        crc = (quint16)((crc << 8) ^ table[((crc >> 8) ^ data[i]) & 0xff]);
+        ++i;
+    }
+
+    return crc;
+}
+
+//=============================================================================
+//=============================================================================
+quint32 AutCrc::crc32(const quint8 *data, qint64 length, quint32 crc)
+{
+    qint64 i = 0;
+    const quint32 *table = tables().crc32;
+
+    crc = ~crc;
+
+    while (i < length)
+    {
+        crc = (crc >> 8) ^ table[(crc ^ data[i]) & 0xff];
+        ++i;
+    }
+
+    return ~crc;
+}
+
+/******************************************************************************/
+// END OF FILE
+/******************************************************************************/
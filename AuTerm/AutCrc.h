@@ -0,0 +1,47 @@
+/******************************************************************************
+** Copyright (C) 2023 Jamie M.
+**
+** Project: AuTerm
+**
+** Module:  AutCrc.h
+**
+** Notes:
+**
+** License: This program is free software: you can redistribute it and/or
+**          modify it under the terms of the GNU General Public License as
+**          published by the Free Software Foundation, version 3.
+**
+**          This program is distributed in the hope that it will be useful,
+**          but WITHOUT ANY WARRANTY; without even the implied warranty of
+**          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**          GNU General Public License for more details.
+**
+**          You should have received a copy of the GNU General Public License
+**          along with this program.  If not, see http://www.gnu.org/licenses/
+**
+*******************************************************************************/
+#ifndef AUTCRC_H
+#define AUTCRC_H
+
+/******************************************************************************/
+// Include Files
+/******************************************************************************/
+#include <QtGlobal>
+
+/******************************************************************************/
+// Class definitions
+/******************************************************************************/
+//Table driven CRCs, crc16 is CRC-16/XMODEM (polynomial 0x1021, initial value 0, same as the SMP UART transport) and
+//crc32 is CRC-32/IEEE 802.3. The crc parameter is the value returned by a previous call when calculating over several blocks
+class AutCrc
+{
+public:
+    static quint16 crc16(const quint8 *data, qint64 length, quint16 crc = 0);
+    static quint32 crc32(const quint8 *data, qint64 length, quint32 crc = 0);
+};
+
+#endif // AUTCRC_H
+
+/******************************************************************************/
+// END OF FILE
+/******************************************************************************/
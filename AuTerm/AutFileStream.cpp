@@ -0,0 +1,361 @@
+/******************************************************************************
+** Copyright (C) 2023 Jamie M.
+**
+** Project: AuTerm
+**
+** Module:  AutFileStream.cpp
+**
+** Notes:
+**
+** License: This program is free software: you can redistribute it and/or
+**          modify it under the terms of the GNU General Public License as
+**          published by the Free Software Foundation, version 3.
+**
+**          This program is distributed in the hope that it will be useful,
+**          but WITHOUT ANY WARRANTY; without even the implied warranty of
+**          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**          GNU General Public License for more details.
+**
+**          You should have received a copy of the GNU General Public License
+**          along with this program.  If not, see http://www.gnu.org/licenses/
+**
+*******************************************************************************/
+
+/******************************************************************************/
+// Include Files
+/******************************************************************************/
+#include "AutFileStream.h"
+#include <cstring>
+
+/******************************************************************************/
+// Local Functions or Private Members
+/******************************************************************************/
+
+//=============================================================================
+//=============================================================================
+AutFileStream::AutFileStream(QSerialPort *port, QObject *parent) : QObject(parent)
+{
+    this->port = port;
+    data = nullptr;
+    mapped = nullptr;
+    file_size = 0;
+    position = 0;
+    bytes_done = 0;
+    window = StreamMinWindow;
+    pacing = StreamPacingNone;
+    pacing_value = 0;
+    waiting = false;
+    throughput_time = 0;
+    throughput_bytes = 0;
+    throughput_rate = 0.0;
+
+    pacing_timer.setSingleShot(true);
+    connect(&pacing_timer, SIGNAL(timeout()), this, SLOT(pacing_timeout()));
+    prompt_timer.setSingleShot(true);
+    prompt_timer.setInterval(StreamPromptTimeout);
+    connect(&prompt_timer, SIGNAL(timeout()), this, SLOT(prompt_timeout()));
+}
+
+//=============================================================================
+//=============================================================================
+AutFileStream::~AutFileStream()
+{
+    pacing_timer.stop();
+    prompt_timer.stop();
+
+    if (mapped != nullptr)
+    {
+        file.unmap(mapped);
+    }
+
+    file.close();
+}
+
+//=============================================================================
+//=============================================================================
+bool AutFileStream::open(QString filename)
+{
+    file.setFileName(filename);
+
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        return false;
+    }
+
+    file_size = file.size();
+
+    if (file_size > 0)
+    {
+        //Map the file so blocks are passed to the serial port without being read into a buffer first, not all files
+        //(e.g. those on some network shares) can be mapped so fall back to reading the whole file
+        mapped = file.map(0, file_size);
+
+        if (mapped != nullptr)
+        {
+            data = (const char *)mapped;
+        }
+        else
+        {
+            buffer = file.readAll();
+            data = buffer.constData();
+            file_size = buffer.length();
+        }
+    }
+
+    return true;
+}
+
+//=============================================================================
+//=============================================================================
+void AutFileStream::set_pacing(AutStreamPacing pacing, quint32 value, QByteArray prompt)
+{
+    this->pacing = pacing;
+    pacing_value = value;
+    this->prompt = prompt;
+
+    if ((pacing == StreamPacingRate && value == 0) || (pacing == StreamPacingPrompt && prompt.isEmpty()))
+    {
+        //Nothing to pace with
+        this->pacing = StreamPacingNone;
+    }
+}
+
+//=============================================================================
+//=============================================================================
+void AutFileStream::start()
+{
+    timer.start();
+    send();
+}
+
+//=============================================================================
+//=============================================================================
+void AutFileStream::bytes_written(qint64 bytes)
+{
+    qint64 elapsed = timer.elapsed();
+
+    bytes_done += bytes;
+
+    if ((elapsed - throughput_time) >= StreamThroughputInterval)
+    {
+        throughput_rate = (double)(bytes_done - throughput_bytes) * 1000.0 / (double)(elapsed - throughput_time);
+        throughput_time = elapsed;
+        throughput_bytes = bytes_done;
+    }
+
+    if (pacing == StreamPacingNone)
+    {
+        if (port->bytesToWrite() == 0 && window < StreamMaxWindow && position < file_size)
+        {
+            //The port emptied its queue before it was topped up, so it can take more than is being given
+            window *= 2;
+        }
+
+        send();
+    }
+    else if (pacing == StreamPacingRate)
+    {
+        send();
+    }
+    else if (pacing == StreamPacingLineDelay && waiting == true && port->bytesToWrite() == 0 && !pacing_timer.isActive())
+    {
+        //Line has been sent, wait before sending the next one
+        pacing_timer.start(pacing_value);
+    }
+}
+
+//=============================================================================
+//=============================================================================
+void AutFileStream::data_received(const QByteArray &data)
+{
+    if (pacing != StreamPacingPrompt || waiting == false)
+    {
+        return;
+    }
+
+    received.append(data);
+
+    if (received.contains(prompt))
+    {
+        //Device is ready for the next line
+        prompt_timer.stop();
+        received.clear();
+        waiting = false;
+        send();
+    }
+    else if (received.length() >= prompt.length())
+    {
+        //Only keep enough data to match a prompt which is split between reads
+        received.remove(0, received.length() - prompt.length() + 1);
+    }
+}
+
+//=============================================================================
+//=============================================================================
+qint64 AutFileStream::size()
+{
+    return file_size;
+}
+
+//=============================================================================
+//=============================================================================
+qint64 AutFileStream::written()
+{
+    return bytes_done;
+}
+
+//=============================================================================
+//=============================================================================
+qint64 AutFileStream::elapsed_ms()
+{
+    return (timer.isValid() ? timer.elapsed() : 0);
+}
+
+//=============================================================================
+//=============================================================================
+double AutFileStream::throughput()
+{
+    if (throughput_time == 0)
+    {
+        //No full measurement interval yet
+        qint64 elapsed = elapsed_ms();
+        return (elapsed > 0 ? (double)bytes_done * 1000.0 / (double)elapsed : 0.0);
+    }
+
+    return throughput_rate;
+}
+
+//=============================================================================
+//=============================================================================
+bool AutFileStream::is_complete()
+{
+    return (bytes_done >= file_size);
+}
+
+//=============================================================================
+//=============================================================================
+void AutFileStream::pacing_timeout()
+{
+    if (pacing == StreamPacingLineDelay)
+    {
+        waiting = false;
+    }
+
+    send();
+}
+
+//=============================================================================
+//=============================================================================
+void AutFileStream::prompt_timeout()
+{
+    emit failed(QString("Timed out waiting for prompt after ").append(QString::number(position)).append(" bytes."));
+}
+
+//=============================================================================
+//=============================================================================
+void AutFileStream::send()
+{
+    if (waiting == true || position >= file_size)
+    {
+        return;
+    }
+
+    if (pacing == StreamPacingNone)
+    {
+        //Top up the port queue once it is half empty
+        qint64 queued = port->bytesToWrite();
+
+        if (queued < (window / 2))
+        {
+            queue(window - queued);
+        }
+    }
+    else if (pacing == StreamPacingRate)
+    {
+        //Send what the target rate allows so far, but never queue more than a short burst so the rate stays even
+        qint64 queued = port->bytesToWrite();
+        qint64 burst = (qint64)pacing_value * StreamRateWindowTime / 1000;
+        qint64 allowed = ((qint64)pacing_value * timer.elapsed() / 1000) - position;
+
+        if (burst < StreamRateMinChunk)
+        {
+            burst = StreamRateMinChunk;
+        }
+
+        if (allowed > (burst - queued))
+        {
+            allowed = burst - queued;
+        }
+
+        if (allowed >= StreamRateMinChunk || (allowed > 0 && allowed >= (file_size - position)))
+        {
+            queue(allowed);
+        }
+        else if (!pacing_timer.isActive())
+        {
+            //Check again when enough time has passed for the next chunk
+            qint64 shortfall = StreamRateMinChunk - (allowed > 0 ? allowed : 0);
+            pacing_timer.start((int)(shortfall * 1000 / pacing_value) + 1);
+        }
+    }
+    else
+    {
+        //One line at a time, the next line is sent after the delay or when the prompt is received
+        queue(next_line_length());
+
+        if (position < file_size)
+        {
+            waiting = true;
+
+            if (pacing == StreamPacingPrompt)
+            {
+                received.clear();
+                prompt_timer.start();
+            }
+        }
+    }
+}
+
+//=============================================================================
+//=============================================================================
+qint64 AutFileStream::next_line_length()
+{
+    const char *line_end = (const char *)memchr(data + position, '\n', (size_t)(file_size - position));
+
+    if (line_end == nullptr)
+    {
+        return (file_size - position);
+    }
+
+    return (line_end - (data + position) + 1);
+}
+
+//=============================================================================
+//=============================================================================
+void AutFileStream::queue(qint64 length)
+{
+    qint64 written_length;
+
+    if (length > (file_size - position))
+    {
+        length = file_size - position;
+    }
+
+    if (length <= 0)
+    {
+        return;
+    }
+
+    //The data is not copied here, receivers of data_queued must not keep a reference to it
+    written_length = port->write(data + position, length);
+
+    if (written_length > 0)
+    {
+        emit data_queued(QByteArray::fromRawData(data + position, written_length));
+        position += written_length;
+    }
+}
+
+/******************************************************************************/
+// END OF FILE
+/******************************************************************************/
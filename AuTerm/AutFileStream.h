@@ -0,0 +1,116 @@
+/******************************************************************************
+** Copyright (C) 2023 Jamie M.
+**
+** Project: AuTerm
+**
+** Module:  AutFileStream.h
+**
+** Notes:
+**
+** License: This program is free software: you can redistribute it and/or
+**          modify it under the terms of the GNU General Public License as
+**          published by the Free Software Foundation, version 3.
+**
+**          This program is distributed in the hope that it will be useful,
+**          but WITHOUT ANY WARRANTY; without even the implied warranty of
+**          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**          GNU General Public License for more details.
+**
+**          You should have received a copy of the GNU General Public License
+**          along with this program.  If not, see http://www.gnu.org/licenses/
+**
+*******************************************************************************/
+#ifndef AUTFILESTREAM_H
+#define AUTFILESTREAM_H
+
+/******************************************************************************/
+// Include Files
+/******************************************************************************/
+#include <QObject>
+#include <QFile>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QByteArray>
+#include <QSerialPort>
+
+/******************************************************************************/
+// Constants
+/******************************************************************************/
+//How the output of a file stream is paced, values are saved in the settings file
+enum AutStreamPacing {
+    StreamPacingNone = 0,
+    StreamPacingRate,
+    StreamPacingLineDelay,
+    StreamPacingPrompt
+};
+
+const qint32 StreamMinWindow                    = 512;   //Initial number of bytes to keep queued in the serial port when streaming
+const qint32 StreamMaxWindow                    = 65536; //Maximum number of bytes to keep queued in the serial port when streaming
+const qint32 StreamRateWindowTime               = 50;    //Time (in ms) of data to queue at once when streaming at a target rate
+const qint32 StreamRateMinChunk                 = 16;    //Minimum number of bytes to write at once when streaming at a target rate
+const qint32 StreamThroughputInterval           = 500;   //Time (in ms) between throughput measurements
+const qint32 StreamPromptTimeout                = 10000; //Time (in ms) to wait for the prompt after each line before the stream is aborted
+
+/******************************************************************************/
+// Class definitions
+/******************************************************************************/
+//Streams a file out of the serial port. The file is memory mapped where possible, writes are sized to keep the
+//serial port queue full without buffering the whole file in the port, and the output can optionally be paced
+class AutFileStream : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit AutFileStream(QSerialPort *port, QObject *parent = nullptr);
+    ~AutFileStream();
+    bool open(QString filename);
+    void set_pacing(AutStreamPacing pacing, quint32 value, QByteArray prompt);
+    void start();
+    void bytes_written(qint64 bytes);
+    void data_received(const QByteArray &data);
+    qint64 size();
+    qint64 written();
+    qint64 elapsed_ms();
+    double throughput();
+    bool is_complete();
+
+signals:
+    void data_queued(QByteArray data);
+    void failed(QString message);
+
+private slots:
+    void pacing_timeout();
+    void prompt_timeout();
+
+private:
+    void send();
+    qint64 next_line_length();
+    void queue(qint64 length);
+
+    QSerialPort *port;
+    QFile file;
+    const char *data;
+    uchar *mapped;
+    QByteArray buffer;
+    qint64 file_size;
+    qint64 position;
+    qint64 bytes_done;
+    qint32 window;
+    AutStreamPacing pacing;
+    quint32 pacing_value;
+    QByteArray prompt;
+    QByteArray received;
+    bool waiting;
+    QElapsedTimer timer;
+    QTimer pacing_timer;
+    QTimer prompt_timer;
+    qint64 throughput_time;
+    qint64 throughput_bytes;
+    double throughput_rate;
+};
+
+#endif // AUTFILESTREAM_H
+
+/******************************************************************************/
+// END OF FILE
+/******************************************************************************/
@@ -0,0 +1,1351 @@
+/******************************************************************************
+** Copyright (C) 2023 Jamie M.
+**
+** Project: AuTerm
+**
+** Module:  AutFileTransfer.cpp
+**
+** Notes:
+**
+** License: This program is free software: you can redistribute it and/or
+**          modify it under the terms of the GNU General Public License as
+**          published by the Free Software Foundation, version 3.
+**
+**          This program is distributed in the hope that it will be useful,
+**          but WITHOUT ANY WARRANTY; without even the implied warranty of
+**          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**          GNU General Public License for more details.
+**
+**          You should have received a copy of the GNU General Public License
+**          along with this program.  If not, see http://www.gnu.org/licenses/
+**
+*******************************************************************************/
+
+/******************************************************************************/
+// Include Files
+/******************************************************************************/
+#include "AutFileTransfer.h"
+#include "AutCrc.h"
+#include <QFileInfo>
+#include <QDateTime>
+#include <cstring>
+
+/******************************************************************************/
+// Local Functions or Private Members
+/******************************************************************************/
+
+//=============================================================================
+//=============================================================================
+static QByteArray make_block(quint8 number, const QByteArray &data, bool use_crc)
+{
+    //Builds an XMODEM/YMODEM block, 1024 byte blocks use STX and 128 byte blocks use SOH
+    QByteArray output;
+
+    output.append((char)(data.length() == 1024 ? XmodemStx : XmodemSoh));
+    output.append((char)number);
+    output.append((char)(0xff - number));
+    output.append(data);
+
+    if (use_crc == true)
+    {
+        quint16 crc = AutCrc::crc16((const quint8 *)data.constData(), data.length());
+        output.append((char)(crc >> 8));
+        output.append((char)(crc & 0xff));
+    }
+    else
+    {
+        quint8 checksum = 0;
+        qint32 i = 0;
+
+        while (i < data.length())
+        {
+            checksum += (quint8)data.at(i);
+            ++i;
+        }
+
+        output.append((char)checksum);
+    }
+
+    return output;
+}
+
+//=============================================================================
+//=============================================================================
+static void append_hex(QByteArray *output, quint8 value)
+{
+    static const char hex_digits[] = "0123456789abcdef";
+
+    output->append(hex_digits[value >> 4]);
+    output->append(hex_digits[value & 0x0f]);
+}
+
+//=============================================================================
+//=============================================================================
+AutFileTransfer::AutFileTransfer(QObject *parent) : QObject(parent)
+{
+    //The engine is created on the GUI thread, the port is given back to this thread when a transfer stops
+    gui_thread = QThread::currentThread();
+    port = nullptr;
+    protocol = TransferXmodemCrc;
+    state = TransferStateIdle;
+    publish_written = false;
+
+    //Timer is a child so that it follows the engine to its thread
+    timer = new QTimer(this);
+    timer->setSingleShot(true);
+    connect(timer, SIGNAL(timeout()), this, SLOT(timeout()));
+}
+
+//=============================================================================
+//=============================================================================
+void AutFileTransfer::set_publish_written(bool publish)
+{
+    //Must be called before start() is queued, data_written is then emitted for everything written to the port
+    publish_written = publish;
+}
+
+//=============================================================================
+//=============================================================================
+void AutFileTransfer::start(int protocol, QStringList files, bool resume, QSerialPort *port)
+{
+    this->protocol = (AutTransferProtocol)protocol;
+    this->files = files;
+    this->resume = resume;
+    this->port = port;
+    connect(port, SIGNAL(readyRead()), this, SLOT(receive()));
+    connect(port, SIGNAL(bytesWritten(qint64)), this, SLOT(bytes_written(qint64)));
+    connect(port, SIGNAL(errorOccurred(QSerialPort::SerialPortError)), this, SLOT(error_occurred(QSerialPort::SerialPortError)));
+
+    file_index = -1;
+    file_name.clear();
+    file_size = 0;
+    position = 0;
+    total_sent = 0;
+    received.clear();
+    retries = 0;
+    cancel_count = 0;
+    last_progress = 0;
+    use_crc = true;
+    batch_end = false;
+    last_header.clear();
+    receiver_flags = 0;
+    receiver_buffer = 0;
+    use_crc32 = false;
+    escape_control = false;
+    stop_and_wait = true;
+    waiting_ack = false;
+    last_sent = 0;
+    elapsed.start();
+
+    if (this->protocol == TransferZmodem)
+    {
+        //Start the receiver if it is a shell which runs rz on request, then ask for the receiver capabilities
+        quint8 header[4] = {0, 0, 0, 0};
+
+        state = ZmodemStateWaitInit;
+        write_port("rz\r");
+        zmodem_write_header(zmodem_hex_header(ZRQINIT, header));
+        timer->start(TransferResponseTimeout);
+    }
+    else
+    {
+        //XMODEM sends a single file, YMODEM opens each file when the receiver asks for the next header
+        state = TransferStateWaitStart;
+
+        if (this->protocol != TransferYmodem && open_next_file() == false)
+        {
+            return;
+        }
+
+        timer->start(TransferStartTimeout);
+    }
+}
+
+//=============================================================================
+//=============================================================================
+void AutFileTransfer::cancel()
+{
+    if (state != TransferStateIdle)
+    {
+        abort("Transfer cancelled.");
+    }
+}
+
+//=============================================================================
+//=============================================================================
+void AutFileTransfer::stop()
+{
+    //Called with a blocking connection, gives the port back to the GUI thread
+    timer->stop();
+    state = TransferStateIdle;
+
+    if (file.isOpen())
+    {
+        file.close();
+    }
+
+    if (port != nullptr)
+    {
+        disconnect(port, nullptr, this, nullptr);
+        port->moveToThread(gui_thread);
+        port = nullptr;
+    }
+}
+
+//=============================================================================
+//=============================================================================
+void AutFileTransfer::receive()
+{
+    received.append(port->readAll());
+
+    if (state == TransferStateIdle)
+    {
+        received.clear();
+    }
+    else if (protocol == TransferZmodem)
+    {
+        zmodem_process();
+    }
+    else
+    {
+        xmodem_process();
+    }
+}
+
+//=============================================================================
+//=============================================================================
+void AutFileTransfer::bytes_written(qint64 bytes)
+{
+    Q_UNUSED(bytes);
+
+    if (state == ZmodemStateSending)
+    {
+        //Data is still flowing so the receiver has not stalled
+        timer->start(TransferResponseTimeout);
+        zmodem_pump();
+    }
+}
+
+//=============================================================================
+//=============================================================================
+void AutFileTransfer::error_occurred(QSerialPort::SerialPortError error)
+{
+    if (state != TransferStateIdle && (error == QSerialPort::ResourceError || error == QSerialPort::PermissionError))
+    {
+        //Fatal error, stop using the port and let the GUI clean up
+        timer->stop();
+        state = TransferStateIdle;
+
+        if (file.isOpen())
+        {
+            file.close();
+        }
+
+        emit port_error((int)error);
+    }
+}
+
+//=============================================================================
+//=============================================================================
+void AutFileTransfer::timeout()
+{
+    switch (state)
+    {
+        case TransferStateWaitStart:
+        {
+            abort("Timed out waiting for the receiver to start the transfer.");
+            break;
+        }
+
+        case TransferStateWaitBlockAck:
+        case TransferStateWaitEotAck:
+        case TransferStateWaitHeaderAck:
+        {
+            //Resend the last block
+            if (retry() == true)
+            {
+                xmodem_write(block);
+            }
+            break;
+        }
+
+        case TransferStateWaitDataStart:
+        {
+            if (retry() == true)
+            {
+                timer->start(TransferResponseTimeout);
+            }
+            break;
+        }
+
+        case ZmodemStateWaitInit:
+        {
+            if (retry() == true)
+            {
+                quint8 header[4] = {0, 0, 0, 0};
+                zmodem_write_header(zmodem_hex_header(ZRQINIT, header));
+                timer->start(TransferResponseTimeout);
+            }
+            break;
+        }
+
+        case ZmodemStateWaitFilePosition:
+        {
+            if (retry() == true)
+            {
+                zmodem_send_file();
+            }
+            break;
+        }
+
+        case ZmodemStateSending:
+        {
+            //No acknowledgement, resend everything which has not been acknowledged
+            if (retry() == true)
+            {
+                port->clear(QSerialPort::Output);
+                total_sent -= (position - acked_position);
+                position = acked_position;
+                zmodem_send_data_header();
+                zmodem_pump();
+            }
+            break;
+        }
+
+        case ZmodemStateWaitEof:
+        case ZmodemStateWaitFin:
+        {
+            if (state == ZmodemStateWaitFin && retries >= 2)
+            {
+                //Some receivers exit without acknowledging the end of the session
+                finish(true, "Transfer complete.");
+            }
+            else if (retry() == true)
+            {
+                write_port(last_header);
+                timer->start(TransferResponseTimeout);
+            }
+            break;
+        }
+
+        default:
+        {
+            break;
+        }
+    }
+}
+
+//=============================================================================
+//=============================================================================
+void AutFileTransfer::finish(bool success, QString message)
+{
+    send_progress(true);
+    timer->stop();
+    state = TransferStateIdle;
+
+    if (file.isOpen())
+    {
+        file.close();
+    }
+
+    emit finished(success, message);
+}
+
+//=============================================================================
+//=============================================================================
+void AutFileTransfer::abort(QString message)
+{
+    //Cancel sequence understood by XMODEM, YMODEM and ZMODEM receivers
+    write_port(QByteArray(8, (char)XmodemCan).append(QByteArray(8, 0x08)));
+    finish(false, message);
+}
+
+//=============================================================================
+//=============================================================================
+void AutFileTransfer::send_progress(bool force)
+{
+    qint64 now = elapsed.elapsed();
+
+    if (force == false && (now - last_progress) < TransferProgressTime)
+    {
+        return;
+    }
+
+    last_progress = now;
+    emit progress(file_name, position, file_size, (now > 0 ? total_sent * 1000 / now : 0));
+}
+
+//=============================================================================
+//=============================================================================
+bool AutFileTransfer::open_next_file()
+{
+    //Returns false if there are no more files or the file could not be opened, in which case the transfer has been aborted
+    if (file.isOpen())
+    {
+        file.close();
+    }
+
+    ++file_index;
+
+    if (file_index >= files.count())
+    {
+        return false;
+    }
+
+    file.setFileName(files.at(file_index));
+
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        abort(QString("Unable to open file: ").append(files.at(file_index)));
+        return false;
+    }
+
+    file_name = QFileInfo(file).fileName();
+    file_size = file.size();
+    position = 0;
+    acked_position = 0;
+    last_rpos = -1;
+
+    return true;
+}
+
+//=============================================================================
+//=============================================================================
+bool AutFileTransfer::retry()
+{
+    ++retries;
+
+    if (retries > TransferMaxRetries)
+    {
+        abort("Too many retries, transfer aborted.");
+        return false;
+    }
+
+    return true;
+}
+
+//=============================================================================
+//=============================================================================
+void AutFileTransfer::xmodem_process()
+{
+    qint32 i = 0;
+
+    while (i < received.length() && state != TransferStateIdle)
+    {
+        quint8 c = (quint8)received.at(i);
+        ++i;
+
+        if (c == XmodemCan)
+        {
+            //Two CANs in a row cancel the transfer
+            ++cancel_count;
+
+            if (cancel_count >= 2)
+            {
+                finish(false, "Transfer cancelled by receiver.");
+            }
+
+            continue;
+        }
+
+        cancel_count = 0;
+
+        switch (state)
+        {
+            case TransferStateWaitStart:
+            {
+                //'C' requests CRC mode, NAK requests the original checksum mode which YMODEM does not support
+                if (c == XmodemCrcRequest || (c == XmodemNak && protocol != TransferYmodem))
+                {
+                    use_crc = (c == XmodemCrcRequest);
+                    retries = 0;
+
+                    if (protocol == TransferYmodem)
+                    {
+                        ymodem_send_header();
+                    }
+                    else
+                    {
+                        block_number = 1;
+                        xmodem_send_block();
+                    }
+                }
+                break;
+            }
+
+            case TransferStateWaitHeaderAck:
+            {
+                if (c == XmodemAck)
+                {
+                    retries = 0;
+
+                    if (batch_end == true)
+                    {
+                        finish(true, "Transfer complete.");
+                    }
+                    else
+                    {
+                        //Receiver requests the file data with another 'C'
+                        state = TransferStateWaitDataStart;
+                        timer->start(TransferResponseTimeout);
+                    }
+                }
+                else if ((c == XmodemNak || c == XmodemCrcRequest) && retry() == true)
+                {
+                    xmodem_write(block);
+                }
+                break;
+            }
+
+            case TransferStateWaitDataStart:
+            {
+                if (c == XmodemCrcRequest || c == XmodemNak)
+                {
+                    block_number = 1;
+                    retries = 0;
+                    xmodem_send_block();
+                }
+                break;
+            }
+
+            case TransferStateWaitBlockAck:
+            {
+                if (c == XmodemAck)
+                {
+                    position += block_data_length;
+                    total_sent += block_data_length;
+                    ++block_number;
+                    retries = 0;
+                    send_progress(false);
+                    xmodem_send_block();
+                }
+                else if (c == XmodemNak && retry() == true)
+                {
+                    xmodem_write(block);
+                }
+                break;
+            }
+
+            case TransferStateWaitEotAck:
+            {
+                if (c == XmodemAck)
+                {
+                    send_progress(true);
+                    retries = 0;
+
+                    if (protocol == TransferYmodem)
+                    {
+                        //Receiver asks for the next header with 'C'
+                        state = TransferStateWaitStart;
+                        timer->start(TransferResponseTimeout);
+                    }
+                    else
+                    {
+                        finish(true, "Transfer complete.");
+                    }
+                }
+                else if (c == XmodemNak && retry() == true)
+                {
+                    //Receivers commonly NAK the first EOT to make sure it was not line noise
+                    xmodem_write(block);
+                }
+                break;
+            }
+
+            default:
+            {
+                break;
+            }
+        }
+    }
+
+    received.clear();
+}
+
+//=============================================================================
+//=============================================================================
+void AutFileTransfer::xmodem_send_block()
+{
+    QByteArray data;
+    qint32 size = 128;
+
+    if (position >= file_size)
+    {
+        //All data has been acknowledged
+        block = QByteArray(1, (char)XmodemEot);
+        block_data_length = 0;
+        state = TransferStateWaitEotAck;
+        xmodem_write(block);
+        return;
+    }
+
+    if ((protocol == TransferXmodem1k || protocol == TransferYmodem) && use_crc == true && (file_size - position) > 128)
+    {
+        //1K blocks, except for a short final block
+        size = 1024;
+    }
+
+    file.seek(position);
+    data = file.read(size);
+
+    if (data.isEmpty())
+    {
+        abort("Unable to read file.");
+        return;
+    }
+
+    block_data_length = data.length();
+
+    if (data.length() < size)
+    {
+        data.append(QByteArray(size - data.length(), (char)XmodemPadding));
+    }
+
+    block = make_block(block_number, data, use_crc);
+    state = TransferStateWaitBlockAck;
+    xmodem_write(block);
+}
+
+//=============================================================================
+//=============================================================================
+void AutFileTransfer::ymodem_send_header()
+{
+    //Block 0 holds the file name and size, an empty block 0 ends the batch
+    QByteArray data;
+
+    batch_end = (open_next_file() == false);
+
+    if (state == TransferStateIdle)
+    {
+        //File could not be opened
+        return;
+    }
+
+    if (batch_end == false)
+    {
+        data = file_name.toUtf8();
+        data.append('\0');
+        data.append(QString("%1 %2 100644").arg(file_size).arg(QFileInfo(file).lastModified().toSecsSinceEpoch(), 0, 8).toUtf8());
+        data.append('\0');
+    }
+
+    if (data.length() > 1024)
+    {
+        data.truncate(1024);
+    }
+
+    data.append(QByteArray((data.length() > 128 ? 1024 : 128) - data.length(), 0));
+    block = make_block(0, data, true);
+    block_data_length = 0;
+    state = TransferStateWaitHeaderAck;
+    xmodem_write(block);
+}
+
+//=============================================================================
+//=============================================================================
+void AutFileTransfer::write_port(const QByteArray &data)
+{
+    port->write(data);
+
+    if (publish_written == true)
+    {
+        //The data is implicitly shared with the receiver, it is only copied if this thread changes the buffer later
+        emit data_written(data);
+    }
+}
+
+//=============================================================================
+//=============================================================================
+void AutFileTransfer::xmodem_write(const QByteArray &data)
+{
+    write_port(data);
+    timer->start(TransferResponseTimeout);
+}
+
+//=============================================================================
+//=============================================================================
+void AutFileTransfer::zmodem_process()
+{
+    quint8 type;
+    quint8 header[4];
+    int result;
+
+    while (state != TransferStateIdle)
+    {
+        result = zmodem_parse_header(&type, header);
+
+        if (result == 0)
+        {
+            //Need more data
+            break;
+        }
+        else if (result < 0)
+        {
+            finish(false, "Transfer cancelled by receiver.");
+        }
+        else if (result == 1)
+        {
+            zmodem_header(type, header);
+        }
+
+        //Corrupt headers are ignored, the receiver repeats them if no response is seen
+    }
+}
+
+//=============================================================================
+//=============================================================================
+int AutFileTransfer::zmodem_parse_header(quint8 *type, quint8 *header)
+{
+    //Returns 1 if a valid header was found, 2 if a corrupt header was found, 0 if more data is needed or -1 if the
+    //receiver sent the cancel sequence. ZDLE is the same as CAN and 5 in a row never occur in a valid stream
+    while (true)
+    {
+        quint8 data[9];
+        quint8 format;
+        qint32 needed;
+        qint32 count = 0;
+        qint32 start;
+        qint32 i = 0;
+
+        if (received.contains(QByteArray(5, (char)ZmodemDle)))
+        {
+            received.clear();
+            return -1;
+        }
+
+        start = received.indexOf((char)ZmodemPad);
+
+        if (start < 0)
+        {
+            //Keep the end of the data in case it is the start of a cancel sequence
+            if (received.length() > 4)
+            {
+                received.remove(0, received.length() - 4);
+            }
+
+            return 0;
+        }
+
+        received.remove(0, start);
+
+        while (i < received.length() && (quint8)received.at(i) == ZmodemPad)
+        {
+            ++i;
+        }
+
+        if ((i + 2) > received.length())
+        {
+            return 0;
+        }
+
+        if ((quint8)received.at(i) != ZmodemDle)
+        {
+            received.remove(0, i);
+            continue;
+        }
+
+        format = (quint8)received.at(i + 1);
+        i += 2;
+
+        if (format == ZmodemHex)
+        {
+            bool valid = true;
+
+            if ((i + 14) > received.length())
+            {
+                return 0;
+            }
+
+            while (count < 7 && valid == true)
+            {
+                data[count] = (quint8)received.mid(i + count * 2, 2).toUShort(&valid, 16);
+                ++count;
+            }
+
+            received.remove(0, i + (valid == true ? 14 : 0));
+
+            if (valid == false)
+            {
+                continue;
+            }
+
+            if (AutCrc::crc16(data, 5) != (quint16)((data[5] << 8) | data[6]))
+            {
+                return 2;
+            }
+        }
+        else if (format == ZmodemBinary16 || format == ZmodemBinary32)
+        {
+            needed = (format == ZmodemBinary16 ? 7 : 9);
+
+            while (count < needed && i < received.length())
+            {
+                quint8 c = (quint8)received.at(i);
+
+                if ((c & 0x7f) == ZmodemXon || (c & 0x7f) == 0x13)
+                {
+                    //Flow control characters are not part of the header
+                    ++i;
+                    continue;
+                }
+
+                if (c == ZmodemDle)
+                {
+                    if ((i + 1) >= received.length())
+                    {
+                        return 0;
+                    }
+
+                    c = (quint8)received.at(i + 1);
+                    i += 2;
+
+                    if (c == ZmodemRubout0)
+                    {
+                        c = 0x7f;
+                    }
+                    else if (c == ZmodemRubout1)
+                    {
+                        c = 0xff;
+                    }
+                    else
+                    {
+                        c ^= 0x40;
+                    }
+                }
+                else
+                {
+                    ++i;
+                }
+
+                data[count] = c;
+                ++count;
+            }
+
+            if (count < needed)
+            {
+                return 0;
+            }
+
+            received.remove(0, i);
+
+            if (format == ZmodemBinary16)
+            {
+                if (AutCrc::crc16(data, 5) != (quint16)((data[5] << 8) | data[6]))
+                {
+                    return 2;
+                }
+            }
+            else if (AutCrc::crc32(data, 5) != ((quint32)data[5] | ((quint32)data[6] << 8) | ((quint32)data[7] << 16) | ((quint32)data[8] << 24)))
+            {
+                return 2;
+            }
+        }
+        else
+        {
+            //Not a header
+            received.remove(0, i);
+            continue;
+        }
+
+        *type = data[0];
+        memcpy(header, &data[1], 4);
+        return 1;
+    }
+}
+
+//=============================================================================
+//=============================================================================
+void AutFileTransfer::zmodem_header(quint8 type, const quint8 *header)
+{
+    //Positions are little endian, the flags byte ZF0 is the last byte of the header
+    qint64 header_position = (qint64)header[0] | ((qint64)header[1] << 8) | ((qint64)header[2] << 16) | ((qint64)header[3] << 24);
+
+    switch (type)
+    {
+        case ZRINIT:
+        {
+            receiver_flags = header[3];
+            receiver_buffer = (qint32)header[0] | ((qint32)header[1] << 8);
+            use_crc32 = ((receiver_flags & ZmodemCanCrc32) != 0);
+            escape_control = ((receiver_flags & ZmodemEscapeControl) != 0);
+
+            //Receivers which cannot overlap disk and serial I/O or have a limited buffer need each block acknowledging
+            stop_and_wait = (receiver_buffer > 0 || (receiver_flags & ZmodemCanFullDuplex) == 0 || (receiver_flags & ZmodemCanOverlapIo) == 0);
+
+            if (state == ZmodemStateWaitInit || state == ZmodemStateWaitEof)
+            {
+                //Ready for the next file, repeated ZRINIT headers whilst waiting for a file position are ignored
+                send_progress(true);
+                retries = 0;
+
+                if (open_next_file() == true)
+                {
+                    zmodem_send_file();
+                }
+                else if (state != TransferStateIdle)
+                {
+                    zmodem_send_fin();
+                }
+            }
+            break;
+        }
+
+        case ZRPOS:
+        {
+            if (state != ZmodemStateWaitFilePosition && state != ZmodemStateSending && state != ZmodemStateWaitEof)
+            {
+                break;
+            }
+
+            if (header_position > file_size)
+            {
+                abort("Receiver requested an invalid file position.");
+                break;
+            }
+
+            if (state == ZmodemStateWaitFilePosition)
+            {
+                //Start of the file, or where an interrupted transfer got to if resuming
+                retries = 0;
+            }
+            else
+            {
+                //Receiver found an error, discard queued data and resend from the requested position
+                if (header_position == last_rpos)
+                {
+                    if (retry() == false)
+                    {
+                        break;
+                    }
+                }
+                else
+                {
+                    retries = 0;
+                }
+
+                port->clear(QSerialPort::Output);
+                total_sent -= (position - header_position);
+            }
+
+            last_rpos = header_position;
+            position = header_position;
+            acked_position = header_position;
+            timer->start(TransferResponseTimeout);
+            zmodem_send_data_header();
+            zmodem_pump();
+            break;
+        }
+
+        case ZACK:
+        {
+            if (state == ZmodemStateSending && header_position >= acked_position && header_position <= position)
+            {
+                acked_position = header_position;
+                retries = 0;
+                timer->start(TransferResponseTimeout);
+
+                if (waiting_ack == true)
+                {
+                    //ZCRCW ended the frame, a new data header is needed
+                    zmodem_send_data_header();
+                }
+
+                send_progress(false);
+                zmodem_pump();
+            }
+            break;
+        }
+
+        case ZSKIP:
+        {
+            if (state == ZmodemStateWaitFilePosition || state == ZmodemStateSending || state == ZmodemStateWaitEof)
+            {
+                //Receiver does not want this file
+                if (state != ZmodemStateWaitFilePosition)
+                {
+                    port->clear(QSerialPort::Output);
+                }
+
+                retries = 0;
+
+                if (open_next_file() == true)
+                {
+                    zmodem_send_file();
+                }
+                else if (state != TransferStateIdle)
+                {
+                    zmodem_send_fin();
+                }
+            }
+            break;
+        }
+
+        case ZNAK:
+        {
+            //Receiver could not decode the last header
+            if (last_header.isEmpty() == false && retry() == true)
+            {
+                write_port(last_header);
+                timer->start(TransferResponseTimeout);
+            }
+            break;
+        }
+
+        case ZFIN:
+        {
+            if (state == ZmodemStateWaitFin)
+            {
+                write_port("OO");
+                finish(true, "Transfer complete.");
+            }
+            break;
+        }
+
+        case ZCRC:
+        {
+            //Receiver wants the CRC of the file (or the start of it) to check if it can be resumed
+            if (state == ZmodemStateWaitFilePosition)
+            {
+                quint32 crc = zmodem_file_crc(header_position == 0 ? file_size : header_position);
+                quint8 crc_header[4] = {(quint8)crc, (quint8)(crc >> 8), (quint8)(crc >> 16), (quint8)(crc >> 24)};
+
+                zmodem_write_header(zmodem_hex_header(ZCRC, crc_header));
+                timer->start(TransferResponseTimeout);
+            }
+            break;
+        }
+
+        case ZCHALLENGE:
+        {
+            zmodem_write_header(zmodem_hex_header(ZACK, header));
+            break;
+        }
+
+        case ZCAN:
+        case ZABORT:
+        case ZFERR:
+        {
+            finish(false, "Transfer aborted by receiver.");
+            break;
+        }
+
+        default:
+        {
+            break;
+        }
+    }
+}
+
+//=============================================================================
+//=============================================================================
+void AutFileTransfer::zmodem_send_file()
+{
+    //ZFILE header followed by the file name and details in a data subpacket
+    QByteArray info = file_name.toUtf8();
+    quint8 header[4] = {0, 0, 0, (resume == true ? ZmodemFileResume : ZmodemFileBinary)};
+    QByteArray output = zmodem_binary_header(ZFILE, header);
+
+    info.append('\0');
+    info.append(QString("%1 %2 100644 0 %3").arg(file_size).arg(QFileInfo(file).lastModified().toSecsSinceEpoch(), 0, 8).arg(files.count() - file_index).toUtf8());
+    info.append('\0');
+    output.append(zmodem_subpacket(info, ZmodemCrcWait));
+
+    state = ZmodemStateWaitFilePosition;
+    zmodem_write_header(output);
+    timer->start(TransferResponseTimeout);
+}
+
+//=============================================================================
+//=============================================================================
+void AutFileTransfer::zmodem_send_data_header()
+{
+    quint8 header[4] = {(quint8)position, (quint8)(position >> 8), (quint8)(position >> 16), (quint8)(position >> 24)};
+
+    file.seek(position);
+    state = ZmodemStateSending;
+    waiting_ack = false;
+    bytes_since_sync = 0;
+    zmodem_write_header(zmodem_binary_header(ZDATA, header));
+}
+
+//=============================================================================
+//=============================================================================
+void AutFileTransfer::zmodem_send_fin()
+{
+    quint8 header[4] = {0, 0, 0, 0};
+
+    state = ZmodemStateWaitFin;
+    retries = 0;
+    zmodem_write_header(zmodem_hex_header(ZFIN, header));
+    timer->start(TransferResponseTimeout);
+}
+
+//=============================================================================
+//=============================================================================
+void AutFileTransfer::zmodem_pump()
+{
+    //Keeps a small amount of data queued in the serial port. When the receiver can stream, up to a window of data is sent
+    //with a ZCRCQ every quarter window so ZACKs keep arriving, otherwise each buffer of data ends with a ZCRCW
+    qint32 window = (receiver_buffer > 0 ? receiver_buffer : ZmodemWindowSize);
+
+    while (state == ZmodemStateSending && waiting_ack == false && port->bytesToWrite() < ZmodemQueueLimit)
+    {
+        QByteArray data;
+        quint8 frame_end;
+
+        if (stop_and_wait == false && (position - acked_position) >= window)
+        {
+            //Wait for the receiver to catch up
+            break;
+        }
+
+        data = file.read(ZmodemSubpacketSize);
+
+        if (data.isEmpty() && position < file_size)
+        {
+            abort("Unable to read file.");
+            return;
+        }
+
+        bytes_since_sync += data.length();
+
+        if ((position + data.length()) >= file_size)
+        {
+            frame_end = ZmodemCrcEnd;
+        }
+        else if (stop_and_wait == true && bytes_since_sync >= window)
+        {
+            frame_end = ZmodemCrcWait;
+            waiting_ack = true;
+            bytes_since_sync = 0;
+        }
+        else if (stop_and_wait == false && bytes_since_sync >= (window / 4))
+        {
+            frame_end = ZmodemCrcQuery;
+            bytes_since_sync = 0;
+        }
+        else
+        {
+            frame_end = ZmodemCrcGo;
+        }
+
+        write_port(zmodem_subpacket(data, frame_end));
+        position += data.length();
+        total_sent += data.length();
+
+        if (frame_end == ZmodemCrcEnd)
+        {
+            //End of file, the receiver replies with ZRINIT once it has written the file
+            quint8 header[4] = {(quint8)position, (quint8)(position >> 8), (quint8)(position >> 16), (quint8)(position >> 24)};
+
+            state = ZmodemStateWaitEof;
+            retries = 0;
+            zmodem_write_header(zmodem_binary_header(ZEOF, header));
+            timer->start(TransferResponseTimeout);
+        }
+    }
+
+    send_progress(false);
+}
+
+//=============================================================================
+//=============================================================================
+void AutFileTransfer::zmodem_write_header(const QByteArray &header)
+{
+    //Kept so that it can be resent if the receiver asks for it
+    last_header = header;
+    write_port(header);
+}
+
+//=============================================================================
+//=============================================================================
+QByteArray AutFileTransfer::zmodem_hex_header(quint8 type, const quint8 *header)
+{
+    QByteArray output;
+    quint8 data[5] = {type, header[0], header[1], header[2], header[3]};
+    quint16 crc = AutCrc::crc16(data, 5);
+    quint8 i = 0;
+
+    output.append((char)ZmodemPad);
+    output.append((char)ZmodemPad);
+    output.append((char)ZmodemDle);
+    output.append((char)ZmodemHex);
+
+    while (i < 5)
+    {
+        append_hex(&output, data[i]);
+        ++i;
+    }
+
+    append_hex(&output, (quint8)(crc >> 8));
+    append_hex(&output, (quint8)(crc & 0xff));
+    output.append('\r');
+    output.append((char)0x8a);
+
+    if (type != ZFIN && type != ZACK)
+    {
+        output.append((char)ZmodemXon);
+    }
+
+    last_sent = (quint8)output.at(output.length() - 1);
+
+    return output;
+}
+
+//=============================================================================
+//=============================================================================
+QByteArray AutFileTransfer::zmodem_binary_header(quint8 type, const quint8 *header)
+{
+    QByteArray output;
+    quint8 data[9] = {type, header[0], header[1], header[2], header[3], 0, 0, 0, 0};
+
+    output.append((char)ZmodemPad);
+    output.append((char)ZmodemDle);
+    output.append((char)(use_crc32 == true ? ZmodemBinary32 : ZmodemBinary16));
+    last_sent = (use_crc32 == true ? ZmodemBinary32 : ZmodemBinary16);
+
+    if (use_crc32 == true)
+    {
+        quint32 crc = AutCrc::crc32(data, 5);
+
+        data[5] = (quint8)crc;
+        data[6] = (quint8)(crc >> 8);
+        data[7] = (quint8)(crc >> 16);
+        data[8] = (quint8)(crc >> 24);
+        zmodem_escape(&output, data, 9);
+    }
+    else
+    {
+        quint16 crc = AutCrc::crc16(data, 5);
+
+        data[5] = (quint8)(crc >> 8);
+        data[6] = (quint8)(crc & 0xff);
+        zmodem_escape(&output, data, 7);
+    }
+
+    return output;
+}
+
+//=============================================================================
+//=============================================================================
+QByteArray AutFileTransfer::zmodem_subpacket(const QByteArray &data, quint8 frame_end)
+{
+    //The CRC covers the data and the frame end
+    QByteArray output;
+    quint8 crc_bytes[4];
+
+    output.reserve(data.length() + (data.length() / 8) + 16);
+    zmodem_escape(&output, (const quint8 *)data.constData(), data.length());
+    output.append((char)ZmodemDle);
+    output.append((char)frame_end);
+    last_sent = frame_end;
+
+    if (use_crc32 == true)
+    {
+        quint32 crc = AutCrc::crc32((const quint8 *)data.constData(), data.length());
+
+        crc = AutCrc::crc32(&frame_end, 1, crc);
+        crc_bytes[0] = (quint8)crc;
+        crc_bytes[1] = (quint8)(crc >> 8);
+        crc_bytes[2] = (quint8)(crc >> 16);
+        crc_bytes[3] = (quint8)(crc >> 24);
+        zmodem_escape(&output, crc_bytes, 4);
+    }
+    else
+    {
+        quint16 crc = AutCrc::crc16((const quint8 *)data.constData(), data.length());
+
+        crc = AutCrc::crc16(&frame_end, 1, crc);
+        crc_bytes[0] = (quint8)(crc >> 8);
+        crc_bytes[1] = (quint8)(crc & 0xff);
+        zmodem_escape(&output, crc_bytes, 2);
+    }
+
+    if (frame_end == ZmodemCrcWait)
+    {
+        output.append((char)ZmodemXon);
+        last_sent = ZmodemXon;
+    }
+
+    return output;
+}
+
+//=============================================================================
+//=============================================================================
+void AutFileTransfer::zmodem_escape(QByteArray *output, const quint8 *data, qint64 length)
+{
+    //ZDLE and flow control characters are always escaped, CR after @ is escaped to avoid Telenet command escapes
+    qint64 i = 0;
+
+    while (i < length)
+    {
+        quint8 c = data[i];
+        bool escape;
+
+        switch (c)
+        {
+            case ZmodemDle:
+            case 0x10:
+            case 0x11:
+            case 0x13:
+            case 0x90:
+            case 0x91:
+            case 0x93:
+            {
+                escape = true;
+                break;
+            }
+
+            case 0x0d:
+            case 0x8d:
+            {
+                escape = (escape_control == true || (last_sent & 0x7f) == '@');
+                break;
+            }
+
+            default:
+            {
+                escape = (escape_control == true && (c & 0x60) == 0);
+                break;
+            }
+        }
+
+        if (escape == true)
+        {
+            output->append((char)ZmodemDle);
+            c ^= 0x40;
+        }
+
+        output->append((char)c);
+        last_sent = c;
+        ++i;
+    }
+}
+
+//=============================================================================
+//=============================================================================
+quint32 AutFileTransfer::zmodem_file_crc(qint64 length)
+{
+    quint32 crc = 0;
+
+    file.seek(0);
+
+    while (length > 0)
+    {
+        QByteArray data = file.read(length > 65536 ? 65536 : length);
+
+        if (data.isEmpty())
+        {
+            break;
+        }
+
+        crc = AutCrc::crc32((const quint8 *)data.constData(), data.length(), crc);
+        length -= data.length();
+    }
+
+    return crc;
+}
+
+/******************************************************************************/
+// END OF FILE
+/******************************************************************************/
@@ -0,0 +1,235 @@
+/******************************************************************************
+** Copyright (C) 2023 Jamie M.
+**
+** Project: AuTerm
+**
+** Module:  AutFileTransfer.h
+**
+** Notes:
+**
+** License: This program is free software: you can redistribute it and/or
+**          modify it under the terms of the GNU General Public License as
+**          published by the Free Software Foundation, version 3.
+**
+**          This program is distributed in the hope that it will be useful,
+**          but WITHOUT ANY WARRANTY; without even the implied warranty of
+**          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**          GNU General Public License for more details.
+**
+**          You should have received a copy of the GNU General Public License
+**          along with this program.  If not, see http://www.gnu.org/licenses/
+**
+*******************************************************************************/
+#ifndef AUTFILETRANSFER_H
+#define AUTFILETRANSFER_H
+
+/******************************************************************************/
+// Include Files
+/******************************************************************************/
+#include <QObject>
+#include <QThread>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QStringList>
+#include <QByteArray>
+#include <QSerialPort>
+
+/******************************************************************************/
+// Constants
+/******************************************************************************/
+//File transfer protocols
+enum AutTransferProtocol {
+    TransferXmodemCrc = 0,
+    TransferXmodem1k,
+    TransferYmodem,
+    TransferZmodem
+};
+
+//Progress of the transfer
+enum AutTransferState {
+    TransferStateIdle = 0,
+    TransferStateWaitStart,
+    TransferStateWaitBlockAck,
+    TransferStateWaitEotAck,
+    TransferStateWaitHeaderAck,
+    TransferStateWaitDataStart,
+    ZmodemStateWaitInit,
+    ZmodemStateWaitFilePosition,
+    ZmodemStateSending,
+    ZmodemStateWaitEof,
+    ZmodemStateWaitFin
+};
+
+//XMODEM/YMODEM control characters
+const quint8 XmodemSoh                          = 0x01;
+const quint8 XmodemStx                          = 0x02;
+const quint8 XmodemEot                          = 0x04;
+const quint8 XmodemAck                          = 0x06;
+const quint8 XmodemNak                          = 0x15;
+const quint8 XmodemCan                          = 0x18;
+const quint8 XmodemCrcRequest                   = 'C';
+const quint8 XmodemPadding                      = 0x1a;
+
+//ZMODEM framing
+const quint8 ZmodemPad                          = '*';
+const quint8 ZmodemDle                          = 0x18;
+const quint8 ZmodemDleEscaped                   = 0x58;
+const quint8 ZmodemBinary16                     = 'A';
+const quint8 ZmodemHex                          = 'B';
+const quint8 ZmodemBinary32                     = 'C';
+const quint8 ZmodemRubout0                      = 'l';
+const quint8 ZmodemRubout1                      = 'm';
+const quint8 ZmodemXon                          = 0x11;
+
+//ZMODEM frame types
+enum AutZmodemFrame {
+    ZRQINIT = 0,
+    ZRINIT,
+    ZSINIT,
+    ZACK,
+    ZFILE,
+    ZSKIP,
+    ZNAK,
+    ZABORT,
+    ZFIN,
+    ZRPOS,
+    ZDATA,
+    ZEOF,
+    ZFERR,
+    ZCRC,
+    ZCHALLENGE,
+    ZCOMPL,
+    ZCAN,
+    ZFREECNT,
+    ZCOMMAND,
+    ZSTDERR
+};
+
+//ZMODEM data subpacket ends
+const quint8 ZmodemCrcEnd                       = 'h'; //End of frame, header follows
+const quint8 ZmodemCrcGo                        = 'i'; //Frame continues, no response expected
+const quint8 ZmodemCrcQuery                     = 'j'; //Frame continues, ZACK expected
+const quint8 ZmodemCrcWait                      = 'k'; //End of frame, ZACK expected
+
+//ZMODEM ZRINIT capability flags and ZFILE options
+const quint8 ZmodemCanFullDuplex                = 0x01;
+const quint8 ZmodemCanOverlapIo                 = 0x02;
+const quint8 ZmodemCanCrc32                     = 0x20;
+const quint8 ZmodemEscapeControl                = 0x40;
+const quint8 ZmodemFileBinary                   = 1;
+const quint8 ZmodemFileResume                   = 3;
+
+const qint32 TransferStartTimeout               = 60000; //Time (in ms) to wait for the receiver to start the transfer
+const qint32 TransferResponseTimeout            = 10000; //Time (in ms) to wait for a response from the receiver before retrying
+const quint8 TransferMaxRetries                 = 10;    //Number of times a block or header is retried before the transfer is aborted
+const qint32 TransferProgressTime               = 250;   //Time (in ms) between progress updates
+const qint32 ZmodemSubpacketSize                = 1024;  //Bytes of file data per ZMODEM data subpacket
+const qint32 ZmodemWindowSize                   = 32768; //Bytes which can be sent without an acknowledgement when the receiver can stream
+const qint32 ZmodemQueueLimit                   = 4096;  //Bytes of ZMODEM data to keep queued in the serial port, kept small so that ZRPOS requests are acted on quickly
+
+/******************************************************************************/
+// Class definitions
+/******************************************************************************/
+//Sends files using XMODEM-CRC, XMODEM-1K, YMODEM (batch) or ZMODEM (batch, streaming with a window and resuming of
+//interrupted transfers). Runs on its own thread, the serial port is moved to that thread for the duration of a transfer
+class AutFileTransfer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit AutFileTransfer(QObject *parent = nullptr);
+    void set_publish_written(bool publish);
+
+public slots:
+    void start(int protocol, QStringList files, bool resume, QSerialPort *port);
+    void cancel();
+    void stop();
+
+signals:
+    void progress(QString file, qint64 position, qint64 size, qint64 rate);
+    void finished(bool success, QString message);
+    void port_error(int error);
+    void data_written(QByteArray data);
+
+private slots:
+    void receive();
+    void bytes_written(qint64 bytes);
+    void error_occurred(QSerialPort::SerialPortError error);
+    void timeout();
+
+private:
+    void finish(bool success, QString message);
+    void write_port(const QByteArray &data);
+    void abort(QString message);
+    void send_progress(bool force);
+    bool open_next_file();
+    bool retry();
+
+    //XMODEM/YMODEM
+    void xmodem_process();
+    void xmodem_send_block();
+    void ymodem_send_header();
+    void xmodem_write(const QByteArray &data);
+
+    //ZMODEM
+    void zmodem_process();
+    int zmodem_parse_header(quint8 *type, quint8 *header);
+    void zmodem_header(quint8 type, const quint8 *header);
+    void zmodem_send_file();
+    void zmodem_send_data_header();
+    void zmodem_send_fin();
+    void zmodem_pump();
+    void zmodem_write_header(const QByteArray &header);
+    QByteArray zmodem_hex_header(quint8 type, const quint8 *header);
+    QByteArray zmodem_binary_header(quint8 type, const quint8 *header);
+    QByteArray zmodem_subpacket(const QByteArray &data, quint8 frame_end);
+    void zmodem_escape(QByteArray *output, const quint8 *data, qint64 length);
+    quint32 zmodem_file_crc(qint64 length);
+
+    QThread *gui_thread;
+    QSerialPort *port;
+    AutTransferProtocol protocol;
+    AutTransferState state;
+    QStringList files;
+    qint32 file_index;
+    QFile file;
+    QString file_name;
+    qint64 file_size;
+    qint64 position;
+    qint64 total_sent;
+    bool resume;
+    QByteArray received;
+    QTimer *timer;
+    QElapsedTimer elapsed;
+    qint64 last_progress;
+    quint8 retries;
+    quint8 cancel_count;
+    bool publish_written;
+
+    //XMODEM/YMODEM
+    QByteArray block;
+    qint32 block_data_length;
+    quint8 block_number;
+    bool use_crc;
+    bool batch_end;
+
+    //ZMODEM
+    QByteArray last_header;
+    qint64 acked_position;
+    qint64 last_rpos;
+    qint64 bytes_since_sync;
+    quint8 receiver_flags;
+    qint32 receiver_buffer;
+    bool use_crc32;
+    bool escape_control;
+    bool stop_and_wait;
+    bool waiting_ack;
+    quint8 last_sent;
+};
+
+#endif // AUTFILETRANSFER_H
+
+/******************************************************************************/
+// END OF FILE
+/******************************************************************************/
@@ -0,0 +1,375 @@
+/******************************************************************************
+** Copyright (C) 2023 Jamie M.
+**
+** Project: AuTerm
+**
+** Module:  AutLatency.cpp
+**
+** Notes:
+**
+** License: This program is free software: you can redistribute it and/or
+**          modify it under the terms of the GNU General Public License as
+**          published by the Free Software Foundation, version 3.
+**
+**          This program is distributed in the hope that it will be useful,
+**          but WITHOUT ANY WARRANTY; without even the implied warranty of
+**          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**          GNU General Public License for more details.
+**
+**          You should have received a copy of the GNU General Public License
+**          along with this program.  If not, see http://www.gnu.org/licenses/
+**
+*******************************************************************************/
+
+/******************************************************************************/
+// Include Files
+/******************************************************************************/
+#include "AutLatency.h"
+#include <QtAlgorithms>
+#include <QtEndian>
+#include <cmath>
+#include <cstring>
+
+/******************************************************************************/
+// Local Functions or Private Members
+/******************************************************************************/
+static QString format_latency(qint64 latency_ns)
+{
+    if (latency_ns < 1000LL)
+    {
+        return QString::number(latency_ns).append(" ns");
+    }
+    else if (latency_ns < 1000000LL)
+    {
+        return QString::number((double)latency_ns / 1000.0, 'f', 1).append(" us");
+    }
+    else if (latency_ns < 1000000000LL)
+    {
+        return QString::number((double)latency_ns / 1000000.0, 'f', 2).append(" ms");
+    }
+
+    return QString::number((double)latency_ns / 1000000000.0, 'f', 2).append(" s");
+}
+
+//=============================================================================
+//=============================================================================
+AutLatency::AutLatency()
+{
+    reset();
+}
+
+//=============================================================================
+//=============================================================================
+void AutLatency::reset()
+{
+    memset(&statistics, 0, sizeof(statistics));
+    buckets.fill(0, ((LatencyMaxShift + 2) << LatencySubBucketBits));
+    pending.clear();
+    received.clear();
+    next_sequence = 0;
+}
+
+//=============================================================================
+//=============================================================================
+QByteArray AutLatency::make_probe(quint32 *sequence)
+{
+    QByteArray probe(LatencyProbeSize, 0);
+
+    *sequence = next_sequence;
+    ++next_sequence;
+
+    probe[0] = (char)LatencyProbeMarker1;
+    probe[1] = (char)LatencyProbeMarker2;
+    qToLittleEndian<quint32>(*sequence, probe.data() + 2);
+    qToLittleEndian<quint32>(~(*sequence), probe.data() + 6);
+
+    return probe;
+}
+
+//=============================================================================
+//=============================================================================
+void AutLatency::probe_sent(quint32 sequence, qint64 timestamp_ns)
+{
+    pending.insert(sequence, timestamp_ns);
+    ++statistics.probes_sent;
+}
+
+//=============================================================================
+//=============================================================================
+int32_t AutLatency::receive(const QByteArray &data, qint64 timestamp_ns)
+{
+    int32_t matched = 0;
+    int32_t offset = 0;
+
+    received.append(data);
+
+    while ((received.length() - offset) >= LatencyProbeSize)
+    {
+        const uchar *probe = (const uchar *)received.constData() + offset;
+
+        if (probe[0] == LatencyProbeMarker1 && probe[1] == LatencyProbeMarker2)
+        {
+            quint32 sequence = qFromLittleEndian<quint32>(probe + 2);
+
+            if (sequence == ~qFromLittleEndian<quint32>(probe + 6))
+            {
+                offset += LatencyProbeSize;
+
+                if (pending.contains(sequence))
+                {
+                    add_sample(timestamp_ns - pending.take(sequence));
+                    ++matched;
+                }
+                else
+                {
+                    //Probe which has already timed out or has been duplicated
+                    ++statistics.probes_unexpected;
+                }
+
+                continue;
+            }
+        }
+
+        //Not the start of a valid probe, skip a byte and look again
+        ++statistics.bytes_discarded;
+        ++offset;
+    }
+
+    received.remove(0, offset);
+
+    return matched;
+}
+
+//=============================================================================
+//=============================================================================
+int32_t AutLatency::expire(qint64 timestamp_ns, qint64 timeout_ns)
+{
+    QMap<quint32, qint64>::iterator probe = pending.begin();
+    int32_t expired = 0;
+
+    while (probe != pending.end())
+    {
+        if ((timestamp_ns - probe.value()) >= timeout_ns)
+        {
+            probe = pending.erase(probe);
+            ++statistics.probes_lost;
+            ++expired;
+        }
+        else
+        {
+            ++probe;
+        }
+    }
+
+    return expired;
+}
+
+//=============================================================================
+//=============================================================================
+int32_t AutLatency::outstanding()
+{
+    return pending.count();
+}
+
+//=============================================================================
+//=============================================================================
+const AutLatencyStats *AutLatency::stats()
+{
+    return &statistics;
+}
+
+//=============================================================================
+//=============================================================================
+qint64 AutLatency::mean()
+{
+    if (statistics.probes_received == 0)
+    {
+        return 0;
+    }
+
+    return statistics.total_ns / (qint64)statistics.probes_received;
+}
+
+//=============================================================================
+//=============================================================================
+qint64 AutLatency::percentile(double percent)
+{
+    quint64 target;
+    quint64 count = 0;
+    int32_t i = 0;
+
+    if (statistics.probes_received == 0)
+    {
+        return 0;
+    }
+
+    target = (quint64)std::ceil(percent * (double)statistics.probes_received / 100.0);
+
+    if (target < 1)
+    {
+        target = 1;
+    }
+
+    while (i < buckets.length())
+    {
+        count += buckets.at(i);
+
+        if (count >= target)
+        {
+            //Middle of the bucket, limited to the values which have actually been seen
+            qint64 value = bucket_lower(i) + bucket_width(i) / 2;
+
+            if (value < statistics.min_ns)
+            {
+                value = statistics.min_ns;
+            }
+            else if (value > statistics.max_ns)
+            {
+                value = statistics.max_ns;
+            }
+
+            return value;
+        }
+
+        ++i;
+    }
+
+    return statistics.max_ns;
+}
+
+//=============================================================================
+//=============================================================================
+QString AutLatency::histogram()
+{
+    //Combine the buckets into powers of two for display
+    QVector<quint64> ranges(64, 0);
+    QString output;
+    quint64 largest = 0;
+    int32_t first = -1;
+    int32_t last = -1;
+    int32_t i = 0;
+
+    while (i < buckets.length())
+    {
+        if (buckets.at(i) > 0)
+        {
+            qint64 lower = bucket_lower(i);
+            int32_t range = (lower == 0 ? 0 : (63 - qCountLeadingZeroBits((quint64)lower)));
+
+            ranges[range] += buckets.at(i);
+
+            if (ranges.at(range) > largest)
+            {
+                largest = ranges.at(range);
+            }
+
+            if (first == -1 || range < first)
+            {
+                first = range;
+            }
+
+            if (range > last)
+            {
+                last = range;
+            }
+        }
+
+        ++i;
+    }
+
+    if (first == -1)
+    {
+        return output;
+    }
+
+    i = first;
+
+    while (i <= last)
+    {
+        qint64 lower = (i == 0 ? 0 : (1LL << i));
+        qint64 upper = (1LL << (i + 1));
+
+        output.append(format_latency(lower).rightJustified(10)).append(" - ").append(format_latency(upper).rightJustified(10)).append(" | ").append(QString("#").repeated((int)(ranges.at(i) * 40 / largest)).leftJustified(40)).append(" ").append(QString::number(ranges.at(i))).append(" (").append(QString::number((double)ranges.at(i) * 100.0 / (double)statistics.probes_received, 'f', 2)).append("%)\r\n");
+        ++i;
+    }
+
+    return output;
+}
+
+//=============================================================================
+//=============================================================================
+void AutLatency::add_sample(qint64 latency_ns)
+{
+    if (latency_ns < 0)
+    {
+        latency_ns = 0;
+    }
+
+    if (statistics.probes_received == 0 || latency_ns < statistics.min_ns)
+    {
+        statistics.min_ns = latency_ns;
+    }
+
+    if (latency_ns > statistics.max_ns)
+    {
+        statistics.max_ns = latency_ns;
+    }
+
+    statistics.total_ns += latency_ns;
+    ++statistics.probes_received;
+    ++buckets[bucket_index(latency_ns)];
+}
+
+//=============================================================================
+//=============================================================================
+int32_t AutLatency::bucket_index(qint64 latency_ns)
+{
+    //Values below 2^(sub-bucket bits + 1) have a bucket each, above that each power of two is split into 2^(sub-bucket bits) buckets
+    int32_t shift;
+
+    if (latency_ns < (2LL << LatencySubBucketBits))
+    {
+        return (int32_t)latency_ns;
+    }
+
+    shift = (63 - qCountLeadingZeroBits((quint64)latency_ns)) - LatencySubBucketBits;
+
+    if (shift > LatencyMaxShift)
+    {
+        return (((LatencyMaxShift + 2) << LatencySubBucketBits) - 1);
+    }
+
+    return ((shift << LatencySubBucketBits) + (int32_t)(latency_ns >> shift));
+}
+
+//=============================================================================
+//=============================================================================
+qint64 AutLatency::bucket_lower(int32_t index)
+{
+    int32_t shift;
+
+    if (index < (2 << LatencySubBucketBits))
+    {
+        return index;
+    }
+
+    shift = (index >> LatencySubBucketBits) - 1;
+
+    return ((qint64)(index - (shift << LatencySubBucketBits)) << shift);
+}
+
+//=============================================================================
+//=============================================================================
+qint64 AutLatency::bucket_width(int32_t index)
+{
+    if (index < (2 << LatencySubBucketBits))
+    {
+        return 1;
+    }
+
+    return (1LL << ((index >> LatencySubBucketBits) - 1));
+}
+
+/******************************************************************************/
+// END OF FILE
+/******************************************************************************/
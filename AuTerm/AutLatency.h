@@ -0,0 +1,94 @@
+/******************************************************************************
+** Copyright (C) 2023 Jamie M.
+**
+** Project: AuTerm
+**
+** Module:  AutLatency.h
+**
+** Notes:
+**
+** License: This program is free software: you can redistribute it and/or
+**          modify it under the terms of the GNU General Public License as
+**          published by the Free Software Foundation, version 3.
+**
+**          This program is distributed in the hope that it will be useful,
+**          but WITHOUT ANY WARRANTY; without even the implied warranty of
+**          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**          GNU General Public License for more details.
+**
+**          You should have received a copy of the GNU General Public License
+**          along with this program.  If not, see http://www.gnu.org/licenses/
+**
+*******************************************************************************/
+#ifndef AUTLATENCY_H
+#define AUTLATENCY_H
+
+/******************************************************************************/
+// Include Files
+/******************************************************************************/
+#include <QByteArray>
+#include <QMap>
+#include <QString>
+#include <QVector>
+
+/******************************************************************************/
+// Constants
+/******************************************************************************/
+const quint8 LatencyProbeSize                   = 10;    //Size of a probe: 2 marker bytes, 32-bit sequence number and the inverted sequence number
+const quint8 LatencyProbeMarker1                = 0xA5;  //First byte of a probe
+const quint8 LatencyProbeMarker2                = 0x5A;  //Second byte of a probe
+const quint8 LatencySubBucketBits               = 5;     //Histogram buckets per power of two are 2^this, giving a resolution of ~3%
+const quint8 LatencyMaxShift                    = 36;    //Largest power of two (above the sub-bucket range) which can be held in the histogram, up to 2^42ns (~73 minutes)
+
+/******************************************************************************/
+// Structures
+/******************************************************************************/
+struct AutLatencyStats {
+    quint64 probes_sent;
+    quint64 probes_received;
+    quint64 probes_lost;
+    quint64 probes_unexpected;
+    quint64 bytes_discarded;
+    qint64 min_ns;
+    qint64 max_ns;
+    qint64 total_ns;
+};
+
+/******************************************************************************/
+// Class definitions
+/******************************************************************************/
+//Measures the round trip time of sequence-stamped probes sent to a looped-back or echoing device, latencies are kept in a
+//log-linear histogram so that memory use does not grow with the length of a test
+class AutLatency
+{
+public:
+    AutLatency();
+    void reset();
+    QByteArray make_probe(quint32 *sequence);
+    void probe_sent(quint32 sequence, qint64 timestamp_ns);
+    int32_t receive(const QByteArray &data, qint64 timestamp_ns);
+    int32_t expire(qint64 timestamp_ns, qint64 timeout_ns);
+    int32_t outstanding();
+    const AutLatencyStats *stats();
+    qint64 mean();
+    qint64 percentile(double percent);
+    QString histogram();
+
+private:
+    void add_sample(qint64 latency_ns);
+    static int32_t bucket_index(qint64 latency_ns);
+    static qint64 bucket_lower(int32_t index);
+    static qint64 bucket_width(int32_t index);
+
+    AutLatencyStats statistics;
+    QVector<quint64> buckets;
+    QMap<quint32, qint64> pending;
+    QByteArray received;
+    quint32 next_sequence;
+};
+
+#endif // AUTLATENCY_H
+
+/******************************************************************************/
+// END OF FILE
+/******************************************************************************/
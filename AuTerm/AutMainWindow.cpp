@@ -79,11 +79,20 @@ AutMainWindow::AutMainWindow(QWidget *parent) : QMainWindow(parent), ui(new Ui::
 {
     int32_t i = 0;
 
+    //Startup tracing shows where the time to open the window goes
+    gtmrStartupTrace.start();
+    gintStartupTraceLast = 0;
+    gbStartupTrace = qEnvironmentVariableIsSet("AUTERM_STARTUP_TRACE");
+
     //Setup the GUI
     ui->setupUi(this);
+    StartupTrace("UI setup");
 
 #ifndef SKIPPLUGINS
-    //Find and load plugins
+    //Plugins can subscribe to serial data when they are set up
+    gpPluginBus = new AutPluginBus();
+
+    //Find plugins from their metadata, plugins are only loaded and set up when they are first needed
 #ifdef QT_STATIC
     //For static Qt builds, plugins must be compiled into the build
     QVector<QStaticPlugin> static_plugins = QPluginLoader::staticPlugins();
@@ -92,16 +101,8 @@ AutMainWindow::AutMainWindow(QWidget *parent) : QMainWindow(parent), ui(new Ui::
     {
         if (static_plugins.at(i).metaData().contains("IID") == true && static_plugins.at(i).metaData().value("IID").toString() == AuTermPluginInterface_iid)
         {
-            plugin.object = static_plugins.at(i).instance();
-            plugin.plugin = qobject_cast<AutPlugin *>(plugin.object);
-
-            if (plugin.plugin)
-            {
-                plugin.plugin->setup(this);
-                plugin_list.append(plugin);
-
-                ui->list_Plugin_Plugins->addItem(QString(static_plugins.at(i).metaData().value("MetaData").toObject().value("Name").toString()).append(", version ").append(static_plugins.at(i).metaData().value("MetaData").toObject().value("Version").toString()));
-            }
+            plugin.static_index = i;
+            AddPlugin(plugin, static_plugins.at(i).metaData().value("MetaData").toObject());
         }
 
         ++i;
@@ -128,36 +129,24 @@ AutMainWindow::AutMainWindow(QWidget *parent) : QMainWindow(parent), ui(new Ui::
     struct plugins plugin;
     while (i < plugin_names.length())
     {
+        //Metadata is read without loading the library
         plugin.plugin_loader = new QPluginLoader(lib_dir.path().append("/").append(plugin_names.at(i)));
-        plugin.object = plugin.plugin_loader->instance();
 
-        if (plugin.plugin_loader->isLoaded())
+        if (plugin.plugin_loader->metaData().value("IID").toString() == AuTermPluginInterface_iid)
         {
             plugin.filename = plugin_names.at(i);
-            plugin.plugin = qobject_cast<AutPlugin *>(plugin.object);
-
-            if (plugin.plugin)
-            {
-                plugin.plugin->setup(this);
-                plugin_list.append(plugin);
-
-                ui->list_Plugin_Plugins->addItem(QString(plugin.plugin_loader->metaData().value("MetaData").toObject().value("Name").toString()).append(", version ").append(plugin.plugin_loader->metaData().value("MetaData").toObject().value("Version").toString()));
-            }
-            else
-            {
-                plugin.plugin_loader->unload();
-                delete plugin.plugin_loader;
-            }
+            AddPlugin(plugin, plugin.plugin_loader->metaData().value("MetaData").toObject());
         }
         else
         {
-            qDebug() << plugin.plugin_loader->errorString();
+            qDebug() << "Not an AuTerm plugin:" << plugin_names.at(i) << plugin.plugin_loader->errorString();
             delete plugin.plugin_loader;
         }
 
         ++i;
     }
 #endif
+    StartupTrace("Plugin discovery");
 #endif
 
 #ifdef SKIPSPEEDTEST
@@ -173,6 +162,18 @@ AutMainWindow::AutMainWindow(QWidget *parent) : QMainWindow(parent), ui(new Ui::
     ui->edit_SpeedPacketsErrorRate->deleteLater();
     ui->edit_SpeedPacketsGood->deleteLater();
     ui->edit_SpeedPacketsRec->deleteLater();
+    ui->edit_SpeedBitErrors->deleteLater();
+    ui->edit_SpeedBitErrorRate->deleteLater();
+    ui->edit_SpeedErrorBursts->deleteLater();
+    ui->edit_SpeedBytesDropped->deleteLater();
+    ui->edit_SpeedBytesInserted->deleteLater();
+    ui->edit_SpeedLongestBurst->deleteLater();
+    ui->edit_SpeedLatencyMin->deleteLater();
+    ui->edit_SpeedLatencyMedian->deleteLater();
+    ui->edit_SpeedLatencyMax->deleteLater();
+    ui->edit_SpeedLatency99->deleteLater();
+    ui->edit_SpeedLatency999->deleteLater();
+    ui->edit_SpeedProbesLost->deleteLater();
     ui->edit_SpeedTestData->deleteLater();
     ui->text_SpeedEditData->deleteLater();
     ui->combo_SpeedDataDisplay->deleteLater();
@@ -187,6 +188,7 @@ AutMainWindow::AutMainWindow(QWidget *parent) : QMainWindow(parent), ui(new Ui::
     ui->btn_SpeedClear->deleteLater();
     ui->btn_SpeedClose->deleteLater();
     ui->btn_SpeedCopy->deleteLater();
+    ui->btn_SpeedExport->deleteLater();
     ui->btn_SpeedStartStop->deleteLater();
     ui->tab_SpeedTest->deleteLater();
 #endif
@@ -246,12 +248,14 @@ AutMainWindow::AutMainWindow(QWidget *parent) : QMainWindow(parent), ui(new Ui::
     //Define default variable values
     gbTermBusy = false;
     gbStreamingFile = false;
+    gbFileTransferPortTaken = false;
     gintRXBytes = 0;
     gintTXBytes = 0;
     gintQueuedTXBytes = 0;
     gchTermMode = 0;
     gbMainLogEnabled = false;
     gbLoopbackMode = false;
+    gslsLatencyState.applied = false;
     gbSysTrayEnabled = false;
     gbCTSStatus = 0;
     gbDCDStatus = 0;
@@ -270,6 +274,11 @@ AutMainWindow::AutMainWindow(QWidget *parent) : QMainWindow(parent), ui(new Ui::
 #ifndef SKIPSPEEDTEST
     gtmrSpeedTestDelayTimer = 0;
     gbSpeedTestRunning = false;
+    gbSpeedTestPrbs = false;
+    gbSpeedTestLatency = false;
+    gbSpeedTestPortTaken = false;
+    gintSpeedTestId = 0;
+    gsnpSpeedSnapshot = AutSpeedSnapshot();
 #endif
 
 #ifndef SKIPAUTOMATIONFORM
@@ -292,13 +301,10 @@ AutMainWindow::AutMainWindow(QWidget *parent) : QMainWindow(parent), ui(new Ui::
     gbAppStarted = false;
     display_update_pending = false;
 
-#ifndef SKIPSPEEDTEST
-    //Also reserve 64KB of RAM to reduce mallocs when speed testing
-    gbaSpeedReceivedData.reserve(65536);
-#endif
-
-    //Load settings from configuration files
+    //Load settings from configuration files, error codes are loaded when they are first needed
+    gpErrorMessages = nullptr;
     LoadSettings();
+    StartupTrace("Settings");
 
     //Create logging handle
     gpMainLog = new LrdLogger();
@@ -365,6 +371,17 @@ AutMainWindow::AutMainWindow(QWidget *parent) : QMainWindow(parent), ui(new Ui::
 
     //Populate the list of devices
     RefreshSerialDevices();
+    StartupTrace("Serial port list");
+
+    //Setup file transfer engine, which sends files using XMODEM/YMODEM/ZMODEM in its own thread
+    gpFileTransfer = new AutFileTransfer();
+    gpFileTransfer->moveToThread(&gthrTransferThread);
+    connect(&gthrTransferThread, SIGNAL(finished()), gpFileTransfer, SLOT(deleteLater()));
+    connect(gpFileTransfer, SIGNAL(progress(QString,qint64,qint64,qint64)), this, SLOT(TransferProgress(QString,qint64,qint64,qint64)));
+    connect(gpFileTransfer, SIGNAL(finished(bool,QString)), this, SLOT(TransferFinished(bool,QString)));
+    connect(gpFileTransfer, SIGNAL(port_error(int)), this, SLOT(TransferPortError(int)));
+    connect(gpFileTransfer, SIGNAL(data_written(QByteArray)), this, SLOT(TransferDataWritten(QByteArray)));
+    gthrTransferThread.start();
 
 #ifndef SKIPSPEEDTEST
     //Setup speed test mode timers
@@ -374,6 +391,22 @@ AutMainWindow::AutMainWindow(QWidget *parent) : QMainWindow(parent), ui(new Ui::
     gtmrSpeedTestStats10s.setInterval(10000);
     gtmrSpeedTestStats10s.setSingleShot(false);
     connect(&gtmrSpeedTestStats10s, SIGNAL(timeout()), this, SLOT(OutputSpeedTestStats()));
+
+    //Setup speed test engine, which generates and checks data in its own thread
+    gpSpeedEngine = new AutSpeedEngine();
+    gpSpeedEngine->moveToThread(&gthrSpeedThread);
+    connect(&gthrSpeedThread, SIGNAL(finished()), gpSpeedEngine, SLOT(deleteLater()));
+    connect(gpSpeedEngine, SIGNAL(snapshot_ready(AutSpeedSnapshot)), this, SLOT(SpeedTestSnapshot(AutSpeedSnapshot)));
+    connect(gpSpeedEngine, SIGNAL(port_error(int)), this, SLOT(SpeedTestPortError(int)));
+    connect(ui->check_SpeedShowTX, SIGNAL(stateChanged(int)), this, SLOT(SpeedTestDisplayOptionsChanged()));
+    connect(ui->check_SpeedShowRX, SIGNAL(stateChanged(int)), this, SLOT(SpeedTestDisplayOptionsChanged()));
+    connect(ui->check_SpeedShowErrors, SIGNAL(stateChanged(int)), this, SLOT(SpeedTestDisplayOptionsChanged()));
+    gthrSpeedThread.start();
+
+    //Add live graph of the speed test rates below the speed test output
+    gpSpeedGraph = new AutSpeedGraph(ui->tab_SpeedTest);
+    gpSpeedGraph->set_recorder(&grecSpeedRecorder);
+    ui->verticalLayout_4b->addWidget(gpSpeedGraph);
 #endif
     //Display version
     ui->statusBar->showMessage(QString("AuTerm version ").append(UwVersion).append(" (").append(OS).append("), Built ").append(__DATE__).append(" Using QT ").append(QT_VERSION_STR)
@@ -397,6 +430,27 @@ AutMainWindow::AutMainWindow(QWidget *parent) : QMainWindow(parent), ui(new Ui::
     gpMenu->addAction("Lookup Selected Error-Code")->setData(MenuActionError);
     gpMenu->addAction("Enable Loopback (Rx->Tx)")->setData(MenuActionLoopback);
     gpMenu->addAction("Stream File Out")->setData(MenuActionStreamFile);
+    gpSMenu5 = gpMenu->addMenu("Stream Pacing");
+    gpSMenu5->addAction("None")->setData(MenuActionStreamPacingNone);
+    gpSMenu5->addAction("Target Rate...")->setData(MenuActionStreamPacingRate);
+    gpSMenu5->addAction("Line Delay...")->setData(MenuActionStreamPacingLineDelay);
+    gpSMenu5->addAction("Wait For Prompt...")->setData(MenuActionStreamPacingPrompt);
+    gpStreamPacingGroup = new QActionGroup(gpSMenu5);
+    foreach (QAction *qaPacing, gpSMenu5->actions())
+    {
+        qaPacing->setCheckable(true);
+        gpStreamPacingGroup->addAction(qaPacing);
+    }
+    SetStreamPacing((AutStreamPacing)gpTermSettings->value("StreamPacing", DefaultStreamPacing).toInt());
+    gpSMenu6 = gpMenu->addMenu("Send File");
+    gpSMenu6->addAction("XMODEM-CRC...")->setData(MenuActionTransferXmodemCrc);
+    gpSMenu6->addAction("XMODEM-1K...")->setData(MenuActionTransferXmodem1k);
+    gpSMenu6->addAction("YMODEM...")->setData(MenuActionTransferYmodem);
+    gpSMenu6->addAction("ZMODEM...")->setData(MenuActionTransferZmodem);
+    gpSMenu6->addAction("ZMODEM (Resume)...")->setData(MenuActionTransferZmodemResume);
+    gpMenu->addAction("Low Latency Mode")->setData(MenuActionLowLatency);
+    gpMenu->actions().last()->setCheckable(true);
+    gpMenu->actions().last()->setChecked(gpTermSettings->value("LowLatency", DefaultLowLatency).toBool());
     gpSMenu4 = gpMenu->addMenu("Customisation");
     gpSMenu4->addAction("Font")->setData(MenuActionFont);
     gpSMenu4->addAction("Text Colour")->setData(MenuActionTextColour);
@@ -414,6 +468,7 @@ AutMainWindow::AutMainWindow(QWidget *parent) : QMainWindow(parent), ui(new Ui::
 #endif
     gpMenu->addAction("Clear Display")->setData(MenuActionClearDisplay);
     gpMenu->addAction("Clear RX/TX count")->setData(MenuActionClearRxTx);
+    gpMenu->addAction("Export Modem Line Edges...")->setData(MenuActionExportModemEdges);
     gpMenu->addSeparator();
     gpMenu->addAction("Copy")->setData(MenuActionCopy);
     gpMenu->addAction("Copy All")->setData(MenuActionCopyAll);
@@ -447,6 +502,9 @@ AutMainWindow::AutMainWindow(QWidget *parent) : QMainWindow(parent), ui(new Ui::
     //Configure the signal timer
     gpSignalTimer = new QTimer(this);
     connect(gpSignalTimer, SIGNAL(timeout()), this, SLOT(SerialStatusSlot()));
+    gpModemMonitor = new AutModemMonitor();
+    connect(gpModemMonitor, SIGNAL(lines_changed(quint32)), this, SLOT(ModemLinesChanged(quint32)));
+    connect(gpModemMonitor, SIGNAL(monitor_failed(int)), this, SLOT(ModemMonitorFailed(int)));
 
     //Connect serial signals
     connect(&gspSerialPort, SIGNAL(readyRead()), this, SLOT(SerialRead()));
@@ -904,36 +962,17 @@ AutMainWindow::AutMainWindow(QWidget *parent) : QMainWindow(parent), ui(new Ui::
 
     while (i < plugin_list.length())
     {
-        plugin_list[i].plugin->setup_finished();
-        ++i;
-    }
-#endif
-
-#ifndef SKIPONLINE
-    if (ui->check_enable_online_version_check->isChecked())
-    {
-        bool run_check = true;
-
-        if (gpTermSettings->contains("LastUpdateCheck"))
+        if (plugin_list.at(i).loaded == true)
         {
-            if (gpTermSettings->value("LastUpdateCheck", QDate::currentDate().toString()).toString() == QDate::currentDate().toString())
-            {
-                run_check = false;
-            }
+            plugin_list[i].plugin->setup_finished();
         }
 
-        if (run_check == true)
-        {
-            gpTermSettings->setValue("LastUpdateCheck", QDate::currentDate().toString());
-            ui->label_version_update->setText("checking...");
-            AuTermUpdateCheck();
-        }
-        else
-        {
-            ui->label_version_update->setText("already checked today.");
-        }
+        ++i;
     }
 #endif
+
+    StartupTrace("Window created");
+    QTimer::singleShot(0, this, SLOT(StartupFinished()));
 }
 
 //=============================================================================
@@ -987,8 +1026,40 @@ AutMainWindow::~AutMainWindow()
         disconnect(this, SLOT(SpeedTestStopTimer()));
         delete gtmrSpeedTestDelayTimer;
     }
+
+    if (gbSpeedTestPortTaken == true)
+    {
+        //Get the serial port back from the speed test thread so that it can be closed
+        QMetaObject::invokeMethod(gpSpeedEngine, "stop", Qt::BlockingQueuedConnection, Q_ARG(AutSpeedSnapshot*, nullptr));
+        gbSpeedTestPortTaken = false;
+    }
+
+    //Stop speed test thread, this deletes the speed test engine
+    disconnect(this, SLOT(SpeedTestSnapshot(AutSpeedSnapshot)));
+    disconnect(this, SLOT(SpeedTestPortError(int)));
+    gthrSpeedThread.quit();
+    gthrSpeedThread.wait();
 #endif
 
+    if (gbFileTransferPortTaken == true)
+    {
+        //Get the serial port back from the file transfer thread so that it can be closed
+        QMetaObject::invokeMethod(gpFileTransfer, "stop", Qt::BlockingQueuedConnection);
+        gbFileTransferPortTaken = false;
+    }
+
+    //Stop file transfer thread, this deletes the file transfer engine
+    disconnect(this, SLOT(TransferProgress(QString,qint64,qint64,qint64)));
+    disconnect(this, SLOT(TransferFinished(bool,QString)));
+    disconnect(this, SLOT(TransferPortError(int)));
+    gthrTransferThread.quit();
+    gthrTransferThread.wait();
+
+    //Stop modem line monitoring before the port is closed
+    disconnect(this, SLOT(ModemLinesChanged(quint32)));
+    disconnect(this, SLOT(ModemMonitorFailed(int)));
+    gpModemMonitor->stop_monitor();
+
     if (gspSerialPort.isOpen() == true)
     {
         //Close serial connection before quitting
@@ -1060,8 +1131,7 @@ AutMainWindow::~AutMainWindow()
     //Clear up streaming data if opened
     if (gbTermBusy == true && gbStreamingFile == true)
     {
-        gpStreamFileHandle->close();
-        delete gpStreamFileHandle;
+        delete gpStreamFile;
     }
 
 #ifndef SKIPONLINE
@@ -1074,35 +1144,45 @@ AutMainWindow::~AutMainWindow()
 
     display_buffers.clear();
 
-#ifndef SKIPSPEEDTEST
-    gbaSpeedReceivedData.squeeze();
-#endif
 
 #ifndef SKIPPLUGINS
     //Clear up plugins
     int32_t i = 0;
     while (i < plugin_list.length())
     {
-        delete plugin_list.at(i).object;
+        if (plugin_list.at(i).loaded == true)
+        {
+            delete plugin_list.at(i).object;
+#ifndef QT_STATIC
+            plugin_list.at(i).plugin_loader->unload();
+#endif
+        }
 #ifndef QT_STATIC
-        plugin_list.at(i).plugin_loader->unload();
         delete plugin_list.at(i).plugin_loader;
 #endif
         ++i;
     }
+
+    delete gpPluginBus;
 #endif
 
     //Delete variables
     delete gpMainLog;
     delete gpPredefinedDevice;
     delete gpTermSettings;
-    delete gpErrorMessages;
+    if (gpErrorMessages != nullptr)
+    {
+        delete gpErrorMessages;
+    }
     delete gpSignalTimer;
+    delete gpModemMonitor;
 #ifndef SKIPSPEEDTEST
     delete gpSpeedMenu;
 #endif
     delete gpBalloonMenu;
     delete gpSMenu4;
+    delete gpSMenu5;
+    delete gpSMenu6;
     delete gpMenu;
     delete gpEmptyCirclePixmap;
     delete gpRedCirclePixmap;
@@ -1185,10 +1265,8 @@ AutMainWindow::on_btn_TermClose_clicked(
         if (gbStreamingFile == true)
         {
             //Clear up file stream
-            gtmrStreamTimer.invalidate();
             gbStreamingFile = false;
-            gpStreamFileHandle->close();
-            delete gpStreamFileHandle;
+            delete gpStreamFile;
         }
 #ifndef SKIPSPEEDTEST
         else if (gbSpeedTestRunning == true)
@@ -1213,6 +1291,9 @@ AutMainWindow::on_btn_TermClose_clicked(
                 ui->check_SpeedStringUnescape->setEnabled(true);
             }
 
+            //Take the port back from the speed test thread
+            SpeedTestReleasePort();
+
             //Update values
             OutputSpeedTestAvgStats((gtmrSpeedTimer.nsecsElapsed() < 1000000000LL ? 1000000000LL : gtmrSpeedTimer.nsecsElapsed()/1000000000LL));
 
@@ -1236,14 +1317,16 @@ AutMainWindow::on_btn_TermClose_clicked(
                 gtmrSpeedTestStats10s.stop();
             }
 
-            //Clear buffers
-            gbaSpeedMatchData.clear();
-            gbaSpeedReceivedData.clear();
-
             //Show finished message in status bar
             ui->statusBar->showMessage("Speed testing failed due to serial port being closed.");
         }
 #endif
+        else if (gbFileTransferPortTaken == true)
+        {
+            //Take the port back from the file transfer thread
+            TransferReleasePort();
+            ui->statusBar->showMessage("File transfer failed due to serial port being closed.");
+        }
 
         //Close the serial port
         if (gspSerialPort.isOpen() == true)
@@ -1435,14 +1518,24 @@ AutMainWindow::SerialRead(
 #ifndef SKIPSPEEDTEST
     if (gbSpeedTestRunning == true)
     {
-        //Serial test is running, pass to speed test function
-        SpeedTestReceive();
+        //Serial test is running, the speed test thread reads the port
         return;
     }
 #endif
+    if (gbFileTransferPortTaken == true)
+    {
+        //File transfer is running, the file transfer thread reads the port
+        return;
+    }
     QByteArray baOrigData = gspSerialPort.readAll();
 //    qDebug() << "Received: " << baOrigData;
 
+    if (gbStreamingFile == true)
+    {
+        //File stream may be waiting for a prompt
+        gpStreamFile->data_received(baOrigData);
+    }
+
 
 #ifndef SKIPPLUGINS
     if (gbPluginHideTerminalOutput == false || gbPluginRunning == false)
@@ -1487,6 +1580,7 @@ AutMainWindow::SerialRead(
                 //Loopback enabled, send this data back
                 gspSerialPort.write(baOrigData);
                 gintQueuedTXBytes += baOrigData.length();
+                PluginDataTransmitted(baOrigData);
                 gpMainLog->WriteRawLogData(baOrigData);
                 update_buffer(&baDispData, false);
             }
@@ -1498,10 +1592,15 @@ AutMainWindow::SerialRead(
     }
 
 #ifndef SKIPPLUGINS
-    if (gbPluginRunning == true)
+    if (gpPluginBus->wanted(PluginDataReceive) == true)
     {
-        //A plugin is running, siphon data to it
-//TODO: limit to the running plugin only
+        //Pass the data to the plugins which have subscribed to it, the buffer is shared and not copied
+        gpPluginBus->publish(baOrigData, PluginDataReceive, (gbPluginRunning == true ? plugin_status_owner : nullptr));
+    }
+
+    if (gbPluginRunning == true && isSignalConnected(QMetaMethod::fromSignal(&AutMainWindow::plugin_serial_receive)) == true)
+    {
+        //A plugin is running, siphon data to plugins which use the signal rather than the data bus
         emit plugin_serial_receive(&baOrigData);
     }
 #endif
@@ -1566,11 +1665,12 @@ AutMainWindow::MenuSelected(
                 gpTermSettings->setValue("LastOtherFileDirectory", SplitFilePath(strFilename).at(0));
 
                 //File was selected - start streaming it out
-                gpStreamFileHandle = new QFile(strFilename);
+                gpStreamFile = new AutFileStream(&gspSerialPort);
 
-                if (!gpStreamFileHandle->open(QIODevice::ReadOnly))
+                if (!gpStreamFile->open(strFilename))
                 {
                     //Unable to open file
+                    delete gpStreamFile;
                     QString strMessage = tr("Error during file streaming: Access to selected file is denied: ").append(strFilename);
                     gpmErrorForm->SetMessage(&strMessage);
                     gpmErrorForm->show();
@@ -1583,28 +1683,133 @@ AutMainWindow::MenuSelected(
                 gchTermMode = 50;
                 ui->btn_Cancel->setEnabled(true);
 
-                //Save the size of the file
-                gintStreamBytesSize = gpStreamFileHandle->size();
-                gintStreamBytesRead = 0;
+                //Setup pacing, the remaining data is sent as the serial port reports bytes written
                 gintStreamBytesProgress = StreamProgress;
+                AutStreamPacing spPacing = (AutStreamPacing)gpTermSettings->value("StreamPacing", DefaultStreamPacing).toInt();
+                QByteArray baPrompt = gpTermSettings->value("StreamPrompt", DefaultStreamPrompt).toString().toUtf8();
+                AutEscape::escape_characters(&baPrompt);
+                gpStreamFile->set_pacing(spPacing, (spPacing == StreamPacingRate ? gpTermSettings->value("StreamPacingRate", DefaultStreamPacingRate).toUInt() : gpTermSettings->value("StreamLineDelay", DefaultStreamLineDelay).toUInt()), baPrompt);
+                connect(gpStreamFile, SIGNAL(data_queued(QByteArray)), this, SLOT(StreamDataQueued(QByteArray)));
+                connect(gpStreamFile, SIGNAL(failed(QString)), this, SLOT(StreamFailed(QString)));
+                gpStreamFile->start();
+
+                if (gpStreamFile->is_complete())
+                {
+                    //Empty file, nothing to send
+                    FinishStream(false);
+                }
+            }
+        }
+    }
+    else if (intItem == MenuActionStreamPacingNone)
+    {
+        //Stream files as fast as the serial port allows
+        SetStreamPacing(StreamPacingNone);
+    }
+    else if (intItem == MenuActionStreamPacingRate)
+    {
+        //Stream files at a target rate
+        bool bTmpBool;
+        int intRate = QInputDialog::getInt(this, tr("Stream Pacing"), tr("Target rate (bytes/second):"), gpTermSettings->value("StreamPacingRate", DefaultStreamPacingRate).toInt(), 1, 10000000, 1, &bTmpBool);
+
+        if (bTmpBool == true)
+        {
+            gpTermSettings->setValue("StreamPacingRate", intRate);
+            SetStreamPacing(StreamPacingRate);
+        }
+        else
+        {
+            SetStreamPacing((AutStreamPacing)gpTermSettings->value("StreamPacing", DefaultStreamPacing).toInt());
+        }
+    }
+    else if (intItem == MenuActionStreamPacingLineDelay)
+    {
+        //Stream files one line at a time with a delay after each line
+        bool bTmpBool;
+        int intDelay = QInputDialog::getInt(this, tr("Stream Pacing"), tr("Delay after each line (ms):"), gpTermSettings->value("StreamLineDelay", DefaultStreamLineDelay).toInt(), 1, 60000, 1, &bTmpBool);
+
+        if (bTmpBool == true)
+        {
+            gpTermSettings->setValue("StreamLineDelay", intDelay);
+            SetStreamPacing(StreamPacingLineDelay);
+        }
+        else
+        {
+            SetStreamPacing((AutStreamPacing)gpTermSettings->value("StreamPacing", DefaultStreamPacing).toInt());
+        }
+    }
+    else if (intItem == MenuActionStreamPacingPrompt)
+    {
+        //Stream files one line at a time, waiting for a prompt from the device after each line
+        bool bTmpBool;
+        QString strPrompt = QInputDialog::getText(this, tr("Stream Pacing"), tr("Prompt to wait for (escape codes such as \\r and \\n are supported):"), QLineEdit::Normal, gpTermSettings->value("StreamPrompt", DefaultStreamPrompt).toString(), &bTmpBool);
+
+        if (bTmpBool == true && strPrompt.isEmpty() == false)
+        {
+            gpTermSettings->setValue("StreamPrompt", strPrompt);
+            SetStreamPacing(StreamPacingPrompt);
+        }
+        else
+        {
+            SetStreamPacing((AutStreamPacing)gpTermSettings->value("StreamPacing", DefaultStreamPacing).toInt());
+        }
+    }
+    else if (intItem >= MenuActionTransferXmodemCrc && intItem <= MenuActionTransferZmodemResume && gbTermBusy == false && gbSpeedTestRunning == false)
+    {
+        //Send files using a file transfer protocol
+        if (gspSerialPort.isOpen() == true && gbLoopbackMode == false)
+        {
+            QStringList lstFiles;
 
-                //Start a timer
-                gtmrStreamTimer.start();
+            if (intItem == MenuActionTransferXmodemCrc || intItem == MenuActionTransferXmodem1k)
+            {
+                //XMODEM can only send a single file
+                QString strFilename = QFileDialog::getOpenFileName(this, tr("Open File To Send"), gstrLastFilename[FilenameIndexOthers], tr("All Files (*.*)"));
 
-                //Reads out each block
-                QByteArray baFileData = gpStreamFileHandle->read(FileReadBlock);
-                gspSerialPort.write(baFileData);
-                gintQueuedTXBytes += baFileData.size();
-                gintStreamBytesRead = baFileData.length();
-                gpMainLog->WriteLogData(QString(baFileData).append("\n"));
-                if (gpStreamFileHandle->atEnd())
+                if (strFilename.length() > 1)
                 {
-                    //Finished sending
-                    FinishStream(false);
+                    lstFiles << strFilename;
+                }
+            }
+            else
+            {
+                //YMODEM and ZMODEM can send a batch of files
+                lstFiles = QFileDialog::getOpenFileNames(this, tr("Open Files To Send"), gstrLastFilename[FilenameIndexOthers], tr("All Files (*.*)"));
+            }
+
+            if (lstFiles.count() > 0)
+            {
+                //Set last directory config
+                gstrLastFilename[FilenameIndexOthers] = lstFiles.at(0);
+                gpTermSettings->setValue("LastOtherFileDirectory", SplitFilePath(lstFiles.at(0)).at(0));
+
+                if (intItem == MenuActionTransferXmodemCrc)
+                {
+                    TransferTakePort(TransferXmodemCrc, lstFiles, false);
+                }
+                else if (intItem == MenuActionTransferXmodem1k)
+                {
+                    TransferTakePort(TransferXmodem1k, lstFiles, false);
+                }
+                else if (intItem == MenuActionTransferYmodem)
+                {
+                    TransferTakePort(TransferYmodem, lstFiles, false);
+                }
+                else
+                {
+                    TransferTakePort(TransferZmodem, lstFiles, (intItem == MenuActionTransferZmodemResume));
                 }
             }
         }
     }
+    else if (intItem == MenuActionLowLatency)
+    {
+        //Enable/disable low latency mode, applied immediately if the port is open
+        bool bLowLatency = !gpTermSettings->value("LowLatency", DefaultLowLatency).toBool();
+        gpTermSettings->setValue("LowLatency", bLowLatency);
+        qaAction->setChecked(bLowLatency);
+        SetLowLatencyMode(bLowLatency);
+    }
     else if (intItem == MenuActionFont)
     {
         //Change font
@@ -1761,6 +1966,26 @@ AutMainWindow::MenuSelected(
         ui->label_TermRx->setText(QString::number(gintRXBytes));
         ui->label_TermTx->setText(QString::number(gintTXBytes));
     }
+    else if (intItem == MenuActionExportModemEdges)
+    {
+        //Export the CTS/DSR/DCD/RI edge history
+        QString strExportFilename = QFileDialog::getSaveFileName(this, "Export Modem Line Edges", QString("modem_edges_").append(QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss")).append(".csv"), "CSV Files (*.csv)");
+
+        if (!strExportFilename.isEmpty())
+        {
+            QFile fileExport(strExportFilename);
+
+            if (fileExport.open(QFile::WriteOnly | QFile::Text))
+            {
+                fileExport.write(gpModemMonitor->to_csv().toUtf8());
+                fileExport.close();
+            }
+            else
+            {
+                ui->statusBar->showMessage("Failed to open modem line edge export file for writing.");
+            }
+        }
+    }
     else if (intItem == MenuActionCopy)
     {
         //Copy selected data
@@ -1825,6 +2050,7 @@ AutMainWindow::enter_pressed(
                 QByteArray baTmpBA = ui->text_TermEditData->get_dat_out()->replace("\r", "\n").replace("\n", (ui->radio_LCR->isChecked() ? "\r" : ui->radio_LLF->isChecked() ? "\n" : ui->radio_LCRLF->isChecked() ? "\r\n" : "")).toUtf8();
                 gspSerialPort.write(baTmpBA);
                 gintQueuedTXBytes += baTmpBA.size();
+                PluginDataTransmitted(baTmpBA);
 
                 //Add to log
                 gpMainLog->WriteLogData(baTmpBA);
@@ -1919,6 +2145,7 @@ AutMainWindow::key_pressed(
                 //Not return
                 gspSerialPort.write(baTmpBA);
                 gintQueuedTXBytes += baTmpBA.size();
+                PluginDataTransmitted(baTmpBA);
             }
 
             //Output back to screen buffer if echo mode is enabled
@@ -1958,6 +2185,7 @@ void AutMainWindow::vt100_send(QByteArray code)
         {
             gspSerialPort.write(code);
             gintQueuedTXBytes += code.size();
+            PluginDataTransmitted(code);
         }
         else if (gbLoopbackMode == true)
         {
@@ -2002,37 +2230,32 @@ AutMainWindow::SerialStatus(
     bool bType
     )
 {
+#ifndef SKIPSPEEDTEST
+    if (gbSpeedTestPortTaken == true)
+    {
+        //Serial port is owned by the speed test thread and must not be used from this thread, skip polling until it is
+        //handed back
+        return;
+    }
+#endif
+
+    if (gbFileTransferPortTaken == true)
+    {
+        //Serial port is owned by the file transfer thread
+        return;
+    }
+
     if (gspSerialPort.isOpen() == true)
     {
         unsigned int intSignals = gspSerialPort.pinoutSignals();
-        if ((((intSignals & QSerialPort::ClearToSendSignal) == QSerialPort::ClearToSendSignal ? 1 : 0) != gbCTSStatus || bType == true))
-        {
-            //CTS changed
-            gbCTSStatus = ((intSignals & QSerialPort::ClearToSendSignal) == QSerialPort::ClearToSendSignal ? 1 : 0);
-            ui->image_CTS->setPixmap((gbCTSStatus == true ? *gpGreenCirclePixmap : *gpRedCirclePixmap));
-            ui->image_CTSb->setPixmap((gbCTSStatus == true ? *gpGreenCirclePixmap : *gpRedCirclePixmap));
-        }
-        if ((((intSignals & QSerialPort::DataCarrierDetectSignal) == QSerialPort::DataCarrierDetectSignal ? 1 : 0) != gbDCDStatus || bType == true))
-        {
-            //DCD changed
-            gbDCDStatus = ((intSignals & QSerialPort::DataCarrierDetectSignal) == QSerialPort::DataCarrierDetectSignal ? 1 : 0);
-            ui->image_DCD->setPixmap((gbDCDStatus == true ? *gpGreenCirclePixmap : *gpRedCirclePixmap));
-            ui->image_DCDb->setPixmap((gbDCDStatus == true ? *gpGreenCirclePixmap : *gpRedCirclePixmap));
-        }
-        if ((((intSignals & QSerialPort::DataSetReadySignal) == QSerialPort::DataSetReadySignal ? 1 : 0) != gbDSRStatus || bType == true))
-        {
-            //DSR changed
-            gbDSRStatus = ((intSignals & QSerialPort::DataSetReadySignal) == QSerialPort::DataSetReadySignal ? 1 : 0);
-            ui->image_DSR->setPixmap((gbDSRStatus == true ? *gpGreenCirclePixmap : *gpRedCirclePixmap));
-            ui->image_DSRb->setPixmap((gbDSRStatus == true ? *gpGreenCirclePixmap : *gpRedCirclePixmap));
-        }
-        if ((((intSignals & QSerialPort::RingIndicatorSignal) == QSerialPort::RingIndicatorSignal ? 1 : 0) != gbRIStatus || bType == true))
+
+        if (gpSignalTimer->isActive())
         {
-            //RI changed
-            gbRIStatus = ((intSignals & QSerialPort::RingIndicatorSignal) == QSerialPort::RingIndicatorSignal ? 1 : 0);
-            ui->image_RI->setPixmap((gbRIStatus == true ? *gpGreenCirclePixmap : *gpRedCirclePixmap));
-            ui->image_RIb->setPixmap((gbRIStatus == true ? *gpGreenCirclePixmap : *gpRedCirclePixmap));
+            //Polling, record edges in the modem line history
+            gpModemMonitor->add_levels(intSignals & (QSerialPort::ClearToSendSignal | QSerialPort::DataSetReadySignal | QSerialPort::DataCarrierDetectSignal | QSerialPort::RingIndicatorSignal));
         }
+
+        UpdateSerialSignals(intSignals, bType);
     }
     else
     {
@@ -2049,10 +2272,80 @@ AutMainWindow::SerialStatus(
 
         //Disable timer
         gpSignalTimer->stop();
+        gpModemMonitor->stop_monitor();
     }
     return;
 }
 
+//=============================================================================
+//=============================================================================
+void
+AutMainWindow::UpdateSerialSignals(
+    unsigned int intSignals,
+    bool bType
+    )
+{
+    //Updates images of signals which have changed, or all signals if bType is true
+    if ((((intSignals & QSerialPort::ClearToSendSignal) == QSerialPort::ClearToSendSignal ? 1 : 0) != gbCTSStatus || bType == true))
+    {
+        //CTS changed
+        gbCTSStatus = ((intSignals & QSerialPort::ClearToSendSignal) == QSerialPort::ClearToSendSignal ? 1 : 0);
+        ui->image_CTS->setPixmap((gbCTSStatus == true ? *gpGreenCirclePixmap : *gpRedCirclePixmap));
+        ui->image_CTSb->setPixmap((gbCTSStatus == true ? *gpGreenCirclePixmap : *gpRedCirclePixmap));
+    }
+    if ((((intSignals & QSerialPort::DataCarrierDetectSignal) == QSerialPort::DataCarrierDetectSignal ? 1 : 0) != gbDCDStatus || bType == true))
+    {
+        //DCD changed
+        gbDCDStatus = ((intSignals & QSerialPort::DataCarrierDetectSignal) == QSerialPort::DataCarrierDetectSignal ? 1 : 0);
+        ui->image_DCD->setPixmap((gbDCDStatus == true ? *gpGreenCirclePixmap : *gpRedCirclePixmap));
+        ui->image_DCDb->setPixmap((gbDCDStatus == true ? *gpGreenCirclePixmap : *gpRedCirclePixmap));
+    }
+    if ((((intSignals & QSerialPort::DataSetReadySignal) == QSerialPort::DataSetReadySignal ? 1 : 0) != gbDSRStatus || bType == true))
+    {
+        //DSR changed
+        gbDSRStatus = ((intSignals & QSerialPort::DataSetReadySignal) == QSerialPort::DataSetReadySignal ? 1 : 0);
+        ui->image_DSR->setPixmap((gbDSRStatus == true ? *gpGreenCirclePixmap : *gpRedCirclePixmap));
+        ui->image_DSRb->setPixmap((gbDSRStatus == true ? *gpGreenCirclePixmap : *gpRedCirclePixmap));
+    }
+    if ((((intSignals & QSerialPort::RingIndicatorSignal) == QSerialPort::RingIndicatorSignal ? 1 : 0) != gbRIStatus || bType == true))
+    {
+        //RI changed
+        gbRIStatus = ((intSignals & QSerialPort::RingIndicatorSignal) == QSerialPort::RingIndicatorSignal ? 1 : 0);
+        ui->image_RI->setPixmap((gbRIStatus == true ? *gpGreenCirclePixmap : *gpRedCirclePixmap));
+        ui->image_RIb->setPixmap((gbRIStatus == true ? *gpGreenCirclePixmap : *gpRedCirclePixmap));
+    }
+}
+
+//=============================================================================
+//=============================================================================
+void
+AutMainWindow::ModemLinesChanged(
+    quint32 intSignals
+    )
+{
+    //Modem line monitor has seen a change in the level of a line
+    if (gspSerialPort.isOpen() == true)
+    {
+        UpdateSerialSignals(intSignals, false);
+    }
+}
+
+//=============================================================================
+//=============================================================================
+void
+AutMainWindow::ModemMonitorFailed(
+    int intError
+    )
+{
+    //Serial driver does not support waiting for line changes, poll them instead
+    Q_UNUSED(intError);
+
+    if (gspSerialPort.isOpen() == true && !gpSignalTimer->isActive())
+    {
+        gpSignalTimer->start(gpTermSettings->value("SerialSignalCheckInterval", DefaultSerialSignalCheckInterval).toUInt());
+    }
+}
+
 //=============================================================================
 //=============================================================================
 void
@@ -2080,6 +2373,14 @@ AutMainWindow::OpenDevice(
             on_btn_Cancel_clicked();
         }
 
+#ifndef SKIPSPEEDTEST
+        //Take the port back if a speed test is running
+        SpeedTestReleasePort();
+#endif
+
+        //Take the port back if a file transfer is running
+        TransferReleasePort();
+
         //Close serial port
         if (gspSerialPort.isOpen() == true)
         {
@@ -2180,6 +2481,12 @@ AutMainWindow::OpenDevice(
             //Break
             gspSerialPort.setBreakEnabled(ui->check_Break->isChecked());
 
+            //Reduce driver and adapter buffering delays if enabled
+            if (gpTermSettings->value("LowLatency", DefaultLowLatency).toBool() == true)
+            {
+                SetLowLatencyMode(true);
+            }
+
             //Enable checkboxes
             ui->check_Break->setEnabled(true);
             ui->check_DTR->setEnabled(true);
@@ -2207,8 +2514,12 @@ AutMainWindow::OpenDevice(
             //Signal checking
             SerialStatus(1);
 
-            //Enable timer
-            gpSignalTimer->start(gpTermSettings->value("SerialSignalCheckInterval", DefaultSerialSignalCheckInterval).toUInt());
+            //Wait for signal changes, falling back to polling them if this is not supported
+            if (gpTermSettings->value("ModemLineMonitor", DefaultModemLineMonitor).toBool() == false || gpModemMonitor->start_monitor(gspSerialPort.handle()) == false)
+            {
+                gpModemMonitor->clear();
+                gpSignalTimer->start(gpTermSettings->value("SerialSignalCheckInterval", DefaultSerialSignalCheckInterval).toUInt());
+            }
 
 #ifndef SKIPAUTOMATIONFORM
             //Notify automation form
@@ -2295,8 +2606,14 @@ AutMainWindow::OpenDevice(
 #endif
             .append((ui->combo_Baud->currentText().toULong() > 115200 ? ", please also ensure that your serial device supports baud rates greater than 115200 (normal COM ports do not have support for these baud rates)" : ""))
             .append(" and try again.");
-            gpmErrorForm->SetMessage(&strMessage);
-            gpmErrorForm->show();
+
+            if (from_plugin == false)
+            {
+                //Plugins handle failures themselves (e.g. retrying whilst a device re-enumerates), so only the status bar is updated
+                gpmErrorForm->SetMessage(&strMessage);
+                gpmErrorForm->show();
+            }
+
             ui->text_TermEditData->set_serial_open(false);
         }
     }
@@ -2316,7 +2633,17 @@ AutMainWindow::on_check_Break_stateChanged(
     )
 {
     //Break status changed
-    gspSerialPort.setBreakEnabled(ui->check_Break->isChecked());
+#ifndef SKIPSPEEDTEST
+    if (gbSpeedTestPortTaken == true)
+    {
+        //Serial port is owned by the speed test thread
+        QMetaObject::invokeMethod(gpSpeedEngine, "set_break_enabled", Qt::QueuedConnection, Q_ARG(bool, ui->check_Break->isChecked()));
+    }
+    else
+#endif
+    {
+        gspSerialPort.setBreakEnabled(ui->check_Break->isChecked());
+    }
 }
 
 //=============================================================================
@@ -2326,7 +2653,17 @@ AutMainWindow::on_check_RTS_stateChanged(
     )
 {
     //RTS status changed
-    gspSerialPort.setRequestToSend(ui->check_RTS->isChecked());
+#ifndef SKIPSPEEDTEST
+    if (gbSpeedTestPortTaken == true)
+    {
+        //Serial port is owned by the speed test thread
+        QMetaObject::invokeMethod(gpSpeedEngine, "set_request_to_send", Qt::QueuedConnection, Q_ARG(bool, ui->check_RTS->isChecked()));
+    }
+    else
+#endif
+    {
+        gspSerialPort.setRequestToSend(ui->check_RTS->isChecked());
+    }
 #ifndef SKIPSPEEDTEST
     if (ui->check_SpeedRTS->isChecked() != ui->check_RTS->isChecked())
     {
@@ -2343,7 +2680,17 @@ AutMainWindow::on_check_DTR_stateChanged(
     )
 {
     //DTR status changed
-    gspSerialPort.setDataTerminalReady(ui->check_DTR->isChecked());
+#ifndef SKIPSPEEDTEST
+    if (gbSpeedTestPortTaken == true)
+    {
+        //Serial port is owned by the speed test thread
+        QMetaObject::invokeMethod(gpSpeedEngine, "set_data_terminal_ready", Qt::QueuedConnection, Q_ARG(bool, ui->check_DTR->isChecked()));
+    }
+    else
+#endif
+    {
+        gspSerialPort.setDataTerminalReady(ui->check_DTR->isChecked());
+    }
 #ifndef SKIPSPEEDTEST
     if (ui->check_SpeedDTR->isChecked() != ui->check_DTR->isChecked())
     {
@@ -2405,10 +2752,8 @@ AutMainWindow::SerialError(
         if (gbStreamingFile == true)
         {
             //Clear up file stream
-            gtmrStreamTimer.invalidate();
             gbStreamingFile = false;
-            gpStreamFileHandle->close();
-            delete gpStreamFileHandle;
+            delete gpStreamFile;
         }
 #ifndef SKIPSPEEDTEST
         else if (gbSpeedTestRunning == true)
@@ -2433,6 +2778,9 @@ AutMainWindow::SerialError(
                 ui->check_SpeedStringUnescape->setEnabled(true);
             }
 
+            //Take the port back from the speed test thread
+            SpeedTestReleasePort();
+
             //Update values
             OutputSpeedTestAvgStats((gtmrSpeedTimer.nsecsElapsed() < 1000000000LL ? 1000000000LL : gtmrSpeedTimer.nsecsElapsed()/1000000000LL));
 
@@ -2456,10 +2804,6 @@ AutMainWindow::SerialError(
                 gtmrSpeedTestStats10s.stop();
             }
 
-            //Clear buffers
-            gbaSpeedMatchData.clear();
-            gbaSpeedReceivedData.clear();
-
             //Show finished message in status bar
             ui->statusBar->showMessage("Speed testing failed due to serial port error.");
         }
@@ -2576,6 +2920,7 @@ AutMainWindow::MessagePass(
         //Output the data and send it to the log
         gspSerialPort.write(baDataString);
         gintQueuedTXBytes += baDataString.size();
+        PluginDataTransmitted(baDataString);
         gpMainLog->WriteRawLogData(baDataString);
 
         if (ui->check_Echo->isChecked() == true)
@@ -2616,6 +2961,8 @@ AutMainWindow::LookupErrorCode(
 {
     //Looks up an error code and outputs it in the edit (does NOT store it to the log)
 #ifndef SKIPERRORCODEFORM
+    LoadErrorCodes();
+
     if (gbErrorsLoaded == true)
     {
         //Error file has been loaded
@@ -2644,8 +2991,8 @@ AutMainWindow::SerialBytesWritten(
 #ifndef SKIPSPEEDTEST
     if (gbSpeedTestRunning == true)
     {
-        //Speed test is running, pass to speed test function
-        SpeedTestBytesWritten(intByteCount);
+        //Speed test is running, the speed test thread counts the bytes written
+        return;
     }
     else
 #endif
@@ -2663,33 +3010,25 @@ AutMainWindow::SerialBytesWritten(
 
         if (gbStreamingFile == true)
         {
-            //File stream in progress, read out a block
-            QByteArray baFileData = gpStreamFileHandle->read(FileReadBlock);
-            gspSerialPort.write(baFileData);
-            gintQueuedTXBytes += baFileData.size();
-            gintStreamBytesRead += baFileData.length();
-            if (gpStreamFileHandle->atEnd())
+            //File stream in progress, queue more data
+            gpStreamFile->bytes_written(intByteCount);
+
+            if (gpStreamFile->is_complete())
             {
                 //Finished sending
                 FinishStream(false);
             }
-            else if (gintStreamBytesRead > gintStreamBytesProgress)
-            {
-                //Progress output
-                update_buffer(QString("Streamed ").append(QString::number(gintStreamBytesRead)).append(" bytes (").append(QString::number(gintStreamBytesRead*100/gintStreamBytesSize)).append("%).\n").toUtf8(), false);
-                gintStreamBytesProgress = gintStreamBytesProgress + StreamProgress;
-            }
-
-            //Update status bar
-            if (gintStreamBytesRead == gintStreamBytesSize)
-            {
-                //Finished streaming file
-                ui->statusBar->showMessage("File streaming complete!");
-            }
             else
             {
-                //Still streaming
-                ui->statusBar->showMessage(QString("Streamed ").append(QString::number(gintStreamBytesRead).append(" bytes of ").append(QString::number(gintStreamBytesSize))).append(" (").append(QString::number(gintStreamBytesRead*100/gintStreamBytesSize)).append("%)"));
+                if ((OS32_64UINT)gpStreamFile->written() > gintStreamBytesProgress)
+                {
+                    //Progress output
+                    update_buffer(QString("Streamed ").append(QString::number(gpStreamFile->written())).append(" bytes (").append(QString::number(gpStreamFile->written()*100/gpStreamFile->size())).append("%).\n").toUtf8(), false);
+                    gintStreamBytesProgress = gintStreamBytesProgress + StreamProgress;
+                }
+
+                //Update status bar with live throughput
+                ui->statusBar->showMessage(QString("Streamed ").append(QString::number(gpStreamFile->written()).append(" bytes of ").append(QString::number(gpStreamFile->size()))).append(" (").append(QString::number(gpStreamFile->written()*100/gpStreamFile->size())).append("%) at ").append(QString::number((quint64)gpStreamFile->throughput())).append(" bytes/second"));
             }
         }
     }
@@ -2713,6 +3052,11 @@ AutMainWindow::on_btn_Cancel_clicked(
             //Cancel stream
             FinishStream(true);
         }
+        else if (gbFileTransferPortTaken == true)
+        {
+            //Cancel file transfer, the receiver is told and the port is given back when it has finished
+            QMetaObject::invokeMethod(gpFileTransfer, "cancel", Qt::QueuedConnection);
+        }
     }
 
     //Disable button
@@ -2730,35 +3074,220 @@ AutMainWindow::FinishStream(
     if (bType == true)
     {
         //Stream cancelled
-        update_buffer(QString("\nCancelled stream after ").append(QString::number(gintStreamBytesRead)).append(" bytes (").append(QString::number(1+(gtmrStreamTimer.nsecsElapsed()/1000000000LL))).append(" seconds) [~").append(QString::number((gintStreamBytesRead/(1+gtmrStreamTimer.nsecsElapsed()/1000000000LL)))).append(" bytes/second].\n").toUtf8(), false);
+        update_buffer(QString("\nCancelled stream after ").append(QString::number(gpStreamFile->written())).append(" bytes (").append(QString::number(1+(gpStreamFile->elapsed_ms()/1000LL))).append(" seconds) [~").append(QString::number((gpStreamFile->written()/(1+gpStreamFile->elapsed_ms()/1000LL)))).append(" bytes/second].\n").toUtf8(), false);
         ui->statusBar->showMessage("File streaming cancelled.");
     }
     else
     {
         //Stream finished
-        update_buffer(QString("\nFinished streaming file, ").append(QString::number(gintStreamBytesRead)).append(" bytes sent in ").append(QString::number(1+(gtmrStreamTimer.nsecsElapsed()/1000000000LL))).append(" seconds [~").append(QString::number((gintStreamBytesRead/(1+gtmrStreamTimer.nsecsElapsed()/1000000000LL)))).append(" bytes/second].\n").toUtf8(), false);
+        update_buffer(QString("\nFinished streaming file, ").append(QString::number(gpStreamFile->written())).append(" bytes sent in ").append(QString::number(1+(gpStreamFile->elapsed_ms()/1000LL))).append(" seconds [~").append(QString::number((gpStreamFile->written()/(1+gpStreamFile->elapsed_ms()/1000LL)))).append(" bytes/second].\n").toUtf8(), false);
         ui->statusBar->showMessage("File streaming complete!");
     }
 
-    //Clear up
-    gtmrStreamTimer.invalidate();
+    //Clear up, this can be called from a signal of the stream so it cannot be deleted immediately
     gbTermBusy = false;
     gbStreamingFile = false;
     gchTermMode = 0;
-    gpStreamFileHandle->close();
-    delete gpStreamFileHandle;
+    gpStreamFile->deleteLater();
     ui->btn_Cancel->setEnabled(false);
 }
 
 //=============================================================================
 //=============================================================================
 void
-AutMainWindow::UpdateReceiveText(
+AutMainWindow::TransferTakePort(
+    AutTransferProtocol tpProtocol,
+    QStringList lstFiles,
+    bool bResume
     )
 {
-    //Updates the receive text buffer
-    if (ui->selector_Tab->currentWidget() == ui->tab_Term)
-    {
+    //Hand the serial port to the file transfer thread, the GUI must not use the port until it has been given back
+    disconnect(&gspSerialPort, SIGNAL(readyRead()), this, SLOT(SerialRead()));
+    disconnect(&gspSerialPort, SIGNAL(errorOccurred(QSerialPort::SerialPortError)), this, SLOT(SerialError(QSerialPort::SerialPortError)));
+    disconnect(&gspSerialPort, SIGNAL(bytesWritten(qint64)), this, SLOT(SerialBytesWritten(qint64)));
+    disconnect(&gspSerialPort, SIGNAL(aboutToClose()), this, SLOT(SerialPortClosing()));
+    gspSerialPort.moveToThread(&gthrTransferThread);
+    gbFileTransferPortTaken = true;
+
+    //Prevent the terminal from sending data, control lines cannot be changed whilst the port is owned by another thread
+    gbTermBusy = true;
+    gchTermMode = 50;
+    ui->btn_Cancel->setEnabled(true);
+    ui->check_Break->setEnabled(false);
+    ui->check_RTS->setEnabled(false);
+    ui->check_DTR->setEnabled(false);
+
+#ifndef SKIPPLUGINS
+    //Data sent by the transfer is only passed back to this thread if a plugin wants it
+    gpFileTransfer->set_publish_written(gpPluginBus->wanted(PluginDataTransmit));
+#endif
+
+    update_buffer(QString("\nSending ").append(QString::number(lstFiles.count())).append(lstFiles.count() == 1 ? " file" : " files").append(", waiting for receiver...\n").toUtf8(), false);
+    QMetaObject::invokeMethod(gpFileTransfer, "start", Qt::QueuedConnection, Q_ARG(int, tpProtocol), Q_ARG(QStringList, lstFiles), Q_ARG(bool, bResume), Q_ARG(QSerialPort*, &gspSerialPort));
+}
+
+//=============================================================================
+//=============================================================================
+void
+AutMainWindow::TransferReleasePort(
+    )
+{
+    //Get the serial port back from the file transfer thread
+    if (gbFileTransferPortTaken == false)
+    {
+        return;
+    }
+
+    QMetaObject::invokeMethod(gpFileTransfer, "stop", Qt::BlockingQueuedConnection);
+    gbFileTransferPortTaken = false;
+    gbTermBusy = false;
+    gchTermMode = 0;
+    ui->btn_Cancel->setEnabled(false);
+
+    connect(&gspSerialPort, SIGNAL(readyRead()), this, SLOT(SerialRead()));
+    connect(&gspSerialPort, SIGNAL(errorOccurred(QSerialPort::SerialPortError)), this, SLOT(SerialError(QSerialPort::SerialPortError)));
+    connect(&gspSerialPort, SIGNAL(bytesWritten(qint64)), this, SLOT(SerialBytesWritten(qint64)));
+    connect(&gspSerialPort, SIGNAL(aboutToClose()), this, SLOT(SerialPortClosing()));
+
+    if (gspSerialPort.isOpen() == true)
+    {
+        ui->check_Break->setEnabled(true);
+        ui->check_RTS->setEnabled(true);
+        ui->check_DTR->setEnabled(true);
+    }
+}
+
+//=============================================================================
+//=============================================================================
+void
+AutMainWindow::TransferProgress(
+    QString strFile,
+    qint64 intPosition,
+    qint64 intSize,
+    qint64 intRate
+    )
+{
+    //Progress published by the file transfer thread
+    if (gbFileTransferPortTaken == false)
+    {
+        return;
+    }
+
+    ui->statusBar->showMessage(QString("Sending ").append(strFile).append(": ").append(QString::number(intPosition)).append(" bytes of ").append(QString::number(intSize)).append(" (").append(QString::number(intSize > 0 ? intPosition*100/intSize : 100)).append("%) at ").append(QString::number(intRate)).append(" bytes/second"));
+}
+
+//=============================================================================
+//=============================================================================
+void
+AutMainWindow::TransferFinished(
+    bool bSuccess,
+    QString strMessage
+    )
+{
+    //File transfer has finished, results which arrive after the port was taken back (e.g. port closed) are ignored
+    if (gbFileTransferPortTaken == false)
+    {
+        return;
+    }
+
+    TransferReleasePort();
+    update_buffer(QString("\n").append(strMessage).append("\n").toUtf8(), false);
+    ui->statusBar->showMessage(bSuccess == true ? "File transfer complete!" : "File transfer failed.");
+}
+
+//=============================================================================
+//=============================================================================
+void
+AutMainWindow::TransferPortError(
+    int intError
+    )
+{
+    //Serial port error whilst the port is owned by the file transfer thread, take the port back before handling it
+    TransferReleasePort();
+    SerialError((QSerialPort::SerialPortError)intError);
+}
+
+//=============================================================================
+//=============================================================================
+void
+AutMainWindow::SetStreamPacing(
+    AutStreamPacing spPacing
+    )
+{
+    //Saves the stream pacing mode and shows it as selected in the menu
+    if (spPacing < StreamPacingNone || spPacing > StreamPacingPrompt)
+    {
+        spPacing = StreamPacingNone;
+    }
+
+    if (gpTermSettings->value("StreamPacing", DefaultStreamPacing).toInt() != spPacing)
+    {
+        gpTermSettings->setValue("StreamPacing", spPacing);
+    }
+
+    gpSMenu5->actions().at(spPacing)->setChecked(true);
+}
+
+//=============================================================================
+//=============================================================================
+void
+AutMainWindow::StreamDataQueued(
+    QByteArray baData
+    )
+{
+    //Data from the file stream has been queued in the serial port
+    gintQueuedTXBytes += baData.size();
+
+    if (ui->check_LogEnable->isChecked())
+    {
+        //Add to log
+        gpMainLog->WriteRawLogData(baData);
+    }
+
+#ifndef SKIPPLUGINS
+    if (gpPluginBus->wanted(PluginDataTransmit) == true)
+    {
+        //The data refers to the memory mapped file which is unmapped when the stream finishes, plugins are given a copy
+        PluginDataTransmitted(QByteArray(baData.constData(), baData.size()));
+    }
+#endif
+}
+
+//=============================================================================
+//=============================================================================
+void
+AutMainWindow::TransferDataWritten(
+    QByteArray baData
+    )
+{
+    //Data sent by the file transfer thread
+    PluginDataTransmitted(baData);
+}
+
+//=============================================================================
+//=============================================================================
+void
+AutMainWindow::StreamFailed(
+    QString strMessage
+    )
+{
+    //File stream could not continue
+    if (gbStreamingFile == true)
+    {
+        update_buffer(QString("\nError during file streaming: ").append(strMessage).toUtf8(), false);
+        FinishStream(true);
+    }
+}
+
+//=============================================================================
+//=============================================================================
+void
+AutMainWindow::UpdateReceiveText(
+    )
+{
+    //Updates the receive text buffer
+    if (ui->selector_Tab->currentWidget() == ui->tab_Term)
+    {
         ui->text_TermEditData->add_display_data(&display_buffers);
         display_update_pending = false;
         display_buffers.clear();
@@ -3172,7 +3701,11 @@ void
 AutMainWindow::SerialPortClosing(
     )
 {
-    //Called when the serial port is closing
+    //Called when the serial port is closing, the modem line monitor must not use the port handle after it has been closed
+    gpModemMonitor->stop_monitor();
+
+    //Put back the settings changed by low latency mode whilst the port handle is still valid
+    AutSerialLatency::restore(gspSerialPort.handle(), gspSerialPort.portName(), &gslsLatencyState);
     ui->image_CTS->setPixmap(*gpEmptyCirclePixmap);
     ui->image_DCD->setPixmap(*gpEmptyCirclePixmap);
     ui->image_DSR->setPixmap(*gpEmptyCirclePixmap);
@@ -3477,15 +4010,6 @@ AutMainWindow::LoadSettings(
 {
     gpTermSettings = new QSettings(QSettings::IniFormat, QSettings::UserScope, "AuTerm", "settings"); //Handle to settings
     gpPredefinedDevice = new QSettings(QSettings::IniFormat, QSettings::UserScope, "AuTerm", "devices"); //Handle to predefined devices
-    gpErrorMessages = new QSettings(":/error_codes.ini", QSettings::IniFormat); //Handle to error codes
-
-    //Check if error code file is included
-    if (!gpErrorMessages->allKeys().isEmpty())
-    {
-        //Error code file has been loaded
-        gbErrorsLoaded = true;
-    }
-
     //Check settings
     if (gpTermSettings->allKeys().isEmpty() || gpTermSettings->value("ConfigVersion").toString() != UwVersion)
     {
@@ -3522,6 +4046,14 @@ AutMainWindow::LoadSettings(
         {
             gpTermSettings->setValue("SerialSignalCheckInterval", DefaultSerialSignalCheckInterval); //How often to check status of CTS, DSR, etc. signals in mS (lower = faster but more CPU usage)
         }
+        if (gpTermSettings->value("ModemLineMonitor").isNull())
+        {
+            gpTermSettings->setValue("ModemLineMonitor", DefaultModemLineMonitor); //Wait for CTS, DSR, etc. signal changes instead of polling them where supported (Linux), 0 = poll, 1 = wait
+        }
+        if (gpTermSettings->value("LowLatency").isNull())
+        {
+            gpTermSettings->setValue("LowLatency", DefaultLowLatency); //Reduce USB serial adapter and driver buffering delays when opening ports (Linux), 0 = disabled, 1 = enabled
+        }
         if (gpTermSettings->value("TextUpdateInterval").isNull())
         {
             gpTermSettings->setValue("TextUpdateInterval", DefaultTextUpdateInterval); //Interval between screen updates in mS, lower = faster but can be problematic when receiving/sending large amounts of data (200 is good for this)
@@ -3693,6 +4225,7 @@ AutMainWindow::on_btn_Error_clicked(
     if (gecErrorCodeForm == 0)
     {
         //Initialise error code form
+        LoadErrorCodes();
         gecErrorCodeForm = new AutErrorCode(nullptr);
         gecErrorCodeForm->SetErrorObject(gpErrorMessages);
     }
@@ -3818,6 +4351,7 @@ AutMainWindow::on_btn_SpeedStartStop_clicked(
         {
             //Data has been received in the past 10 seconds: start a timer before stopping to catch the extra data packets
             gchSpeedTestMode = SpeedModeRecv;
+            QMetaObject::invokeMethod(gpSpeedEngine, "set_mode", Qt::QueuedConnection, Q_ARG(quint8, gchSpeedTestMode));
             gtmrSpeedTestDelayTimer = new QTimer();
             gtmrSpeedTestDelayTimer->setSingleShot(true);
             connect(gtmrSpeedTestDelayTimer, SIGNAL(timeout()), this, SLOT(SpeedTestStopTimer()));
@@ -3830,6 +4364,7 @@ AutMainWindow::on_btn_SpeedStartStop_clicked(
         {
             //Delay for 5 seconds for buffer to clear
             gchSpeedTestMode = SpeedModeInactive;
+            QMetaObject::invokeMethod(gpSpeedEngine, "set_mode", Qt::QueuedConnection, Q_ARG(quint8, gchSpeedTestMode));
             gtmrSpeedTestDelayTimer = new QTimer();
             gtmrSpeedTestDelayTimer->setSingleShot(true);
             connect(gtmrSpeedTestDelayTimer, SIGNAL(timeout()), this, SLOT(SpeedTestStopTimer()));
@@ -3851,6 +4386,9 @@ AutMainWindow::on_btn_SpeedStartStop_clicked(
                 ui->check_SpeedStringUnescape->setEnabled(true);
             }
 
+            //Take the port back from the speed test thread
+            SpeedTestReleasePort();
+
             //Update values
             OutputSpeedTestAvgStats((gtmrSpeedTimer.nsecsElapsed() < 1000000000LL ? 1000000000LL : gtmrSpeedTimer.nsecsElapsed()/1000000000LL));
 
@@ -3874,9 +4412,11 @@ AutMainWindow::on_btn_SpeedStartStop_clicked(
                 gtmrSpeedTestStats10s.stop();
             }
 
-            //Clear buffers
-            gbaSpeedMatchData.clear();
-            gbaSpeedReceivedData.clear();
+            if (gbSpeedTestLatency == true)
+            {
+                //Show latency distribution of the test
+                OutputSpeedTestLatencyHistogram();
+            }
 
             //Show message that test has finished
             ui->statusBar->showMessage("Speed testing finished.");
@@ -3915,7 +4455,7 @@ AutMainWindow::SpeedMenuSelected(
         }
 
         //Check size of string if sending data
-        if (ui->combo_SpeedDataType->currentIndex() != 0 && !(ui->edit_SpeedTestData->text().length() > 3))
+        if (ui->combo_SpeedDataType->currentIndex() == 1 && !(ui->edit_SpeedTestData->text().length() > 3))
         {
             //Invalid string size
             QString strMessage = tr("Error: Test data string must be a minimum of 4 bytes for speed testing.");
@@ -3924,6 +4464,15 @@ AutMainWindow::SpeedMenuSelected(
             return;
         }
 
+        //Latency probes and PRBS sequences use every bit of each byte
+        if (ui->combo_SpeedDataType->currentIndex() >= SpeedDataTypeLatency && gspSerialPort.dataBits() != QSerialPort::Data8)
+        {
+            QString strMessage = tr("Error: Latency and PRBS speed testing require the serial port to be configured for 8 data bits.");
+            gpmErrorForm->SetMessage(&strMessage);
+            gpmErrorForm->show();
+            return;
+        }
+
         //Enable testing
         gintSpeedTestDataBits = gspSerialPort.dataBits();
         gintSpeedTestStartStopParityBits = gspSerialPort.stopBits() + 1 + (gspSerialPort.parity() == QSerialPort::NoParity ? 0 : 1); //Odd/even parity is one bit and include start bit
@@ -3950,7 +4499,6 @@ AutMainWindow::SpeedMenuSelected(
         gintSpeedBufferCount = 0;
         gintSpeedTestStatPacketsSent = 0;
         gintSpeedTestStatPacketsReceived = 0;
-        gintSpeedTestReceiveIndex = 0;
         gintSpeedTestStatSuccess = 0;
         gintSpeedTestStatErrors = 0;
         gbSpeedTestReceived = false;
@@ -3972,34 +4520,73 @@ AutMainWindow::SpeedMenuSelected(
         ui->edit_SpeedBytesSent->setText("0");
         ui->edit_SpeedBytesSent10s->setText("0");
         ui->edit_SpeedBytesSentAvg->setText("0");
+        ui->edit_SpeedBitErrors->setText("0");
+        ui->edit_SpeedBitErrorRate->setText("0");
+        ui->edit_SpeedErrorBursts->setText("0");
+        ui->edit_SpeedBytesDropped->setText("0");
+        ui->edit_SpeedBytesInserted->setText("0");
+        ui->edit_SpeedLongestBurst->setText("0");
+        ui->edit_SpeedLatencyMin->setText("0");
+        ui->edit_SpeedLatencyMedian->setText("0");
+        ui->edit_SpeedLatencyMax->setText("0");
+        ui->edit_SpeedLatency99->setText("0");
+        ui->edit_SpeedLatency999->setText("0");
+        ui->edit_SpeedProbesLost->setText("0");
 
         //Clear all labels
         ui->label_SpeedRx->setText("0");
         ui->label_SpeedTx->setText("0");
         ui->label_SpeedTime->setText("00:00:00:00");
 
-        //Clear received buffer and data match buffer
-        gbaSpeedMatchData.clear();
-        gbaSpeedReceivedData.clear();
+        //Clear recorded samples
+        grecSpeedRecorder.clear();
+        gdtSpeedTestStart = QDateTime::currentDateTime();
+        gpSpeedGraph->update();
 
-        //Check if this is a string match or throughput-only test
-        if (ui->combo_SpeedDataType->currentIndex() != 0)
+        //Clear last snapshot from the speed test thread
+        gsnpSpeedSnapshot = AutSpeedSnapshot();
+
+        //Check if this is a latency, PRBS, string match or throughput-only test
+        AutSpeedEngineConfig secConfig;
+        gbSpeedTestLatency = (ui->combo_SpeedDataType->currentIndex() == SpeedDataTypeLatency);
+        gbSpeedTestPrbs = (ui->combo_SpeedDataType->currentIndex() >= SpeedDataTypePrbsFirst);
+        secConfig.test_id = ++gintSpeedTestId;
+        secConfig.data_type = SpeedDataThroughput;
+        secConfig.prbs_type = PrbsType7;
+        secConfig.send_now = false;
+        secConfig.show_tx = ui->check_SpeedShowTX->isChecked();
+        secConfig.show_rx = ui->check_SpeedShowRX->isChecked();
+        secConfig.show_errors = ui->check_SpeedShowErrors->isChecked();
+
+        if (gbSpeedTestLatency == true)
+        {
+            //Each probe which is echoed back counts as a packet
+            secConfig.data_type = SpeedDataLatency;
+            gintSpeedTestMatchDataLength = LatencyProbeSize;
+        }
+        else if (gbSpeedTestPrbs == true)
+        {
+            //Both ends start from the same seed, the checker synchronises itself to the received data so the receive side can start at any point
+            secConfig.data_type = SpeedDataPrbs;
+            secConfig.prbs_type = (AutPrbsType)(ui->combo_SpeedDataType->currentIndex() - SpeedDataTypePrbsFirst);
+
+            //Each chunk of the sequence which is sent counts as a packet
+            gintSpeedTestMatchDataLength = SpeedTestChunkSize;
+        }
+        else if (ui->combo_SpeedDataType->currentIndex() != 0)
         {
-            //Escape character codes if enabled
+            //String match test, escape character codes if enabled
+            secConfig.data_type = SpeedDataString;
+            secConfig.match_data = ui->edit_SpeedTestData->text().toUtf8();
+
             if (ui->check_SpeedStringUnescape->isChecked())
             {
                 //Escape
-                gbaSpeedMatchData = ui->edit_SpeedTestData->text().toUtf8();
-                AutEscape::escape_characters(&gbaSpeedMatchData);
-            }
-            else
-            {
-                //Normal
-                gbaSpeedMatchData = ui->edit_SpeedTestData->text().toUtf8();
+                AutEscape::escape_characters(&secConfig.match_data);
             }
 
             //Set length of match data
-            gintSpeedTestMatchDataLength = gbaSpeedMatchData.length();
+            gintSpeedTestMatchDataLength = secConfig.match_data.length();
         }
 
         //By default, no send delay
@@ -4016,7 +4603,7 @@ AutMainWindow::SpeedMenuSelected(
             gchSpeedTestMode = SpeedModeSend;
 
             //Send data
-            SendSpeedTestData(SpeedTestChunkSize);
+            secConfig.send_now = true;
         }
         else if (chItem == SpeedMenuActionSendRecv || chItem == SpeedMenuActionSendRecv5Delay || chItem == SpeedMenuActionSendRecv10Delay || chItem == SpeedMenuActionSendRecv15Delay)
         {
@@ -4035,10 +4622,14 @@ AutMainWindow::SpeedMenuSelected(
             else
             {
                 //Send immediately
-                SendSpeedTestData(SpeedTestChunkSize);
+                secConfig.send_now = true;
             }
         }
 
+        //Hand the serial port over to the speed test thread
+        secConfig.mode = gchSpeedTestMode;
+        SpeedTestTakePort(secConfig);
+
         if (!ui->check_SpeedSyncReceive->isChecked())
         {
             //Do not synchronise the receive delay when the first data packet is received
@@ -4163,6 +4754,64 @@ AutMainWindow::on_combo_SpeedDataType_currentIndexChanged(
             ++i;
         }
     }
+    else if (ui->combo_SpeedDataType->currentIndex() == SpeedDataTypeLatency)
+    {
+        //Latency
+        ui->edit_SpeedTestData->setEnabled(false);
+        ui->edit_SpeedPacketsSent->setEnabled(true);
+        ui->edit_SpeedPacketsSent10s->setEnabled(true);
+        ui->edit_SpeedPacketsSentAvg->setEnabled(true);
+        ui->edit_SpeedPacketsRec->setEnabled(true);
+        ui->edit_SpeedPacketsRec10s->setEnabled(true);
+        ui->edit_SpeedPacketsRecAvg->setEnabled(true);
+        ui->edit_SpeedPacketsGood->setEnabled(false);
+        ui->edit_SpeedPacketsBad->setEnabled(false);
+        ui->edit_SpeedPacketsErrorRate->setEnabled(false);
+
+        //Probes must be echoed back, only enable send & receive modes
+        while (i < gpSpeedMenu->actions().length())
+        {
+            gpSpeedMenu->actions().at(i)->setEnabled(gpSpeedMenu->actions().at(i)->data().toInt() >= SpeedMenuActionSendRecv);
+            ++i;
+        }
+    }
+    else
+    {
+        //PRBS
+        ui->edit_SpeedTestData->setEnabled(false);
+        ui->edit_SpeedPacketsSent->setEnabled(true);
+        ui->edit_SpeedPacketsSent10s->setEnabled(true);
+        ui->edit_SpeedPacketsSentAvg->setEnabled(true);
+        ui->edit_SpeedPacketsRec->setEnabled(true);
+        ui->edit_SpeedPacketsRec10s->setEnabled(true);
+        ui->edit_SpeedPacketsRecAvg->setEnabled(true);
+        ui->edit_SpeedPacketsGood->setEnabled(false);
+        ui->edit_SpeedPacketsBad->setEnabled(false);
+        ui->edit_SpeedPacketsErrorRate->setEnabled(false);
+
+        //Enable sending modes
+        while (i < gpSpeedMenu->actions().length())
+        {
+            gpSpeedMenu->actions().at(i)->setEnabled(true);
+            ++i;
+        }
+    }
+
+    //Bit error statistics are only available for PRBS tests
+    ui->edit_SpeedBitErrors->setEnabled(ui->combo_SpeedDataType->currentIndex() >= SpeedDataTypePrbsFirst);
+    ui->edit_SpeedBitErrorRate->setEnabled(ui->combo_SpeedDataType->currentIndex() >= SpeedDataTypePrbsFirst);
+    ui->edit_SpeedErrorBursts->setEnabled(ui->combo_SpeedDataType->currentIndex() >= SpeedDataTypePrbsFirst);
+    ui->edit_SpeedBytesDropped->setEnabled(ui->combo_SpeedDataType->currentIndex() >= SpeedDataTypePrbsFirst);
+    ui->edit_SpeedBytesInserted->setEnabled(ui->combo_SpeedDataType->currentIndex() >= SpeedDataTypePrbsFirst);
+    ui->edit_SpeedLongestBurst->setEnabled(ui->combo_SpeedDataType->currentIndex() >= SpeedDataTypePrbsFirst);
+
+    //Round trip statistics are only available for latency tests
+    ui->edit_SpeedLatencyMin->setEnabled(ui->combo_SpeedDataType->currentIndex() == SpeedDataTypeLatency);
+    ui->edit_SpeedLatencyMedian->setEnabled(ui->combo_SpeedDataType->currentIndex() == SpeedDataTypeLatency);
+    ui->edit_SpeedLatencyMax->setEnabled(ui->combo_SpeedDataType->currentIndex() == SpeedDataTypeLatency);
+    ui->edit_SpeedLatency99->setEnabled(ui->combo_SpeedDataType->currentIndex() == SpeedDataTypeLatency);
+    ui->edit_SpeedLatency999->setEnabled(ui->combo_SpeedDataType->currentIndex() == SpeedDataTypeLatency);
+    ui->edit_SpeedProbesLost->setEnabled(ui->combo_SpeedDataType->currentIndex() == SpeedDataTypeLatency);
 }
 
 //=============================================================================
@@ -4348,279 +4997,266 @@ AutMainWindow::on_btn_SpeedCopy_clicked(
         append(ui->edit_SpeedPacketsBad->text()).
         append("\r\n    > Rx Error Rate % (Packets): ").
         append(ui->edit_SpeedPacketsErrorRate->text()).
+        append("\r\n    > Rx Bit Errors: ").
+        append(ui->edit_SpeedBitErrors->text()).
+        append("\r\n    > Rx Bit Error Rate: ").
+        append(ui->edit_SpeedBitErrorRate->text()).
+        append("\r\n    > Rx Error Bursts: ").
+        append(ui->edit_SpeedErrorBursts->text()).
+        append("\r\n    > Rx Longest Burst (bytes): ").
+        append(ui->edit_SpeedLongestBurst->text()).
+        append("\r\n    > Rx Bytes Dropped: ").
+        append(ui->edit_SpeedBytesDropped->text()).
+        append("\r\n    > Rx Bytes Inserted: ").
+        append(ui->edit_SpeedBytesInserted->text()).
+        append("\r\n    > Latency Min (us): ").
+        append(ui->edit_SpeedLatencyMin->text()).
+        append("\r\n    > Latency Median (us): ").
+        append(ui->edit_SpeedLatencyMedian->text()).
+        append("\r\n    > Latency 99th Percentile (us): ").
+        append(ui->edit_SpeedLatency99->text()).
+        append("\r\n    > Latency 99.9th Percentile (us): ").
+        append(ui->edit_SpeedLatency999->text()).
+        append("\r\n    > Latency Max (us): ").
+        append(ui->edit_SpeedLatencyMax->text()).
+        append("\r\n    > Latency Probes Lost: ").
+        append(ui->edit_SpeedProbesLost->text()).
+        append(gbSpeedTestLatency == true ? QString("\r\n    > Latency Histogram:\r\n").append(gsnpSpeedSnapshot.latency_histogram) : QString()).
         append("\r\n=================================\r\n"));
 }
 
 //=============================================================================
 //=============================================================================
 void
-AutMainWindow::SendSpeedTestData(
-    int intMaxLength
+AutMainWindow::on_btn_SpeedExport_clicked(
     )
 {
-    //Send string out. It's OK to send less than the maximum length but not more, unless none fit
-    int intSendTimes = 1;
+    //Exports the recorded samples and a summary of the speed test
+    QString strExportFilename = QFileDialog::getSaveFileName(this, "Export Speed Test Results", QString("speedtest_").append((gdtSpeedTestStart.isValid() ? gdtSpeedTestStart : QDateTime::currentDateTime()).toString("yyyyMMdd_hhmmss")).append(".json"), "JSON Files (*.json);;CSV Files (*.csv)");
+
+    if (strExportFilename.isEmpty())
+    {
+        return;
+    }
 
-    if (intMaxLength > gintSpeedTestMatchDataLength)
+    QFile fileExport(strExportFilename);
+
+    if (!fileExport.open(QFile::WriteOnly | QFile::Text))
     {
-        intSendTimes = (intMaxLength / gintSpeedTestMatchDataLength);
+        ui->statusBar->showMessage("Failed to open speed test export file for writing.");
+        return;
     }
 
-    if (ui->check_SpeedShowTX->isChecked())
+    if (strExportFilename.endsWith(".csv", Qt::CaseInsensitive))
     {
-        //Show TX data in terminal
-        int print_times = intSendTimes;
+        //Samples and summary are written to separate files as they have different columns
+        QFileInfo fiExport(strExportFilename);
+        QFile fileSummary(fiExport.absolutePath().append("/").append(fiExport.completeBaseName()).append("_summary.csv"));
 
-        while (print_times > 0)
+        fileExport.write(grecSpeedRecorder.to_csv().toUtf8());
+
+        if (fileSummary.open(QFile::WriteOnly | QFile::Text))
         {
-            //Append to buffer
-            gbaSpeedDisplayBuffer.append(gbaSpeedMatchData);
-            --print_times;
+            fileSummary.write(AutSpeedRecorder::summary_to_csv(SpeedTestSummary()).toUtf8());
+            fileSummary.close();
         }
-
-        if (!gtmrSpeedUpdateTimer.isActive())
+        else
         {
-            gtmrSpeedUpdateTimer.start();
+            ui->statusBar->showMessage("Failed to open speed test summary file for writing.");
         }
     }
-
-    while (intSendTimes > 0)
+    else
     {
-        //Send out until finished
-        gspSerialPort.write(gbaSpeedMatchData);
-        gintSpeedBufferCount += gintSpeedTestMatchDataLength;
-        --intSendTimes;
-        ++gintSpeedTestStatPacketsSent;
+        fileExport.write(grecSpeedRecorder.to_json(SpeedTestSummary()));
     }
+
+    fileExport.close();
+}
+
+//=============================================================================
+//=============================================================================
+QJsonObject
+AutMainWindow::SpeedTestSummary(
+    )
+{
+    //Settings and results of the current or last speed test
+    QJsonObject joSummary;
+    QJsonObject joPort;
+    qint64 lngElapsed = (gtmrSpeedTimer.isValid() ? gtmrSpeedTimer.nsecsElapsed()/1000000LL : (grecSpeedRecorder.count() > 0 ? grecSpeedRecorder.at(grecSpeedRecorder.count() - 1)->elapsed_ms : 0));
+
+    joPort.insert("name", gspSerialPort.portName());
+    joPort.insert("baud", gspSerialPort.baudRate());
+    joPort.insert("data_bits", gspSerialPort.dataBits());
+    joPort.insert("stop_bits", gspSerialPort.stopBits());
+    joPort.insert("parity", gspSerialPort.parity());
+    joPort.insert("flow_control", gspSerialPort.flowControl());
+    joPort.insert("low_latency", (gpTermSettings->value("LowLatency", DefaultLowLatency).toBool() == true ? AutSerialLatency::describe(&gslsLatencyState) : QString("disabled")));
+
+    joSummary.insert("version", UwVersion);
+    joSummary.insert("started", gdtSpeedTestStart.toString(Qt::ISODate));
+    joSummary.insert("duration_ms", lngElapsed);
+    joSummary.insert("data_type", ui->combo_SpeedDataType->currentText());
+    joSummary.insert("port", joPort);
+    joSummary.insert("bytes_sent", (qint64)gintSpeedBytesSent);
+    joSummary.insert("bytes_received", (qint64)gintSpeedBytesReceived);
+    joSummary.insert("tx_bytes_per_second", (lngElapsed > 0 ? (double)gintSpeedBytesSent * 1000.0 / (double)lngElapsed : 0.0));
+    joSummary.insert("rx_bytes_per_second", (lngElapsed > 0 ? (double)gintSpeedBytesReceived * 1000.0 / (double)lngElapsed : 0.0));
+    joSummary.insert("packets_sent", gintSpeedTestStatPacketsSent);
+    joSummary.insert("packets_received", gintSpeedTestStatPacketsReceived);
+    joSummary.insert("packets_good", gintSpeedTestStatSuccess);
+    joSummary.insert("packets_bad", gintSpeedTestStatErrors);
+
+    if (gbSpeedTestPrbs == true)
+    {
+        const AutPrbsStats *prbs_stats = &gsnpSpeedSnapshot.prbs;
+        QJsonObject joPrbs;
+
+        joPrbs.insert("bits_checked", (qint64)prbs_stats->bits_checked);
+        joPrbs.insert("bit_errors", (qint64)prbs_stats->bit_errors);
+        joPrbs.insert("bit_error_rate", gsnpSpeedSnapshot.bit_error_rate);
+        joPrbs.insert("bursts", (qint64)prbs_stats->bursts);
+        joPrbs.insert("longest_burst", (qint64)prbs_stats->longest_burst);
+        joPrbs.insert("bytes_dropped", (qint64)prbs_stats->bytes_dropped);
+        joPrbs.insert("bytes_inserted", (qint64)prbs_stats->bytes_inserted);
+        joPrbs.insert("sync_losses", (qint64)prbs_stats->sync_losses);
+        joSummary.insert("prbs", joPrbs);
+    }
+    else if (gbSpeedTestLatency == true)
+    {
+        const AutLatencyStats *latency_stats = &gsnpSpeedSnapshot.latency;
+        QJsonObject joLatency;
+
+        joLatency.insert("probes_sent", (qint64)latency_stats->probes_sent);
+        joLatency.insert("probes_received", (qint64)latency_stats->probes_received);
+        joLatency.insert("probes_lost", (qint64)latency_stats->probes_lost);
+        joLatency.insert("min_us", (double)latency_stats->min_ns / 1000.0);
+        joLatency.insert("mean_us", (double)gsnpSpeedSnapshot.latency_mean_ns / 1000.0);
+        joLatency.insert("median_us", (double)gsnpSpeedSnapshot.latency_p50_ns / 1000.0);
+        joLatency.insert("p90_us", (double)gsnpSpeedSnapshot.latency_p90_ns / 1000.0);
+        joLatency.insert("p99_us", (double)gsnpSpeedSnapshot.latency_p99_ns / 1000.0);
+        joLatency.insert("p999_us", (double)gsnpSpeedSnapshot.latency_p999_ns / 1000.0);
+        joLatency.insert("max_us", (double)latency_stats->max_ns / 1000.0);
+        joSummary.insert("latency", joLatency);
+    }
+
+    return joSummary;
 }
 
 //=============================================================================
 //=============================================================================
 void
-AutMainWindow::SpeedTestBytesWritten(
-    qint64 intByteCount
+AutMainWindow::SpeedTestTakePort(
+    AutSpeedEngineConfig secConfig
     )
 {
-    //Serial port bytes have been written in speed test mode
-    if ((gchSpeedTestMode & SpeedModeSend) == SpeedModeSend)
-    {
-        //Sending data in speed test
-        gintSpeedBufferCount -= intByteCount;
-        if (gintSpeedBufferCount <= SpeedTestMinBufSize)
-        {
-            //Buffer has space: send more data
-            SendSpeedTestData(SpeedTestChunkSize);
-        }
-    }
+    //Hand the serial port to the speed test thread, the GUI must not use the port until it has been given back
+    disconnect(&gspSerialPort, SIGNAL(readyRead()), this, SLOT(SerialRead()));
+    disconnect(&gspSerialPort, SIGNAL(errorOccurred(QSerialPort::SerialPortError)), this, SLOT(SerialError(QSerialPort::SerialPortError)));
+    disconnect(&gspSerialPort, SIGNAL(bytesWritten(qint64)), this, SLOT(SerialBytesWritten(qint64)));
+    disconnect(&gspSerialPort, SIGNAL(aboutToClose()), this, SLOT(SerialPortClosing()));
+    gspSerialPort.moveToThread(&gthrSpeedThread);
+    gbSpeedTestPortTaken = true;
+
+    //Prevent the terminal from sending data
+    gbTermBusy = true;
 
-    //Add to bytes sent counters
-    gintSpeedBytesSent += intByteCount;
-    gintSpeedBytesSent10s += intByteCount;
+    QMetaObject::invokeMethod(gpSpeedEngine, "start", Qt::QueuedConnection, Q_ARG(AutSpeedEngineConfig, secConfig), Q_ARG(QSerialPort*, &gspSerialPort));
 }
 
 //=============================================================================
 //=============================================================================
 void
-AutMainWindow::SpeedTestReceive(
+AutMainWindow::SpeedTestReleasePort(
     )
 {
-    //Receieved data from serial port in speed test mode
-    if ((gchSpeedTestMode & SpeedModeRecv) == SpeedModeRecv)
+    //Get the serial port back from the speed test thread along with the final counters
+    AutSpeedSnapshot snpFinal;
+
+    if (gbSpeedTestPortTaken == false)
     {
-        //Check data as in receieve mode
-        uint64_t received_bytes = gspSerialPort.bytesAvailable();
-        gintSpeedBytesReceived += received_bytes;
-        gintSpeedBytesReceived10s += received_bytes;
+        return;
+    }
 
-        if (ui->check_SpeedSyncReceive->isChecked() && gbSpeedTestReceived == false)
-        {
-            //Data has now been received, update the delay timer
-            gbSpeedTestReceived = true;
-            gintDelayedSpeedTestReceive = gtmrSpeedTimer.nsecsElapsed()/1000000000LL;
-        }
+    QMetaObject::invokeMethod(gpSpeedEngine, "stop", Qt::BlockingQueuedConnection, Q_ARG(AutSpeedSnapshot*, &snpFinal));
+    SpeedTestSnapshot(snpFinal);
+    gbSpeedTestPortTaken = false;
+    gbTermBusy = false;
 
-        if (ui->check_SpeedShowRX->isChecked() == true)
-        {
-            //Append RX data to buffer
-            gbaSpeedDisplayBuffer.append(gspSerialPort.peek(received_bytes));
-            if (!gtmrSpeedUpdateTimer.isActive())
-            {
-                gtmrSpeedUpdateTimer.start();
-            }
-        }
+    connect(&gspSerialPort, SIGNAL(readyRead()), this, SLOT(SerialRead()));
+    connect(&gspSerialPort, SIGNAL(errorOccurred(QSerialPort::SerialPortError)), this, SLOT(SerialError(QSerialPort::SerialPortError)));
+    connect(&gspSerialPort, SIGNAL(bytesWritten(qint64)), this, SLOT(SerialBytesWritten(qint64)));
+    connect(&gspSerialPort, SIGNAL(aboutToClose()), this, SLOT(SerialPortClosing()));
 
-        if (ui->combo_SpeedDataType->currentIndex() != 0)
-        {
-            //Test data is OK
-            int32_t remove_size = 0;
-            gbaSpeedReceivedData.append(gspSerialPort.read(received_bytes));
-            while (remove_size < gbaSpeedReceivedData.length())
-            {
-                //Data to check
-                int SizeToTest = gintSpeedTestMatchDataLength - gintSpeedTestReceiveIndex;
-                if ((SizeToTest + remove_size) > gbaSpeedReceivedData.length())
-                {
-                    SizeToTest = gbaSpeedReceivedData.length() - remove_size;
-                }
+    UpdateSpeedTestValues();
+}
 
-                //Optimised search check function. for testing only
-                int32_t i = 0;
-                bool good = true;
-                pointer_buf rec_buf;
-                pointer_buf match_buf;
-                rec_buf.p8 = ((uint8_t *)gbaSpeedReceivedData.data() + remove_size);
-                match_buf.p8 = ((uint8_t *)gbaSpeedMatchData.data() + gintSpeedTestReceiveIndex);
+//=============================================================================
+//=============================================================================
+void
+AutMainWindow::SpeedTestSnapshot(
+    AutSpeedSnapshot snapshot
+    )
+{
+    //Counters have been published by the speed test thread, snapshots which were queued before the test stopped are ignored
+    if (gbSpeedTestPortTaken == false || snapshot.test_id != gintSpeedTestId)
+    {
+        return;
+    }
 
-                while (i < SizeToTest)
-                {
-                    uint32_t loop_check_size = 8;
-                    switch (SizeToTest - i)
-                    {
-                    case 1:
-                        if (*rec_buf.p8 != *match_buf.p8)
-                        {
-                                good = false;
-                        }
-                        loop_check_size = 1;
-                        break;
-                    case 2:
-                        if (*rec_buf.p16 != *match_buf.p16)
-                        {
-                                good = false;
-                        }
-                        loop_check_size = 2;
-                        break;
-                    case 3:
-                        if (*rec_buf.p16 != *match_buf.p16 || *(rec_buf.p8+2) != *(match_buf.p8+2))
-                        {
-                                good = false;
-                        }
-                        loop_check_size = 3;
-                        break;
-                    case 4:
-                        if (*rec_buf.p32 != *match_buf.p32)
-                        {
-                                good = false;
-                        }
-                        loop_check_size = 4;
-                        break;
-                    case 5:
-                        if (*rec_buf.p32 != *match_buf.p32 || *(rec_buf.p8 + 4) != *(match_buf.p8 + 4))
-                        {
-                                good = false;
-                        }
-                        loop_check_size = 5;
-                        break;
-                    case 6:
-                        if (*rec_buf.p32 != *match_buf.p32 || *(rec_buf.p16 + 2) != *(match_buf.p16 + 2))
-                        {
-                                good = false;
-                        }
-                        loop_check_size = 6;
-                        break;
-                    case 7:
-                        if (*rec_buf.p32 != *match_buf.p32 || *(rec_buf.p16 + 2) != *(match_buf.p16 + 2) || *(rec_buf.p8 + 6) != *(match_buf.p8 + 6))
-                        {
-                                good = false;
-                        }
-                        loop_check_size = 7;
-                        break;
-                    default:
-                        if (*rec_buf.p64 != *match_buf.p64)
-                        {
-                                good = false;
-                        }
-                        break;
-                    }
+    gintSpeedBytesSent10s += snapshot.bytes_sent - gintSpeedBytesSent;
+    gintSpeedBytesReceived10s += snapshot.bytes_received - gintSpeedBytesReceived;
+    gintSpeedBytesSent = snapshot.bytes_sent;
+    gintSpeedBytesReceived = snapshot.bytes_received;
+    gintSpeedBufferCount = snapshot.buffer_bytes;
+    gintSpeedTestStatPacketsSent = snapshot.packets_sent;
+    gintSpeedTestStatPacketsReceived = snapshot.packets_received;
+    gintSpeedTestStatSuccess = snapshot.packets_good;
+    gintSpeedTestStatErrors = snapshot.packets_bad;
 
-                    if (good == false)
-                    {
-                        break;
-                    }
+    if (gbSpeedTestReceived == false && snapshot.first_receive_ms >= 0)
+    {
+        //Receive averages start from when the first data was received
+        gbSpeedTestReceived = true;
+        gintDelayedSpeedTestReceive = snapshot.first_receive_ms/1000LL;
+    }
 
-                    i += loop_check_size;
-                    rec_buf.p8 += loop_check_size;
-                    match_buf.p8 += loop_check_size;
-                }
+    if (!snapshot.display.isEmpty())
+    {
+        //Show sent/received data and errors
+        gbaSpeedDisplayBuffer.append(snapshot.display);
+        snapshot.display.clear();
 
-                if (good == true)
-                {
-                    //Good
-                    remove_size += SizeToTest;
-                    gintSpeedTestReceiveIndex += SizeToTest;
-                    if (gintSpeedTestReceiveIndex >= gintSpeedTestMatchDataLength)
-                    {
-                        ++gintSpeedTestStatSuccess;
-                        ++gintSpeedTestStatPacketsReceived;
-                        gintSpeedTestReceiveIndex = 0;
-                    }
-                }
-                else
-                {
-                    //Bad
-                    ++gintSpeedTestStatErrors;
-
-                    if (ui->check_SpeedShowErrors->isChecked())
-                    {
-                        //Show error - find mismatch position
-                        uint16_t new_offset = (i > 5 ? i - 5 : 0);
-                        QString strFirst(gbaSpeedReceivedData.mid(remove_size + new_offset));
-                        QString strSecond(gbaSpeedMatchData.mid(gintSpeedTestReceiveIndex + new_offset));
-                        int32_t max_size = strFirst.length() > strSecond.length() ? strSecond.length() : strFirst.length();
-                        quint16 iOffset = 0;
-                        while (iOffset < max_size)
-                        {
-                                if (strFirst.at(iOffset) != strSecond.at(iOffset))
-                                {
-                                        //Found
-                                        ++iOffset;
-                                        break;
-                                }
-                                ++iOffset;
-                        }
-
-                        if (strFirst.length() > max_size)
-                        {
-                                strFirst.remove(max_size, strFirst.length() - max_size);
-                        }
-
-                        if (strSecond.length() > max_size)
-                        {
-                                strSecond.remove(max_size, strSecond.length() - max_size);
-                        }
-
-                        //Add to display
-                        gbaSpeedDisplayBuffer.append(QString("\r\nError: Data mismatch.\r\n\tExpected: ").append(strSecond).append("\r\n\tGot     : ").append(strFirst).append("\r\n\tPosition: ").append(QString("-").repeated(iOffset-1).append("^")).append("\r\n\tOccurred: ").append(ui->label_SpeedTime->text()).append(" (").append(QDateTime::currentDateTime().toLocalTime().toString()).append(")\r\n").toUtf8());
-                        if (!gtmrSpeedUpdateTimer.isActive())
-                        {
-                                gtmrSpeedUpdateTimer.start();
-                        }
-                    }
+        if (!gtmrSpeedUpdateTimer.isActive())
+        {
+            gtmrSpeedUpdateTimer.start();
+        }
+    }
 
-                    //Search for start character (ignoring first character)
-                    int StartChar = gbaSpeedReceivedData.indexOf(gbaSpeedMatchData.at(0), remove_size + 1);
-                    if (StartChar == -1)
-                    {
-                        //Not found, clear whole receive buffer
-                        gbaSpeedReceivedData.clear();
-                    }
-                    else
-                    {
-                        //Found, remove until this character
-                        gbaSpeedReceivedData.remove(0, StartChar);
-                    }
+    gsnpSpeedSnapshot = snapshot;
+}
 
-                    ++gintSpeedTestStatPacketsReceived;
-                    gintSpeedTestReceiveIndex = 0;
-                    remove_size = 0;
-                }
-            }
+//=============================================================================
+//=============================================================================
+void
+AutMainWindow::SpeedTestPortError(
+    int intError
+    )
+{
+    //Serial port error whilst the port is owned by the speed test thread, take the port back before handling it
+    SpeedTestReleasePort();
+    SerialError((QSerialPort::SerialPortError)intError);
+}
 
-            if (remove_size > 0)
-            {
-                gbaSpeedReceivedData.remove(0, remove_size);
-            }
-        }
+//=============================================================================
+//=============================================================================
+void
+AutMainWindow::SpeedTestDisplayOptionsChanged(
+    )
+{
+    //Display options can be changed whilst a test is running
+    if (gbSpeedTestPortTaken == true)
+    {
+        QMetaObject::invokeMethod(gpSpeedEngine, "set_display_options", Qt::QueuedConnection, Q_ARG(bool, ui->check_SpeedShowTX->isChecked()), Q_ARG(bool, ui->check_SpeedShowRX->isChecked()), Q_ARG(bool, ui->check_SpeedShowErrors->isChecked()));
     }
 }
 
@@ -4687,7 +5323,49 @@ AutMainWindow::UpdateSpeedTestValues(
             //Calculate error rate (up to 2 decimal places and rounding up)
             ui->edit_SpeedPacketsErrorRate->setText(QString::number(std::ceil((float)gintSpeedTestStatErrors*10000.0/(float)(gintSpeedTestStatSuccess+gintSpeedTestStatErrors))/100.0));
         }
+
+        if (gbSpeedTestPrbs == true)
+        {
+            //Update PRBS bit error statistics
+            const AutPrbsStats *prbs_stats = &gsnpSpeedSnapshot.prbs;
+            ui->edit_SpeedBitErrors->setText(QString::number(prbs_stats->bit_errors));
+            ui->edit_SpeedBitErrorRate->setText(QString::number(gsnpSpeedSnapshot.bit_error_rate, 'e', 2));
+            ui->edit_SpeedErrorBursts->setText(QString::number(prbs_stats->bursts));
+            ui->edit_SpeedBytesDropped->setText(QString::number(prbs_stats->bytes_dropped));
+            ui->edit_SpeedBytesInserted->setText(QString::number(prbs_stats->bytes_inserted));
+            ui->edit_SpeedLongestBurst->setText(QString::number(prbs_stats->longest_burst));
+        }
+        else if (gbSpeedTestLatency == true)
+        {
+            //Update round trip latency statistics (in microseconds)
+            const AutLatencyStats *latency_stats = &gsnpSpeedSnapshot.latency;
+
+            if (latency_stats->probes_received > 0)
+            {
+                ui->edit_SpeedLatencyMin->setText(QString::number((double)latency_stats->min_ns / 1000.0, 'f', 1));
+                ui->edit_SpeedLatencyMedian->setText(QString::number((double)gsnpSpeedSnapshot.latency_p50_ns / 1000.0, 'f', 1));
+                ui->edit_SpeedLatencyMax->setText(QString::number((double)latency_stats->max_ns / 1000.0, 'f', 1));
+                ui->edit_SpeedLatency99->setText(QString::number((double)gsnpSpeedSnapshot.latency_p99_ns / 1000.0, 'f', 1));
+                ui->edit_SpeedLatency999->setText(QString::number((double)gsnpSpeedSnapshot.latency_p999_ns / 1000.0, 'f', 1));
+            }
+
+            ui->edit_SpeedProbesLost->setText(QString::number(latency_stats->probes_lost));
+        }
     }
+
+    //Record sample of the counters
+    AutSpeedSample sample;
+    sample.elapsed_ms = lngElapsed;
+    sample.bytes_sent = gintSpeedBytesSent;
+    sample.bytes_received = gintSpeedBytesReceived;
+    sample.packets_sent = gintSpeedTestStatPacketsSent;
+    sample.packets_received = gintSpeedTestStatPacketsReceived;
+    sample.packets_bad = gintSpeedTestStatErrors;
+    sample.bit_errors = (gbSpeedTestPrbs == true ? gsnpSpeedSnapshot.prbs.bit_errors : 0);
+    sample.probes_lost = (gbSpeedTestLatency == true ? gsnpSpeedSnapshot.latency.probes_lost : 0);
+    sample.buffer_bytes = gintSpeedBufferCount;
+    grecSpeedRecorder.add(sample);
+    gpSpeedGraph->update();
 }
 
 //=============================================================================
@@ -4700,7 +5378,7 @@ AutMainWindow::SpeedTestStartTimer(
     disconnect(gtmrSpeedTestDelayTimer, SIGNAL(timeout()), this, SLOT(SpeedTestStartTimer()));
     delete gtmrSpeedTestDelayTimer;
     gtmrSpeedTestDelayTimer = 0;
-    SendSpeedTestData(SpeedTestChunkSize);
+    QMetaObject::invokeMethod(gpSpeedEngine, "start_sending", Qt::QueuedConnection);
 }
 
 //=============================================================================
@@ -4723,6 +5401,9 @@ AutMainWindow::SpeedTestStopTimer(
         ui->check_SpeedStringUnescape->setEnabled(true);
     }
 
+    //Take the port back from the speed test thread
+    SpeedTestReleasePort();
+
     //Update values
     OutputSpeedTestAvgStats(gtmrSpeedTimer.nsecsElapsed()/1000000000LL);
 
@@ -4746,9 +5427,11 @@ AutMainWindow::SpeedTestStopTimer(
         gtmrSpeedTestStats10s.stop();
     }
 
-    //Clear buffers
-    gbaSpeedMatchData.clear();
-    gbaSpeedReceivedData.clear();
+    if (gbSpeedTestLatency == true)
+    {
+        //Show latency distribution of the test
+        OutputSpeedTestLatencyHistogram();
+    }
 
     //Show finished message in status bar
     ui->statusBar->showMessage("Speed testing finished.");
@@ -4809,6 +5492,23 @@ AutMainWindow::OutputSpeedTestAvgStats(
     }
 }
 
+//=============================================================================
+//=============================================================================
+void
+AutMainWindow::OutputSpeedTestLatencyHistogram(
+    )
+{
+    //Outputs the distribution of round trip times to the speed test display
+    const AutLatencyStats *latency_stats = &gsnpSpeedSnapshot.latency;
+
+    gbaSpeedDisplayBuffer.append(QString("\r\nLatency: ").append(QString::number(latency_stats->probes_received)).append(" of ").append(QString::number(latency_stats->probes_sent)).append(" probes echoed, ").append(QString::number(latency_stats->probes_lost)).append(" lost, mean ").append(QString::number((double)gsnpSpeedSnapshot.latency_mean_ns / 1000.0, 'f', 1)).append(" us\r\n").append(gsnpSpeedSnapshot.latency_histogram).toUtf8());
+
+    if (!gtmrSpeedUpdateTimer.isActive())
+    {
+        gtmrSpeedUpdateTimer.start();
+    }
+}
+
 //=============================================================================
 //=============================================================================
 void
@@ -4968,6 +5668,42 @@ AutMainWindow::SetLoopBackMode(
     }
 }
 
+//=============================================================================
+//=============================================================================
+void
+AutMainWindow::SetLowLatencyMode(
+    bool bEnable
+    )
+{
+    //Applies or removes low latency mode on the open port and shows the effective settings, compare the round trip time
+    //with the speed test latency mode to check the difference it makes
+    if (gspSerialPort.isOpen() == false)
+    {
+        return;
+    }
+
+    if (bEnable == true)
+    {
+        if (AutSerialLatency::apply(gspSerialPort.handle(), gspSerialPort.portName(), &gslsLatencyState) == false)
+        {
+            update_buffer("\n[Low latency mode is not supported by this port]\n", false);
+            return;
+        }
+
+        update_buffer(QString("\n[").append(AutSerialLatency::describe(&gslsLatencyState)).append("]\n").toUtf8(), false);
+
+        if (gslsLatencyState.latency_timer > SerialLatencyTimerLow)
+        {
+            update_buffer("[Unable to change the adapter latency timer, write access to its latency_timer sysfs attribute is needed]\n", false);
+        }
+    }
+    else
+    {
+        AutSerialLatency::restore(gspSerialPort.handle(), gspSerialPort.portName(), &gslsLatencyState);
+        update_buffer("\n[Low latency mode disabled]\n", false);
+    }
+}
+
 #ifndef SKIPONLINE
 //=============================================================================
 //=============================================================================
@@ -5100,7 +5836,7 @@ void
 AutMainWindow::on_btn_Plugin_Abort_clicked(
     )
 {
-    if (ui->list_Plugin_Plugins->currentRow() >= 0)
+    if (ui->list_Plugin_Plugins->currentRow() >= 0 && LoadPlugin(ui->list_Plugin_Plugins->currentRow()) == true)
     {
         gpmErrorForm->show_message(plugin_list.at(ui->list_Plugin_Plugins->currentRow()).plugin->plugin_about());
     }
@@ -5112,7 +5848,7 @@ void
 AutMainWindow::on_btn_Plugin_Config_clicked(
     )
 {
-    if (ui->list_Plugin_Plugins->currentRow() >= 0 && plugin_list.at(ui->list_Plugin_Plugins->currentRow()).plugin->plugin_configuration() == false)
+    if (ui->list_Plugin_Plugins->currentRow() >= 0 && LoadPlugin(ui->list_Plugin_Plugins->currentRow()) == true && plugin_list.at(ui->list_Plugin_Plugins->currentRow()).plugin->plugin_configuration() == false)
     {
         gpmErrorForm->show_message("This plugin does not have any configuration.");
     }
@@ -5174,20 +5910,16 @@ AutMainWindow::find_plugin(
     uint16_t i = 0;
     uint16_t l = plugin_list.length();
 
-#ifdef QT_STATIC
-    QVector<QStaticPlugin> static_plugins = QPluginLoader::staticPlugins();
-#endif
-
     while (i < l)
     {
-        if (name ==
-#ifdef QT_STATIC
-            static_plugins.at(i).metaData().value("MetaData").toObject().value("Name").toString()
-#else
-            plugin_list[i].plugin_loader->metaData().value("MetaData").toObject().value("Name").toString()
-#endif
-        )
+        if (name == plugin_list.at(i).name)
         {
+            //Plugins which have not been used yet are loaded when another plugin asks for them
+            if (LoadPlugin(i) == false)
+            {
+                break;
+            }
+
             plugin->object = plugin_list[i].object;
             plugin->found = true;
             return;
@@ -5208,10 +5940,25 @@ AutMainWindow::plugin_serial_transmit(
     )
 {
 //    qDebug() << "Transmitted";
+#ifndef SKIPSPEEDTEST
+    if (gbSpeedTestPortTaken == true)
+    {
+        //Serial port is owned by the speed test thread
+        return;
+    }
+#endif
+
+    if (gbFileTransferPortTaken == true)
+    {
+        //Serial port is owned by the file transfer thread
+        return;
+    }
+
     if (gbPluginRunning == true)
     {
         gspSerialPort.write(*data);
         gintQueuedTXBytes += data->size();
+        PluginDataTransmitted(*data);
 
 //TODO: Add to log
         gpMainLog->WriteLogData(*data);
@@ -5318,6 +6065,21 @@ void AutMainWindow::plugin_load_setting(QString name, QVariant *data, bool *foun
         *data = gpTermSettings->value(name);
     }
 }
+
+//=============================================================================
+//=============================================================================
+void AutMainWindow::plugin_data_subscribe(QObject *receiver, quint32 flags, qint32 queue_limit)
+{
+    //The sender is the plugin object, which is what plugin_set_status records as the running plugin
+    gpPluginBus->subscribe(this->sender(), receiver, flags, queue_limit);
+}
+
+//=============================================================================
+//=============================================================================
+void AutMainWindow::plugin_data_unsubscribe(QObject *receiver)
+{
+    gpPluginBus->unsubscribe(receiver);
+}
 #endif
 
 //=============================================================================
@@ -5411,6 +6173,22 @@ void AutMainWindow::on_check_enable_online_version_check_toggled(bool checked)
 //=============================================================================
 void AutMainWindow::on_selector_Tab_currentChanged(int index)
 {
+#ifndef SKIPPLUGINS
+    int32_t i = 0;
+
+    while (i < plugin_list.length())
+    {
+        if (plugin_list.at(i).loaded == false && plugin_list.at(i).placeholder != nullptr && ui->selector_Tab->widget(index) == plugin_list.at(i).placeholder)
+        {
+            //First time the tab of this plugin has been opened, set the plugin up which replaces the placeholder tab
+            LoadPlugin(i);
+            return;
+        }
+
+        ++i;
+    }
+#endif
+
     if (index == ui->selector_Tab->indexOf(ui->tab_Term))
     {
         if (display_update_pending == true)
@@ -5508,6 +6286,232 @@ void AutMainWindow::update_display_trimming()
     }
 }
 
+//=============================================================================
+//=============================================================================
+void
+AutMainWindow::PluginDataTransmitted(
+    const QByteArray &baData
+    )
+{
+    //Passes data sent to the serial port to the plugins which have subscribed to it
+#ifndef SKIPPLUGINS
+    if (gpPluginBus->wanted(PluginDataTransmit) == true)
+    {
+        gpPluginBus->publish(baData, PluginDataTransmit, (gbPluginRunning == true ? plugin_status_owner : nullptr));
+    }
+#else
+    Q_UNUSED(baData);
+#endif
+}
+
+//=============================================================================
+//=============================================================================
+void
+AutMainWindow::StartupFinished(
+    )
+{
+    //Runs once the event loop has started and the window has been shown, non-critical startup work is done from here
+    StartupTrace("Event loop started");
+
+#ifndef SKIPONLINE
+    if (ui->check_enable_online_version_check->isChecked())
+    {
+        bool run_check = true;
+
+        if (gpTermSettings->contains("LastUpdateCheck"))
+        {
+            if (gpTermSettings->value("LastUpdateCheck", QDate::currentDate().toString()).toString() == QDate::currentDate().toString())
+            {
+                run_check = false;
+            }
+        }
+
+        if (run_check == true)
+        {
+            gpTermSettings->setValue("LastUpdateCheck", QDate::currentDate().toString());
+            ui->label_version_update->setText("checking...");
+            AuTermUpdateCheck();
+        }
+        else
+        {
+            ui->label_version_update->setText("already checked today.");
+        }
+    }
+#endif
+}
+
+//=============================================================================
+//=============================================================================
+void
+AutMainWindow::StartupTrace(
+    QString strStage
+    )
+{
+    //Outputs the time taken by a startup stage when the AUTERM_STARTUP_TRACE environment variable is set
+    if (gbStartupTrace == false)
+    {
+        return;
+    }
+
+    qint64 intElapsed = gtmrStartupTrace.elapsed();
+    qInfo().noquote() << QString("Startup trace: %1 +%2ms (total %3ms)").arg(strStage).arg(intElapsed - gintStartupTraceLast).arg(intElapsed);
+    gintStartupTraceLast = intElapsed;
+}
+
+//=============================================================================
+//=============================================================================
+void
+AutMainWindow::LoadErrorCodes(
+    )
+{
+    //Error codes are parsed the first time they are needed rather than at startup
+    if (gpErrorMessages != nullptr)
+    {
+        return;
+    }
+
+    gpErrorMessages = new QSettings(":/error_codes.ini", QSettings::IniFormat); //Handle to error codes
+
+    //Check if error code file is included
+    if (!gpErrorMessages->allKeys().isEmpty())
+    {
+        //Error code file has been loaded
+        gbErrorsLoaded = true;
+    }
+}
+
+#ifndef SKIPPLUGINS
+//=============================================================================
+//=============================================================================
+void
+AutMainWindow::AddPlugin(
+    struct plugins plugin,
+    const QJsonObject &joMetaData
+    )
+{
+    //Adds a plugin found from its metadata, plugins with a tab get a placeholder tab until it is first opened
+    plugin.object = nullptr;
+    plugin.plugin = nullptr;
+    plugin.placeholder = nullptr;
+    plugin.loaded = false;
+    plugin.name = joMetaData.value("Name").toString();
+    plugin.tab = joMetaData.value("Tab").toString();
+
+    if (!plugin.tab.isEmpty())
+    {
+        plugin.placeholder = new QWidget(ui->selector_Tab);
+        ui->selector_Tab->addTab(plugin.placeholder, plugin.tab);
+    }
+
+    plugin_list.append(plugin);
+    ui->list_Plugin_Plugins->addItem(QString(plugin.name).append(", version ").append(joMetaData.value("Version").toString()));
+
+    if (plugin.tab.isEmpty() && joMetaData.value("Lazy").toBool() == false)
+    {
+        //Plugins without a tab which have not opted in to lazy loading may provide things at startup so load them now
+        LoadPlugin(plugin_list.length() - 1);
+    }
+}
+
+//=============================================================================
+//=============================================================================
+bool
+AutMainWindow::LoadPlugin(
+    int intIndex
+    )
+{
+    //Loads and sets up a plugin the first time it is needed
+    if (plugin_list.at(intIndex).loaded == true)
+    {
+        return true;
+    }
+
+    struct plugins *plugin = &plugin_list[intIndex];
+    QElapsedTimer tmrLoad;
+    tmrLoad.start();
+
+#ifdef QT_STATIC
+    plugin->object = QPluginLoader::staticPlugins().at(plugin->static_index).instance();
+#else
+    plugin->object = plugin->plugin_loader->instance();
+#endif
+
+    if (plugin->object != nullptr)
+    {
+        plugin->plugin = qobject_cast<AutPlugin *>(plugin->object);
+    }
+
+    if (plugin->object == nullptr || plugin->plugin == nullptr)
+    {
+        QString strError = "does not implement the AuTerm plugin interface";
+
+#ifndef QT_STATIC
+        if (plugin->object == nullptr)
+        {
+            strError = plugin->plugin_loader->errorString();
+        }
+
+        plugin->plugin_loader->unload();
+#endif
+        plugin->object = nullptr;
+        plugin->plugin = nullptr;
+
+        if (gbAppStarted == true)
+        {
+            gpmErrorForm->show_message(QString("Failed to load plugin ").append(plugin->name).append(": ").append(strError));
+        }
+        else
+        {
+            //Plugins which fail to load during startup are marked in the plugin list as the error form does not exist yet
+            ui->list_Plugin_Plugins->item(intIndex)->setText(ui->list_Plugin_Plugins->item(intIndex)->text().append(" (failed to load: ").append(strError).append(")"));
+        }
+
+        return false;
+    }
+
+    //Marked as loaded before setup so that plugins looking up other plugins cannot recurse into this one
+    plugin->loaded = true;
+
+    int32_t intTabCount = ui->selector_Tab->count();
+    QWidget *placeholder = plugin->placeholder;
+    plugin->placeholder = nullptr;
+    plugin->plugin->setup(this);
+
+    if (placeholder != nullptr)
+    {
+        //Move the tab added by the plugin to where the placeholder tab was and remove the placeholder
+        bool bPlaceholderCurrent = (ui->selector_Tab->currentWidget() == placeholder);
+        ui->selector_Tab->blockSignals(true);
+
+        if (ui->selector_Tab->count() > intTabCount)
+        {
+            QWidget *tab = ui->selector_Tab->widget(intTabCount);
+            QString strTabText = ui->selector_Tab->tabText(intTabCount);
+            ui->selector_Tab->removeTab(intTabCount);
+            ui->selector_Tab->insertTab(ui->selector_Tab->indexOf(placeholder), tab, strTabText);
+
+            if (bPlaceholderCurrent == true)
+            {
+                ui->selector_Tab->setCurrentWidget(tab);
+            }
+        }
+
+        ui->selector_Tab->removeTab(ui->selector_Tab->indexOf(placeholder));
+        ui->selector_Tab->blockSignals(false);
+        placeholder->deleteLater();
+    }
+
+    if (gbAppStarted == true)
+    {
+        plugin->plugin->setup_finished();
+    }
+
+    StartupTrace(QString("Plugin ").append(plugin->name).append(" setup"));
+
+    return true;
+}
+#endif
+
 /******************************************************************************/
 // END OF FILE
 /******************************************************************************/
@@ -51,12 +51,15 @@
 #include <QTextDocumentFragment>
 #include <QTime>
 #include <QDate>
+#include <QDateTime>
 #include <QElapsedTimer>
 #include <QDesktopServices>
 #include <QUrl>
 #include <QFileInfo>
 #include <QStringView>
 #include <QListWidgetItem>
+#include <QActionGroup>
+#include <QInputDialog>
 //Need cmath for std::ceil function
 #include <cmath>
 #include <QStandardPaths>
@@ -73,9 +76,21 @@
 #include "UwxScripting.h"
 #endif
 #include "AutEscape.h"
+#include "AutFileStream.h"
+#include "AutFileTransfer.h"
+#include "AutModemMonitor.h"
+#include "AutSerialLatency.h"
+#ifndef SKIPSPEEDTEST
+#include "AutSpeedEngine.h"
+#include "AutSpeedRecorder.h"
+#include "AutSpeedGraph.h"
+#include <QJsonObject>
+#endif
 #ifndef SKIPPLUGINS
 #include <QPluginLoader>
 #include "AutPlugin.h"
+#include "AutPluginBus.h"
+#include <QJsonObject>
 #endif
 #ifndef SKIPONLINE
 #include <QNetworkReply>
@@ -106,7 +121,6 @@
 //Constants for version and functions
 const QString UwVersion                         = "0.28a"; //Version string
 //Constants for timeouts and streaming
-const qint16 FileReadBlock                      = 512;     //Number of bytes to read per block when streaming files
 const qint16 StreamProgress                     = 10000;   //Number of bytes between streaming progress updates
 //Constants for default config values
 const QString DefaultLogFileName                = "AuTerm.log";
@@ -114,6 +128,8 @@ const bool DefaultLogMode                       = 0;
 const bool DefaultLogEnable                     = 0;
 const bool DefaultSysTrayIcon                   = 1;
 const qint16 DefaultSerialSignalCheckInterval   = 50;
+const bool DefaultModemLineMonitor              = true;  //Use event driven modem line monitoring where supported instead of polling
+const bool DefaultLowLatency                    = false;
 const qint16 DefaultTextUpdateInterval          = 80;
 const bool DefaultAutoDTrimBuffer               = false;
 const quint32 DefaultAutoTrimDBufferThreshold   = 512;
@@ -121,6 +137,10 @@ const quint32 DefaultAutoTrimDBufferSize        = 256;
 const quint16 DefaultScrollbackBufferSize       = 32;    //(Unlisted option)
 const bool DefaultSaveSize                      = false;
 const bool DefaultOnlineUpdateCheck             = true;
+const qint8 DefaultStreamPacing                 = StreamPacingNone;
+const quint32 DefaultStreamPacingRate           = 960;   //Bytes per second
+const quint32 DefaultStreamLineDelay            = 50;    //Milliseconds
+const QString DefaultStreamPrompt               = ">";
 //Constants for URLs
 const QString URLLinuxNonRootSetup = "https://github.com/LairdCP/AuTerm/wiki/Granting-non-root-USB-device-access-(Linux)";
 const qint8 FilenameIndexScripting              = 0;
@@ -130,6 +150,16 @@ enum menu_actions {
     MenuActionError                             = 0,
     MenuActionLoopback,
     MenuActionStreamFile,
+    MenuActionStreamPacingNone,
+    MenuActionStreamPacingRate,
+    MenuActionStreamPacingLineDelay,
+    MenuActionStreamPacingPrompt,
+    MenuActionTransferXmodemCrc,
+    MenuActionTransferXmodem1k,
+    MenuActionTransferYmodem,
+    MenuActionTransferZmodem,
+    MenuActionTransferZmodemResume,
+    MenuActionLowLatency,
     MenuActionFont,
     MenuActionTextColour,
     MenuActionBackground,
@@ -138,6 +168,7 @@ enum menu_actions {
     MenuActionScripting,
     MenuActionClearDisplay,
     MenuActionClearRxTx,
+    MenuActionExportModemEdges,
     MenuActionCopy,
     MenuActionCopyAll,
     MenuActionPaste,
@@ -155,14 +186,10 @@ enum speed_menu_actions {
     SpeedMenuActionSendRecv10Delay,
     SpeedMenuActionSendRecv15Delay
 };
-const qint8 SpeedModeInactive                   = 0;
-const qint8 SpeedModeRecv                       = 1;
-const qint8 SpeedModeSend                       = 2;
-const qint8 SpeedModeSendRecv                   = 3;
-//Constants for speed testing
-const qint16 SpeedTestChunkSize                 = 512;  //Maximum number of bytes to send per chunk when speed testing
-const qint16 SpeedTestMinBufSize                = 128;  //Minimum buffer size when speed testing, when there are less than this number of bytes in the output buffer it will be topped up
+//Constants for speed testing (speed test modes and engine constants are in AutSpeedEngine.h)
 const qint16 SpeedTestStatUpdateTime            = 500;  //Time (in ms) between status updates for speed test mode
+const qint8 SpeedDataTypeLatency                = 2;    //Index of the latency (ping-pong) option in the speed test data type combo box
+const qint8 SpeedDataTypePrbsFirst              = 3;    //Index of the first PRBS option in the speed test data type combo box, the remaining options follow in AutPrbsType order
 const QString WINDOWS_NEWLINE                   = "\r\n";
 const QChar NEWLINE                             = '\n';
 
@@ -187,20 +214,18 @@ enum modes {
     mode_check_for_update,
 };
 
-//Union used for checking received byte array contents whilst speed testing
-union pointer_buf {
-    uint8_t *p8;
-    uint16_t *p16;
-    uint32_t *p32;
-    uint64_t *p64;
-};
-
 #ifndef SKIPPLUGINS
 //Struct used for holding plugin objects
 struct plugins {
     QObject *object;
     AutPlugin *plugin;
-#ifndef QT_STATIC
+    QString name; //Name from the plugin metadata
+    QString tab; //Title of the tab the plugin adds, plugins with a tab are set up when their tab is first opened
+    QWidget *placeholder; //Empty tab shown in place of the plugin tab until the plugin is set up
+    bool loaded; //True once the plugin has been instantiated and set up
+#ifdef QT_STATIC
+    int static_index; //Index in QPluginLoader::staticPlugins(), QStaticPlugin cannot be default constructed in Qt 6
+#else
     QPluginLoader *plugin_loader;
     QString filename;
 #endif
@@ -226,6 +251,8 @@ public slots:
     void MenuSelected(QAction* qaAction);
     void balloontriggered(QAction* qaAction);
     void SerialStatusSlot();
+    void ModemLinesChanged(quint32 intSignals);
+    void ModemMonitorFailed(int intError);
     void SerialError(QSerialPort::SerialPortError speErrorCode);
     void enter_pressed();
     void key_pressed(int nKey, QChar chrKeyValue);
@@ -251,6 +278,12 @@ private slots:
     void on_check_Line_stateChanged();
     void closeEvent(QCloseEvent *closeEvent);
     void on_btn_Cancel_clicked();
+    void StreamDataQueued(QByteArray baData);
+    void StreamFailed(QString strMessage);
+    void TransferProgress(QString strFile, qint64 intPosition, qint64 intSize, qint64 intRate);
+    void TransferFinished(bool bSuccess, QString strMessage);
+    void TransferPortError(int intError);
+    void TransferDataWritten(QByteArray baData);
     void UpdateReceiveText();
     void on_combo_COM_currentIndexChanged(int intIndex);
 #ifndef SKIPONLINE
@@ -303,9 +336,13 @@ private slots:
     void OutputSpeedTestStats();
     void on_combo_SpeedDataType_currentIndexChanged(int);
     void on_btn_SpeedCopy_clicked();
+    void on_btn_SpeedExport_clicked();
     void UpdateSpeedTestValues();
     void SpeedTestStartTimer();
     void SpeedTestStopTimer();
+    void SpeedTestSnapshot(AutSpeedSnapshot snapshot);
+    void SpeedTestPortError(int intError);
+    void SpeedTestDisplayOptionsChanged();
     void on_combo_SpeedDataDisplay_currentIndexChanged(int);
     void update_displayText();
 #endif
@@ -360,6 +397,7 @@ private slots:
     void on_check_enable_online_version_check_toggled(bool checked);
 #endif
     void on_selector_Tab_currentChanged(int index);
+    void StartupFinished();
     void on_check_trim_toggled(bool checked);
     void on_spin_trim_threshold_editingFinished();
     void on_spin_trim_size_editingFinished();
@@ -398,6 +436,8 @@ public slots:
         );
     void plugin_save_setting(QString name, QVariant data);
     void plugin_load_setting(QString name, QVariant *data, bool *found);
+    void plugin_data_subscribe(QObject *receiver, quint32 flags, qint32 queue_limit);
+    void plugin_data_unsubscribe(QObject *receiver);
 #endif
 
 private:
@@ -416,6 +456,11 @@ private:
         bool bType
         );
     void
+    UpdateSerialSignals(
+        unsigned int intSignals,
+        bool bType
+        );
+    void
     OpenDevice(
         bool from_plugin = false
         );
@@ -428,9 +473,48 @@ private:
         bool bType
         );
     void
+    SetStreamPacing(
+        AutStreamPacing spPacing
+        );
+    void
+    TransferTakePort(
+        AutTransferProtocol tpProtocol,
+        QStringList lstFiles,
+        bool bResume
+        );
+    void
+    TransferReleasePort(
+        );
+    void
+    SetLowLatencyMode(
+        bool bEnable
+        );
+    void
+    LoadErrorCodes(
+        );
+    void
+    StartupTrace(
+        QString strStage
+        );
+#ifndef SKIPPLUGINS
+    void
+    AddPlugin(
+        struct plugins plugin,
+        const QJsonObject &joMetaData
+        );
+    bool
+    LoadPlugin(
+        int intIndex
+        );
+#endif
+    void
     LoadSettings(
         );
     void
+    PluginDataTransmitted(
+        const QByteArray &baData
+        );
+    void
     UpdateSettings(
         int intMajor,
         int intMinor,
@@ -438,20 +522,22 @@ private:
         );
 #ifndef SKIPSPEEDTEST
     void
-    SendSpeedTestData(
-        int intMaxLength
-        );
-    void
-    SpeedTestBytesWritten(
-        qint64 intByteCount
+    SpeedTestTakePort(
+        AutSpeedEngineConfig secConfig
         );
     void
-    SpeedTestReceive(
+    SpeedTestReleasePort(
         );
     void
     OutputSpeedTestAvgStats(
         qint64 lngElapsed
         );
+    void
+    OutputSpeedTestLatencyHistogram(
+        );
+    QJsonObject
+    SpeedTestSummary(
+        );
 #endif
     void
     SetLoopBackMode(
@@ -490,27 +576,32 @@ private:
 //    QPixmap *gpUw32Pixmap; //Pixmap holder for UwTerminal 32x32 icon
     QPixmap *gpUw16Pixmap; //Pixmap holder for UwTerminal 16x16 icon
     QTimer *gpSignalTimer; //Handle for a timer to update COM port signals
+    AutModemMonitor *gpModemMonitor; //Event driven monitoring and edge history of the COM port signals, the timer is only used if this is not supported
     LrdLogger *gpMainLog; //Handle to the main log file (if enabled/used)
     bool gbMainLogEnabled; //True if opened successfully (and enabled)
     QMenu *gpMenu; //Main menu
     QMenu *gpSMenu4; //Submenu 4
+    QMenu *gpSMenu5; //Submenu 5 (stream pacing)
+    QActionGroup *gpStreamPacingGroup; //Only one stream pacing option can be selected
+    QMenu *gpSMenu6; //Submenu 6 (send file using XMODEM/YMODEM/ZMODEM)
     QMenu *gpBalloonMenu; //Balloon menu
 #ifndef SKIPSPEEDTEST
     QMenu *gpSpeedMenu; //Speed testing menu
 #endif
     bool gbLoopbackMode; //True if loopback mode is enabled
+    AutSerialLatencyState gslsLatencyState; //Settings changed by low latency mode, restored when the port is closed
     bool gbSysTrayEnabled; //True if system tray is enabled
     QSystemTrayIcon *gpSysTray; //Handle for system tray object
     bool gbCTSStatus; //True when CTS is asserted
     bool gbDCDStatus; //True when DCD is asserted
     bool gbDSRStatus; //True when DSR is asserted
     bool gbRIStatus; //True when RI is asserted
-    QFile *gpStreamFileHandle; //Handle for the file to stream data from
-    OS32_64UINT gintStreamBytesSize; //The size of the file to stream in bytes
-    OS32_64UINT gintStreamBytesRead; //The number of bytes read from the stream
+    AutFileStream *gpStreamFile; //Streams the selected file out of the serial port
+    AutFileTransfer *gpFileTransfer; //Sends files using XMODEM/YMODEM/ZMODEM, runs on gthrTransferThread
+    QThread gthrTransferThread; //Thread which owns the serial port whilst a file transfer is running
+    bool gbFileTransferPortTaken; //True if the serial port has been handed to the file transfer thread
     OS32_64UINT gintStreamBytesProgress; //The number of bytes when the next progress output should be made
     display_buffer_list display_buffers; //List of pending data awaiting terminal display
-    QElapsedTimer gtmrStreamTimer; //Counts how long a stream takes to send
     QTimer gtmrTextUpdateTimer; //Timer for slower updating of display buffer (but less display freezing)
     QSettings *gpTermSettings; //Handle to settings
     QSettings *gpErrorMessages; //Handle to error codes
@@ -539,8 +630,6 @@ private:
     unsigned char gchSpeedTestMode; //What mode the speed test is (inactive, receive, send or send & receive)
     QElapsedTimer gtmrSpeedTimer; //Used for timing how long a speed test has been running
     QByteArray gbaSpeedDisplayBuffer; //Buffer of data to display for speed test mode
-    QByteArray gbaSpeedMatchData; //Expected data to match in speed test mode
-    QByteArray gbaSpeedReceivedData; //Received data from device in speed test mode
     QTimer gtmrSpeedTestStats; //Timer that runs every 250ms to update stats for speed test
     QTimer gtmrSpeedTestStats10s; //Timer that runs every 10 seconds to output 10s stats for speed test
     QTimer gtmrSpeedUpdateTimer; //Timer for slower updating of speed test buffer (but less display freezing)
@@ -551,7 +640,6 @@ private:
     quint64 gintSpeedBytesSent10s; //Number of bytes sent to the device in the past 10 seconds in speed test mode
     qint32 gintSpeedBufferCount; //Number of bytes waiting to be sent to the device (waiting in the buffer) in speed test mode
     qint32 gintSpeedTestMatchDataLength; //Length of MatchData
-    qint32 gintSpeedTestReceiveIndex; //Current index for RecData
     qint32 gintSpeedTestStatErrors; //Number of errors in packets recieved in speed test mode
     qint32 gintSpeedTestStatSuccess; //Number of successful packets received in speed test mode
     qint32 gintSpeedTestStatPacketsSent; //Numbers of packets sent in speed test mode
@@ -562,14 +650,28 @@ private:
     quint8 gintDelayedSpeedTestSend; //Stores the delay before sending data in a speed test begins (in seconds)
     quint32 gintDelayedSpeedTestReceive; //Stores the delay before data started being received after a speed test begins (in seconds)
     bool gbSpeedTestReceived; //Set to true when data has been received in a speed test
+    bool gbSpeedTestPrbs; //True if the speed test is sending/checking a PRBS sequence instead of a string
+    bool gbSpeedTestLatency; //True if the speed test is measuring the round trip time of echoed probes
+    AutSpeedEngine *gpSpeedEngine; //Generates and checks speed test data, runs on gthrSpeedThread
+    QThread gthrSpeedThread; //Thread which owns the serial port whilst a speed test is running
+    bool gbSpeedTestPortTaken; //True if the serial port has been handed to the speed test thread
+    quint32 gintSpeedTestId; //Incremented for each speed test so that late snapshots from a previous test are ignored
+    AutSpeedSnapshot gsnpSpeedSnapshot; //Last snapshot of the speed test engine counters
+    AutSpeedRecorder grecSpeedRecorder; //Samples of the speed test counters taken at each statistics update
+    AutSpeedGraph *gpSpeedGraph; //Live graph of the speed test send and receive rates
+    QDateTime gdtSpeedTestStart; //Date and time the current or last speed test was started
 #endif
     bool gbAppStarted; //True if application startup is complete
+    QElapsedTimer gtmrStartupTrace; //Time since the window started being created, used for startup tracing
+    qint64 gintStartupTraceLast; //Time (in ms) of the last startup trace point
+    bool gbStartupTrace; //True if startup tracing is enabled (AUTERM_STARTUP_TRACE environment variable is set)
     QElapsedTimer gtmrPortOpened; //Used for updating last received timestamp
     qint64 gintLastSerialTimeUpdate; //Used for recording when next last received timestamp should appear
 #ifndef SKIPPLUGINS
     bool gbPluginRunning; //True if a plugin is running
     bool gbPluginHideTerminalOutput; //True if terminal output should not be updated whilst plugin is running
     QObject *plugin_status_owner; //Owner of the last plugin set operation
+    AutPluginBus *gpPluginBus; //Delivers serial data to the plugins which have subscribed to it
     QList<QPushButton *> list_plugin_open_close_buttons;
     QList<plugins> plugin_list;
 #endif
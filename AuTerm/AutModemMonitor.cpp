@@ -0,0 +1,417 @@
+/******************************************************************************
+** Copyright (C) 2023 Jamie M.
+**
+** Project: AuTerm
+**
+** Module:  AutModemMonitor.cpp
+**
+** Notes:
+**
+** License: This program is free software: you can redistribute it and/or
+**          modify it under the terms of the GNU General Public License as
+**          published by the Free Software Foundation, version 3.
+**
+**          This program is distributed in the hope that it will be useful,
+**          but WITHOUT ANY WARRANTY; without even the implied warranty of
+**          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**          GNU General Public License for more details.
+**
+**          You should have received a copy of the GNU General Public License
+**          along with this program.  If not, see http://www.gnu.org/licenses/
+**
+*******************************************************************************/
+
+/******************************************************************************/
+// Include Files
+/******************************************************************************/
+#include "AutModemMonitor.h"
+#include <QDateTime>
+#include <QMutexLocker>
+#include <cstring>
+#ifdef Q_OS_LINUX
+#include <sys/ioctl.h>
+#include <linux/serial.h>
+#include <termios.h>
+#include <signal.h>
+#include <pthread.h>
+#include <errno.h>
+#include <time.h>
+#endif
+
+/******************************************************************************/
+// Constants
+/******************************************************************************/
+//Line order used for the counter arrays
+static const quint32 modem_lines[ModemLineCount] = {
+    QSerialPort::ClearToSendSignal,
+    QSerialPort::DataSetReadySignal,
+    QSerialPort::DataCarrierDetectSignal,
+    QSerialPort::RingIndicatorSignal
+};
+
+static const char *modem_line_names[ModemLineCount] = {
+    "CTS",
+    "DSR",
+    "DCD",
+    "RI"
+};
+
+#ifdef Q_OS_LINUX
+//Signal used to interrupt TIOCMIWAIT when the monitor is stopped, the handler does nothing
+const int ModemMonitorWakeSignal                = SIGUSR2;
+#endif
+
+/******************************************************************************/
+// Local Functions or Private Members
+/******************************************************************************/
+
+#ifdef Q_OS_LINUX
+//=============================================================================
+//=============================================================================
+static void wake_handler(int signal)
+{
+    Q_UNUSED(signal);
+}
+
+//=============================================================================
+//=============================================================================
+static bool read_lines(int handle, bool counters_supported, quint32 *levels, quint32 *counts)
+{
+    //Reads the line levels and, if the driver supports it, the number of transitions of each line
+    int status;
+
+    if (ioctl(handle, TIOCMGET, &status) == -1)
+    {
+        return false;
+    }
+
+    *levels = ((status & TIOCM_CTS) ? QSerialPort::ClearToSendSignal : 0) | ((status & TIOCM_DSR) ? QSerialPort::DataSetReadySignal : 0) | ((status & TIOCM_CD) ? QSerialPort::DataCarrierDetectSignal : 0) | ((status & TIOCM_RNG) ? QSerialPort::RingIndicatorSignal : 0);
+
+    if (counters_supported == true)
+    {
+        struct serial_icounter_struct icount;
+
+        if (ioctl(handle, TIOCGICOUNT, &icount) == -1)
+        {
+            return false;
+        }
+
+        counts[0] = (quint32)icount.cts;
+        counts[1] = (quint32)icount.dsr;
+        counts[2] = (quint32)icount.dcd;
+        counts[3] = (quint32)icount.rng;
+    }
+
+    return true;
+}
+#endif
+
+//=============================================================================
+//=============================================================================
+AutModemMonitor::AutModemMonitor(QObject *parent) : QThread(parent)
+{
+    running = 0;
+    thread_ready = 0;
+    port_handle = -1;
+    counters_supported = false;
+    thread_id = nullptr;
+    clear();
+}
+
+//=============================================================================
+//=============================================================================
+AutModemMonitor::~AutModemMonitor()
+{
+    stop_monitor();
+}
+
+//=============================================================================
+//=============================================================================
+bool AutModemMonitor::start_monitor(QSerialPort::Handle handle)
+{
+    //Returns false if event driven monitoring is not supported, in which case the caller should poll the lines
+    stop_monitor();
+    clear();
+
+#ifdef Q_OS_LINUX
+    struct sigaction action;
+    struct serial_icounter_struct icount;
+    quint32 counts[ModemLineCount] = {0, 0, 0, 0};
+
+    //No SA_RESTART so that TIOCMIWAIT returns EINTR when the thread is signalled
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = wake_handler;
+    sigemptyset(&action.sa_mask);
+    sigaction(ModemMonitorWakeSignal, &action, nullptr);
+
+    port_handle = handle;
+    counters_supported = (ioctl(port_handle, TIOCGICOUNT, &icount) == 0);
+
+    if (read_lines(port_handle, counters_supported, &last_levels, counts) == false)
+    {
+        port_handle = -1;
+        return false;
+    }
+
+    memcpy(last_counts, counts, sizeof(last_counts));
+    levels_valid = true;
+    running = 1;
+    start();
+
+    return true;
+#else
+    Q_UNUSED(handle);
+
+    return false;
+#endif
+}
+
+//=============================================================================
+//=============================================================================
+void AutModemMonitor::stop_monitor()
+{
+    //Must be called before the port is closed. The thread is signalled until it has left TIOCMIWAIT, as a signal which
+    //arrives just before it enters the ioctl would otherwise be missed
+    if (isRunning() == false)
+    {
+        running = 0;
+        return;
+    }
+
+    running = 0;
+
+    while (wait(ModemMonitorStopWait) == false)
+    {
+#ifdef Q_OS_LINUX
+        if (thread_ready == 1)
+        {
+            pthread_kill((pthread_t)thread_id, ModemMonitorWakeSignal);
+        }
+#endif
+    }
+
+    thread_ready = 0;
+    port_handle = -1;
+}
+
+//=============================================================================
+//=============================================================================
+void AutModemMonitor::run()
+{
+#ifdef Q_OS_LINUX
+    quint32 levels;
+    quint32 counts[ModemLineCount];
+    sigset_t signal_set;
+
+    //Make sure the wake signal is delivered to this thread
+    sigemptyset(&signal_set);
+    sigaddset(&signal_set, ModemMonitorWakeSignal);
+    pthread_sigmask(SIG_UNBLOCK, &signal_set, nullptr);
+    thread_id = (Qt::HANDLE)pthread_self();
+    thread_ready = 1;
+
+    while (running == 1)
+    {
+        qint64 timestamp_us = timestamp_now();
+
+        if (read_lines(port_handle, counters_supported, &levels, counts) == false)
+        {
+            emit monitor_failed(errno);
+            break;
+        }
+
+        if (levels != last_levels || (counters_supported == true && memcmp(counts, last_counts, sizeof(last_counts)) != 0))
+        {
+            //Lines changed since the last event, including whilst this thread was not waiting
+            record(timestamp_us, levels, counts);
+            continue;
+        }
+
+        if (ioctl(port_handle, TIOCMIWAIT, (TIOCM_CTS | TIOCM_DSR | TIOCM_CD | TIOCM_RNG)) == -1)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+
+            //Driver does not support waiting for line changes or the device was removed
+            if (running == 1)
+            {
+                emit monitor_failed(errno);
+            }
+
+            break;
+        }
+    }
+#endif
+}
+
+//=============================================================================
+//=============================================================================
+void AutModemMonitor::add_levels(quint32 levels)
+{
+    //Line levels from polling, only level changes can be seen. The first levels after clearing are the initial state
+    if (levels_valid == false)
+    {
+        last_levels = levels;
+        levels_valid = true;
+    }
+    else if (levels != last_levels)
+    {
+        record(timestamp_now(), levels, nullptr);
+    }
+}
+
+//=============================================================================
+//=============================================================================
+void AutModemMonitor::record(qint64 timestamp_us, quint32 levels, const quint32 *counts)
+{
+    QMutexLocker locker(&lock);
+    bool levels_changed = (levels != last_levels);
+    quint8 i = 0;
+
+    while (i < ModemLineCount)
+    {
+        bool level = ((levels & modem_lines[i]) != 0);
+        quint32 transitions = (counts != nullptr && counters_supported == true ? counts[i] - last_counts[i] : 0);
+
+        if (transitions == 0 && level != ((last_levels & modem_lines[i]) != 0))
+        {
+            //Level changed without the counter changing, RI is only counted on the trailing edge by some drivers
+            transitions = 1;
+        }
+
+        if (transitions > 0)
+        {
+            AutModemEdge edge;
+
+            if (edge_list.count() >= ModemEdgeHistoryLimit)
+            {
+                edge_list.removeFirst();
+                ++edges_discarded;
+            }
+
+            edge.timestamp_us = timestamp_us;
+            edge.line = modem_lines[i];
+            edge.level = level;
+            edge.transitions = transitions;
+            edge_list.append(edge);
+            total_transitions[i] += transitions;
+        }
+
+        ++i;
+    }
+
+    last_levels = levels;
+
+    if (counts != nullptr && counters_supported == true)
+    {
+        memcpy(last_counts, counts, sizeof(last_counts));
+    }
+
+    locker.unlock();
+
+    if (levels_changed == true)
+    {
+        emit lines_changed(levels);
+    }
+}
+
+//=============================================================================
+//=============================================================================
+void AutModemMonitor::clear()
+{
+    QMutexLocker locker(&lock);
+
+    edge_list.clear();
+    edges_discarded = 0;
+    last_levels = 0;
+    levels_valid = false;
+    memset(last_counts, 0, sizeof(last_counts));
+    memset(total_transitions, 0, sizeof(total_transitions));
+}
+
+//=============================================================================
+//=============================================================================
+QList<AutModemEdge> AutModemMonitor::edges()
+{
+    QMutexLocker locker(&lock);
+
+    return edge_list;
+}
+
+//=============================================================================
+//=============================================================================
+quint64 AutModemMonitor::transitions(quint32 line)
+{
+    QMutexLocker locker(&lock);
+    quint8 i = 0;
+
+    while (i < ModemLineCount)
+    {
+        if (modem_lines[i] == line)
+        {
+            return total_transitions[i];
+        }
+
+        ++i;
+    }
+
+    return 0;
+}
+
+//=============================================================================
+//=============================================================================
+QString AutModemMonitor::to_csv()
+{
+    //Edges followed by the total transitions and pulses (pairs of transitions) of each line
+    QMutexLocker locker(&lock);
+    QString output("timestamp_us,time,line,level,transitions\r\n");
+    qint32 i = 0;
+
+    while (i < edge_list.count())
+    {
+        const AutModemEdge *edge = &edge_list.at(i);
+        quint8 line = 0;
+
+        while (line < ModemLineCount && modem_lines[line] != edge->line)
+        {
+            ++line;
+        }
+
+        output.append(QString::number(edge->timestamp_us)).append(",").append(QDateTime::fromMSecsSinceEpoch(edge->timestamp_us / 1000LL).toString("yyyy-MM-dd hh:mm:ss.zzz")).append(",").append(line < ModemLineCount ? modem_line_names[line] : "").append(",").append(edge->level == true ? "1" : "0").append(",").append(QString::number(edge->transitions)).append("\r\n");
+        ++i;
+    }
+
+    output.append("\r\nline,transitions,pulses\r\n");
+    i = 0;
+
+    while (i < ModemLineCount)
+    {
+        output.append(modem_line_names[i]).append(",").append(QString::number(total_transitions[i])).append(",").append(QString::number(total_transitions[i] / 2)).append("\r\n");
+        ++i;
+    }
+
+    output.append("\r\nedges_discarded,").append(QString::number(edges_discarded)).append("\r\n");
+
+    return output;
+}
+
+//=============================================================================
+//=============================================================================
+qint64 AutModemMonitor::timestamp_now()
+{
+#ifdef Q_OS_LINUX
+    struct timespec now;
+
+    clock_gettime(CLOCK_REALTIME, &now);
+
+    return ((qint64)now.tv_sec * 1000000LL) + ((qint64)now.tv_nsec / 1000LL);
+#else
+    return QDateTime::currentMSecsSinceEpoch() * 1000LL;
+#endif
+}
+
+/******************************************************************************/
+// END OF FILE
+/******************************************************************************/
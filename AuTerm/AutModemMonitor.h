@@ -0,0 +1,104 @@
+/******************************************************************************
+** Copyright (C) 2023 Jamie M.
+**
+** Project: AuTerm
+**
+** Module:  AutModemMonitor.h
+**
+** Notes:
+**
+** License: This program is free software: you can redistribute it and/or
+**          modify it under the terms of the GNU General Public License as
+**          published by the Free Software Foundation, version 3.
+**
+**          This program is distributed in the hope that it will be useful,
+**          but WITHOUT ANY WARRANTY; without even the implied warranty of
+**          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**          GNU General Public License for more details.
+**
+**          You should have received a copy of the GNU General Public License
+**          along with this program.  If not, see http://www.gnu.org/licenses/
+**
+*******************************************************************************/
+#ifndef AUTMODEMMONITOR_H
+#define AUTMODEMMONITOR_H
+
+/******************************************************************************/
+// Include Files
+/******************************************************************************/
+#include <QThread>
+#include <QMutex>
+#include <QAtomicInt>
+#include <QList>
+#include <QString>
+#include <QSerialPort>
+
+/******************************************************************************/
+// Constants
+/******************************************************************************/
+const quint8 ModemLineCount                     = 4;      //CTS, DSR, DCD and RI
+const qint32 ModemEdgeHistoryLimit              = 100000; //Maximum number of edges kept, oldest are discarded first
+const qint32 ModemMonitorStopWait               = 10;     //Time (in ms) to wait for the monitor thread to exit before interrupting it again
+
+/******************************************************************************/
+// Structures
+/******************************************************************************/
+struct AutModemEdge {
+    qint64 timestamp_us; //Time the edge was seen, in microseconds since the epoch
+    quint32 line; //QSerialPort::PinoutSignal of the line
+    bool level; //Level of the line after the edge
+    quint32 transitions; //Transitions counted by the driver since the previous event, more than 1 if pulses were shorter than the wake up time
+};
+
+/******************************************************************************/
+// Class definitions
+/******************************************************************************/
+//Monitors the CTS, DSR, DCD and RI lines of a serial port. On Linux a thread blocks in TIOCMIWAIT and reads the driver
+//transition counters (TIOCGICOUNT) so that pulses shorter than the wake up time are still counted. lines_changed is
+//only emitted when the level of a line changes. On other platforms (or drivers without TIOCMIWAIT) start_monitor fails
+//and the levels from polling can be passed to add_levels so that the edge history is still recorded
+class AutModemMonitor : public QThread
+{
+    Q_OBJECT
+
+public:
+    explicit AutModemMonitor(QObject *parent = nullptr);
+    ~AutModemMonitor();
+    bool start_monitor(QSerialPort::Handle handle);
+    void stop_monitor();
+    void add_levels(quint32 levels);
+    void clear();
+    QList<AutModemEdge> edges();
+    quint64 transitions(quint32 line);
+    QString to_csv();
+
+signals:
+    void lines_changed(quint32 levels);
+    void monitor_failed(int error);
+
+protected:
+    void run() override;
+
+private:
+    void record(qint64 timestamp_us, quint32 levels, const quint32 *counts);
+    static qint64 timestamp_now();
+
+    QMutex lock;
+    QAtomicInt running;
+    QAtomicInt thread_ready;
+    int port_handle;
+    bool counters_supported;
+    Qt::HANDLE thread_id;
+    quint32 last_levels;
+    bool levels_valid;
+    quint32 last_counts[ModemLineCount];
+    quint64 total_transitions[ModemLineCount];
+    quint64 edges_discarded;
+    QList<AutModemEdge> edge_list;
+};
+
+#endif // AUTMODEMMONITOR_H
+
+/******************************************************************************/
+// END OF FILE
+/******************************************************************************/
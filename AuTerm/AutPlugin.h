@@ -29,6 +29,15 @@
 
 #define AuTermPluginInterface_iid "org.AuTerm.PluginInterface"
 
+//Flags used when subscribing to serial data with plugin_data_subscribe. The receiver must have a
+//plugin_data(QByteArray data, quint8 direction) slot, direction is PluginDataReceive or PluginDataTransmit
+enum plugin_data_flags {
+    PluginDataReceive = 0x01, //Data received from the serial port
+    PluginDataTransmit = 0x02, //Data sent to the serial port
+    PluginDataRunningOnly = 0x04, //Only deliver data whilst this plugin is the running plugin (plugin_set_status)
+    PluginDataQueued = 0x08 //Deliver data to the thread the receiver lives in, with a bounded queue
+};
+
 class AutPlugin
 {
 public:
@@ -51,6 +60,8 @@ signals:
 //#endif
     void plugin_to_hex(QByteArray *data);
     void find_plugin(QString name, struct plugin_data *plugin);
+    void plugin_data_subscribe(QObject *receiver, quint32 flags, qint32 queue_limit);
+    void plugin_data_unsubscribe(QObject *receiver);
 };
 
 Q_DECLARE_INTERFACE(AutPlugin, AuTermPluginInterface_iid)
@@ -97,6 +108,8 @@ public slots:
         );
     void plugin_save_setting(QString name, QVariant data);
     void plugin_load_setting(QString name, QVariant *data, bool *found);
+    void plugin_data_subscribe(QObject *receiver, quint32 flags, qint32 queue_limit);
+    void plugin_data_unsubscribe(QObject *receiver);
 };
 #endif
 
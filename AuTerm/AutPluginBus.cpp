@@ -0,0 +1,235 @@
+/******************************************************************************
+** Copyright (C) 2023 Jamie M.
+**
+** Project: AuTerm
+**
+** Module:  AutPluginBus.cpp
+**
+** Notes:
+**
+** License: This program is free software: you can redistribute it and/or
+**          modify it under the terms of the GNU General Public License as
+**          published by the Free Software Foundation, version 3.
+**
+**          This program is distributed in the hope that it will be useful,
+**          but WITHOUT ANY WARRANTY; without even the implied warranty of
+**          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**          GNU General Public License for more details.
+**
+**          You should have received a copy of the GNU General Public License
+**          along with this program.  If not, see http://www.gnu.org/licenses/
+**
+*******************************************************************************/
+
+/******************************************************************************/
+// Include Files
+/******************************************************************************/
+#include "AutPluginBus.h"
+#include <QDebug>
+
+/******************************************************************************/
+// Local Functions or Private Members
+/******************************************************************************/
+
+//=============================================================================
+//=============================================================================
+AutPluginBus::AutPluginBus(QObject *parent) : QObject(parent)
+{
+    subscribed_directions = 0;
+}
+
+//=============================================================================
+//=============================================================================
+AutPluginBus::~AutPluginBus()
+{
+    int32_t i = 0;
+
+    while (i < subscription_list.length())
+    {
+        if (!subscription_list.at(i).receiver.isNull())
+        {
+            disconnect(subscription_list.at(i).receiver.data(), SIGNAL(destroyed(QObject*)), this, SLOT(receiver_destroyed(QObject*)));
+        }
+
+        ++i;
+    }
+}
+
+//=============================================================================
+//=============================================================================
+bool AutPluginBus::subscribe(const QObject *owner, QObject *receiver, quint32 flags, qint32 queue_limit)
+{
+    AutPluginSubscription subscription;
+    int32_t method_index;
+
+    if (receiver == nullptr || (flags & (PluginDataReceive | PluginDataTransmit)) == 0)
+    {
+        qDebug() << "A plugin tried to subscribe to the data bus without a receiver or direction";
+        return false;
+    }
+
+    method_index = receiver->metaObject()->indexOfMethod(QMetaObject::normalizedSignature("plugin_data(QByteArray,quint8)").constData());
+
+    if (method_index < 0)
+    {
+        qDebug() << "A plugin tried to subscribe to the data bus with a receiver which has no plugin_data(QByteArray,quint8) method";
+        return false;
+    }
+
+    //A receiver only has one subscription, subscribing again replaces the filter
+    unsubscribe(receiver);
+
+    subscription.owner = owner;
+    subscription.receiver = receiver;
+    subscription.method = receiver->metaObject()->method(method_index);
+    subscription.flags = flags;
+    subscription.queue_limit = (queue_limit > 0 ? queue_limit : PluginBusDefaultQueueLimit);
+    subscription.state = QSharedPointer<AutPluginSubscriptionState>::create();
+    subscription.state->dropped = 0;
+    subscription.state->active.storeRelease(1);
+    subscription_list.append(subscription);
+    connect(receiver, SIGNAL(destroyed(QObject*)), this, SLOT(receiver_destroyed(QObject*)));
+    update_directions();
+
+    return true;
+}
+
+//=============================================================================
+//=============================================================================
+void AutPluginBus::unsubscribe(const QObject *receiver)
+{
+    int32_t i = 0;
+
+    while (i < subscription_list.length())
+    {
+        if (subscription_list.at(i).receiver.data() == receiver)
+        {
+            disconnect(subscription_list.at(i).receiver.data(), SIGNAL(destroyed(QObject*)), this, SLOT(receiver_destroyed(QObject*)));
+            subscription_list.at(i).state->active.storeRelease(0);
+            subscription_list.removeAt(i);
+            continue;
+        }
+
+        ++i;
+    }
+
+    update_directions();
+}
+
+//=============================================================================
+//=============================================================================
+void AutPluginBus::publish(const QByteArray &data, quint8 direction, const QObject *running_owner)
+{
+    //Direct subscribers can subscribe or unsubscribe whilst data is being delivered, so a copy of the list is used
+    const QList<AutPluginSubscription> subscriptions = subscription_list;
+    int32_t i = 0;
+
+    while (i < subscriptions.length())
+    {
+        const AutPluginSubscription *subscription = &subscriptions.at(i);
+        ++i;
+
+        if ((subscription->flags & direction) == 0 || subscription->state->active.loadAcquire() == 0 || subscription->receiver.isNull())
+        {
+            continue;
+        }
+
+        if ((subscription->flags & PluginDataRunningOnly) != 0 && subscription->owner != running_owner)
+        {
+            //Plugin is not the running plugin
+            continue;
+        }
+
+        if ((subscription->flags & PluginDataQueued) == 0)
+        {
+            //Delivered on this thread, the receiver gets a shallow copy of the buffer
+            subscription->method.invoke(subscription->receiver.data(), Qt::DirectConnection, Q_ARG(QByteArray, data), Q_ARG(quint8, direction));
+            continue;
+        }
+
+        if (subscription->state->pending.loadAcquire() >= subscription->queue_limit)
+        {
+            //Receiver is not keeping up, drop this buffer rather than letting the queue grow without limit
+            ++subscription->state->dropped;
+            continue;
+        }
+
+        //Delivered on the thread of the receiver, if the receiver is destroyed first the event is discarded by Qt and if it
+        //unsubscribes first then buffers which are still queued are not delivered
+        QObject *receiver = subscription->receiver.data();
+        QMetaMethod method = subscription->method;
+        QSharedPointer<AutPluginSubscriptionState> state = subscription->state;
+        state->pending.ref();
+        QMetaObject::invokeMethod(receiver, [receiver, method, data, direction, state]()
+        {
+            if (state->active.loadAcquire() != 0)
+            {
+                method.invoke(receiver, Qt::DirectConnection, Q_ARG(QByteArray, data), Q_ARG(quint8, direction));
+            }
+
+            state->pending.deref();
+        }, Qt::QueuedConnection);
+    }
+}
+
+//=============================================================================
+//=============================================================================
+quint64 AutPluginBus::dropped(const QObject *receiver)
+{
+    int32_t i = 0;
+
+    while (i < subscription_list.length())
+    {
+        if (subscription_list.at(i).receiver.data() == receiver)
+        {
+            return subscription_list.at(i).state->dropped;
+        }
+
+        ++i;
+    }
+
+    return 0;
+}
+
+//=============================================================================
+//=============================================================================
+void AutPluginBus::receiver_destroyed(QObject *receiver)
+{
+    int32_t i = 0;
+
+    //The QPointer has already been cleared, so find subscriptions with a cleared receiver
+    Q_UNUSED(receiver);
+
+    while (i < subscription_list.length())
+    {
+        if (subscription_list.at(i).receiver.isNull())
+        {
+            subscription_list.at(i).state->active.storeRelease(0);
+            subscription_list.removeAt(i);
+            continue;
+        }
+
+        ++i;
+    }
+
+    update_directions();
+}
+
+//=============================================================================
+//=============================================================================
+void AutPluginBus::update_directions()
+{
+    int32_t i = 0;
+
+    subscribed_directions = 0;
+
+    while (i < subscription_list.length())
+    {
+        subscribed_directions |= (subscription_list.at(i).flags & (PluginDataReceive | PluginDataTransmit));
+        ++i;
+    }
+}
+
+/******************************************************************************/
+// END OF FILE
+/******************************************************************************/
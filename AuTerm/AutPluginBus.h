@@ -0,0 +1,99 @@
+/******************************************************************************
+** Copyright (C) 2023 Jamie M.
+**
+** Project: AuTerm
+**
+** Module:  AutPluginBus.h
+**
+** Notes:
+**
+** License: This program is free software: you can redistribute it and/or
+**          modify it under the terms of the GNU General Public License as
+**          published by the Free Software Foundation, version 3.
+**
+**          This program is distributed in the hope that it will be useful,
+**          but WITHOUT ANY WARRANTY; without even the implied warranty of
+**          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**          GNU General Public License for more details.
+**
+**          You should have received a copy of the GNU General Public License
+**          along with this program.  If not, see http://www.gnu.org/licenses/
+**
+*******************************************************************************/
+#ifndef AUTPLUGINBUS_H
+#define AUTPLUGINBUS_H
+
+/******************************************************************************/
+// Include Files
+/******************************************************************************/
+#include <QObject>
+#include <QByteArray>
+#include <QList>
+#include <QMetaMethod>
+#include <QPointer>
+#include <QSharedPointer>
+#include <QAtomicInt>
+#include "AutPlugin.h"
+
+/******************************************************************************/
+// Constants
+/******************************************************************************/
+const qint32 PluginBusDefaultQueueLimit         = 64; //Default number of buffers which can be outstanding for a queued subscriber before newer data is dropped
+
+/******************************************************************************/
+// Structures
+/******************************************************************************/
+//State of a subscription which is shared with copies of the subscription list and with queued deliveries
+struct AutPluginSubscriptionState {
+    QAtomicInt pending; //Number of buffers queued to the receiver which have not yet been delivered
+    quint64 dropped; //Number of buffers dropped because the queue was full
+    QAtomicInt active; //Cleared when the subscription is removed, checked by queued deliveries on the thread of the receiver
+};
+
+struct AutPluginSubscription {
+    const QObject *owner; //Plugin object which subscribed, used for the running only filter
+    QPointer<QObject> receiver; //Object data is delivered to
+    QMetaMethod method; //plugin_data(QByteArray,quint8) method of the receiver
+    quint32 flags; //plugin_data_flags of the subscription
+    qint32 queue_limit; //Maximum number of outstanding buffers for queued subscribers
+    QSharedPointer<AutPluginSubscriptionState> state; //Shared state of the subscription
+};
+
+/******************************************************************************/
+// Class definitions
+/******************************************************************************/
+//Delivers serial data to plugins which have subscribed to it. Each subscriber only receives the directions it asked
+//for, and subscribers using PluginDataRunningOnly only receive data whilst their plugin is the running plugin. Data is
+//passed as an implicitly shared QByteArray so it is never deep copied. Subscribers using PluginDataQueued have data
+//delivered to the thread their receiver lives in, with a bounded number of outstanding buffers
+class AutPluginBus : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit AutPluginBus(QObject *parent = nullptr);
+    ~AutPluginBus();
+    bool subscribe(const QObject *owner, QObject *receiver, quint32 flags, qint32 queue_limit);
+    void unsubscribe(const QObject *receiver);
+    void publish(const QByteArray &data, quint8 direction, const QObject *running_owner);
+    quint64 dropped(const QObject *receiver);
+    inline bool wanted(quint8 direction) const
+    {
+        return ((subscribed_directions & direction) != 0);
+    }
+
+private slots:
+    void receiver_destroyed(QObject *receiver);
+
+private:
+    void update_directions();
+
+    QList<AutPluginSubscription> subscription_list;
+    quint32 subscribed_directions;
+};
+
+#endif // AUTPLUGINBUS_H
+
+/******************************************************************************/
+// END OF FILE
+/******************************************************************************/
@@ -0,0 +1,484 @@
+/******************************************************************************
+** Copyright (C) 2023 Jamie M.
+**
+** Project: AuTerm
+**
+** Module:  AutPrbs.cpp
+**
+** Notes:
+**
+** License: This program is free software: you can redistribute it and/or
+**          modify it under the terms of the GNU General Public License as
+**          published by the Free Software Foundation, version 3.
+**
+**          This program is distributed in the hope that it will be useful,
+**          but WITHOUT ANY WARRANTY; without even the implied warranty of
+**          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**          GNU General Public License for more details.
+**
+**          You should have received a copy of the GNU General Public License
+**          along with this program.  If not, see http://www.gnu.org/licenses/
+**
+*******************************************************************************/
+
+/******************************************************************************/
+// Include Files
+/******************************************************************************/
+#include "AutPrbs.h"
+#include <QtAlgorithms>
+#include <cstring>
+
+/******************************************************************************/
+// Local Functions or Private Members
+/******************************************************************************/
+
+//=============================================================================
+//=============================================================================
+AutPrbs::AutPrbs()
+{
+    set_type(PrbsType7);
+}
+
+//=============================================================================
+//=============================================================================
+void AutPrbs::set_type(AutPrbsType type)
+{
+    //Polynomials are x^length + x^tap + 1
+    switch (type)
+    {
+        case PrbsType15:
+        {
+            length = 15;
+            tap = 14;
+            break;
+        }
+        case PrbsType23:
+        {
+            length = 23;
+            tap = 18;
+            break;
+        }
+        case PrbsType31:
+        {
+            length = 31;
+            tap = 28;
+            break;
+        }
+        default:
+        {
+            length = 7;
+            tap = 6;
+        }
+    }
+
+    mask = (quint32)((1ULL << length) - 1);
+    reset();
+}
+
+//=============================================================================
+//=============================================================================
+void AutPrbs::reset()
+{
+    state = mask;
+}
+
+//=============================================================================
+//=============================================================================
+quint8 AutPrbs::next_byte()
+{
+    quint8 data = 0;
+    quint8 i = 0;
+
+    while (i < 8)
+    {
+        quint8 bit = ((state >> (length - 1)) ^ (state >> (tap - 1))) & 0x1;
+
+        state = ((state << 1) | bit) & mask;
+        data = (data << 1) | bit;
+        ++i;
+    }
+
+    return data;
+}
+
+//=============================================================================
+//=============================================================================
+quint64 AutPrbs::next_block()
+{
+    //Bytes are in the same order as they would be in memory so that this can be compared directly with received data
+    quint8 data[PrbsBlockSize];
+    quint64 block;
+    quint8 i = 0;
+
+    while (i < PrbsBlockSize)
+    {
+        data[i] = next_byte();
+        ++i;
+    }
+
+    memcpy(&block, data, sizeof(block));
+
+    return block;
+}
+
+//=============================================================================
+//=============================================================================
+void AutPrbs::generate(QByteArray *data, int32_t count)
+{
+    int32_t i = 0;
+
+    data->resize(count);
+
+    while (i < count)
+    {
+        (*data)[i] = (char)next_byte();
+        ++i;
+    }
+}
+
+//=============================================================================
+//=============================================================================
+void AutPrbs::skip(int32_t count)
+{
+    while (count > 0)
+    {
+        next_byte();
+        --count;
+    }
+}
+
+//=============================================================================
+//=============================================================================
+quint32 AutPrbs::get_state()
+{
+    return state;
+}
+
+//=============================================================================
+//=============================================================================
+quint8 AutPrbs::state_bytes()
+{
+    //Number of whole bytes needed to hold the state of the sequence
+    return (length + 7) / 8;
+}
+
+//=============================================================================
+//=============================================================================
+void AutPrbs::seed(const quint8 *data)
+{
+    //The state is the last bits which were output, so loading received data puts the generator in step with the sender
+    quint8 i = 0;
+
+    state = 0;
+
+    while (i < state_bytes())
+    {
+        quint8 bit = 0;
+
+        while (bit < 8)
+        {
+            state = ((state << 1) | ((data[i] >> (7 - bit)) & 0x1)) & mask;
+            ++bit;
+        }
+
+        ++i;
+    }
+}
+
+//=============================================================================
+//=============================================================================
+AutPrbsChecker::AutPrbsChecker()
+{
+    set_type(PrbsType7);
+}
+
+//=============================================================================
+//=============================================================================
+void AutPrbsChecker::set_type(AutPrbsType type)
+{
+    this->type = type;
+    reset();
+}
+
+//=============================================================================
+//=============================================================================
+void AutPrbsChecker::reset()
+{
+    expected.set_type(type);
+    memset(&statistics, 0, sizeof(statistics));
+    pending.clear();
+    locked = false;
+    in_burst = false;
+    burst_length = 0;
+    clean_bytes = 0;
+}
+
+//=============================================================================
+//=============================================================================
+void AutPrbsChecker::check(const QByteArray &data)
+{
+    int32_t offset = 0;
+
+    pending.append(data);
+
+    while (true)
+    {
+        if (locked == false)
+        {
+            //Search for a position which gives a sequence that matches the data following it
+            if ((pending.length() - offset) < (expected.state_bytes() + PrbsVerifyBytes))
+            {
+                break;
+            }
+
+            if (synchronise(offset) == true)
+            {
+                add_errors(0, expected.state_bytes());
+                offset += expected.state_bytes();
+                locked = true;
+            }
+            else
+            {
+                ++statistics.bytes_unsynchronised;
+                ++offset;
+            }
+
+            continue;
+        }
+
+        if ((pending.length() - offset) < PrbsBlockSize)
+        {
+            break;
+        }
+
+        //Compare a whole block at once, the number of differing bits is the number of bit errors
+        AutPrbs next = expected;
+        quint64 received;
+        quint64 difference;
+
+        memcpy(&received, (pending.constData() + offset), sizeof(received));
+        difference = received ^ next.next_block();
+
+        if (difference == 0)
+        {
+            add_errors(difference, PrbsBlockSize);
+            expected = next;
+            offset += PrbsBlockSize;
+            continue;
+        }
+
+        if (qPopulationCount(difference) <= PrbsSlipThreshold)
+        {
+            //A slip near the end of a block only gives a few errors, so check that the following block is still in step
+            AutPrbs following = next;
+
+            if ((pending.length() - offset) < (PrbsBlockSize * 2))
+            {
+                break;
+            }
+
+            memcpy(&received, (pending.constData() + offset + PrbsBlockSize), sizeof(received));
+
+            if (qPopulationCount(received ^ following.next_block()) <= PrbsSlipThreshold)
+            {
+                add_errors(difference, PrbsBlockSize);
+                expected = next;
+                offset += PrbsBlockSize;
+                continue;
+            }
+        }
+
+        //Too many errors for this to be noise, bytes before the fault still match so step over them individually
+        AutPrbs probe = expected;
+        quint8 i = 0;
+
+        while (i < PrbsBlockSize && (quint8)pending.at(offset) == probe.next_byte())
+        {
+            add_errors(0, 1);
+            expected = probe;
+            ++offset;
+            ++i;
+        }
+
+        if ((pending.length() - offset) < (PrbsBlockSize + PrbsMaxSlipBytes + PrbsVerifyBytes))
+        {
+            //Wait for enough data to test each alignment
+            break;
+        }
+
+        if (realign(&offset) == false)
+        {
+            //Could not find where the data went, synchronise again from scratch
+            ++statistics.sync_losses;
+            locked = false;
+            in_burst = false;
+        }
+    }
+
+    pending.remove(0, offset);
+}
+
+//=============================================================================
+//=============================================================================
+bool AutPrbsChecker::synchronise(int32_t offset)
+{
+    AutPrbs candidate = expected;
+
+    candidate.seed((const quint8 *)pending.constData() + offset);
+
+    if (matches(candidate, (offset + candidate.state_bytes())) == false)
+    {
+        return false;
+    }
+
+    expected = candidate;
+
+    return true;
+}
+
+//=============================================================================
+//=============================================================================
+bool AutPrbsChecker::matches(AutPrbs generator, int32_t offset)
+{
+    quint64 received;
+
+    memcpy(&received, (pending.constData() + offset), sizeof(received));
+
+    return (qPopulationCount(received ^ generator.next_block()) <= PrbsVerifyMaxBitErrors);
+}
+
+//=============================================================================
+//=============================================================================
+bool AutPrbsChecker::realign(int32_t *offset)
+{
+    AutPrbs candidate = expected;
+    quint8 slip = 1;
+
+    //Error burst, the data after this block is still in step so count the block as bit errors
+    candidate.skip(PrbsBlockSize);
+
+    if (matches(candidate, (*offset + PrbsBlockSize)) == true)
+    {
+        quint64 received;
+
+        memcpy(&received, (pending.constData() + *offset), sizeof(received));
+        add_errors((received ^ expected.next_block()), PrbsBlockSize);
+        *offset += PrbsBlockSize;
+
+        return true;
+    }
+
+    while (slip <= PrbsMaxSlipBytes)
+    {
+        //Bytes dropped, the received data is ahead of the expected data
+        candidate = expected;
+        candidate.skip(slip);
+
+        if (matches(candidate, *offset) == true)
+        {
+            statistics.bytes_dropped += slip;
+            expected = candidate;
+            in_burst = false;
+
+            return true;
+        }
+
+        //Bytes inserted, the expected data appears later in the received data
+        if (matches(expected, (*offset + slip)) == true)
+        {
+            statistics.bytes_inserted += slip;
+            *offset += slip;
+            in_burst = false;
+
+            return true;
+        }
+
+        ++slip;
+    }
+
+    return false;
+}
+
+//=============================================================================
+//=============================================================================
+void AutPrbsChecker::add_errors(quint64 difference, quint8 bytes)
+{
+    quint8 data[PrbsBlockSize];
+    quint8 i = 0;
+
+    statistics.bits_checked += (quint64)bytes * 8;
+
+    if (difference == 0 && in_burst == false)
+    {
+        return;
+    }
+
+    statistics.bit_errors += qPopulationCount(difference);
+    memcpy(data, &difference, sizeof(data));
+
+    //A burst is a run of errored bytes which are separated by fewer than PrbsBurstGapBytes error-free bytes
+    while (i < bytes)
+    {
+        if (data[i] != 0)
+        {
+            if (in_burst == false)
+            {
+                in_burst = true;
+                burst_length = 1;
+                ++statistics.bursts;
+            }
+            else
+            {
+                burst_length += clean_bytes + 1;
+            }
+
+            clean_bytes = 0;
+
+            if (burst_length > statistics.longest_burst)
+            {
+                statistics.longest_burst = burst_length;
+            }
+        }
+        else if (in_burst == true)
+        {
+            ++clean_bytes;
+
+            if (clean_bytes >= PrbsBurstGapBytes)
+            {
+                in_burst = false;
+            }
+        }
+
+        ++i;
+    }
+}
+
+//=============================================================================
+//=============================================================================
+bool AutPrbsChecker::is_locked()
+{
+    return locked;
+}
+
+//=============================================================================
+//=============================================================================
+const AutPrbsStats *AutPrbsChecker::stats()
+{
+    return &statistics;
+}
+
+//=============================================================================
+//=============================================================================
+double AutPrbsChecker::bit_error_rate()
+{
+    if (statistics.bits_checked == 0)
+    {
+        return 0.0;
+    }
+
+    return (double)statistics.bit_errors / (double)statistics.bits_checked;
+}
+
+/******************************************************************************/
+// END OF FILE
+/******************************************************************************/
@@ -0,0 +1,121 @@
+/******************************************************************************
+** Copyright (C) 2023 Jamie M.
+**
+** Project: AuTerm
+**
+** Module:  AutPrbs.h
+**
+** Notes:
+**
+** License: This program is free software: you can redistribute it and/or
+**          modify it under the terms of the GNU General Public License as
+**          published by the Free Software Foundation, version 3.
+**
+**          This program is distributed in the hope that it will be useful,
+**          but WITHOUT ANY WARRANTY; without even the implied warranty of
+**          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**          GNU General Public License for more details.
+**
+**          You should have received a copy of the GNU General Public License
+**          along with this program.  If not, see http://www.gnu.org/licenses/
+**
+*******************************************************************************/
+#ifndef AUTPRBS_H
+#define AUTPRBS_H
+
+/******************************************************************************/
+// Include Files
+/******************************************************************************/
+#include <QByteArray>
+
+/******************************************************************************/
+// Constants
+/******************************************************************************/
+//PRBS sequences (ITU-T O.150 polynomials), order matches the speed test data type combo box
+enum AutPrbsType {
+    PrbsType7 = 0,
+    PrbsType15,
+    PrbsType23,
+    PrbsType31
+};
+
+const quint8 PrbsBlockSize                      = 8;  //Number of bytes compared at once whilst locked
+const quint8 PrbsVerifyBytes                    = 8;  //Number of bytes which must follow a candidate position for it to be accepted when synchronising
+const quint8 PrbsVerifyMaxBitErrors             = 2;  //Maximum bit errors allowed in the verify bytes when synchronising
+const quint8 PrbsSlipThreshold                  = 16; //Bit errors in a block above this are treated as a possible byte slip rather than bit errors (random data gives ~32)
+const quint8 PrbsMaxSlipBytes                   = 16; //Maximum number of dropped or inserted bytes which are searched for when realigning
+const quint8 PrbsBurstGapBytes                  = 4;  //Number of error-free bytes which end an error burst
+
+/******************************************************************************/
+// Structures
+/******************************************************************************/
+struct AutPrbsStats {
+    quint64 bits_checked;
+    quint64 bit_errors;
+    quint64 bytes_dropped;
+    quint64 bytes_inserted;
+    quint64 bytes_unsynchronised;
+    quint64 sync_losses;
+    quint64 bursts;
+    quint64 longest_burst;
+};
+
+/******************************************************************************/
+// Class definitions
+/******************************************************************************/
+//Byte-wise PRBS generator, the state holds the last n bits which were output so it can be seeded from received data
+class AutPrbs
+{
+public:
+    AutPrbs();
+    void set_type(AutPrbsType type);
+    void reset();
+    void generate(QByteArray *data, int32_t count);
+    quint8 next_byte();
+    quint64 next_block();
+    void skip(int32_t count);
+    quint32 get_state();
+    quint8 state_bytes();
+    void seed(const quint8 *data);
+
+private:
+    quint32 state;
+    quint32 mask;
+    quint8 length;
+    quint8 tap;
+};
+
+//Checks received data against a PRBS sequence, synchronising itself to the data so that dropped and inserted bytes can be
+//told apart from bit errors
+class AutPrbsChecker
+{
+public:
+    AutPrbsChecker();
+    void set_type(AutPrbsType type);
+    void reset();
+    void check(const QByteArray &data);
+    bool is_locked();
+    const AutPrbsStats *stats();
+    double bit_error_rate();
+
+private:
+    bool synchronise(int32_t offset);
+    bool matches(AutPrbs generator, int32_t offset);
+    bool realign(int32_t *offset);
+    void add_errors(quint64 difference, quint8 bytes);
+
+    AutPrbs expected;
+    AutPrbsType type;
+    AutPrbsStats statistics;
+    QByteArray pending;
+    bool locked;
+    bool in_burst;
+    quint64 burst_length;
+    quint64 clean_bytes;
+};
+
+#endif // AUTPRBS_H
+
+/******************************************************************************/
+// END OF FILE
+/******************************************************************************/
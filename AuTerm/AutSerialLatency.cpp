@@ -0,0 +1,223 @@
+/******************************************************************************
+** Copyright (C) 2023 Jamie M.
+**
+** Project: AuTerm
+**
+** Module:  AutSerialLatency.cpp
+**
+** Notes:
+**
+** License: This program is free software: you can redistribute it and/or
+**          modify it under the terms of the GNU General Public License as
+**          published by the Free Software Foundation, version 3.
+**
+**          This program is distributed in the hope that it will be useful,
+**          but WITHOUT ANY WARRANTY; without even the implied warranty of
+**          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**          GNU General Public License for more details.
+**
+**          You should have received a copy of the GNU General Public License
+**          along with this program.  If not, see http://www.gnu.org/licenses/
+**
+*******************************************************************************/
+
+/******************************************************************************/
+// Include Files
+/******************************************************************************/
+#include "AutSerialLatency.h"
+#include <QFile>
+#include <QFileInfo>
+#ifdef Q_OS_LINUX
+#include <sys/ioctl.h>
+#include <linux/serial.h>
+#include <termios.h>
+#endif
+
+/******************************************************************************/
+// Local Functions or Private Members
+/******************************************************************************/
+
+//=============================================================================
+//=============================================================================
+bool AutSerialLatency::apply(QSerialPort::Handle handle, QString port_name, AutSerialLatencyState *state)
+{
+    //Returns false if low latency mode is not supported at all for this port
+    state->applied = false;
+    state->low_latency_supported = false;
+    state->low_latency_original = false;
+    state->low_latency = false;
+    state->latency_timer_original = SerialLatencyUnknown;
+    state->latency_timer = SerialLatencyUnknown;
+    state->vmin = SerialLatencyUnknown;
+    state->vtime = SerialLatencyUnknown;
+
+#ifdef Q_OS_LINUX
+    struct serial_struct serial;
+    struct termios options;
+
+    //Adapters with a latency timer hold received data for up to this time (16ms by default) before sending it to the host
+    state->latency_timer_original = read_latency_timer(port_name);
+
+    if (ioctl(handle, TIOCGSERIAL, &serial) == 0)
+    {
+        //On FTDI adapters this also uses a 1ms latency timer, but the sysfs attribute is not changed
+        state->low_latency_supported = true;
+        state->low_latency_original = ((serial.flags & ASYNC_LOW_LATENCY) != 0);
+
+        if (state->low_latency_original == false)
+        {
+            serial.flags |= ASYNC_LOW_LATENCY;
+
+            if (ioctl(handle, TIOCSSERIAL, &serial) == 0)
+            {
+                state->applied = true;
+            }
+        }
+
+        if (ioctl(handle, TIOCGSERIAL, &serial) == 0)
+        {
+            state->low_latency = ((serial.flags & ASYNC_LOW_LATENCY) != 0);
+        }
+    }
+
+    if (state->latency_timer_original != SerialLatencyUnknown && state->latency_timer_original > SerialLatencyTimerLow)
+    {
+        if (write_latency_timer(port_name, SerialLatencyTimerLow) == true)
+        {
+            state->applied = true;
+        }
+    }
+
+    state->latency_timer = read_latency_timer(port_name);
+
+    if (tcgetattr(handle, &options) == 0)
+    {
+        //Reads are non-blocking, make sure the driver does not wait for a minimum amount of data or inter-character time
+        if (options.c_cc[VMIN] != 0 || options.c_cc[VTIME] != 0)
+        {
+            options.c_cc[VMIN] = 0;
+            options.c_cc[VTIME] = 0;
+
+            if (tcsetattr(handle, TCSANOW, &options) == 0)
+            {
+                state->applied = true;
+            }
+
+            tcgetattr(handle, &options);
+        }
+
+        state->vmin = options.c_cc[VMIN];
+        state->vtime = options.c_cc[VTIME];
+    }
+
+    return (state->low_latency_supported == true || state->latency_timer != SerialLatencyUnknown);
+#else
+    Q_UNUSED(handle);
+    Q_UNUSED(port_name);
+
+    return false;
+#endif
+}
+
+//=============================================================================
+//=============================================================================
+void AutSerialLatency::restore(QSerialPort::Handle handle, QString port_name, AutSerialLatencyState *state)
+{
+    //Must be called before the port is closed, as the adapter keeps its latency timer until it is unplugged
+    if (state->applied == false)
+    {
+        return;
+    }
+
+#ifdef Q_OS_LINUX
+    struct serial_struct serial;
+
+    if (state->low_latency_supported == true && state->low_latency_original == false && ioctl(handle, TIOCGSERIAL, &serial) == 0)
+    {
+        serial.flags &= ~ASYNC_LOW_LATENCY;
+        ioctl(handle, TIOCSSERIAL, &serial);
+    }
+
+    if (state->latency_timer_original != SerialLatencyUnknown && state->latency_timer_original != read_latency_timer(port_name))
+    {
+        write_latency_timer(port_name, state->latency_timer_original);
+    }
+#else
+    Q_UNUSED(handle);
+    Q_UNUSED(port_name);
+#endif
+
+    state->applied = false;
+}
+
+//=============================================================================
+//=============================================================================
+QString AutSerialLatency::describe(const AutSerialLatencyState *state)
+{
+    QString output("Low latency: ");
+
+    if (state->low_latency_supported == false && state->latency_timer == SerialLatencyUnknown)
+    {
+        return output.append("not supported by this port");
+    }
+
+    output.append("ASYNC_LOW_LATENCY ").append(state->low_latency_supported == false ? "not supported" : (state->low_latency == true ? "on" : "off"));
+    output.append(", latency timer ").append(state->latency_timer == SerialLatencyUnknown ? QString("n/a") : QString::number(state->latency_timer).append("ms"));
+
+    if (state->vmin != SerialLatencyUnknown)
+    {
+        output.append(", VMIN ").append(QString::number(state->vmin)).append(" VTIME ").append(QString::number(state->vtime));
+    }
+
+    return output;
+}
+
+//=============================================================================
+//=============================================================================
+QString AutSerialLatency::latency_timer_path(QString port_name)
+{
+    //Port names are e.g. ttyUSB0 or /dev/ttyUSB0
+    return QString("/sys/bus/usb-serial/devices/").append(QFileInfo(port_name).fileName()).append("/latency_timer");
+}
+
+//=============================================================================
+//=============================================================================
+qint32 AutSerialLatency::read_latency_timer(QString port_name)
+{
+    QFile file(latency_timer_path(port_name));
+    bool valid;
+    qint32 latency;
+
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        return SerialLatencyUnknown;
+    }
+
+    latency = file.readAll().trimmed().toInt(&valid);
+    file.close();
+
+    return (valid == true ? latency : SerialLatencyUnknown);
+}
+
+//=============================================================================
+//=============================================================================
+bool AutSerialLatency::write_latency_timer(QString port_name, qint32 latency)
+{
+    //Needs write access to the sysfs attribute, which by default only root has
+    QFile file(latency_timer_path(port_name));
+    bool success;
+
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        return false;
+    }
+
+    success = (file.write(QByteArray::number(latency)) > 0);
+    file.close();
+
+    return success;
+}
+
+/******************************************************************************/
+// END OF FILE
+/******************************************************************************/
@@ -0,0 +1,76 @@
+/******************************************************************************
+** Copyright (C) 2023 Jamie M.
+**
+** Project: AuTerm
+**
+** Module:  AutSerialLatency.h
+**
+** Notes:
+**
+** License: This program is free software: you can redistribute it and/or
+**          modify it under the terms of the GNU General Public License as
+**          published by the Free Software Foundation, version 3.
+**
+**          This program is distributed in the hope that it will be useful,
+**          but WITHOUT ANY WARRANTY; without even the implied warranty of
+**          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**          GNU General Public License for more details.
+**
+**          You should have received a copy of the GNU General Public License
+**          along with this program.  If not, see http://www.gnu.org/licenses/
+**
+*******************************************************************************/
+#ifndef AUTSERIALLATENCY_H
+#define AUTSERIALLATENCY_H
+
+/******************************************************************************/
+// Include Files
+/******************************************************************************/
+#include <QString>
+#include <QSerialPort>
+
+/******************************************************************************/
+// Constants
+/******************************************************************************/
+const qint32 SerialLatencyTimerLow              = 1;    //Latency timer (in ms) of USB serial adapters in low latency mode
+const qint32 SerialLatencyUnknown               = -1;
+
+/******************************************************************************/
+// Structures
+/******************************************************************************/
+//Settings of a port before and after low latency mode was applied, the original values are restored when the port is closed
+struct AutSerialLatencyState {
+    bool applied; //True if any setting was changed
+    bool low_latency_supported; //True if the driver supports TIOCGSERIAL/TIOCSSERIAL
+    bool low_latency_original; //ASYNC_LOW_LATENCY flag before it was set
+    bool low_latency; //Effective ASYNC_LOW_LATENCY flag
+    qint32 latency_timer_original; //USB serial adapter latency timer (in ms) before it was changed, or SerialLatencyUnknown
+    qint32 latency_timer; //Effective USB serial adapter latency timer (in ms), or SerialLatencyUnknown if the adapter does not have one
+    qint32 vmin; //Effective VMIN, or SerialLatencyUnknown
+    qint32 vtime; //Effective VTIME (in 1/10 s), or SerialLatencyUnknown
+};
+
+/******************************************************************************/
+// Class definitions
+/******************************************************************************/
+//Reduces the time data spends buffered in the driver and USB serial adapter (Linux only): sets ASYNC_LOW_LATENCY, sets the
+//latency_timer sysfs attribute of adapters which have one (e.g. FTDI) and makes reads return as soon as any data is
+//available (VMIN 0, VTIME 0)
+class AutSerialLatency
+{
+public:
+    static bool apply(QSerialPort::Handle handle, QString port_name, AutSerialLatencyState *state);
+    static void restore(QSerialPort::Handle handle, QString port_name, AutSerialLatencyState *state);
+    static QString describe(const AutSerialLatencyState *state);
+
+private:
+    static QString latency_timer_path(QString port_name);
+    static qint32 read_latency_timer(QString port_name);
+    static bool write_latency_timer(QString port_name, qint32 latency);
+};
+
+#endif // AUTSERIALLATENCY_H
+
+/******************************************************************************/
+// END OF FILE
+/******************************************************************************/
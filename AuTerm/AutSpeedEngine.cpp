@@ -0,0 +1,607 @@
+/******************************************************************************
+** Copyright (C) 2023 Jamie M.
+**
+** Project: AuTerm
+**
+** Module:  AutSpeedEngine.cpp
+**
+** Notes:
+**
+** License: This program is free software: you can redistribute it and/or
+**          modify it under the terms of the GNU General Public License as
+**          published by the Free Software Foundation, version 3.
+**
+**          This program is distributed in the hope that it will be useful,
+**          but WITHOUT ANY WARRANTY; without even the implied warranty of
+**          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**          GNU General Public License for more details.
+**
+**          You should have received a copy of the GNU General Public License
+**          along with this program.  If not, see http://www.gnu.org/licenses/
+**
+*******************************************************************************/
+
+/******************************************************************************/
+// Include Files
+/******************************************************************************/
+#include "AutSpeedEngine.h"
+#include <QDateTime>
+
+/******************************************************************************/
+// Local Functions or Private Members
+/******************************************************************************/
+static QString format_elapsed(qint64 elapsed_ms)
+{
+    //Same format as the speed test time label
+    unsigned int hours = (elapsed_ms / 3600000LL);
+    unsigned char minutes = (elapsed_ms / 60000LL) % 60;
+    unsigned char seconds = (elapsed_ms % 60000) / 1000;
+    unsigned int hundredths = (elapsed_ms % 1000) / 10;
+
+    return QString((hours < 10 ? "0" : "")).append(QString::number(hours)).append((minutes < 10 ? ":0" : ":")).append(QString::number(minutes)).append((seconds < 10 ? ":0" : ":")).append(QString::number(seconds)).append((hundredths < 10 ? ".0" : ".")).append(QString::number(hundredths));
+}
+
+//=============================================================================
+//=============================================================================
+AutSpeedEngine::AutSpeedEngine(QObject *parent) : QObject(parent)
+{
+    qRegisterMetaType<AutSpeedEngineConfig>("AutSpeedEngineConfig");
+    qRegisterMetaType<AutSpeedSnapshot>("AutSpeedSnapshot");
+    qRegisterMetaType<AutSpeedSnapshot *>("AutSpeedSnapshot*");
+
+    //The engine is created on the GUI thread, the port is given back to this thread when a test stops
+    gui_thread = QThread::currentThread();
+    port = nullptr;
+    config.test_id = 0;
+    config.mode = SpeedModeInactive;
+    config.data_type = SpeedDataThroughput;
+
+    //Timers are children so that they follow the engine to its thread
+    snapshot_timer = new QTimer(this);
+    snapshot_timer->setInterval(SpeedTestSnapshotTime);
+    snapshot_timer->setSingleShot(false);
+    connect(snapshot_timer, SIGNAL(timeout()), this, SLOT(publish_snapshot()));
+    latency_timer = new QTimer(this);
+    latency_timer->setInterval(SpeedTestLatencyProbeTimeout);
+    latency_timer->setSingleShot(true);
+    connect(latency_timer, SIGNAL(timeout()), this, SLOT(latency_timeout()));
+}
+
+//=============================================================================
+//=============================================================================
+void AutSpeedEngine::start(AutSpeedEngineConfig config, QSerialPort *port)
+{
+    this->config = config;
+    this->port = port;
+    connect(port, SIGNAL(readyRead()), this, SLOT(receive()));
+    connect(port, SIGNAL(bytesWritten(qint64)), this, SLOT(bytes_written(qint64)));
+    connect(port, SIGNAL(errorOccurred(QSerialPort::SerialPortError)), this, SLOT(error_occurred(QSerialPort::SerialPortError)));
+
+    //Reset all counters
+    received_data.clear();
+    display.clear();
+    bytes_sent = 0;
+    bytes_received = 0;
+    buffer_count = 0;
+    receive_index = 0;
+    packets_sent = 0;
+    packets_received = 0;
+    packets_good = 0;
+    packets_bad = 0;
+    first_receive_ms = -1;
+    match_data_length = config.match_data.length();
+
+    if (config.data_type == SpeedDataLatency)
+    {
+        //Each probe which is echoed back counts as a packet
+        latency.reset();
+        match_data_length = LatencyProbeSize;
+    }
+    else if (config.data_type == SpeedDataPrbs)
+    {
+        //Both ends start from the same seed, the checker synchronises itself to the received data so the receive side can start at any point
+        prbs_generator.set_type(config.prbs_type);
+        prbs_checker.set_type(config.prbs_type);
+
+        //Each chunk of the sequence which is sent counts as a packet
+        match_data_length = SpeedTestChunkSize;
+    }
+
+    elapsed.start();
+    snapshot_timer->start();
+
+    if ((config.mode & SpeedModeSend) == SpeedModeSend && config.send_now == true)
+    {
+        send_data(SpeedTestChunkSize);
+    }
+}
+
+//=============================================================================
+//=============================================================================
+void AutSpeedEngine::start_sending()
+{
+    //Delay before sending has expired
+    if (port != nullptr && (config.mode & SpeedModeSend) == SpeedModeSend)
+    {
+        send_data(SpeedTestChunkSize);
+    }
+}
+
+//=============================================================================
+//=============================================================================
+void AutSpeedEngine::set_mode(quint8 mode)
+{
+    config.mode = mode;
+
+    if ((mode & SpeedModeSend) != SpeedModeSend)
+    {
+        latency_timer->stop();
+    }
+}
+
+//=============================================================================
+//=============================================================================
+void AutSpeedEngine::set_display_options(bool show_tx, bool show_rx, bool show_errors)
+{
+    config.show_tx = show_tx;
+    config.show_rx = show_rx;
+    config.show_errors = show_errors;
+}
+
+//=============================================================================
+//=============================================================================
+void AutSpeedEngine::set_request_to_send(bool set)
+{
+    if (port != nullptr)
+    {
+        port->setRequestToSend(set);
+    }
+}
+
+//=============================================================================
+//=============================================================================
+void AutSpeedEngine::set_data_terminal_ready(bool set)
+{
+    if (port != nullptr)
+    {
+        port->setDataTerminalReady(set);
+    }
+}
+
+//=============================================================================
+//=============================================================================
+void AutSpeedEngine::set_break_enabled(bool set)
+{
+    if (port != nullptr)
+    {
+        port->setBreakEnabled(set);
+    }
+}
+
+//=============================================================================
+//=============================================================================
+void AutSpeedEngine::stop(AutSpeedSnapshot *final_snapshot)
+{
+    //Called with a blocking connection, gives the port back to the GUI thread along with the final counters
+    snapshot_timer->stop();
+    latency_timer->stop();
+    config.mode = SpeedModeInactive;
+
+    if (port != nullptr)
+    {
+        disconnect(port, nullptr, this, nullptr);
+        port->moveToThread(gui_thread);
+        port = nullptr;
+    }
+
+    if (final_snapshot != nullptr)
+    {
+        fill_snapshot(final_snapshot);
+    }
+
+    display.clear();
+}
+
+//=============================================================================
+//=============================================================================
+void AutSpeedEngine::receive()
+{
+    //Received data from serial port in speed test mode, the arrival time of latency probes is when the data is read
+    qint64 arrival_time = elapsed.nsecsElapsed();
+    QByteArray data = port->readAll();
+
+    if ((config.mode & SpeedModeRecv) != SpeedModeRecv)
+    {
+        return;
+    }
+
+    bytes_received += data.length();
+
+    if (first_receive_ms == -1)
+    {
+        first_receive_ms = elapsed.elapsed();
+    }
+
+    if (config.show_rx == true)
+    {
+        append_display(data);
+    }
+
+    if (config.data_type == SpeedDataLatency)
+    {
+        //Match echoed probes
+        int32_t matched = latency.receive(data, arrival_time);
+
+        if (matched > 0)
+        {
+            packets_received += matched;
+
+            if (latency.outstanding() == 0)
+            {
+                latency_timer->stop();
+
+                if ((config.mode & SpeedModeSend) == SpeedModeSend)
+                {
+                    //Send the next probe
+                    send_data(LatencyProbeSize);
+                }
+            }
+        }
+    }
+    else if (config.data_type == SpeedDataPrbs)
+    {
+        //Check PRBS sequence
+        prbs_checker.check(data);
+        packets_received = prbs_checker.stats()->bits_checked / 8 / SpeedTestChunkSize;
+    }
+    else if (config.data_type == SpeedDataString)
+    {
+        check_string(data);
+    }
+}
+
+//=============================================================================
+//=============================================================================
+void AutSpeedEngine::check_string(const QByteArray &data)
+{
+    //Test data is OK
+    int32_t remove_size = 0;
+    received_data.append(data);
+    while (remove_size < received_data.length())
+    {
+        //Data to check
+        int SizeToTest = match_data_length - receive_index;
+        if ((SizeToTest + remove_size) > received_data.length())
+        {
+            SizeToTest = received_data.length() - remove_size;
+        }
+
+        //Optimised search check function. for testing only
+        int32_t i = 0;
+        bool good = true;
+        pointer_buf rec_buf;
+        pointer_buf match_buf;
+        rec_buf.p8 = ((uint8_t *)received_data.data() + remove_size);
+        match_buf.p8 = ((uint8_t *)config.match_data.data() + receive_index);
+
+        while (i < SizeToTest)
+        {
+            uint32_t loop_check_size = 8;
+            switch (SizeToTest - i)
+            {
+            case 1:
+                if (*rec_buf.p8 != *match_buf.p8)
+                {
+                        good = false;
+                }
+                loop_check_size = 1;
+                break;
+            case 2:
+                if (*rec_buf.p16 != *match_buf.p16)
+                {
+                        good = false;
+                }
+                loop_check_size = 2;
+                break;
+            case 3:
+                if (*rec_buf.p16 != *match_buf.p16 || *(rec_buf.p8+2) != *(match_buf.p8+2))
+                {
+                        good = false;
+                }
+                loop_check_size = 3;
+                break;
+            case 4:
+                if (*rec_buf.p32 != *match_buf.p32)
+                {
+                        good = false;
+                }
+                loop_check_size = 4;
+                break;
+            case 5:
+                if (*rec_buf.p32 != *match_buf.p32 || *(rec_buf.p8 + 4) != *(match_buf.p8 + 4))
+                {
+                        good = false;
+                }
+                loop_check_size = 5;
+                break;
+            case 6:
+                if (*rec_buf.p32 != *match_buf.p32 || *(rec_buf.p16 + 2) != *(match_buf.p16 + 2))
+                {
+                        good = false;
+                }
+                loop_check_size = 6;
+                break;
+            case 7:
+                if (*rec_buf.p32 != *match_buf.p32 || *(rec_buf.p16 + 2) != *(match_buf.p16 + 2) || *(rec_buf.p8 + 6) != *(match_buf.p8 + 6))
+                {
+                        good = false;
+                }
+                loop_check_size = 7;
+                break;
+            default:
+                if (*rec_buf.p64 != *match_buf.p64)
+                {
+                        good = false;
+                }
+                break;
+            }
+
+            if (good == false)
+            {
+                break;
+            }
+
+            i += loop_check_size;
+            rec_buf.p8 += loop_check_size;
+            match_buf.p8 += loop_check_size;
+        }
+
+        if (good == true)
+        {
+            //Good
+            remove_size += SizeToTest;
+            receive_index += SizeToTest;
+            if (receive_index >= match_data_length)
+            {
+                ++packets_good;
+                ++packets_received;
+                receive_index = 0;
+            }
+        }
+        else
+        {
+            //Bad
+            ++packets_bad;
+
+            if (config.show_errors)
+            {
+                //Show error - find mismatch position
+                uint16_t new_offset = (i > 5 ? i - 5 : 0);
+                QString strFirst(received_data.mid(remove_size + new_offset));
+                QString strSecond(config.match_data.mid(receive_index + new_offset));
+                int32_t max_size = strFirst.length() > strSecond.length() ? strSecond.length() : strFirst.length();
+                quint16 iOffset = 0;
+                while (iOffset < max_size)
+                {
+                        if (strFirst.at(iOffset) != strSecond.at(iOffset))
+                        {
+                                //Found
+                                ++iOffset;
+                                break;
+                        }
+                        ++iOffset;
+                }
+
+                if (strFirst.length() > max_size)
+                {
+                        strFirst.remove(max_size, strFirst.length() - max_size);
+                }
+
+                if (strSecond.length() > max_size)
+                {
+                        strSecond.remove(max_size, strSecond.length() - max_size);
+                }
+
+                //Add to display
+                append_display(QString("\r\nError: Data mismatch.\r\n\tExpected: ").append(strSecond).append("\r\n\tGot     : ").append(strFirst).append("\r\n\tPosition: ").append(QString("-").repeated(iOffset-1).append("^")).append("\r\n\tOccurred: ").append(format_elapsed(elapsed.elapsed())).append(" (").append(QDateTime::currentDateTime().toLocalTime().toString()).append(")\r\n").toUtf8());
+            }
+
+            //Search for start character (ignoring first character)
+            int StartChar = received_data.indexOf(config.match_data.at(0), remove_size + 1);
+            if (StartChar == -1)
+            {
+                //Not found, clear whole receive buffer
+                received_data.clear();
+            }
+            else
+            {
+                //Found, remove until this character
+                received_data.remove(0, StartChar);
+            }
+
+            ++packets_received;
+            receive_index = 0;
+            remove_size = 0;
+        }
+    }
+
+    if (remove_size > 0)
+    {
+        received_data.remove(0, remove_size);
+    }
+}
+
+//=============================================================================
+//=============================================================================
+void AutSpeedEngine::bytes_written(qint64 bytes)
+{
+    //Serial port bytes have been written in speed test mode
+    if ((config.mode & SpeedModeSend) == SpeedModeSend)
+    {
+        //Sending data in speed test
+        buffer_count -= bytes;
+
+        if (buffer_count <= SpeedTestMinBufSize)
+        {
+            //Buffer has space: send more data
+            send_data(SpeedTestChunkSize);
+        }
+    }
+
+    //Add to bytes sent counters
+    bytes_sent += bytes;
+}
+
+//=============================================================================
+//=============================================================================
+void AutSpeedEngine::error_occurred(QSerialPort::SerialPortError error)
+{
+    if (error == QSerialPort::ResourceError || error == QSerialPort::PermissionError)
+    {
+        //Fatal error, stop using the port and let the GUI clean up
+        snapshot_timer->stop();
+        latency_timer->stop();
+        config.mode = SpeedModeInactive;
+        emit port_error((int)error);
+    }
+}
+
+//=============================================================================
+//=============================================================================
+void AutSpeedEngine::latency_timeout()
+{
+    //No echo was received for the outstanding probe in time, this timer only runs whilst a probe is outstanding
+    latency.expire(elapsed.nsecsElapsed(), 0);
+
+    if ((config.mode & SpeedModeSend) == SpeedModeSend)
+    {
+        //Carry on with the next probe
+        send_data(LatencyProbeSize);
+    }
+}
+
+//=============================================================================
+//=============================================================================
+void AutSpeedEngine::publish_snapshot()
+{
+    AutSpeedSnapshot snapshot;
+
+    fill_snapshot(&snapshot);
+    display.clear();
+    emit snapshot_ready(snapshot);
+}
+
+//=============================================================================
+//=============================================================================
+void AutSpeedEngine::send_data(int max_length)
+{
+    //Send string out. It's OK to send less than the maximum length but not more, unless none fit
+    int send_times = 1;
+
+    if (config.data_type == SpeedDataLatency)
+    {
+        //Ping-pong, the next probe is only sent once the previous one has been echoed back or has timed out
+        if (latency.outstanding() > 0)
+        {
+            return;
+        }
+
+        quint32 sequence;
+        QByteArray probe = latency.make_probe(&sequence);
+
+        if (config.show_tx == true)
+        {
+            //Show TX data in terminal
+            append_display(probe);
+        }
+
+        //Hand the probe to the OS straight away rather than on the next event loop iteration, the send time is when this completes
+        port->write(probe);
+        port->flush();
+        latency.probe_sent(sequence, elapsed.nsecsElapsed());
+        latency_timer->start();
+        buffer_count += LatencyProbeSize;
+        ++packets_sent;
+        return;
+    }
+    else if (config.data_type == SpeedDataPrbs)
+    {
+        //Send the next part of the PRBS sequence
+        QByteArray data;
+        prbs_generator.generate(&data, max_length);
+
+        if (config.show_tx == true)
+        {
+            //Show TX data in terminal
+            append_display(data);
+        }
+
+        port->write(data);
+        buffer_count += max_length;
+        ++packets_sent;
+        return;
+    }
+
+    if (max_length > match_data_length)
+    {
+        send_times = (max_length / match_data_length);
+    }
+
+    if (config.show_tx == true)
+    {
+        //Show TX data in terminal
+        int print_times = send_times;
+
+        while (print_times > 0)
+        {
+            //Append to buffer
+            append_display(config.match_data);
+            --print_times;
+        }
+    }
+
+    while (send_times > 0)
+    {
+        //Send out until finished
+        port->write(config.match_data);
+        buffer_count += match_data_length;
+        --send_times;
+        ++packets_sent;
+    }
+}
+
+//=============================================================================
+//=============================================================================
+void AutSpeedEngine::fill_snapshot(AutSpeedSnapshot *snapshot)
+{
+    snapshot->test_id = config.test_id;
+    snapshot->bytes_sent = bytes_sent;
+    snapshot->bytes_received = bytes_received;
+    snapshot->buffer_bytes = buffer_count;
+    snapshot->packets_sent = packets_sent;
+    snapshot->packets_received = packets_received;
+    snapshot->packets_good = packets_good;
+    snapshot->packets_bad = packets_bad;
+    snapshot->first_receive_ms = first_receive_ms;
+    snapshot->prbs = *prbs_checker.stats();
+    snapshot->bit_error_rate = prbs_checker.bit_error_rate();
+    snapshot->latency = *latency.stats();
+    snapshot->latency_mean_ns = latency.mean();
+    snapshot->latency_p50_ns = latency.percentile(50.0);
+    snapshot->latency_p90_ns = latency.percentile(90.0);
+    snapshot->latency_p99_ns = latency.percentile(99.0);
+    snapshot->latency_p999_ns = latency.percentile(99.9);
+    snapshot->latency_histogram = (config.data_type == SpeedDataLatency ? latency.histogram() : QString());
+    snapshot->display = display;
+}
+
+//=============================================================================
+//=============================================================================
+void AutSpeedEngine::append_display(const QByteArray &data)
+{
+    display.append(data);
+}
+
+/******************************************************************************/
+// END OF FILE
+/******************************************************************************/
@@ -0,0 +1,175 @@
+/******************************************************************************
+** Copyright (C) 2023 Jamie M.
+**
+** Project: AuTerm
+**
+** Module:  AutSpeedEngine.h
+**
+** Notes:
+**
+** License: This program is free software: you can redistribute it and/or
+**          modify it under the terms of the GNU General Public License as
+**          published by the Free Software Foundation, version 3.
+**
+**          This program is distributed in the hope that it will be useful,
+**          but WITHOUT ANY WARRANTY; without even the implied warranty of
+**          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**          GNU General Public License for more details.
+**
+**          You should have received a copy of the GNU General Public License
+**          along with this program.  If not, see http://www.gnu.org/licenses/
+**
+*******************************************************************************/
+#ifndef AUTSPEEDENGINE_H
+#define AUTSPEEDENGINE_H
+
+/******************************************************************************/
+// Include Files
+/******************************************************************************/
+#include <QObject>
+#include <QThread>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QSerialPort>
+#include <QByteArray>
+#include <QString>
+#include "AutPrbs.h"
+#include "AutLatency.h"
+
+/******************************************************************************/
+// Constants
+/******************************************************************************/
+const qint8 SpeedModeInactive                   = 0;
+const qint8 SpeedModeRecv                       = 1;
+const qint8 SpeedModeSend                       = 2;
+const qint8 SpeedModeSendRecv                   = 3;
+const qint16 SpeedTestChunkSize                 = 512;  //Maximum number of bytes to send per chunk when speed testing
+const qint16 SpeedTestMinBufSize                = 128;  //Minimum buffer size when speed testing, when there are less than this number of bytes in the output buffer it will be topped up
+const qint16 SpeedTestLatencyProbeTimeout       = 1000; //Time (in ms) to wait for a latency probe to be echoed back before it is counted as lost
+const qint16 SpeedTestSnapshotTime              = 100;  //Time (in ms) between snapshots of the speed test counters being published to the GUI
+
+//Types of data which the speed test engine can send and check
+enum AutSpeedDataType {
+    SpeedDataThroughput = 0,
+    SpeedDataString,
+    SpeedDataLatency,
+    SpeedDataPrbs
+};
+
+/******************************************************************************/
+// Structures
+/******************************************************************************/
+//Union used for checking received byte array contents whilst speed testing
+union pointer_buf {
+    uint8_t *p8;
+    uint16_t *p16;
+    uint32_t *p32;
+    uint64_t *p64;
+};
+
+//Settings of a speed test, copied to the engine when the test starts
+struct AutSpeedEngineConfig {
+    quint32 test_id;
+    quint8 mode;
+    AutSpeedDataType data_type;
+    AutPrbsType prbs_type;
+    QByteArray match_data;
+    bool send_now;
+    bool show_tx;
+    bool show_rx;
+    bool show_errors;
+};
+
+//Copy of the speed test counters, published periodically so the GUI never reads state owned by the engine thread
+struct AutSpeedSnapshot {
+    quint32 test_id;
+    quint64 bytes_sent;
+    quint64 bytes_received;
+    qint32 buffer_bytes;
+    qint32 packets_sent;
+    qint32 packets_received;
+    qint32 packets_good;
+    qint32 packets_bad;
+    qint64 first_receive_ms;
+    AutPrbsStats prbs;
+    double bit_error_rate;
+    AutLatencyStats latency;
+    qint64 latency_mean_ns;
+    qint64 latency_p50_ns;
+    qint64 latency_p90_ns;
+    qint64 latency_p99_ns;
+    qint64 latency_p999_ns;
+    QString latency_histogram;
+    QByteArray display;
+};
+
+Q_DECLARE_METATYPE(AutSpeedEngineConfig)
+Q_DECLARE_METATYPE(AutSpeedSnapshot)
+
+/******************************************************************************/
+// Class definitions
+/******************************************************************************/
+//Generates and checks speed test data on a dedicated thread. For the duration of a test the serial port is moved to the
+//engine thread so that reads and writes are not held up by the GUI event loop, the port is moved back when the test stops
+class AutSpeedEngine : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit AutSpeedEngine(QObject *parent = nullptr);
+
+public slots:
+    void start(AutSpeedEngineConfig config, QSerialPort *port);
+    void start_sending();
+    void set_mode(quint8 mode);
+    void set_display_options(bool show_tx, bool show_rx, bool show_errors);
+    void set_request_to_send(bool set);
+    void set_data_terminal_ready(bool set);
+    void set_break_enabled(bool set);
+    void stop(AutSpeedSnapshot *final_snapshot);
+
+signals:
+    void snapshot_ready(AutSpeedSnapshot snapshot);
+    void port_error(int error);
+
+private slots:
+    void receive();
+    void bytes_written(qint64 bytes);
+    void error_occurred(QSerialPort::SerialPortError error);
+    void latency_timeout();
+    void publish_snapshot();
+
+private:
+    void send_data(int max_length);
+    void check_string(const QByteArray &data);
+    void fill_snapshot(AutSpeedSnapshot *snapshot);
+    void append_display(const QByteArray &data);
+
+    QThread *gui_thread;
+    QSerialPort *port;
+    AutSpeedEngineConfig config;
+    QElapsedTimer elapsed;
+    QTimer *snapshot_timer;
+    QTimer *latency_timer;
+    AutPrbs prbs_generator;
+    AutPrbsChecker prbs_checker;
+    AutLatency latency;
+    QByteArray received_data;
+    QByteArray display;
+    quint64 bytes_sent;
+    quint64 bytes_received;
+    qint32 buffer_count;
+    qint32 match_data_length;
+    qint32 receive_index;
+    qint32 packets_sent;
+    qint32 packets_received;
+    qint32 packets_good;
+    qint32 packets_bad;
+    qint64 first_receive_ms;
+};
+
+#endif // AUTSPEEDENGINE_H
+
+/******************************************************************************/
+// END OF FILE
+/******************************************************************************/
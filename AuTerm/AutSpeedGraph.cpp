@@ -0,0 +1,160 @@
+/******************************************************************************
+** Copyright (C) 2023 Jamie M.
+**
+** Project: AuTerm
+**
+** Module:  AutSpeedGraph.cpp
+**
+** Notes:
+**
+** License: This program is free software: you can redistribute it and/or
+**          modify it under the terms of the GNU General Public License as
+**          published by the Free Software Foundation, version 3.
+**
+**          This program is distributed in the hope that it will be useful,
+**          but WITHOUT ANY WARRANTY; without even the implied warranty of
+**          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**          GNU General Public License for more details.
+**
+**          You should have received a copy of the GNU General Public License
+**          along with this program.  If not, see http://www.gnu.org/licenses/
+**
+*******************************************************************************/
+
+/******************************************************************************/
+// Include Files
+/******************************************************************************/
+#include "AutSpeedGraph.h"
+#include <QPainter>
+#include <QPainterPath>
+
+/******************************************************************************/
+// Local Functions or Private Members
+/******************************************************************************/
+//Counters which are plotted and the colour and name of each
+static quint64 AutSpeedSample::*const graph_counters[] = {
+    &AutSpeedSample::bytes_sent,
+    &AutSpeedSample::bytes_received,
+};
+static const Qt::GlobalColor graph_colours[] = {
+    Qt::blue,
+    Qt::red,
+};
+static const char *const graph_names[] = {
+    "Tx",
+    "Rx",
+};
+
+//=============================================================================
+//=============================================================================
+AutSpeedGraph::AutSpeedGraph(QWidget *parent) : QWidget(parent)
+{
+    recorder = nullptr;
+    setMinimumHeight(80);
+}
+
+//=============================================================================
+//=============================================================================
+void AutSpeedGraph::set_recorder(AutSpeedRecorder *recorder)
+{
+    this->recorder = recorder;
+    update();
+}
+
+//=============================================================================
+//=============================================================================
+void AutSpeedGraph::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event);
+
+    QPainter painter(this);
+    QRect area = rect().adjusted(4, (fontMetrics().height() + 4), -4, -4);
+    double max_rate = 0.0;
+    int32_t sample;
+    uint8_t i = 0;
+
+    painter.fillRect(rect(), palette().base());
+    painter.setPen(palette().mid().color());
+    painter.drawRect(area);
+
+    if (recorder == nullptr || recorder->count() < 2 || area.width() <= 0 || area.height() <= 0)
+    {
+        return;
+    }
+
+    //Find the scale of the graph
+    while (i < (sizeof(graph_counters) / sizeof(graph_counters[0])))
+    {
+        sample = 1;
+
+        while (sample < recorder->count())
+        {
+            double rate;
+
+            if (recorder->rate(sample, graph_counters[i], &rate) == true && rate > max_rate)
+            {
+                max_rate = rate;
+            }
+
+            ++sample;
+        }
+
+        ++i;
+    }
+
+    if (max_rate <= 0.0)
+    {
+        max_rate = 1.0;
+    }
+
+    painter.setRenderHint(QPainter::Antialiasing, true);
+    i = 0;
+
+    while (i < (sizeof(graph_counters) / sizeof(graph_counters[0])))
+    {
+        QPainterPath path;
+        bool started = false;
+
+        sample = 1;
+
+        while (sample < recorder->count())
+        {
+            double rate;
+
+            if (recorder->rate(sample, graph_counters[i], &rate) == true)
+            {
+                QPointF point((area.left() + (double)area.width() * (sample - 1) / (recorder->count() - 2 > 0 ? recorder->count() - 2 : 1)), (area.bottom() - (double)area.height() * rate / max_rate));
+
+                if (started == false)
+                {
+                    path.moveTo(point);
+                    started = true;
+                }
+                else
+                {
+                    path.lineTo(point);
+                }
+            }
+            else
+            {
+                //Gap in the data
+                started = false;
+            }
+
+            ++sample;
+        }
+
+        painter.setPen(QPen(graph_colours[i], 1.5));
+        painter.drawPath(path);
+        painter.drawText(rect().adjusted(4, 1, (-4 - (int)((sizeof(graph_counters) / sizeof(graph_counters[0])) - 1 - i) * fontMetrics().horizontalAdvance("Tx ")), 0), (Qt::AlignRight | Qt::AlignTop), graph_names[i]);
+        ++i;
+    }
+
+    //Scale
+    painter.setPen(palette().text().color());
+    painter.drawText(4, fontMetrics().ascent() + 1, QString("Max: ").append(QString::number(max_rate, 'f', 0)).append(" bytes/s"));
+}
+
+/******************************************************************************/
+// END OF FILE
+/******************************************************************************/
@@ -0,0 +1,55 @@
+/******************************************************************************
+** Copyright (C) 2023 Jamie M.
+**
+** Project: AuTerm
+**
+** Module:  AutSpeedGraph.h
+**
+** Notes:
+**
+** License: This program is free software: you can redistribute it and/or
+**          modify it under the terms of the GNU General Public License as
+**          published by the Free Software Foundation, version 3.
+**
+**          This program is distributed in the hope that it will be useful,
+**          but WITHOUT ANY WARRANTY; without even the implied warranty of
+**          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**          GNU General Public License for more details.
+**
+**          You should have received a copy of the GNU General Public License
+**          along with this program.  If not, see http://www.gnu.org/licenses/
+**
+*******************************************************************************/
+#ifndef AUTSPEEDGRAPH_H
+#define AUTSPEEDGRAPH_H
+
+/******************************************************************************/
+// Include Files
+/******************************************************************************/
+#include <QWidget>
+#include "AutSpeedRecorder.h"
+
+/******************************************************************************/
+// Class definitions
+/******************************************************************************/
+//Plots the send and receive rates of the samples held in a speed test recorder
+class AutSpeedGraph : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit AutSpeedGraph(QWidget *parent = nullptr);
+    void set_recorder(AutSpeedRecorder *recorder);
+
+protected:
+    void paintEvent(QPaintEvent *event);
+
+private:
+    AutSpeedRecorder *recorder;
+};
+
+#endif // AUTSPEEDGRAPH_H
+
+/******************************************************************************/
+// END OF FILE
+/******************************************************************************/
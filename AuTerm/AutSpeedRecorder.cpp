@@ -0,0 +1,220 @@
+/******************************************************************************
+** Copyright (C) 2023 Jamie M.
+**
+** Project: AuTerm
+**
+** Module:  AutSpeedRecorder.cpp
+**
+** Notes:
+**
+** License: This program is free software: you can redistribute it and/or
+**          modify it under the terms of the GNU General Public License as
+**          published by the Free Software Foundation, version 3.
+**
+**          This program is distributed in the hope that it will be useful,
+**          but WITHOUT ANY WARRANTY; without even the implied warranty of
+**          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**          GNU General Public License for more details.
+**
+**          You should have received a copy of the GNU General Public License
+**          along with this program.  If not, see http://www.gnu.org/licenses/
+**
+*******************************************************************************/
+
+/******************************************************************************/
+// Include Files
+/******************************************************************************/
+#include "AutSpeedRecorder.h"
+#include <QJsonArray>
+#include <QJsonDocument>
+
+/******************************************************************************/
+// Local Functions or Private Members
+/******************************************************************************/
+
+//=============================================================================
+//=============================================================================
+AutSpeedRecorder::AutSpeedRecorder()
+{
+    set_capacity(SpeedRecorderDefaultCapacity);
+}
+
+//=============================================================================
+//=============================================================================
+void AutSpeedRecorder::set_capacity(int32_t capacity)
+{
+    samples.resize(capacity);
+    samples.squeeze();
+    clear();
+}
+
+//=============================================================================
+//=============================================================================
+void AutSpeedRecorder::clear()
+{
+    head = 0;
+    used = 0;
+    samples_overwritten = 0;
+}
+
+//=============================================================================
+//=============================================================================
+void AutSpeedRecorder::add(const AutSpeedSample &sample)
+{
+    if (samples.length() == 0)
+    {
+        return;
+    }
+
+    samples[head] = sample;
+    head = (head + 1) % samples.length();
+
+    if (used < samples.length())
+    {
+        ++used;
+    }
+    else
+    {
+        ++samples_overwritten;
+    }
+}
+
+//=============================================================================
+//=============================================================================
+int32_t AutSpeedRecorder::count()
+{
+    return used;
+}
+
+//=============================================================================
+//=============================================================================
+quint64 AutSpeedRecorder::overwritten()
+{
+    return samples_overwritten;
+}
+
+//=============================================================================
+//=============================================================================
+const AutSpeedSample *AutSpeedRecorder::at(int32_t index)
+{
+    //Index 0 is the oldest sample which is held
+    if (index < 0 || index >= used)
+    {
+        return nullptr;
+    }
+
+    return &samples.at((head - used + index + samples.length()) % samples.length());
+}
+
+//=============================================================================
+//=============================================================================
+bool AutSpeedRecorder::rate(int32_t index, quint64 AutSpeedSample::*counter, double *per_second)
+{
+    //Rate of change of a counter between a sample and the one before it
+    const AutSpeedSample *current = at(index);
+    const AutSpeedSample *previous = at(index - 1);
+
+    if (current == nullptr || previous == nullptr || current->elapsed_ms <= previous->elapsed_ms || current->*counter < previous->*counter)
+    {
+        return false;
+    }
+
+    *per_second = (double)(current->*counter - previous->*counter) * 1000.0 / (double)(current->elapsed_ms - previous->elapsed_ms);
+
+    return true;
+}
+
+//=============================================================================
+//=============================================================================
+QString AutSpeedRecorder::to_csv()
+{
+    QString output("elapsed_ms,bytes_sent,bytes_received,tx_bytes_per_second,rx_bytes_per_second,packets_sent,packets_received,packets_bad,bit_errors,probes_lost,buffer_bytes\r\n");
+    int32_t i = 0;
+
+    while (i < used)
+    {
+        const AutSpeedSample *sample = at(i);
+        double tx_rate = 0.0;
+        double rx_rate = 0.0;
+
+        rate(i, &AutSpeedSample::bytes_sent, &tx_rate);
+        rate(i, &AutSpeedSample::bytes_received, &rx_rate);
+        output.append(QString::number(sample->elapsed_ms)).append(",").append(QString::number(sample->bytes_sent)).append(",").append(QString::number(sample->bytes_received)).append(",").append(QString::number(tx_rate, 'f', 1)).append(",").append(QString::number(rx_rate, 'f', 1)).append(",").append(QString::number(sample->packets_sent)).append(",").append(QString::number(sample->packets_received)).append(",").append(QString::number(sample->packets_bad)).append(",").append(QString::number(sample->bit_errors)).append(",").append(QString::number(sample->probes_lost)).append(",").append(QString::number(sample->buffer_bytes)).append("\r\n");
+        ++i;
+    }
+
+    return output;
+}
+
+//=============================================================================
+//=============================================================================
+QByteArray AutSpeedRecorder::to_json(const QJsonObject &summary)
+{
+    QJsonObject root;
+    QJsonArray series;
+    int32_t i = 0;
+
+    while (i < used)
+    {
+        const AutSpeedSample *sample = at(i);
+        QJsonObject entry;
+        double tx_rate = 0.0;
+        double rx_rate = 0.0;
+
+        rate(i, &AutSpeedSample::bytes_sent, &tx_rate);
+        rate(i, &AutSpeedSample::bytes_received, &rx_rate);
+        entry.insert("elapsed_ms", sample->elapsed_ms);
+        entry.insert("bytes_sent", (qint64)sample->bytes_sent);
+        entry.insert("bytes_received", (qint64)sample->bytes_received);
+        entry.insert("tx_bytes_per_second", tx_rate);
+        entry.insert("rx_bytes_per_second", rx_rate);
+        entry.insert("packets_sent", (qint64)sample->packets_sent);
+        entry.insert("packets_received", (qint64)sample->packets_received);
+        entry.insert("packets_bad", (qint64)sample->packets_bad);
+        entry.insert("bit_errors", (qint64)sample->bit_errors);
+        entry.insert("probes_lost", (qint64)sample->probes_lost);
+        entry.insert("buffer_bytes", sample->buffer_bytes);
+        series.append(entry);
+        ++i;
+    }
+
+    root.insert("summary", summary);
+    root.insert("samples_overwritten", (qint64)samples_overwritten);
+    root.insert("samples", series);
+
+    return QJsonDocument(root).toJson(QJsonDocument::Indented);
+}
+
+//=============================================================================
+//=============================================================================
+QString AutSpeedRecorder::summary_to_csv(const QJsonObject &summary, QString prefix)
+{
+    //Outputs key,value rows, keys of nested objects are prefixed with the name of the object they are in
+    QString output;
+    QJsonObject::const_iterator entry = summary.constBegin();
+
+    if (prefix.isEmpty())
+    {
+        output.append("key,value\r\n");
+    }
+
+    while (entry != summary.constEnd())
+    {
+        if (entry.value().isObject())
+        {
+            output.append(summary_to_csv(entry.value().toObject(), QString(prefix).append(entry.key()).append(".")));
+        }
+        else
+        {
+            output.append(prefix).append(entry.key()).append(",").append(entry.value().toVariant().toString()).append("\r\n");
+        }
+
+        ++entry;
+    }
+
+    return output;
+}
+
+/******************************************************************************/
+// END OF FILE
+/******************************************************************************/
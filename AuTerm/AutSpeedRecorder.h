@@ -0,0 +1,85 @@
+/******************************************************************************
+** Copyright (C) 2023 Jamie M.
+**
+** Project: AuTerm
+**
+** Module:  AutSpeedRecorder.h
+**
+** Notes:
+**
+** License: This program is free software: you can redistribute it and/or
+**          modify it under the terms of the GNU General Public License as
+**          published by the Free Software Foundation, version 3.
+**
+**          This program is distributed in the hope that it will be useful,
+**          but WITHOUT ANY WARRANTY; without even the implied warranty of
+**          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**          GNU General Public License for more details.
+**
+**          You should have received a copy of the GNU General Public License
+**          along with this program.  If not, see http://www.gnu.org/licenses/
+**
+*******************************************************************************/
+#ifndef AUTSPEEDRECORDER_H
+#define AUTSPEEDRECORDER_H
+
+/******************************************************************************/
+// Include Files
+/******************************************************************************/
+#include <QByteArray>
+#include <QJsonObject>
+#include <QString>
+#include <QVector>
+
+/******************************************************************************/
+// Constants
+/******************************************************************************/
+const int32_t SpeedRecorderDefaultCapacity      = 7200; //Number of samples held before the oldest are overwritten (1 hour at the default update rate)
+
+/******************************************************************************/
+// Structures
+/******************************************************************************/
+//Counters are totals since the start of the test so that rates over any interval can be derived from two samples
+struct AutSpeedSample {
+    qint64 elapsed_ms;
+    quint64 bytes_sent;
+    quint64 bytes_received;
+    quint64 packets_sent;
+    quint64 packets_received;
+    quint64 packets_bad;
+    quint64 bit_errors;
+    quint64 probes_lost;
+    qint32 buffer_bytes;
+};
+
+/******************************************************************************/
+// Class definitions
+/******************************************************************************/
+//Fixed size ring buffer of speed test samples, storage is allocated up front so recording does not allocate during a test
+class AutSpeedRecorder
+{
+public:
+    AutSpeedRecorder();
+    void set_capacity(int32_t capacity);
+    void clear();
+    void add(const AutSpeedSample &sample);
+    int32_t count();
+    quint64 overwritten();
+    const AutSpeedSample *at(int32_t index);
+    bool rate(int32_t index, quint64 AutSpeedSample::*counter, double *per_second);
+    QString to_csv();
+    QByteArray to_json(const QJsonObject &summary);
+    static QString summary_to_csv(const QJsonObject &summary, QString prefix = "");
+
+private:
+    QVector<AutSpeedSample> samples;
+    int32_t head;
+    int32_t used;
+    quint64 samples_overwritten;
+};
+
+#endif // AUTSPEEDRECORDER_H
+
+/******************************************************************************/
+// END OF FILE
+/******************************************************************************/
@@ -0,0 +1,646 @@
+/******************************************************************************
+** Copyright (C) 2023 Jamie M.
+**
+** Project: AuTerm
+**
+** Module:  job_queue.cpp
+**
+** Notes:
+**
+** License: This program is free software: you can redistribute it and/or
+**          modify it under the terms of the GNU General Public License as
+**          published by the Free Software Foundation, version 3.
+**
+**          This program is distributed in the hope that it will be useful,
+**          but WITHOUT ANY WARRANTY; without even the implied warranty of
+**          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**          GNU General Public License for more details.
+**
+**          You should have received a copy of the GNU General Public License
+**          along with this program.  If not, see http://www.gnu.org/licenses/
+**
+*******************************************************************************/
+#include "job_queue.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QTextStream>
+#include <QProcess>
+
+//Progress weight of jobs which do not transfer a file, and of downloads as the size is not known until they start
+const uint64_t small_job_weight = 256;
+const uint64_t unknown_transfer_weight = 65536;
+
+static const struct {
+    const char *name;
+    job_type type;
+    uint8_t minimum_arguments;
+    uint8_t maximum_arguments;
+} job_names[] = {
+    {"img_upload", JOB_TYPE_IMG_UPLOAD, 2, 2},
+    {"img_test", JOB_TYPE_IMG_TEST, 1, 1},
+    {"img_confirm", JOB_TYPE_IMG_CONFIRM, 1, 1},
+    {"img_list", JOB_TYPE_IMG_LIST, 0, 0},
+    {"img_erase", JOB_TYPE_IMG_ERASE, 1, 1},
+    {"fs_upload", JOB_TYPE_FS_UPLOAD, 2, 3},
+    {"fs_download", JOB_TYPE_FS_DOWNLOAD, 2, 3},
+    {"fs_status", JOB_TYPE_FS_STATUS, 1, 1},
+    {"fs_hash", JOB_TYPE_FS_HASH, 1, 2},
+    {"echo", JOB_TYPE_OS_ECHO, 1, 255},
+    {"os_info", JOB_TYPE_OS_INFO, 0, 1},
+    {"reset", JOB_TYPE_OS_RESET, 0, 0},
+    {"wait", JOB_TYPE_WAIT, 1, 1},
+};
+
+#if QT_VERSION < QT_VERSION_CHECK(5, 15, 0)
+//QProcess::splitCommand() is not available, split the same way: arguments are separated by whitespace, double quotes
+//group arguments containing whitespace and triple quotes give a literal quote
+static QStringList split_command(QString command)
+{
+    QStringList arguments;
+    QString argument;
+    int quote_count = 0;
+    bool in_quote = false;
+    int i = 0;
+
+    while (i < command.length())
+    {
+        if (command.at(i) == '"')
+        {
+            ++quote_count;
+
+            if (quote_count == 3)
+            {
+                quote_count = 0;
+                argument += command.at(i);
+            }
+
+            ++i;
+            continue;
+        }
+
+        if (quote_count > 0)
+        {
+            if (quote_count == 1)
+            {
+                in_quote = !in_quote;
+            }
+
+            quote_count = 0;
+        }
+
+        if (in_quote == false && command.at(i).isSpace())
+        {
+            if (!argument.isEmpty())
+            {
+                arguments << argument;
+                argument.clear();
+            }
+        }
+        else
+        {
+            argument += command.at(i);
+        }
+
+        ++i;
+    }
+
+    if (!argument.isEmpty())
+    {
+        arguments << argument;
+    }
+
+    return arguments;
+}
+#endif
+
+job_queue::job_queue()
+{
+    clear();
+}
+
+void job_queue::clear()
+{
+    jobs.clear();
+    index = -1;
+    total_weight = 0;
+}
+
+bool job_queue::load(QString filename, QString *error)
+{
+    QFile file(filename);
+    uint32_t line_number = 0;
+
+    clear();
+
+    if (!file.open(QFile::ReadOnly | QFile::Text))
+    {
+        *error = file.errorString();
+        return false;
+    }
+
+    QTextStream stream(&file);
+
+    while (!stream.atEnd())
+    {
+        QString line = stream.readLine().trimmed();
+        job_t job;
+
+        ++line_number;
+
+        if (line.isEmpty() || line.at(0) == '#')
+        {
+            continue;
+        }
+
+        job.id = jobs.length() + 1;
+        job.line = line_number;
+        job.command = line;
+#if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)
+        job.arguments = QProcess::splitCommand(line);
+#else
+        job.arguments = split_command(line);
+#endif
+        job.weight = small_job_weight;
+        job.state = JOB_STATE_PENDING;
+        job.started_at = 0;
+        job.duration_ms = 0;
+
+        if (parse_job(&job, error) == false)
+        {
+            error->prepend(QString("Line %1: ").arg(QString::number(line_number)));
+            jobs.clear();
+            return false;
+        }
+
+        total_weight += job.weight;
+        jobs.append(job);
+    }
+
+    file.close();
+
+    if (jobs.isEmpty())
+    {
+        *error = "No jobs in file";
+        return false;
+    }
+
+    return true;
+}
+
+//Checks the job type and arguments, removing the job name and dependencies from the argument list
+bool job_queue::parse_job(job_t *job, QString *error)
+{
+    QString name;
+    uint8_t i = 0;
+    bool found = false;
+    bool converted = false;
+
+    if (job->arguments.isEmpty())
+    {
+        *error = "Missing job name";
+        return false;
+    }
+
+    name = job->arguments.takeFirst();
+
+    //Dependencies can only be on earlier jobs, which means there cannot be any loops
+    while (!job->arguments.isEmpty() && job->arguments.last().startsWith("after="))
+    {
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+        QStringList ids = job->arguments.takeLast().mid(6).split(',', Qt::SkipEmptyParts);
+#else
+        QStringList ids = job->arguments.takeLast().mid(6).split(',', QString::SkipEmptyParts);
+#endif
+
+        while (!ids.isEmpty())
+        {
+            uint16_t id = ids.takeFirst().toUShort(&converted);
+
+            if (converted == false || id == 0 || id >= job->id)
+            {
+                *error = "Dependencies must be on earlier jobs";
+                return false;
+            }
+
+            job->depends_on.append(id);
+        }
+    }
+
+    while (i < (sizeof(job_names) / sizeof(job_names[0])))
+    {
+        if (name == job_names[i].name)
+        {
+            found = true;
+            break;
+        }
+
+        ++i;
+    }
+
+    if (found == false)
+    {
+        *error = QString("Unknown job \"").append(name).append("\"");
+        return false;
+    }
+
+    job->type = job_names[i].type;
+
+    if (job->arguments.length() < job_names[i].minimum_arguments || job->arguments.length() > job_names[i].maximum_arguments)
+    {
+        *error = QString("Invalid number of arguments for ").append(name);
+        return false;
+    }
+
+    switch (job->type)
+    {
+        case JOB_TYPE_IMG_UPLOAD:
+        {
+            QFileInfo file_info(job->arguments.at(1));
+
+            if (job->arguments.at(0).toUShort(&converted) > 255 || converted == false)
+            {
+                *error = "Invalid image number";
+                return false;
+            }
+
+            if (file_info.exists() == false)
+            {
+                *error = QString("File does not exist: ").append(job->arguments.at(1));
+                return false;
+            }
+
+            job->weight = file_info.size();
+            break;
+        }
+
+        case JOB_TYPE_IMG_TEST:
+        case JOB_TYPE_IMG_CONFIRM:
+        {
+            if (job->arguments.at(0).startsWith('@'))
+            {
+                //Use the hash of an image uploaded by an earlier job
+                uint16_t id = job->arguments.at(0).mid(1).toUShort(&converted);
+
+                if (converted == false || id == 0 || id >= job->id || jobs.at(id - 1).type != JOB_TYPE_IMG_UPLOAD)
+                {
+                    *error = "Image hash must refer to an earlier img_upload job";
+                    return false;
+                }
+
+                if (!job->depends_on.contains(id))
+                {
+                    job->depends_on.append(id);
+                }
+            }
+            else
+            {
+                job->hash = QByteArray::fromHex(job->arguments.at(0).toLatin1());
+
+                if (job->hash.length() != 32)
+                {
+                    *error = "Image hash must be 32 bytes";
+                    return false;
+                }
+            }
+
+            break;
+        }
+
+        case JOB_TYPE_IMG_ERASE:
+        {
+            if (job->arguments.at(0).toUShort(&converted) > 255 || converted == false)
+            {
+                *error = "Invalid slot number";
+                return false;
+            }
+
+            break;
+        }
+
+        case JOB_TYPE_FS_UPLOAD:
+        {
+            QFileInfo file_info(job->arguments.at(0));
+
+            if (file_info.exists() == false)
+            {
+                *error = QString("File does not exist: ").append(job->arguments.at(0));
+                return false;
+            }
+
+            job->weight = file_info.size();
+            break;
+        }
+
+        case JOB_TYPE_FS_DOWNLOAD:
+        {
+            job->weight = unknown_transfer_weight;
+            break;
+        }
+
+        case JOB_TYPE_WAIT:
+        {
+            if (job->arguments.at(0).toUInt(&converted) == 0 || converted == false)
+            {
+                *error = "Invalid wait time";
+                return false;
+            }
+
+            break;
+        }
+
+        default:
+        {
+        }
+    }
+
+    return true;
+}
+
+uint16_t job_queue::job_count()
+{
+    return jobs.length();
+}
+
+job_t *job_queue::current()
+{
+    if (index < 0 || index >= jobs.length())
+    {
+        return nullptr;
+    }
+
+    return &jobs[index];
+}
+
+job_t *job_queue::find(uint16_t id)
+{
+    if (id == 0 || id > jobs.length())
+    {
+        return nullptr;
+    }
+
+    return &jobs[id - 1];
+}
+
+bool job_queue::dependencies_done(const job_t *job, bool *dependency_failed)
+{
+    uint16_t i = 0;
+    bool done = true;
+
+    *dependency_failed = false;
+
+    while (i < job->depends_on.length())
+    {
+        job_state state = jobs.at(job->depends_on.at(i) - 1).state;
+
+        if (state != JOB_STATE_DONE)
+        {
+            done = false;
+
+            if (state != JOB_STATE_PENDING && state != JOB_STATE_RUNNING)
+            {
+                *dependency_failed = true;
+            }
+        }
+
+        ++i;
+    }
+
+    return done;
+}
+
+//A job can run before an earlier job only if the earlier job is a transfer which neither the job depends on nor uses the
+//same image or file as, jobs which change the state of the device are never passed
+bool job_queue::can_pass(const job_t *job, const job_t *earlier)
+{
+    return (is_bulk(earlier->type) == true && resource(job) != resource(earlier) && !job->depends_on.contains(earlier->id));
+}
+
+bool job_queue::is_bulk(job_type type)
+{
+    return (type == JOB_TYPE_IMG_UPLOAD || type == JOB_TYPE_FS_UPLOAD || type == JOB_TYPE_FS_DOWNLOAD);
+}
+
+bool job_queue::is_read_only(job_type type)
+{
+    return (type == JOB_TYPE_IMG_LIST || type == JOB_TYPE_FS_STATUS || type == JOB_TYPE_FS_HASH || type == JOB_TYPE_OS_ECHO || type == JOB_TYPE_OS_INFO);
+}
+
+//Device state used by a job, all image jobs share the image state
+QString job_queue::resource(const job_t *job)
+{
+    switch (job->type)
+    {
+        case JOB_TYPE_IMG_UPLOAD:
+        case JOB_TYPE_IMG_TEST:
+        case JOB_TYPE_IMG_CONFIRM:
+        case JOB_TYPE_IMG_LIST:
+        case JOB_TYPE_IMG_ERASE:
+        {
+            return "img";
+        }
+
+        case JOB_TYPE_FS_UPLOAD:
+        {
+            return QString("fs:").append(job->arguments.at(1));
+        }
+
+        case JOB_TYPE_FS_DOWNLOAD:
+        case JOB_TYPE_FS_STATUS:
+        case JOB_TYPE_FS_HASH:
+        {
+            return QString("fs:").append(job->arguments.at(0));
+        }
+
+        default:
+        {
+            return QString();
+        }
+    }
+}
+
+//Selects the next job to run and marks it as running, returns nullptr when there are no more jobs which can be run.
+//Jobs whose dependencies did not complete are skipped
+job_t *job_queue::next(qint64 timestamp_ms, bool reorder)
+{
+    int32_t first = -1;
+    int32_t selected = -1;
+    int32_t i = 0;
+
+    while (i < jobs.length())
+    {
+        job_t *job = &jobs[i];
+        bool dependency_failed = false;
+
+        if (job->state == JOB_STATE_PENDING)
+        {
+            bool done = dependencies_done(job, &dependency_failed);
+
+            if (dependency_failed == true)
+            {
+                job->state = JOB_STATE_SKIPPED;
+                job->result = "Dependency did not complete";
+            }
+            else if (first == -1)
+            {
+                //All earlier jobs have finished so the dependencies of the first pending job are always complete
+                first = i;
+
+                if (reorder == false || is_bulk(job->type) == false)
+                {
+                    break;
+                }
+            }
+            else if (done == true && is_read_only(job->type) == true)
+            {
+                int32_t l = first;
+
+                while (l < i)
+                {
+                    if (jobs.at(l).state == JOB_STATE_PENDING && can_pass(job, &jobs.at(l)) == false)
+                    {
+                        break;
+                    }
+
+                    ++l;
+                }
+
+                if (l == i)
+                {
+                    selected = i;
+                    break;
+                }
+            }
+        }
+
+        ++i;
+    }
+
+    if (selected == -1)
+    {
+        selected = first;
+    }
+
+    if (selected == -1)
+    {
+        index = -1;
+        return nullptr;
+    }
+
+    index = selected;
+    jobs[index].state = JOB_STATE_RUNNING;
+    jobs[index].started_at = timestamp_ms;
+
+    return &jobs[index];
+}
+
+void job_queue::set_result(qint64 timestamp_ms, job_state state, QString result)
+{
+    job_t *job = current();
+
+    if (job == nullptr)
+    {
+        return;
+    }
+
+    job->state = state;
+    job->result = result;
+    job->duration_ms = timestamp_ms - job->started_at;
+}
+
+uint16_t job_queue::count_state(job_state state)
+{
+    uint16_t count = 0;
+    uint16_t i = 0;
+
+    while (i < jobs.length())
+    {
+        if (jobs.at(i).state == state)
+        {
+            ++count;
+        }
+
+        ++i;
+    }
+
+    return count;
+}
+
+//Overall progress of the queue, each job counts by its size so that file transfers make up most of the progress
+uint8_t job_queue::progress(uint8_t current_percent)
+{
+    uint64_t done_weight = 0;
+    uint16_t i = 0;
+
+    if (total_weight == 0)
+    {
+        return 0;
+    }
+
+    while (i < jobs.length())
+    {
+        if (jobs.at(i).state == JOB_STATE_RUNNING)
+        {
+            done_weight += jobs.at(i).weight * current_percent / 100;
+        }
+        else if (jobs.at(i).state != JOB_STATE_PENDING)
+        {
+            done_weight += jobs.at(i).weight;
+        }
+
+        ++i;
+    }
+
+    return (uint8_t)(done_weight * 100 / total_weight);
+}
+
+QString job_queue::describe(const job_t *job)
+{
+    QString text = QString("[%1] %2: %3").arg(QString::number(job->id), job->command, state_to_string(job->state));
+
+    if (job->state != JOB_STATE_PENDING && job->state != JOB_STATE_SKIPPED)
+    {
+        text.append(QString(" (%1 ms)").arg(QString::number(job->duration_ms)));
+    }
+
+    if (!job->result.isEmpty())
+    {
+        text.append(": ").append(job->result);
+    }
+
+    return text;
+}
+
+QString job_queue::state_to_string(job_state state)
+{
+    switch (state)
+    {
+        case JOB_STATE_PENDING:
+        {
+            return "not run";
+        }
+        case JOB_STATE_RUNNING:
+        {
+            return "running";
+        }
+        case JOB_STATE_DONE:
+        {
+            return "done";
+        }
+        case JOB_STATE_FAILED:
+        {
+            return "failed";
+        }
+        case JOB_STATE_SKIPPED:
+        {
+            return "skipped";
+        }
+        case JOB_STATE_CANCELLED:
+        {
+            return "cancelled";
+        }
+        default:
+        {
+            return "unknown";
+        }
+    };
+}
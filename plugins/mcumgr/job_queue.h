@@ -0,0 +1,105 @@
+/******************************************************************************
+** Copyright (C) 2023 Jamie M.
+**
+** Project: AuTerm
+**
+** Module:  job_queue.h
+**
+** Notes:
+**
+** License: This program is free software: you can redistribute it and/or
+**          modify it under the terms of the GNU General Public License as
+**          published by the Free Software Foundation, version 3.
+**
+**          This program is distributed in the hope that it will be useful,
+**          but WITHOUT ANY WARRANTY; without even the implied warranty of
+**          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**          GNU General Public License for more details.
+**
+**          You should have received a copy of the GNU General Public License
+**          along with this program.  If not, see http://www.gnu.org/licenses/
+**
+*******************************************************************************/
+#ifndef JOB_QUEUE_H
+#define JOB_QUEUE_H
+
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QList>
+
+enum job_type : uint8_t {
+    JOB_TYPE_IMG_UPLOAD = 0,
+    JOB_TYPE_IMG_TEST,
+    JOB_TYPE_IMG_CONFIRM,
+    JOB_TYPE_IMG_LIST,
+    JOB_TYPE_IMG_ERASE,
+    JOB_TYPE_FS_UPLOAD,
+    JOB_TYPE_FS_DOWNLOAD,
+    JOB_TYPE_FS_STATUS,
+    JOB_TYPE_FS_HASH,
+    JOB_TYPE_OS_ECHO,
+    JOB_TYPE_OS_INFO,
+    JOB_TYPE_OS_RESET,
+    JOB_TYPE_WAIT,
+};
+
+enum job_state : uint8_t {
+    JOB_STATE_PENDING = 0,
+    JOB_STATE_RUNNING,
+    JOB_STATE_DONE,
+    JOB_STATE_FAILED,
+    JOB_STATE_SKIPPED,
+    JOB_STATE_CANCELLED,
+};
+
+//A single job of a job file, jobs are numbered from 1 in the order they appear in the file
+struct job_t {
+    uint16_t id;
+    uint32_t line;
+    QString command;
+    job_type type;
+    QStringList arguments;
+    QList<uint16_t> depends_on;
+    uint64_t weight;
+    job_state state;
+    QByteArray hash;
+    QString result;
+    qint64 started_at;
+    qint64 duration_ms;
+};
+
+//List of SMP jobs loaded from a file and run back to back. Each line is "<job> [arguments...] [after=<id>[,<id>...]]",
+//lines starting with # are comments. Image test/confirm jobs can use "@<id>" in place of a hash to use the hash of the
+//image uploaded by an earlier job. When reordering is enabled, small read-only jobs are run ahead of earlier file
+//transfers if they do not depend on them and do not use the same image or file
+class job_queue
+{
+public:
+    job_queue();
+    void clear();
+    bool load(QString filename, QString *error);
+    uint16_t job_count();
+    job_t *current();
+    job_t *next(qint64 timestamp_ms, bool reorder);
+    void set_result(qint64 timestamp_ms, job_state state, QString result);
+    uint16_t count_state(job_state state);
+    uint8_t progress(uint8_t current_percent);
+    QString describe(const job_t *job);
+    job_t *find(uint16_t id);
+
+private:
+    bool parse_job(job_t *job, QString *error);
+    bool dependencies_done(const job_t *job, bool *dependency_failed);
+    bool can_pass(const job_t *job, const job_t *earlier);
+    static bool is_bulk(job_type type);
+    static bool is_read_only(job_type type);
+    QString resource(const job_t *job);
+    QString state_to_string(job_state state);
+
+    QList<job_t> jobs;
+    int32_t index;
+    uint64_t total_weight;
+};
+
+#endif // JOB_QUEUE_H
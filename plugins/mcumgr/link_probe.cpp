@@ -0,0 +1,229 @@
+/******************************************************************************
+** Copyright (C) 2023 Jamie M.
+**
+** Project: AuTerm
+**
+** Module:  link_probe.cpp
+**
+** Notes:
+**
+** License: This program is free software: you can redistribute it and/or
+**          modify it under the terms of the GNU General Public License as
+**          published by the Free Software Foundation, version 3.
+**
+**          This program is distributed in the hope that it will be useful,
+**          but WITHOUT ANY WARRANTY; without even the implied warranty of
+**          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**          GNU General Public License for more details.
+**
+**          You should have received a copy of the GNU General Public License
+**          along with this program.  If not, see http://www.gnu.org/licenses/
+**
+*******************************************************************************/
+#include "link_probe.h"
+
+link_probe::link_probe()
+{
+    payload_minimum = 16;
+    payload_maximum = 16;
+    payload_step = 0;
+    clear();
+}
+
+void link_probe::clear()
+{
+    payload_current = payload_minimum;
+    count_sent = 0;
+    count_received = 0;
+    rtt_last_us = 0;
+    rtt_min_us = 0;
+    rtt_max_us = 0;
+    rtt_total_us = 0;
+    jitter_us = 0.0;
+    jitter_valid = false;
+    payload_last = 0;
+    payload_largest = 0;
+    payload_smallest_failed = 0;
+}
+
+void link_probe::set_payload_range(uint16_t minimum, uint16_t maximum, uint16_t step)
+{
+    payload_minimum = (minimum == 0 ? 1 : minimum);
+    payload_maximum = (maximum < payload_minimum ? payload_minimum : maximum);
+    payload_step = step;
+    payload_current = payload_minimum;
+}
+
+//Size of the payload to use for the next echo request
+uint16_t link_probe::payload_size()
+{
+    return payload_current;
+}
+
+void link_probe::add_result(bool success, qint64 rtt_us)
+{
+    ++count_sent;
+
+    if (success == true)
+    {
+        ++count_received;
+
+        if (count_received == 1 || rtt_us < rtt_min_us)
+        {
+            rtt_min_us = rtt_us;
+        }
+
+        if (rtt_us > rtt_max_us)
+        {
+            rtt_max_us = rtt_us;
+        }
+
+        rtt_total_us += rtt_us;
+
+        //Jitter is only calculated between requests of the same size as the round trip time depends upon the payload size
+        if (payload_last == payload_current)
+        {
+            qint64 difference = rtt_us - rtt_last_us;
+
+            if (difference < 0)
+            {
+                difference = -difference;
+            }
+
+            //Smoothed inter-arrival jitter as per RFC 3550
+            if (jitter_valid == false)
+            {
+                jitter_us = (double)difference;
+                jitter_valid = true;
+            }
+            else
+            {
+                jitter_us += ((double)difference - jitter_us) / 16.0;
+            }
+        }
+
+        rtt_last_us = rtt_us;
+        payload_last = payload_current;
+
+        if (payload_current > payload_largest)
+        {
+            payload_largest = payload_current;
+        }
+
+        if (payload_current >= payload_smallest_failed && payload_smallest_failed != 0)
+        {
+            //A size which failed before now works, the earlier failure was likely due to loss rather than size
+            payload_smallest_failed = 0;
+        }
+
+        if (payload_step == 0)
+        {
+            return;
+        }
+
+        if (payload_current >= payload_maximum)
+        {
+            payload_current = payload_minimum;
+        }
+        else if ((uint32_t)payload_current + payload_step > payload_maximum)
+        {
+            payload_current = payload_maximum;
+        }
+        else
+        {
+            payload_current += payload_step;
+        }
+    }
+    else
+    {
+        payload_last = 0;
+
+        if (payload_current > payload_minimum && (payload_smallest_failed == 0 || payload_current < payload_smallest_failed))
+        {
+            payload_smallest_failed = payload_current;
+        }
+
+        payload_current = payload_minimum;
+    }
+}
+
+uint32_t link_probe::sent()
+{
+    return count_sent;
+}
+
+uint32_t link_probe::received()
+{
+    return count_received;
+}
+
+uint32_t link_probe::lost()
+{
+    return count_sent - count_received;
+}
+
+double link_probe::loss_percent()
+{
+    if (count_sent == 0)
+    {
+        return 0.0;
+    }
+
+    return (double)lost() * 100.0 / (double)count_sent;
+}
+
+double link_probe::rtt_last_ms()
+{
+    return (double)rtt_last_us / 1000.0;
+}
+
+double link_probe::rtt_min_ms()
+{
+    return (double)rtt_min_us / 1000.0;
+}
+
+double link_probe::rtt_average_ms()
+{
+    if (count_received == 0)
+    {
+        return 0.0;
+    }
+
+    return (double)rtt_total_us / (double)count_received / 1000.0;
+}
+
+double link_probe::rtt_max_ms()
+{
+    return (double)rtt_max_us / 1000.0;
+}
+
+double link_probe::jitter_ms()
+{
+    return jitter_us / 1000.0;
+}
+
+uint16_t link_probe::largest_payload()
+{
+    return payload_largest;
+}
+
+//Smallest payload size which has failed and not later succeeded, 0 if none
+uint16_t link_probe::smallest_failed_payload()
+{
+    return payload_smallest_failed;
+}
+
+QString link_probe::summary()
+{
+    QString text = QString("Sent: %1, received: %2, lost: %3 (%4%)\n").arg(QString::number(count_sent), QString::number(count_received), QString::number(lost()), QString::number(loss_percent(), 'f', 1));
+
+    text.append(QString("RTT last/min/avg/max: %1/%2/%3/%4 ms, jitter: %5 ms\n").arg(QString::number(rtt_last_ms(), 'f', 1), QString::number(rtt_min_ms(), 'f', 1), QString::number(rtt_average_ms(), 'f', 1), QString::number(rtt_max_ms(), 'f', 1), QString::number(jitter_ms(), 'f', 2)));
+    text.append(QString("Largest working payload: %1 bytes").arg(QString::number(payload_largest)));
+
+    if (payload_smallest_failed != 0)
+    {
+        text.append(QString(", smallest failed: %1 bytes").arg(QString::number(payload_smallest_failed)));
+    }
+
+    return text;
+}
@@ -0,0 +1,69 @@
+/******************************************************************************
+** Copyright (C) 2023 Jamie M.
+**
+** Project: AuTerm
+**
+** Module:  link_probe.h
+**
+** Notes:
+**
+** License: This program is free software: you can redistribute it and/or
+**          modify it under the terms of the GNU General Public License as
+**          published by the Free Software Foundation, version 3.
+**
+**          This program is distributed in the hope that it will be useful,
+**          but WITHOUT ANY WARRANTY; without even the implied warranty of
+**          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**          GNU General Public License for more details.
+**
+**          You should have received a copy of the GNU General Public License
+**          along with this program.  If not, see http://www.gnu.org/licenses/
+**
+*******************************************************************************/
+#ifndef LINK_PROBE_H
+#define LINK_PROBE_H
+
+#include <QString>
+
+//Statistics of echo requests used to measure the quality of the SMP link. Payload sizes are swept from the minimum to the
+//maximum size in steps, restarting from the minimum after reaching the maximum or after a failure, to find the largest payload which works
+class link_probe
+{
+public:
+    link_probe();
+    void clear();
+    void set_payload_range(uint16_t minimum, uint16_t maximum, uint16_t step);
+    uint16_t payload_size();
+    void add_result(bool success, qint64 rtt_us);
+    uint32_t sent();
+    uint32_t received();
+    uint32_t lost();
+    double loss_percent();
+    double rtt_last_ms();
+    double rtt_min_ms();
+    double rtt_average_ms();
+    double rtt_max_ms();
+    double jitter_ms();
+    uint16_t largest_payload();
+    uint16_t smallest_failed_payload();
+    QString summary();
+
+private:
+    uint16_t payload_minimum;
+    uint16_t payload_maximum;
+    uint16_t payload_step;
+    uint16_t payload_current;
+    uint32_t count_sent;
+    uint32_t count_received;
+    qint64 rtt_last_us;
+    qint64 rtt_min_us;
+    qint64 rtt_max_us;
+    qint64 rtt_total_us;
+    double jitter_us;
+    bool jitter_valid;
+    uint16_t payload_last;
+    uint16_t payload_largest;
+    uint16_t payload_smallest_failed;
+};
+
+#endif // LINK_PROBE_H
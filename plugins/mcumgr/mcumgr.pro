@@ -17,10 +17,16 @@ TARGET          = $$qtLibraryTarget(plugin_mcumgr)
 SOURCES += \
     ../../AuTerm/AutScrollEdit.cpp \
     ../../AuTerm/AutEscape.cpp \
-    crc16.cpp \
+    ../../AuTerm/AutCrc.cpp \
     debug_logger.cpp \
     error_lookup.cpp \
+    job_queue.cpp \
+    link_probe.cpp \
+    mtu_discovery.cpp \
     plugin_mcumgr.cpp \
+    settings_snapshot.cpp \
+    shell_batch.cpp \
+    smp_cbor_index.cpp \
     smp_error.cpp \
     smp_group_fs_mgmt.cpp \
     smp_group_os_mgmt.cpp \
@@ -30,17 +36,27 @@ SOURCES += \
     smp_group_zephyr_mgmt.cpp \
     smp_message.cpp \
     smp_processor.cpp \
+    smp_reconnect.cpp \
     smp_uart.cpp \
+    stat_graph.cpp \
+    stat_sampler.cpp \
+    task_profiler.cpp \
     smp_group_img_mgmt.cpp
 
 HEADERS += \
     ../../AuTerm/AutPlugin.h \
     ../../AuTerm/AutScrollEdit.h \
     ../../AuTerm/AutEscape.h \
-    crc16.h \
+    ../../AuTerm/AutCrc.h \
     debug_logger.h \
     error_lookup.h \
+    job_queue.h \
+    link_probe.h \
+    mtu_discovery.h \
     plugin_mcumgr.h \
+    settings_snapshot.h \
+    shell_batch.h \
+    smp_cbor_index.h \
     smp_error.h \
     smp_group_array.h \
     smp_group_fs_mgmt.h \
@@ -51,8 +67,12 @@ HEADERS += \
     smp_group_zephyr_mgmt.h \
     smp_message.h \
     smp_processor.h \
+    smp_reconnect.h \
     smp_transport.h \
     smp_uart.h \
+    stat_graph.h \
+    stat_sampler.h \
+    task_profiler.h \
     smp_group.h \
     smp_group_img_mgmt.h
 
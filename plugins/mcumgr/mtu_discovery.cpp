@@ -0,0 +1,196 @@
+/******************************************************************************
+** Copyright (C) 2023 Jamie M.
+**
+** Project: AuTerm
+**
+** Module:  mtu_discovery.cpp
+**
+** Notes:
+**
+** License: This program is free software: you can redistribute it and/or
+**          modify it under the terms of the GNU General Public License as
+**          published by the Free Software Foundation, version 3.
+**
+**          This program is distributed in the hope that it will be useful,
+**          but WITHOUT ANY WARRANTY; without even the implied warranty of
+**          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**          GNU General Public License for more details.
+**
+**          You should have received a copy of the GNU General Public License
+**          along with this program.  If not, see http://www.gnu.org/licenses/
+**
+*******************************************************************************/
+#include "mtu_discovery.h"
+
+//Limits of the MTU which can be set in the plugin
+const uint16_t mtu_minimum = 32;
+const uint16_t mtu_maximum = 8192;
+
+//Size of an echo request or response which is not the echoed string: SMP header, CBOR map, "d" key and string header
+const uint16_t echo_overhead = 8 + 1 + 2 + 3;
+
+//Search stops when the largest working and smallest failed sizes are this close
+const uint16_t search_resolution = 8;
+
+mtu_discovery::mtu_discovery()
+{
+    clear(mtu_minimum);
+}
+
+void mtu_discovery::clear(uint16_t current_mtu)
+{
+    mtu_current = current_mtu;
+    buffer_size = 0;
+    buffer_count = 0;
+    transport_mtu = 0;
+    search_worked = 0;
+    search_failed = 0;
+    search_size = 0;
+    search_attempts = 0;
+    search_active = false;
+    search_done = false;
+}
+
+void mtu_discovery::set_buffer_parameters(uint32_t buffer_size, uint32_t buffer_count)
+{
+    this->buffer_size = buffer_size;
+    this->buffer_count = buffer_count;
+}
+
+void mtu_discovery::set_transport_mtu(uint16_t mtu)
+{
+    transport_mtu = mtu;
+}
+
+//Starts a search from the device buffer size (or the largest supported size if the device did not report it) downwards,
+//the largest size is tried first as it is expected to work in most cases, which then needs only a single echo
+void mtu_discovery::start_search()
+{
+    uint32_t maximum = (buffer_size > 0 ? buffer_size : mtu_maximum);
+
+    if (maximum > mtu_maximum)
+    {
+        maximum = mtu_maximum;
+    }
+    else if (maximum < mtu_minimum)
+    {
+        maximum = mtu_minimum;
+    }
+
+    search_worked = 0;
+    search_failed = maximum + 1;
+    search_size = maximum;
+    search_attempts = 0;
+    search_active = true;
+    search_done = false;
+}
+
+bool mtu_discovery::searching()
+{
+    return search_active;
+}
+
+//SMP message size currently being tried
+uint16_t mtu_discovery::message_size()
+{
+    return search_size;
+}
+
+//Size of the echo string which gives a message of the size being tried
+uint16_t mtu_discovery::payload_size()
+{
+    return (search_size > echo_overhead ? search_size - echo_overhead : 1);
+}
+
+void mtu_discovery::add_result(bool success)
+{
+    if (search_active == false)
+    {
+        return;
+    }
+
+    ++search_attempts;
+
+    if (success == true)
+    {
+        search_worked = search_size;
+    }
+    else
+    {
+        search_failed = search_size;
+    }
+
+    if ((search_failed - search_worked) <= search_resolution || search_failed <= mtu_minimum)
+    {
+        search_active = false;
+        search_done = true;
+        return;
+    }
+
+    search_size = search_worked + (search_failed - search_worked) / 2;
+
+    if (search_size < mtu_minimum)
+    {
+        search_size = mtu_minimum;
+    }
+}
+
+//MTU to use, the largest size which round-tripped if a search was performed, otherwise the device buffer size if it was
+//reported, otherwise the MTU in use before discovery
+uint16_t mtu_discovery::result()
+{
+    uint32_t mtu = mtu_current;
+
+    if (search_done == true && search_worked > 0)
+    {
+        mtu = search_worked;
+    }
+    else if (search_done == false && buffer_size > 0)
+    {
+        mtu = buffer_size;
+    }
+
+    if (mtu > mtu_maximum)
+    {
+        mtu = mtu_maximum;
+    }
+    else if (mtu < mtu_minimum)
+    {
+        mtu = mtu_minimum;
+    }
+
+    return mtu;
+}
+
+QString mtu_discovery::summary()
+{
+    QString text = QString("MTU: ").append(QString::number(result()));
+
+    if (buffer_size > 0)
+    {
+        text.append(QString(", device buffers: %1 x %2").arg(QString::number(buffer_count), QString::number(buffer_size)));
+    }
+    else
+    {
+        text.append(", device buffers: unknown");
+    }
+
+    if (transport_mtu > 0)
+    {
+        text.append(", link MTU: ").append(QString::number(transport_mtu));
+    }
+
+    if (search_done == true)
+    {
+        if (search_worked > 0)
+        {
+            text.append(QString(", %1 echoes").arg(QString::number(search_attempts)));
+        }
+        else
+        {
+            text.append(", no echo succeeded");
+        }
+    }
+
+    return text;
+}
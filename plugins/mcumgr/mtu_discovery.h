@@ -0,0 +1,58 @@
+/******************************************************************************
+** Copyright (C) 2023 Jamie M.
+**
+** Project: AuTerm
+**
+** Module:  mtu_discovery.h
+**
+** Notes:
+**
+** License: This program is free software: you can redistribute it and/or
+**          modify it under the terms of the GNU General Public License as
+**          published by the Free Software Foundation, version 3.
+**
+**          This program is distributed in the hope that it will be useful,
+**          but WITHOUT ANY WARRANTY; without even the implied warranty of
+**          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**          GNU General Public License for more details.
+**
+**          You should have received a copy of the GNU General Public License
+**          along with this program.  If not, see http://www.gnu.org/licenses/
+**
+*******************************************************************************/
+#ifndef MTU_DISCOVERY_H
+#define MTU_DISCOVERY_H
+
+#include <QString>
+
+//Works out the largest SMP message size to use with a device. The MCUmgr buffer size reported by the device is used as the
+//upper limit, on transports which cannot split messages the largest size is then found by a binary search of echo requests
+class mtu_discovery
+{
+public:
+    mtu_discovery();
+    void clear(uint16_t current_mtu);
+    void set_buffer_parameters(uint32_t buffer_size, uint32_t buffer_count);
+    void set_transport_mtu(uint16_t mtu);
+    void start_search();
+    bool searching();
+    uint16_t message_size();
+    uint16_t payload_size();
+    void add_result(bool success);
+    uint16_t result();
+    QString summary();
+
+private:
+    uint16_t mtu_current;
+    uint32_t buffer_size;
+    uint32_t buffer_count;
+    uint16_t transport_mtu;
+    uint16_t search_worked;
+    uint16_t search_failed;
+    uint16_t search_size;
+    uint16_t search_attempts;
+    bool search_active;
+    bool search_done;
+};
+
+#endif // MTU_DISCOVERY_H
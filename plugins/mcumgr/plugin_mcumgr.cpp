@@ -51,6 +51,8 @@ void plugin_mcumgr::setup(QMainWindow *main_window)
 
     //Initialise SMP-related objects
     processor = new smp_processor(this);
+    reconnect_transport = new smp_reconnect(this);
+    processor->set_reconnect(reconnect_transport);
     smp_groups.fs_mgmt = new smp_group_fs_mgmt(processor);
     smp_groups.img_mgmt = new smp_group_img_mgmt(processor);
     smp_groups.os_mgmt = new smp_group_os_mgmt(processor);
@@ -58,6 +60,7 @@ void plugin_mcumgr::setup(QMainWindow *main_window)
     smp_groups.shell_mgmt = new smp_group_shell_mgmt(processor);
     smp_groups.stat_mgmt = new smp_group_stat_mgmt(processor);
     smp_groups.zephyr_mgmt = new smp_group_zephyr_mgmt(processor);
+    smp_groups.img_mgmt->set_image_cache(&image_cache);
     error_lookup_form = new error_lookup(parent_window, &smp_groups);
 
 #ifndef SKIPPLUGIN_LOGGER
@@ -67,6 +70,7 @@ void plugin_mcumgr::setup(QMainWindow *main_window)
     //Set defaults
     mode = ACTION_IDLE;
     uart_transport_locked = false;
+    uart_reconnecting = false;
     parent_row = -1;
     parent_column = -1;
     child_row = -1;
@@ -102,6 +106,21 @@ void plugin_mcumgr::setup(QMainWindow *main_window)
 
     horizontalLayout_7->addWidget(edit_MTU);
 
+    check_MTU_Auto = new QCheckBox(tab);
+    check_MTU_Auto->setObjectName("check_MTU_Auto");
+
+    horizontalLayout_7->addWidget(check_MTU_Auto);
+
+    btn_MTU_Discover = new QPushButton(tab);
+    btn_MTU_Discover->setObjectName("btn_MTU_Discover");
+
+    horizontalLayout_7->addWidget(btn_MTU_Discover);
+
+    check_Transport_Reconnect = new QCheckBox(tab);
+    check_Transport_Reconnect->setObjectName("check_Transport_Reconnect");
+
+    horizontalLayout_7->addWidget(check_Transport_Reconnect);
+
     check_V2_Protocol = new QCheckBox(tab);
     check_V2_Protocol->setObjectName("check_V2_Protocol");
     check_V2_Protocol->setChecked(true);
@@ -173,7 +192,27 @@ void plugin_mcumgr::setup(QMainWindow *main_window)
     label_6 = new QLabel(tab_IMG_Upload);
     label_6->setObjectName("label_6");
 
-    gridLayout_4->addWidget(label_6, 3, 0, 1, 1);
+    gridLayout_4->addWidget(label_6, 5, 0, 1, 1);
+
+    label_IMG_Skip = new QLabel(tab_IMG_Upload);
+    label_IMG_Skip->setObjectName("label_IMG_Skip");
+
+    gridLayout_4->addWidget(label_IMG_Skip, 3, 0, 1, 1);
+
+    check_IMG_Skip_Present = new QCheckBox(tab_IMG_Upload);
+    check_IMG_Skip_Present->setObjectName("check_IMG_Skip_Present");
+
+    gridLayout_4->addWidget(check_IMG_Skip_Present, 3, 1, 1, 1);
+
+    label_IMG_Upgrade = new QLabel(tab_IMG_Upload);
+    label_IMG_Upgrade->setObjectName("label_IMG_Upgrade");
+
+    gridLayout_4->addWidget(label_IMG_Upgrade, 4, 0, 1, 1);
+
+    check_IMG_Upgrade = new QCheckBox(tab_IMG_Upload);
+    check_IMG_Upgrade->setObjectName("check_IMG_Upgrade");
+
+    gridLayout_4->addWidget(check_IMG_Upgrade, 4, 1, 1, 1);
 
     horizontalLayout_5 = new QHBoxLayout();
     horizontalLayout_5->setSpacing(2);
@@ -228,7 +267,7 @@ void plugin_mcumgr::setup(QMainWindow *main_window)
     progress_IMG_Complete->setObjectName("progress_IMG_Complete");
     progress_IMG_Complete->setValue(0);
 
-    gridLayout_4->addWidget(progress_IMG_Complete, 3, 1, 1, 1);
+    gridLayout_4->addWidget(progress_IMG_Complete, 5, 1, 1, 1);
 
     label_9 = new QLabel(tab_IMG_Upload);
     label_9->setObjectName("label_9");
@@ -237,7 +276,7 @@ void plugin_mcumgr::setup(QMainWindow *main_window)
 
     verticalSpacer_4 = new QSpacerItem(20, 40, QSizePolicy::Minimum, QSizePolicy::Expanding);
 
-    gridLayout_4->addItem(verticalSpacer_4, 4, 0, 1, 1);
+    gridLayout_4->addItem(verticalSpacer_4, 6, 0, 1, 1);
 
     tabWidget_3->addTab(tab_IMG_Upload, QString());
     tab_IMG_Images = new QWidget();
@@ -548,13 +587,100 @@ void plugin_mcumgr::setup(QMainWindow *main_window)
     gridLayout_8->addWidget(edit_OS_Echo_Output, 1, 1, 1, 1);
 
     selector_OS->addTab(tab_OS_Echo, QString());
+    tab_OS_Link = new QWidget();
+    tab_OS_Link->setObjectName("tab_OS_Link");
+    gridLayout_19 = new QGridLayout(tab_OS_Link);
+    gridLayout_19->setSpacing(2);
+    gridLayout_19->setObjectName("gridLayout_19");
+    label_33 = new QLabel(tab_OS_Link);
+    label_33->setObjectName("label_33");
+
+    gridLayout_19->addWidget(label_33, 0, 0, 1, 1);
+
+    horizontalLayout_22 = new QHBoxLayout();
+    horizontalLayout_22->setSpacing(2);
+    horizontalLayout_22->setObjectName("horizontalLayout_22");
+    edit_OS_Link_Minimum = new QSpinBox(tab_OS_Link);
+    edit_OS_Link_Minimum->setObjectName("edit_OS_Link_Minimum");
+    edit_OS_Link_Minimum->setMinimum(1);
+    edit_OS_Link_Minimum->setMaximum(4096);
+    edit_OS_Link_Minimum->setValue(16);
+
+    horizontalLayout_22->addWidget(edit_OS_Link_Minimum);
+
+    label_34 = new QLabel(tab_OS_Link);
+    label_34->setObjectName("label_34");
+
+    horizontalLayout_22->addWidget(label_34);
+
+    edit_OS_Link_Maximum = new QSpinBox(tab_OS_Link);
+    edit_OS_Link_Maximum->setObjectName("edit_OS_Link_Maximum");
+    edit_OS_Link_Maximum->setMinimum(1);
+    edit_OS_Link_Maximum->setMaximum(4096);
+    edit_OS_Link_Maximum->setValue(256);
+
+    horizontalLayout_22->addWidget(edit_OS_Link_Maximum);
+
+    label_35 = new QLabel(tab_OS_Link);
+    label_35->setObjectName("label_35");
+
+    horizontalLayout_22->addWidget(label_35);
+
+    edit_OS_Link_Step = new QSpinBox(tab_OS_Link);
+    edit_OS_Link_Step->setObjectName("edit_OS_Link_Step");
+    edit_OS_Link_Step->setMinimum(0);
+    edit_OS_Link_Step->setMaximum(4096);
+    edit_OS_Link_Step->setValue(16);
+
+    horizontalLayout_22->addWidget(edit_OS_Link_Step);
+
+
+    gridLayout_19->addLayout(horizontalLayout_22, 0, 1, 1, 1);
+
+    label_36 = new QLabel(tab_OS_Link);
+    label_36->setObjectName("label_36");
+
+    gridLayout_19->addWidget(label_36, 1, 0, 1, 1);
+
+    edit_OS_Link_Interval = new QSpinBox(tab_OS_Link);
+    edit_OS_Link_Interval->setObjectName("edit_OS_Link_Interval");
+    edit_OS_Link_Interval->setMinimum(50);
+    edit_OS_Link_Interval->setMaximum(60000);
+    edit_OS_Link_Interval->setSingleStep(50);
+    edit_OS_Link_Interval->setValue(500);
+
+    gridLayout_19->addWidget(edit_OS_Link_Interval, 1, 1, 1, 1);
+
+    label_37 = new QLabel(tab_OS_Link);
+    label_37->setObjectName("label_37");
+
+    gridLayout_19->addWidget(label_37, 2, 0, 1, 1);
+
+    lbl_OS_Link_Summary = new QLabel(tab_OS_Link);
+    lbl_OS_Link_Summary->setObjectName("lbl_OS_Link_Summary");
+
+    gridLayout_19->addWidget(lbl_OS_Link_Summary, 2, 1, 1, 1);
+
+    label_38 = new QLabel(tab_OS_Link);
+    label_38->setObjectName("label_38");
+
+    gridLayout_19->addWidget(label_38, 3, 0, 1, 1);
+
+    edit_OS_Link_Log = new QPlainTextEdit(tab_OS_Link);
+    edit_OS_Link_Log->setObjectName("edit_OS_Link_Log");
+    edit_OS_Link_Log->setUndoRedoEnabled(false);
+    edit_OS_Link_Log->setReadOnly(true);
+
+    gridLayout_19->addWidget(edit_OS_Link_Log, 3, 1, 1, 1);
+
+    selector_OS->addTab(tab_OS_Link, QString());
     tab_OS_Tasks = new QWidget();
     tab_OS_Tasks->setObjectName("tab_OS_Tasks");
     gridLayout_14 = new QGridLayout(tab_OS_Tasks);
     gridLayout_14->setObjectName("gridLayout_14");
     table_OS_Tasks = new QTableWidget(tab_OS_Tasks);
-    if (table_OS_Tasks->columnCount() < 8)
-        table_OS_Tasks->setColumnCount(8);
+    if (table_OS_Tasks->columnCount() < 12)
+        table_OS_Tasks->setColumnCount(12);
     QTableWidgetItem *__qtablewidgetitem = new QTableWidgetItem();
     table_OS_Tasks->setHorizontalHeaderItem(0, __qtablewidgetitem);
     QTableWidgetItem *__qtablewidgetitem1 = new QTableWidgetItem();
@@ -571,6 +697,14 @@ void plugin_mcumgr::setup(QMainWindow *main_window)
     table_OS_Tasks->setHorizontalHeaderItem(6, __qtablewidgetitem6);
     QTableWidgetItem *__qtablewidgetitem7 = new QTableWidgetItem();
     table_OS_Tasks->setHorizontalHeaderItem(7, __qtablewidgetitem7);
+    QTableWidgetItem *__qtablewidgetitem8 = new QTableWidgetItem();
+    table_OS_Tasks->setHorizontalHeaderItem(8, __qtablewidgetitem8);
+    QTableWidgetItem *__qtablewidgetitem9 = new QTableWidgetItem();
+    table_OS_Tasks->setHorizontalHeaderItem(9, __qtablewidgetitem9);
+    QTableWidgetItem *__qtablewidgetitem10 = new QTableWidgetItem();
+    table_OS_Tasks->setHorizontalHeaderItem(10, __qtablewidgetitem10);
+    QTableWidgetItem *__qtablewidgetitem11 = new QTableWidgetItem();
+    table_OS_Tasks->setHorizontalHeaderItem(11, __qtablewidgetitem11);
     table_OS_Tasks->setObjectName("table_OS_Tasks");
     table_OS_Tasks->setEditTriggers(QAbstractItemView::NoEditTriggers);
     table_OS_Tasks->setProperty("showDropIndicator", QVariant(false));
@@ -582,6 +716,35 @@ void plugin_mcumgr::setup(QMainWindow *main_window)
 
     gridLayout_14->addWidget(table_OS_Tasks, 0, 0, 1, 1);
 
+    horizontalLayout_20 = new QHBoxLayout();
+    horizontalLayout_20->setSpacing(2);
+    horizontalLayout_20->setObjectName("horizontalLayout_20");
+    check_OS_Tasks_Profile = new QCheckBox(tab_OS_Tasks);
+    check_OS_Tasks_Profile->setObjectName("check_OS_Tasks_Profile");
+
+    horizontalLayout_20->addWidget(check_OS_Tasks_Profile);
+
+    edit_OS_Tasks_Interval = new QSpinBox(tab_OS_Tasks);
+    edit_OS_Tasks_Interval->setObjectName("edit_OS_Tasks_Interval");
+    edit_OS_Tasks_Interval->setMinimum(250);
+    edit_OS_Tasks_Interval->setMaximum(3600000);
+    edit_OS_Tasks_Interval->setSingleStep(250);
+    edit_OS_Tasks_Interval->setValue(2000);
+
+    horizontalLayout_20->addWidget(edit_OS_Tasks_Interval);
+
+    horizontalSpacer_21 = new QSpacerItem(40, 20, QSizePolicy::Expanding, QSizePolicy::Minimum);
+
+    horizontalLayout_20->addItem(horizontalSpacer_21);
+
+    btn_OS_Tasks_Baseline = new QPushButton(tab_OS_Tasks);
+    btn_OS_Tasks_Baseline->setObjectName("btn_OS_Tasks_Baseline");
+
+    horizontalLayout_20->addWidget(btn_OS_Tasks_Baseline);
+
+
+    gridLayout_14->addLayout(horizontalLayout_20, 1, 0, 1, 1);
+
     selector_OS->addTab(tab_OS_Tasks, QString());
     tab_OS_Memory = new QWidget();
     tab_OS_Memory->setObjectName("tab_OS_Memory");
@@ -590,14 +753,14 @@ void plugin_mcumgr::setup(QMainWindow *main_window)
     table_OS_Memory = new QTableWidget(tab_OS_Memory);
     if (table_OS_Memory->columnCount() < 4)
         table_OS_Memory->setColumnCount(4);
-    QTableWidgetItem *__qtablewidgetitem8 = new QTableWidgetItem();
-    table_OS_Memory->setHorizontalHeaderItem(0, __qtablewidgetitem8);
-    QTableWidgetItem *__qtablewidgetitem9 = new QTableWidgetItem();
-    table_OS_Memory->setHorizontalHeaderItem(1, __qtablewidgetitem9);
-    QTableWidgetItem *__qtablewidgetitem10 = new QTableWidgetItem();
-    table_OS_Memory->setHorizontalHeaderItem(2, __qtablewidgetitem10);
-    QTableWidgetItem *__qtablewidgetitem11 = new QTableWidgetItem();
-    table_OS_Memory->setHorizontalHeaderItem(3, __qtablewidgetitem11);
+    QTableWidgetItem *__qtablewidgetitem12 = new QTableWidgetItem();
+    table_OS_Memory->setHorizontalHeaderItem(0, __qtablewidgetitem12);
+    QTableWidgetItem *__qtablewidgetitem13 = new QTableWidgetItem();
+    table_OS_Memory->setHorizontalHeaderItem(1, __qtablewidgetitem13);
+    QTableWidgetItem *__qtablewidgetitem14 = new QTableWidgetItem();
+    table_OS_Memory->setHorizontalHeaderItem(2, __qtablewidgetitem14);
+    QTableWidgetItem *__qtablewidgetitem15 = new QTableWidgetItem();
+    table_OS_Memory->setHorizontalHeaderItem(3, __qtablewidgetitem15);
     table_OS_Memory->setObjectName("table_OS_Memory");
     table_OS_Memory->setEditTriggers(QAbstractItemView::NoEditTriggers);
     table_OS_Memory->setProperty("showDropIndicator", QVariant(false));
@@ -792,7 +955,7 @@ void plugin_mcumgr::setup(QMainWindow *main_window)
     lbl_STAT_Status = new QLabel(tab_Stats);
     lbl_STAT_Status->setObjectName("lbl_STAT_Status");
 
-    gridLayout_11->addWidget(lbl_STAT_Status, 3, 0, 1, 2);
+    gridLayout_11->addWidget(lbl_STAT_Status, 4, 0, 1, 2);
 
     horizontalLayout_9 = new QHBoxLayout();
     horizontalLayout_9->setSpacing(2);
@@ -808,8 +971,22 @@ void plugin_mcumgr::setup(QMainWindow *main_window)
 
     horizontalLayout_9->addWidget(radio_STAT_Fetch);
 
+    radio_STAT_Sample = new QRadioButton(tab_Stats);
+    radio_STAT_Sample->setObjectName("radio_STAT_Sample");
+
+    horizontalLayout_9->addWidget(radio_STAT_Sample);
+
+    edit_STAT_Interval = new QSpinBox(tab_Stats);
+    edit_STAT_Interval->setObjectName("edit_STAT_Interval");
+    edit_STAT_Interval->setMinimum(100);
+    edit_STAT_Interval->setMaximum(3600000);
+    edit_STAT_Interval->setSingleStep(100);
+    edit_STAT_Interval->setValue(1000);
+
+    horizontalLayout_9->addWidget(edit_STAT_Interval);
+
 
-    gridLayout_11->addLayout(horizontalLayout_9, 2, 0, 1, 2);
+    gridLayout_11->addLayout(horizontalLayout_9, 3, 0, 1, 2);
 
     combo_STAT_Group = new QComboBox(tab_Stats);
     combo_STAT_Group->setObjectName("combo_STAT_Group");
@@ -830,12 +1007,17 @@ void plugin_mcumgr::setup(QMainWindow *main_window)
 
     horizontalLayout_14->addWidget(btn_STAT_Go);
 
+    btn_STAT_Export = new QPushButton(tab_Stats);
+    btn_STAT_Export->setObjectName("btn_STAT_Export");
+
+    horizontalLayout_14->addWidget(btn_STAT_Export);
+
     horizontalSpacer_20 = new QSpacerItem(40, 20, QSizePolicy::Expanding, QSizePolicy::Minimum);
 
     horizontalLayout_14->addItem(horizontalSpacer_20);
 
 
-    gridLayout_11->addLayout(horizontalLayout_14, 4, 0, 1, 2);
+    gridLayout_11->addLayout(horizontalLayout_14, 5, 0, 1, 2);
 
     label_16 = new QLabel(tab_Stats);
     label_16->setObjectName("label_16");
@@ -848,12 +1030,16 @@ void plugin_mcumgr::setup(QMainWindow *main_window)
     gridLayout_11->addWidget(label_15, 0, 0, 1, 1);
 
     table_STAT_Values = new QTableWidget(tab_Stats);
-    if (table_STAT_Values->columnCount() < 2)
-        table_STAT_Values->setColumnCount(2);
-    QTableWidgetItem *__qtablewidgetitem12 = new QTableWidgetItem();
-    table_STAT_Values->setHorizontalHeaderItem(0, __qtablewidgetitem12);
-    QTableWidgetItem *__qtablewidgetitem13 = new QTableWidgetItem();
-    table_STAT_Values->setHorizontalHeaderItem(1, __qtablewidgetitem13);
+    if (table_STAT_Values->columnCount() < 4)
+        table_STAT_Values->setColumnCount(4);
+    QTableWidgetItem *__qtablewidgetitem16 = new QTableWidgetItem();
+    table_STAT_Values->setHorizontalHeaderItem(0, __qtablewidgetitem16);
+    QTableWidgetItem *__qtablewidgetitem17 = new QTableWidgetItem();
+    table_STAT_Values->setHorizontalHeaderItem(1, __qtablewidgetitem17);
+    QTableWidgetItem *__qtablewidgetitem18 = new QTableWidgetItem();
+    table_STAT_Values->setHorizontalHeaderItem(2, __qtablewidgetitem18);
+    QTableWidgetItem *__qtablewidgetitem19 = new QTableWidgetItem();
+    table_STAT_Values->setHorizontalHeaderItem(3, __qtablewidgetitem19);
     table_STAT_Values->setObjectName("table_STAT_Values");
     table_STAT_Values->setEditTriggers(QAbstractItemView::NoEditTriggers);
     table_STAT_Values->setProperty("showDropIndicator", QVariant(false));
@@ -866,6 +1052,16 @@ void plugin_mcumgr::setup(QMainWindow *main_window)
 
     gridLayout_11->addWidget(table_STAT_Values, 1, 1, 1, 1);
 
+    label_STAT_Graph = new QLabel(tab_Stats);
+    label_STAT_Graph->setObjectName("label_STAT_Graph");
+
+    gridLayout_11->addWidget(label_STAT_Graph, 2, 0, 1, 1);
+
+    graph_STAT = new stat_graph(tab_Stats);
+    graph_STAT->setObjectName("graph_STAT");
+
+    gridLayout_11->addWidget(graph_STAT, 2, 1, 1, 1);
+
     tabWidget_2->addTab(tab_Stats, QString());
     tab_Shell = new QWidget();
     tab_Shell->setObjectName("tab_Shell");
@@ -927,6 +1123,11 @@ void plugin_mcumgr::setup(QMainWindow *main_window)
 
     horizontalLayout_8->addWidget(btn_SHELL_Copy);
 
+    btn_SHELL_Batch = new QToolButton(tab_Shell);
+    btn_SHELL_Batch->setObjectName("btn_SHELL_Batch");
+
+    horizontalLayout_8->addWidget(btn_SHELL_Batch);
+
     horizontalSpacer_8 = new QSpacerItem(40, 20, QSizePolicy::Expanding, QSizePolicy::Minimum);
 
     horizontalLayout_8->addItem(horizontalSpacer_8);
@@ -951,6 +1152,11 @@ void plugin_mcumgr::setup(QMainWindow *main_window)
 
     horizontalLayout_17->addWidget(check_shel_unescape_strings);
 
+    check_SHELL_Batch_Continue = new QCheckBox(tab_Shell);
+    check_SHELL_Batch_Continue->setObjectName("check_SHELL_Batch_Continue");
+
+    horizontalLayout_17->addWidget(check_SHELL_Batch_Continue);
+
     horizontalSpacer_12 = new QSpacerItem(40, 20, QSizePolicy::Expanding, QSizePolicy::Minimum);
 
     horizontalLayout_17->addItem(horizontalSpacer_12);
@@ -1116,9 +1322,44 @@ void plugin_mcumgr::setup(QMainWindow *main_window)
 
     horizontalLayout_11->addWidget(radio_settings_save);
 
+    radio_settings_snapshot = new QRadioButton(tab_Settings);
+    buttonGroup->addButton(radio_settings_snapshot);
+    radio_settings_snapshot->setObjectName("radio_settings_snapshot");
+
+    horizontalLayout_11->addWidget(radio_settings_snapshot);
+
+    radio_settings_apply = new QRadioButton(tab_Settings);
+    buttonGroup->addButton(radio_settings_apply);
+    radio_settings_apply->setObjectName("radio_settings_apply");
+
+    horizontalLayout_11->addWidget(radio_settings_apply);
+
 
     gridLayout_15->addLayout(horizontalLayout_11, 3, 2, 1, 1);
 
+    label_32 = new QLabel(tab_Settings);
+    label_32->setObjectName("label_32");
+
+    gridLayout_15->addWidget(label_32, 2, 0, 1, 1);
+
+    horizontalLayout_21 = new QHBoxLayout();
+    horizontalLayout_21->setSpacing(2);
+    horizontalLayout_21->setObjectName("horizontalLayout_21");
+    edit_settings_file = new QLineEdit(tab_Settings);
+    edit_settings_file->setObjectName("edit_settings_file");
+    edit_settings_file->setEnabled(false);
+
+    horizontalLayout_21->addWidget(edit_settings_file);
+
+    btn_settings_file = new QToolButton(tab_Settings);
+    btn_settings_file->setObjectName("btn_settings_file");
+    btn_settings_file->setEnabled(false);
+
+    horizontalLayout_21->addWidget(btn_settings_file);
+
+
+    gridLayout_15->addLayout(horizontalLayout_21, 2, 2, 1, 1);
+
     edit_settings_value = new QLineEdit(tab_Settings);
     edit_settings_value->setObjectName("edit_settings_value");
     edit_settings_value->setReadOnly(true);
@@ -1196,6 +1437,92 @@ void plugin_mcumgr::setup(QMainWindow *main_window)
     gridLayout_16->addWidget(lbl_zephyr_status, 1, 0, 1, 1);
 
     tabWidget_2->addTab(tab_zephyr, QString());
+    tab_Jobs = new QWidget();
+    tab_Jobs->setObjectName("tab_Jobs");
+    gridLayout_20 = new QGridLayout(tab_Jobs);
+    gridLayout_20->setSpacing(2);
+    gridLayout_20->setObjectName("gridLayout_20");
+    gridLayout_20->setContentsMargins(6, 6, 6, 6);
+    label_39 = new QLabel(tab_Jobs);
+    label_39->setObjectName("label_39");
+
+    gridLayout_20->addWidget(label_39, 0, 0, 1, 1);
+
+    horizontalLayout_23 = new QHBoxLayout();
+    horizontalLayout_23->setSpacing(2);
+    horizontalLayout_23->setObjectName("horizontalLayout_23");
+    edit_JOB_File = new QLineEdit(tab_Jobs);
+    edit_JOB_File->setObjectName("edit_JOB_File");
+
+    horizontalLayout_23->addWidget(edit_JOB_File);
+
+    btn_JOB_File = new QToolButton(tab_Jobs);
+    btn_JOB_File->setObjectName("btn_JOB_File");
+
+    horizontalLayout_23->addWidget(btn_JOB_File);
+
+
+    gridLayout_20->addLayout(horizontalLayout_23, 0, 1, 1, 1);
+
+    horizontalLayout_24 = new QHBoxLayout();
+    horizontalLayout_24->setSpacing(2);
+    horizontalLayout_24->setObjectName("horizontalLayout_24");
+    check_JOB_Reorder = new QCheckBox(tab_Jobs);
+    check_JOB_Reorder->setObjectName("check_JOB_Reorder");
+    check_JOB_Reorder->setChecked(true);
+
+    horizontalLayout_24->addWidget(check_JOB_Reorder);
+
+    check_JOB_Continue = new QCheckBox(tab_Jobs);
+    check_JOB_Continue->setObjectName("check_JOB_Continue");
+
+    horizontalLayout_24->addWidget(check_JOB_Continue);
+
+    horizontalSpacer_22 = new QSpacerItem(40, 20, QSizePolicy::Expanding, QSizePolicy::Minimum);
+
+    horizontalLayout_24->addItem(horizontalSpacer_22);
+
+
+    gridLayout_20->addLayout(horizontalLayout_24, 1, 0, 1, 2);
+
+    edit_JOB_Log = new QPlainTextEdit(tab_Jobs);
+    edit_JOB_Log->setObjectName("edit_JOB_Log");
+    edit_JOB_Log->setUndoRedoEnabled(false);
+    edit_JOB_Log->setReadOnly(true);
+
+    gridLayout_20->addWidget(edit_JOB_Log, 2, 0, 1, 2);
+
+    progress_JOB_Complete = new QProgressBar(tab_Jobs);
+    progress_JOB_Complete->setObjectName("progress_JOB_Complete");
+    progress_JOB_Complete->setValue(0);
+
+    gridLayout_20->addWidget(progress_JOB_Complete, 3, 0, 1, 2);
+
+    lbl_JOB_Status = new QLabel(tab_Jobs);
+    lbl_JOB_Status->setObjectName("lbl_JOB_Status");
+
+    gridLayout_20->addWidget(lbl_JOB_Status, 4, 0, 1, 2);
+
+    horizontalLayout_25 = new QHBoxLayout();
+    horizontalLayout_25->setSpacing(2);
+    horizontalLayout_25->setObjectName("horizontalLayout_25");
+    horizontalSpacer_23 = new QSpacerItem(40, 20, QSizePolicy::Expanding, QSizePolicy::Minimum);
+
+    horizontalLayout_25->addItem(horizontalSpacer_23);
+
+    btn_JOB_Go = new QPushButton(tab_Jobs);
+    btn_JOB_Go->setObjectName("btn_JOB_Go");
+
+    horizontalLayout_25->addWidget(btn_JOB_Go);
+
+    horizontalSpacer_24 = new QSpacerItem(40, 20, QSizePolicy::Expanding, QSizePolicy::Minimum);
+
+    horizontalLayout_25->addItem(horizontalSpacer_24);
+
+
+    gridLayout_20->addLayout(horizontalLayout_25, 5, 0, 1, 2);
+
+    tabWidget_2->addTab(tab_Jobs, QString());
 
     verticalLayout_2->addWidget(tabWidget_2);
 
@@ -1299,6 +1626,9 @@ void plugin_mcumgr::setup(QMainWindow *main_window)
 ///AUTOGEN_START_TRANSLATE
 //    Form->setWindowTitle(QCoreApplication::translate("Form", "Form", nullptr));
     label->setText(QCoreApplication::translate("Form", "MTU:", nullptr));
+    check_MTU_Auto->setText(QCoreApplication::translate("Form", "Auto", nullptr));
+    btn_MTU_Discover->setText(QCoreApplication::translate("Form", "Discover", nullptr));
+    check_Transport_Reconnect->setText(QCoreApplication::translate("Form", "Reconnect", nullptr));
     check_V2_Protocol->setText(QCoreApplication::translate("Form", "v2 protocol", nullptr));
     radio_transport_uart->setText(QCoreApplication::translate("Form", "UART", nullptr));
     radio_transport_udp->setText(QCoreApplication::translate("Form", "UDP", nullptr));
@@ -1313,6 +1643,10 @@ void plugin_mcumgr::setup(QMainWindow *main_window)
     radio_IMG_Test->setText(QCoreApplication::translate("Form", "Test", nullptr));
     radio_IMG_Confirm->setText(QCoreApplication::translate("Form", "Confirm", nullptr));
     label_9->setText(QCoreApplication::translate("Form", "Reset:", nullptr));
+    label_IMG_Skip->setText(QCoreApplication::translate("Form", "Skip:", nullptr));
+    check_IMG_Skip_Present->setText(QCoreApplication::translate("Form", "If already on device", nullptr));
+    label_IMG_Upgrade->setText(QCoreApplication::translate("Form", "Upgrade:", nullptr));
+    check_IMG_Upgrade->setText(QCoreApplication::translate("Form", "Only if newer", nullptr));
     tabWidget_3->setTabText(tabWidget_3->indexOf(tab_IMG_Upload), QCoreApplication::translate("Form", "Upload", nullptr));
     label_5->setText(QCoreApplication::translate("Form", "State:", nullptr));
     radio_IMG_Get->setText(QCoreApplication::translate("Form", "Get", nullptr));
@@ -1344,6 +1678,17 @@ void plugin_mcumgr::setup(QMainWindow *main_window)
     label_10->setText(QCoreApplication::translate("Form", "Input:", nullptr));
     label_11->setText(QCoreApplication::translate("Form", "Output:", nullptr));
     selector_OS->setTabText(selector_OS->indexOf(tab_OS_Echo), QCoreApplication::translate("Form", "Echo", nullptr));
+    label_33->setText(QCoreApplication::translate("Form", "Payload:", nullptr));
+    edit_OS_Link_Minimum->setSuffix(QCoreApplication::translate("Form", " bytes", nullptr));
+    label_34->setText(QCoreApplication::translate("Form", "to", nullptr));
+    edit_OS_Link_Maximum->setSuffix(QCoreApplication::translate("Form", " bytes", nullptr));
+    label_35->setText(QCoreApplication::translate("Form", "step", nullptr));
+    edit_OS_Link_Step->setSuffix(QCoreApplication::translate("Form", " bytes", nullptr));
+    label_36->setText(QCoreApplication::translate("Form", "Interval:", nullptr));
+    edit_OS_Link_Interval->setSuffix(QCoreApplication::translate("Form", " ms", nullptr));
+    label_37->setText(QCoreApplication::translate("Form", "Link:", nullptr));
+    label_38->setText(QCoreApplication::translate("Form", "Log:", nullptr));
+    selector_OS->setTabText(selector_OS->indexOf(tab_OS_Link), QCoreApplication::translate("Form", "Link", nullptr));
     QTableWidgetItem *___qtablewidgetitem = table_OS_Tasks->horizontalHeaderItem(0);
     ___qtablewidgetitem->setText(QCoreApplication::translate("Form", "Task", nullptr));
     QTableWidgetItem *___qtablewidgetitem1 = table_OS_Tasks->horizontalHeaderItem(1);
@@ -1360,15 +1705,26 @@ void plugin_mcumgr::setup(QMainWindow *main_window)
     ___qtablewidgetitem6->setText(QCoreApplication::translate("Form", "Stack size", nullptr));
     QTableWidgetItem *___qtablewidgetitem7 = table_OS_Tasks->horizontalHeaderItem(7);
     ___qtablewidgetitem7->setText(QCoreApplication::translate("Form", "Stack usage", nullptr));
+    QTableWidgetItem *___qtablewidgetitem8 = table_OS_Tasks->horizontalHeaderItem(8);
+    ___qtablewidgetitem8->setText(QCoreApplication::translate("Form", "CPU %", nullptr));
+    QTableWidgetItem *___qtablewidgetitem9 = table_OS_Tasks->horizontalHeaderItem(9);
+    ___qtablewidgetitem9->setText(QCoreApplication::translate("Form", "Switches/s", nullptr));
+    QTableWidgetItem *___qtablewidgetitem10 = table_OS_Tasks->horizontalHeaderItem(10);
+    ___qtablewidgetitem10->setText(QCoreApplication::translate("Form", "Stack peak", nullptr));
+    QTableWidgetItem *___qtablewidgetitem11 = table_OS_Tasks->horizontalHeaderItem(11);
+    ___qtablewidgetitem11->setText(QCoreApplication::translate("Form", "Stack baseline", nullptr));
+    check_OS_Tasks_Profile->setText(QCoreApplication::translate("Form", "Profile every:", nullptr));
+    edit_OS_Tasks_Interval->setSuffix(QCoreApplication::translate("Form", " ms", nullptr));
+    btn_OS_Tasks_Baseline->setText(QCoreApplication::translate("Form", "Save stack baseline", nullptr));
     selector_OS->setTabText(selector_OS->indexOf(tab_OS_Tasks), QCoreApplication::translate("Form", "Tasks", nullptr));
-    QTableWidgetItem *___qtablewidgetitem8 = table_OS_Memory->horizontalHeaderItem(0);
-    ___qtablewidgetitem8->setText(QCoreApplication::translate("Form", "Name", nullptr));
-    QTableWidgetItem *___qtablewidgetitem9 = table_OS_Memory->horizontalHeaderItem(1);
-    ___qtablewidgetitem9->setText(QCoreApplication::translate("Form", "Size", nullptr));
-    QTableWidgetItem *___qtablewidgetitem10 = table_OS_Memory->horizontalHeaderItem(2);
-    ___qtablewidgetitem10->setText(QCoreApplication::translate("Form", "Free", nullptr));
-    QTableWidgetItem *___qtablewidgetitem11 = table_OS_Memory->horizontalHeaderItem(3);
-    ___qtablewidgetitem11->setText(QCoreApplication::translate("Form", "Minimum", nullptr));
+    QTableWidgetItem *___qtablewidgetitem12 = table_OS_Memory->horizontalHeaderItem(0);
+    ___qtablewidgetitem12->setText(QCoreApplication::translate("Form", "Name", nullptr));
+    QTableWidgetItem *___qtablewidgetitem13 = table_OS_Memory->horizontalHeaderItem(1);
+    ___qtablewidgetitem13->setText(QCoreApplication::translate("Form", "Size", nullptr));
+    QTableWidgetItem *___qtablewidgetitem14 = table_OS_Memory->horizontalHeaderItem(2);
+    ___qtablewidgetitem14->setText(QCoreApplication::translate("Form", "Free", nullptr));
+    QTableWidgetItem *___qtablewidgetitem15 = table_OS_Memory->horizontalHeaderItem(3);
+    ___qtablewidgetitem15->setText(QCoreApplication::translate("Form", "Minimum", nullptr));
     selector_OS->setTabText(selector_OS->indexOf(tab_OS_Memory), QCoreApplication::translate("Form", "Memory", nullptr));
     check_OS_Force_Reboot->setText(QCoreApplication::translate("Form", "Force reboot", nullptr));
     selector_OS->setTabText(selector_OS->indexOf(tab_OS_Reset), QCoreApplication::translate("Form", "Reset", nullptr));
@@ -1393,19 +1749,29 @@ void plugin_mcumgr::setup(QMainWindow *main_window)
     lbl_STAT_Status->setText(QCoreApplication::translate("Form", "[Status]", nullptr));
     radio_STAT_List->setText(QCoreApplication::translate("Form", "List Groups", nullptr));
     radio_STAT_Fetch->setText(QCoreApplication::translate("Form", "Fetch Stats", nullptr));
+    radio_STAT_Sample->setText(QCoreApplication::translate("Form", "Sample every:", nullptr));
+    edit_STAT_Interval->setSuffix(QCoreApplication::translate("Form", " ms", nullptr));
     btn_STAT_Go->setText(QCoreApplication::translate("Form", "Go", nullptr));
+    btn_STAT_Export->setText(QCoreApplication::translate("Form", "Export CSV", nullptr));
     label_16->setText(QCoreApplication::translate("Form", "Values:", nullptr));
     label_15->setText(QCoreApplication::translate("Form", "Group:", nullptr));
-    QTableWidgetItem *___qtablewidgetitem12 = table_STAT_Values->horizontalHeaderItem(0);
-    ___qtablewidgetitem12->setText(QCoreApplication::translate("Form", "Name", nullptr));
-    QTableWidgetItem *___qtablewidgetitem13 = table_STAT_Values->horizontalHeaderItem(1);
-    ___qtablewidgetitem13->setText(QCoreApplication::translate("Form", "Value", nullptr));
+    QTableWidgetItem *___qtablewidgetitem16 = table_STAT_Values->horizontalHeaderItem(0);
+    ___qtablewidgetitem16->setText(QCoreApplication::translate("Form", "Name", nullptr));
+    QTableWidgetItem *___qtablewidgetitem17 = table_STAT_Values->horizontalHeaderItem(1);
+    ___qtablewidgetitem17->setText(QCoreApplication::translate("Form", "Value", nullptr));
+    QTableWidgetItem *___qtablewidgetitem18 = table_STAT_Values->horizontalHeaderItem(2);
+    ___qtablewidgetitem18->setText(QCoreApplication::translate("Form", "Delta", nullptr));
+    QTableWidgetItem *___qtablewidgetitem19 = table_STAT_Values->horizontalHeaderItem(3);
+    ___qtablewidgetitem19->setText(QCoreApplication::translate("Form", "Rate (/s)", nullptr));
+    label_STAT_Graph->setText(QCoreApplication::translate("Form", "Graph:", nullptr));
     tabWidget_2->setTabText(tabWidget_2->indexOf(tab_Stats), QCoreApplication::translate("Form", "Stats", nullptr));
     lbl_SHELL_Status->setText(QCoreApplication::translate("Form", "[Status]", nullptr));
     btn_SHELL_Clear->setText(QCoreApplication::translate("Form", "Clear", nullptr));
     btn_SHELL_Copy->setText(QCoreApplication::translate("Form", "Copy", nullptr));
+    btn_SHELL_Batch->setText(QCoreApplication::translate("Form", "Run batch...", nullptr));
     check_shell_vt100_decoding->setText(QCoreApplication::translate("Form", "VT100 decoding", nullptr));
     check_shel_unescape_strings->setText(QCoreApplication::translate("Form", "Un-escape strings", nullptr));
+    check_SHELL_Batch_Continue->setText(QCoreApplication::translate("Form", "Continue batch on error", nullptr));
     tabWidget_2->setTabText(tabWidget_2->indexOf(tab_Shell), QCoreApplication::translate("Form", "Shell", nullptr));
     label_22->setText(QCoreApplication::translate("Form", "Action:", nullptr));
     lbl_settings_status->setText(QCoreApplication::translate("Form", "[Status]", nullptr));
@@ -1426,12 +1792,23 @@ void plugin_mcumgr::setup(QMainWindow *main_window)
     radio_settings_commit->setText(QCoreApplication::translate("Form", "Commit", nullptr));
     radio_settings_load->setText(QCoreApplication::translate("Form", "Load", nullptr));
     radio_settings_save->setText(QCoreApplication::translate("Form", "Save", nullptr));
+    radio_settings_snapshot->setText(QCoreApplication::translate("Form", "Snapshot", nullptr));
+    radio_settings_apply->setText(QCoreApplication::translate("Form", "Apply", nullptr));
+    label_32->setText(QCoreApplication::translate("Form", "Bulk file:", nullptr));
+    btn_settings_file->setText(QCoreApplication::translate("Form", "...", nullptr));
     tabWidget_2->setTabText(tabWidget_2->indexOf(tab_Settings), QCoreApplication::translate("Form", "Settings", nullptr));
     btn_zephyr_go->setText(QCoreApplication::translate("Form", "Go", nullptr));
     label_12->setText(QCoreApplication::translate("Form", "This will erase the \"storage_partition\" flash partition on the device.", nullptr));
     tabWidget_4->setTabText(tabWidget_4->indexOf(tab_zephyr_storage_erase), QCoreApplication::translate("Form", "Storage Erase", nullptr));
     lbl_zephyr_status->setText(QCoreApplication::translate("Form", "[Status]", nullptr));
     tabWidget_2->setTabText(tabWidget_2->indexOf(tab_zephyr), QCoreApplication::translate("Form", "Zephyr", nullptr));
+    label_39->setText(QCoreApplication::translate("Form", "Job file:", nullptr));
+    btn_JOB_File->setText(QCoreApplication::translate("Form", "...", nullptr));
+    check_JOB_Reorder->setText(QCoreApplication::translate("Form", "Run small jobs first", nullptr));
+    check_JOB_Continue->setText(QCoreApplication::translate("Form", "Continue after failure", nullptr));
+    lbl_JOB_Status->setText(QCoreApplication::translate("Form", "[Status]", nullptr));
+    btn_JOB_Go->setText(QCoreApplication::translate("Form", "Go", nullptr));
+    tabWidget_2->setTabText(tabWidget_2->indexOf(tab_Jobs), QCoreApplication::translate("Form", "Jobs", nullptr));
 //    tabWidget->setTabText(tabWidget->indexOf(tab), QCoreApplication::translate("Form", "MCUmgr", nullptr));
     label_7->setText(QCoreApplication::translate("Form", "Hash:", nullptr));
     label_8->setText(QCoreApplication::translate("Form", "Version:", nullptr));
@@ -1452,8 +1829,14 @@ void plugin_mcumgr::setup(QMainWindow *main_window)
     connect(this, SIGNAL(plugin_add_open_close_button(QPushButton*)), this, SLOT(plugin_add_open_close_button(QPushButton*)));
     connect(this, SIGNAL(plugin_to_hex(QByteArray*)), parent_window, SLOT(plugin_to_hex(QByteArray*)));
     connect(this, SIGNAL(plugin_serial_open_close(uint8_t)), parent_window, SLOT(plugin_serial_open_close(uint8_t)));
+    connect(this, SIGNAL(plugin_serial_is_open(bool*)), parent_window, SLOT(plugin_serial_is_open(bool*)));
+    connect(this, SIGNAL(plugin_save_setting(QString,QVariant)), parent_window, SLOT(plugin_save_setting(QString,QVariant)));
+    connect(this, SIGNAL(plugin_load_setting(QString,QVariant*,bool*)), parent_window, SLOT(plugin_load_setting(QString,QVariant*,bool*)));
+    connect(this, SIGNAL(plugin_data_subscribe(QObject*,quint32,qint32)), parent_window, SLOT(plugin_data_subscribe(QObject*,quint32,qint32)));
+
+    //Received data is only needed whilst this plugin has claimed the port
+    emit plugin_data_subscribe(this, PluginDataReceive | PluginDataRunningOnly, 0);
 
-    connect(parent_window, SIGNAL(plugin_serial_receive(QByteArray*)), this, SLOT(serial_receive(QByteArray*)));
     connect(parent_window, SIGNAL(plugin_serial_error(QSerialPort::SerialPortError)), this, SLOT(serial_error(QSerialPort::SerialPortError)));
     connect(parent_window, SIGNAL(plugin_serial_bytes_written(qint64)), this, SLOT(serial_bytes_written(qint64)));
     connect(parent_window, SIGNAL(plugin_serial_about_to_close()), this, SLOT(serial_about_to_close()));
@@ -1462,13 +1845,19 @@ void plugin_mcumgr::setup(QMainWindow *main_window)
 
     connect(uart_transport, SIGNAL(serial_write(QByteArray*)), parent_window, SLOT(plugin_serial_transmit(QByteArray*)));
     connect(uart_transport, SIGNAL(receive_waiting(smp_message*)), processor, SLOT(message_received(smp_message*)));
+    connect(uart_transport, SIGNAL(serial_reopen(bool*)), this, SLOT(uart_reopen(bool*)));
+    connect(reconnect_transport, SIGNAL(link_lost()), this, SLOT(transport_link_lost()));
+    connect(reconnect_transport, SIGNAL(link_restored()), this, SLOT(transport_link_restored()));
+    connect(reconnect_transport, SIGNAL(link_failed()), this, SLOT(transport_link_failed()));
 
 #if defined(PLUGIN_MCUMGR_TRANSPORT_UDP)
     connect(udp_transport, SIGNAL(receive_waiting(smp_message*)), processor, SLOT(message_received(smp_message*)));
+    connect(udp_transport, SIGNAL(transport_connected()), this, SLOT(transport_connected()));
 #endif
 
 #if defined(PLUGIN_MCUMGR_TRANSPORT_BLUETOOTH)
     connect(bluetooth_transport, SIGNAL(receive_waiting(smp_message*)), processor, SLOT(message_received(smp_message*)));
+    connect(bluetooth_transport, SIGNAL(transport_connected()), this, SLOT(transport_connected()));
 #endif
 
     connect(smp_groups.fs_mgmt, SIGNAL(status(uint8_t,group_status,QString)), this, SLOT(status(uint8_t,group_status,QString)));
@@ -1500,10 +1889,19 @@ void plugin_mcumgr::setup(QMainWindow *main_window)
     connect(radio_IMG_No_Action, SIGNAL(toggled(bool)), this, SLOT(on_radio_IMG_No_Action_toggled(bool)));
     connect(btn_IMG_Preview_Copy, SIGNAL(clicked()), this, SLOT(on_btn_IMG_Preview_Copy_clicked()));
     connect(btn_OS_Go, SIGNAL(clicked()), this, SLOT(on_btn_OS_Go_clicked()));
+    connect(btn_OS_Tasks_Baseline, SIGNAL(clicked()), this, SLOT(on_btn_OS_Tasks_Baseline_clicked()));
+    connect(&task_profile_timer, SIGNAL(timeout()), this, SLOT(task_profile_timeout()));
+    connect(&link_probe_timer, SIGNAL(timeout()), this, SLOT(link_probe_timeout()));
     connect(btn_STAT_Go, SIGNAL(clicked()), this, SLOT(on_btn_STAT_Go_clicked()));
+    connect(btn_STAT_Export, SIGNAL(clicked()), this, SLOT(on_btn_STAT_Export_clicked()));
+    connect(table_STAT_Values, SIGNAL(itemSelectionChanged()), this, SLOT(on_table_STAT_Values_itemSelectionChanged()));
+    connect(&stat_sample_timer, SIGNAL(timeout()), this, SLOT(stat_sample_timeout()));
     connect(btn_SHELL_Clear, SIGNAL(clicked()), this, SLOT(on_btn_SHELL_Clear_clicked()));
     connect(btn_SHELL_Copy, SIGNAL(clicked()), this, SLOT(on_btn_SHELL_Copy_clicked()));
+    connect(btn_SHELL_Batch, SIGNAL(clicked()), this, SLOT(on_btn_SHELL_Batch_clicked()));
     connect(btn_transport_connect, SIGNAL(clicked()), this, SLOT(on_btn_transport_connect_clicked()));
+    connect(btn_MTU_Discover, SIGNAL(clicked()), this, SLOT(on_btn_MTU_Discover_clicked()));
+    connect(check_Transport_Reconnect, SIGNAL(toggled(bool)), this, SLOT(on_check_Transport_Reconnect_toggled(bool)));
     connect(colview_IMG_Images, SIGNAL(updatePreviewWidget(QModelIndex)), this, SLOT(on_colview_IMG_Images_updatePreviewWidget(QModelIndex)));
     connect(radio_transport_uart, SIGNAL(toggled(bool)), this, SLOT(on_radio_transport_uart_toggled(bool)));
 #if defined(PLUGIN_MCUMGR_TRANSPORT_UDP)
@@ -1522,6 +1920,9 @@ void plugin_mcumgr::setup(QMainWindow *main_window)
     connect(radio_settings_commit, SIGNAL(toggled(bool)), this, SLOT(on_radio_settings_commit_toggled(bool)));
     connect(radio_settings_load, SIGNAL(toggled(bool)), this, SLOT(on_radio_settings_load_toggled(bool)));
     connect(radio_settings_save, SIGNAL(toggled(bool)), this, SLOT(on_radio_settings_save_toggled(bool)));
+    connect(radio_settings_snapshot, SIGNAL(toggled(bool)), this, SLOT(on_radio_settings_snapshot_toggled(bool)));
+    connect(radio_settings_apply, SIGNAL(toggled(bool)), this, SLOT(on_radio_settings_apply_toggled(bool)));
+    connect(btn_settings_file, SIGNAL(clicked()), this, SLOT(on_btn_settings_file_clicked()));
     connect(btn_settings_go, SIGNAL(clicked()), this, SLOT(on_btn_settings_go_clicked()));
     connect(radio_settings_none, SIGNAL(toggled(bool)), this, SLOT(on_radio_settings_none_toggled(bool)));
     connect(radio_settings_text, SIGNAL(toggled(bool)), this, SLOT(on_radio_settings_text_toggled(bool)));
@@ -1531,6 +1932,9 @@ void plugin_mcumgr::setup(QMainWindow *main_window)
     connect(edit_SHELL_Output, SIGNAL(enter_pressed()), this, SLOT(enter_pressed()));
     connect(btn_zephyr_go, SIGNAL(clicked()), this, SLOT(on_btn_zephyr_go_clicked()));
     connect(btn_zephyr_go, SIGNAL(clicked()), this, SLOT(on_btn_zephyr_go_clicked()));
+    connect(btn_JOB_File, SIGNAL(clicked()), this, SLOT(on_btn_JOB_File_clicked()));
+    connect(btn_JOB_Go, SIGNAL(clicked()), this, SLOT(on_btn_JOB_Go_clicked()));
+    connect(&job_wait_timer, SIGNAL(timeout()), this, SLOT(job_wait_timeout()));
     connect(check_os_datetime_use_pc_date_time, SIGNAL(toggled(bool)), this, SLOT(on_check_os_datetime_use_pc_date_time_toggled(bool)));
     connect(radio_os_datetime_get, SIGNAL(toggled(bool)), this, SLOT(on_radio_os_datetime_get_toggled(bool)));
     connect(radio_os_datetime_set, SIGNAL(toggled(bool)), this, SLOT(on_radio_os_datetime_set_toggled(bool)));
@@ -1549,6 +1953,17 @@ void plugin_mcumgr::setup(QMainWindow *main_window)
     edit_SHELL_Output->set_vt100_mode(VT100_MODE_DECODE);
 
     colview_IMG_Images->setModel(&model_image_state);
+    graph_STAT->set_sampler(&stat_samples);
+    stat_sampling = false;
+    stat_sample_group = 0;
+    task_profiling = false;
+    link_probing = false;
+    shell_batch_running = false;
+    shell_batch_next_pending = false;
+    job_running = false;
+    job_next_pending = false;
+    job_starting = false;
+    job_wait_timer.setSingleShot(true);
     colview_IMG_Images->setColumnWidths(QList<int>() << 50 << 50 << 460);
 
     check_IMG_Preview_Confirmed->setChecked(true);
@@ -1565,6 +1980,7 @@ void plugin_mcumgr::setup(QMainWindow *main_window)
 
 #ifndef SKIPPLUGIN_LOGGER
     processor->set_logger(logger);
+    reconnect_transport->set_logger(logger);
     uart_transport->set_logger(logger);
 
 #if defined(PLUGIN_MCUMGR_TRANSPORT_UDP)
@@ -1604,9 +2020,12 @@ plugin_mcumgr::~plugin_mcumgr()
     disconnect(this, SIGNAL(plugin_add_open_close_button(QPushButton*)), this, SLOT(plugin_add_open_close_button(QPushButton*)));
     disconnect(this, SIGNAL(plugin_to_hex(QByteArray*)), parent_window, SLOT(plugin_to_hex(QByteArray*)));
     disconnect(this, SIGNAL(plugin_serial_open_close(uint8_t)), parent_window, SLOT(plugin_serial_open_close(uint8_t)));
+    disconnect(this, SIGNAL(plugin_serial_is_open(bool*)), parent_window, SLOT(plugin_serial_is_open(bool*)));
+    disconnect(this, SIGNAL(plugin_save_setting(QString,QVariant)), parent_window, SLOT(plugin_save_setting(QString,QVariant)));
+    disconnect(this, SIGNAL(plugin_load_setting(QString,QVariant*,bool*)), parent_window, SLOT(plugin_load_setting(QString,QVariant*,bool*)));
+    disconnect(this, SIGNAL(plugin_data_subscribe(QObject*,quint32,qint32)), parent_window, SLOT(plugin_data_subscribe(QObject*,quint32,qint32)));
     disconnect(uart_transport, SIGNAL(serial_write(QByteArray*)), parent_window, SLOT(plugin_serial_transmit(QByteArray*)));
 
-    disconnect(parent_window, SIGNAL(plugin_serial_receive(QByteArray*)), this, SLOT(serial_receive(QByteArray*)));
     disconnect(parent_window, SIGNAL(plugin_serial_error(QSerialPort::SerialPortError)), this, SLOT(serial_error(QSerialPort::SerialPortError)));
     disconnect(parent_window, SIGNAL(plugin_serial_bytes_written(qint64)), this, SLOT(serial_bytes_written(qint64)));
     disconnect(parent_window, SIGNAL(plugin_serial_about_to_close()), this, SLOT(serial_about_to_close()));
@@ -1614,6 +2033,7 @@ plugin_mcumgr::~plugin_mcumgr()
     disconnect(parent_window, SIGNAL(plugin_serial_closed()), this, SLOT(serial_closed()));
 
     disconnect(processor, SLOT(message_received(smp_message*)));
+    disconnect(this, SLOT(transport_connected()));
 
     disconnect(this, SLOT(status(uint8_t,group_status,QString)));
     disconnect(this, SLOT(progress(uint8_t,uint8_t)));
@@ -1631,10 +2051,23 @@ plugin_mcumgr::~plugin_mcumgr()
     disconnect(this, SLOT(on_radio_IMG_No_Action_toggled(bool)));
     disconnect(this, SLOT(on_btn_IMG_Preview_Copy_clicked()));
     disconnect(this, SLOT(on_btn_OS_Go_clicked()));
+    disconnect(this, SLOT(on_btn_OS_Tasks_Baseline_clicked()));
+    disconnect(this, SLOT(task_profile_timeout()));
+    disconnect(this, SLOT(link_probe_timeout()));
     disconnect(this, SLOT(on_btn_STAT_Go_clicked()));
+    disconnect(this, SLOT(on_btn_STAT_Export_clicked()));
+    disconnect(this, SLOT(on_table_STAT_Values_itemSelectionChanged()));
+    disconnect(this, SLOT(stat_sample_timeout()));
     disconnect(this, SLOT(on_btn_SHELL_Clear_clicked()));
     disconnect(this, SLOT(on_btn_SHELL_Copy_clicked()));
+    disconnect(this, SLOT(on_btn_SHELL_Batch_clicked()));
     disconnect(this, SLOT(on_btn_transport_connect_clicked()));
+    disconnect(this, SLOT(on_btn_MTU_Discover_clicked()));
+    disconnect(this, SLOT(on_check_Transport_Reconnect_toggled(bool)));
+    disconnect(this, SLOT(uart_reopen(bool*)));
+    disconnect(this, SLOT(transport_link_lost()));
+    disconnect(this, SLOT(transport_link_restored()));
+    disconnect(this, SLOT(transport_link_failed()));
     disconnect(this, SLOT(on_colview_IMG_Images_updatePreviewWidget(QModelIndex)));
     disconnect(this, SLOT(on_radio_transport_uart_toggled(bool)));
 #if defined(PLUGIN_MCUMGR_TRANSPORT_UDP)
@@ -1653,6 +2086,9 @@ plugin_mcumgr::~plugin_mcumgr()
     disconnect(this, SLOT(on_radio_settings_commit_toggled(bool)));
     disconnect(this, SLOT(on_radio_settings_load_toggled(bool)));
     disconnect(this, SLOT(on_radio_settings_save_toggled(bool)));
+    disconnect(this, SLOT(on_radio_settings_snapshot_toggled(bool)));
+    disconnect(this, SLOT(on_radio_settings_apply_toggled(bool)));
+    disconnect(this, SLOT(on_btn_settings_file_clicked()));
     disconnect(this, SLOT(on_btn_settings_go_clicked()));
     disconnect(this, SLOT(on_radio_settings_none_toggled(bool)));
     disconnect(this, SLOT(on_radio_settings_text_toggled(bool)));
@@ -1661,6 +2097,9 @@ plugin_mcumgr::~plugin_mcumgr()
     disconnect(this, SLOT(on_check_settings_signed_decimal_value_toggled(bool)));
     disconnect(this, SLOT(enter_pressed()));
     disconnect(this, SLOT(on_btn_zephyr_go_clicked()));
+    disconnect(this, SLOT(on_btn_JOB_File_clicked()));
+    disconnect(this, SLOT(on_btn_JOB_Go_clicked()));
+    disconnect(this, SLOT(job_wait_timeout()));
     disconnect(this, SLOT(on_check_os_datetime_use_pc_date_time_toggled(bool)));
     disconnect(this, SLOT(on_radio_os_datetime_get_toggled(bool)));
     disconnect(this, SLOT(on_radio_os_datetime_set_toggled(bool)));
@@ -1668,6 +2107,8 @@ plugin_mcumgr::~plugin_mcumgr()
     //Clean up GUI
     delete tab_2;
 
+    delete reconnect_transport;
+
 #if defined(PLUGIN_MCUMGR_TRANSPORT_BLUETOOTH)
     delete bluetooth_transport;
 #endif
@@ -1739,11 +2180,19 @@ QWidget *plugin_mcumgr::GetWidget()
 void plugin_mcumgr::serial_error(QSerialPort::SerialPortError serial_error)
 {
     log_error() << "Serial error: " << serial_error;
+
+    //The port is about to be closed due to the device going away (e.g. USB re-enumeration after a reset), keep the
+    //operation in progress and reopen the port if reconnecting is enabled
+    if ((serial_error == QSerialPort::ResourceError || serial_error == QSerialPort::PermissionError) && mode != ACTION_IDLE && active_transport() == uart_transport && check_Transport_Reconnect->isChecked() == true)
+    {
+        uart_reconnecting = true;
+    }
 }
 
-void plugin_mcumgr::serial_receive(QByteArray *data)
+void plugin_mcumgr::plugin_data(QByteArray data, quint8 direction)
 {
-    uart_transport->serial_read(data);
+    Q_UNUSED(direction);
+    uart_transport->serial_read(&data);
 }
 
 void plugin_mcumgr::serial_bytes_written(qint64 bytes)
@@ -1758,6 +2207,29 @@ void plugin_mcumgr::serial_about_to_close()
 void plugin_mcumgr::serial_opened()
 {
     btn_transport_connect->setText("Close");
+
+    if (uart_reconnecting == true)
+    {
+        bool successful = false;
+
+        //Claim the port again and replay the outstanding messages
+        uart_reconnecting = false;
+        emit plugin_set_status(true, false, &successful);
+        uart_transport_locked = successful;
+
+        if (successful == false)
+        {
+            log_error() << "Failed to claim UART transport after reconnecting";
+        }
+
+        uart_transport->port_opened();
+        return;
+    }
+
+    if (active_transport() == uart_transport && check_MTU_Auto->isChecked() == true)
+    {
+        mtu_discover_start();
+    }
 }
 
 void plugin_mcumgr::serial_closed()
@@ -1769,8 +2241,17 @@ void plugin_mcumgr::serial_closed()
     }
 #endif
 
+    if (uart_reconnecting == true)
+    {
+        btn_transport_connect->setText("Open");
+        uart_transport_locked = false;
+        uart_transport->port_lost();
+        return;
+    }
+
     switch (mode)
     {
+        case ACTION_IMG_UPLOAD_CHECK:
         case ACTION_IMG_UPLOAD:
         case ACTION_IMG_UPLOAD_SET:
         case ACTION_IMG_IMAGE_LIST:
@@ -1784,6 +2265,8 @@ void plugin_mcumgr::serial_closed()
         case ACTION_OS_UPLOAD_RESET:
         case ACTION_OS_ECHO:
         case ACTION_OS_TASK_STATS:
+        case ACTION_OS_TASK_PROFILE:
+        case ACTION_OS_LINK_PROBE:
         case ACTION_OS_MEMORY_POOL:
         case ACTION_OS_RESET:
         case ACTION_OS_DATETIME_GET:
@@ -1791,12 +2274,15 @@ void plugin_mcumgr::serial_closed()
         case ACTION_OS_MCUMGR_BUFFER:
         case ACTION_OS_OS_APPLICATION_INFO:
         case ACTION_OS_BOOTLOADER_INFO:
+        case ACTION_MTU_DISCOVER_PARAMETERS:
+        case ACTION_MTU_DISCOVER_ECHO:
         {
             smp_groups.os_mgmt->cancel();
             break;
         }
 
         case ACTION_SHELL_EXECUTE:
+        case ACTION_SHELL_BATCH:
         {
             smp_groups.shell_mgmt->cancel();
             break;
@@ -1804,6 +2290,7 @@ void plugin_mcumgr::serial_closed()
 
         case ACTION_STAT_GROUP_DATA:
         case ACTION_STAT_LIST_GROUPS:
+        case ACTION_STAT_SAMPLE:
         {
             smp_groups.stat_mgmt->cancel();
             break;
@@ -1825,6 +2312,9 @@ void plugin_mcumgr::serial_closed()
         case ACTION_SETTINGS_COMMIT:
         case ACTION_SETTINGS_LOAD:
         case ACTION_SETTINGS_SAVE:
+        case ACTION_SETTINGS_SNAPSHOT:
+        case ACTION_SETTINGS_APPLY_READ:
+        case ACTION_SETTINGS_APPLY_WRITE:
         {
             smp_groups.settings_mgmt->cancel();
             break;
@@ -1836,6 +2326,12 @@ void plugin_mcumgr::serial_closed()
             break;
         }
 
+        case ACTION_JOB:
+        {
+            job_cancel();
+            break;
+        }
+
         default:
         {
         }
@@ -1844,6 +2340,27 @@ void plugin_mcumgr::serial_closed()
     mode = ACTION_IDLE;
     btn_transport_connect->setText("Open");
     uart_transport_locked = false;
+
+    if (stat_sampling == true)
+    {
+        stat_sample_timer.stop();
+        stat_sampling = false;
+        btn_STAT_Go->setText("Go");
+    }
+
+    if (task_profiling == true)
+    {
+        task_profile_timer.stop();
+        task_profiling = false;
+        btn_OS_Go->setText("Go");
+    }
+
+    if (link_probing == true)
+    {
+        link_probe_timer.stop();
+        link_probing = false;
+        btn_OS_Go->setText("Go");
+    }
 }
 
 //Form actions
@@ -1896,7 +2413,9 @@ void plugin_mcumgr::on_btn_FS_Go_clicked()
             mode = ACTION_FS_UPLOAD;
             processor->set_transport(active_transport());
             smp_groups.fs_mgmt->set_parameters((check_V2_Protocol->isChecked() ? 1 : 0), edit_MTU->value(), retries, timeout_ms, mode);
-            started = smp_groups.fs_mgmt->start_upload(edit_FS_Local->text(), edit_FS_Remote->text());
+            fs_hash_checksum_response.clear();
+            edit_FS_Result->clear();
+            started = smp_groups.fs_mgmt->start_upload(edit_FS_Local->text(), edit_FS_Remote->text(), combo_FS_type->currentText(), &fs_hash_checksum_response);
 
             if (started == true)
             {
@@ -1919,11 +2438,22 @@ void plugin_mcumgr::on_btn_FS_Go_clicked()
             mode = ACTION_FS_DOWNLOAD;
             processor->set_transport(active_transport());
             smp_groups.fs_mgmt->set_parameters((check_V2_Protocol->isChecked() ? 1 : 0), edit_MTU->value(), retries, timeout_ms, mode);
-            started = smp_groups.fs_mgmt->start_download(edit_FS_Remote->text(), edit_FS_Local->text());
+            fs_hash_checksum_response.clear();
+            edit_FS_Result->clear();
+            started = smp_groups.fs_mgmt->start_download(edit_FS_Remote->text(), edit_FS_Local->text(), combo_FS_type->currentText(), &fs_hash_checksum_response);
 
             if (started == true)
             {
-                lbl_FS_Status->setText("Downloading...");
+                fs_mgmt_resume_t resume;
+
+                if (smp_groups.fs_mgmt->get_resume(&resume) == true)
+                {
+                    lbl_FS_Status->setText(QString("Resuming download from ").append(QString::number(resume.offset)).append("..."));
+                }
+                else
+                {
+                    lbl_FS_Status->setText("Downloading...");
+                }
             }
         }
     }
@@ -1999,8 +2529,8 @@ void plugin_mcumgr::on_radio_FS_Upload_toggled(bool checked)
         edit_FS_Local->setEnabled(true);
         btn_FS_Local->setEnabled(true);
         edit_FS_Remote->setEnabled(true);
-        combo_FS_type->setEnabled(false);
-        edit_FS_Result->setEnabled(false);
+        combo_FS_type->setEnabled(true);
+        edit_FS_Result->setEnabled(true);
         edit_FS_Size->setEnabled(false);
     }
 }
@@ -2012,8 +2542,8 @@ void plugin_mcumgr::on_radio_FS_Download_toggled(bool checked)
         edit_FS_Local->setEnabled(true);
         btn_FS_Local->setEnabled(true);
         edit_FS_Remote->setEnabled(true);
-        combo_FS_type->setEnabled(false);
-        edit_FS_Result->setEnabled(false);
+        combo_FS_type->setEnabled(true);
+        edit_FS_Result->setEnabled(true);
         edit_FS_Size->setEnabled(false);
     }
 }
@@ -2087,16 +2617,39 @@ void plugin_mcumgr::on_btn_IMG_Go_clicked()
         {
             lbl_IMG_Status->setText("Error: File does not exist");
         }
+        else if (check_IMG_Skip_Present->isChecked())
+        {
+            //Read image state first so that the upload can be skipped if the image is already on the device
+            mode = ACTION_IMG_UPLOAD_CHECK;
+            upload_check_images.clear();
+            processor->set_transport(active_transport());
+            smp_groups.img_mgmt->set_parameters((check_V2_Protocol->isChecked() ? 1 : 0), edit_MTU->value(), retries, timeout_ms, mode);
+            started = smp_groups.img_mgmt->start_image_get(&upload_check_images);
+
+            if (started == true)
+            {
+                lbl_IMG_Status->setText("Checking device images...");
+            }
+        }
         else
         {
             mode = ACTION_IMG_UPLOAD;
             processor->set_transport(active_transport());
             smp_groups.img_mgmt->set_parameters((check_V2_Protocol->isChecked() ? 1 : 0), edit_MTU->value(), retries, timeout_ms, mode);
-            started = smp_groups.img_mgmt->start_firmware_update(edit_IMG_Image->value(), edit_IMG_Local->text(), false, &upload_hash);
+            started = smp_groups.img_mgmt->start_firmware_update(edit_IMG_Image->value(), edit_IMG_Local->text(), check_IMG_Upgrade->isChecked(), &upload_hash);
 
             if (started == true)
             {
-                lbl_IMG_Status->setText("Uploading...");
+                img_mgmt_resume_t resume;
+
+                if (smp_groups.img_mgmt->get_resume(&resume) == true)
+                {
+                    lbl_IMG_Status->setText(QString("Resuming upload from ").append(QString::number(resume.offset)).append("..."));
+                }
+                else
+                {
+                    lbl_IMG_Status->setText("Uploading...");
+                }
             }
         }
     }
@@ -2211,6 +2764,27 @@ void plugin_mcumgr::on_btn_OS_Go_clicked()
 {
     bool started = false;
 
+    if (task_profiling == true)
+    {
+        //Stop profiling, an outstanding task list request will still be added when it completes
+        task_profile_timer.stop();
+        task_profiling = false;
+        btn_OS_Go->setText("Go");
+        lbl_OS_Status->setText(QString("Profiling stopped, ").append(QString::number(task_profile.snapshot_count())).append(" snapshots held"));
+        return;
+    }
+
+    if (link_probing == true)
+    {
+        //Stop probing, an outstanding echo will still be counted when it completes
+        link_probe_timer.stop();
+        link_probing = false;
+        btn_OS_Go->setText("Go");
+        lbl_OS_Status->setText("Link probe stopped");
+        log_information() << "Link probe stopped: " << link_stats.summary();
+        return;
+    }
+
     if (claim_transport(lbl_OS_Status) == false)
     {
         return;
@@ -2238,14 +2812,42 @@ void plugin_mcumgr::on_btn_OS_Go_clicked()
     }
     else if (selector_OS->currentWidget() == tab_OS_Tasks)
     {
-        mode = ACTION_OS_TASK_STATS;
+        //When profiling, rates are calculated from the difference between successive task lists
+        mode = (check_OS_Tasks_Profile->isChecked() ? ACTION_OS_TASK_PROFILE : ACTION_OS_TASK_STATS);
         processor->set_transport(active_transport());
         smp_groups.os_mgmt->set_parameters((check_V2_Protocol->isChecked() ? 1 : 0), edit_MTU->value(), retries, timeout_ms, mode);
+        task_profile.clear();
         started = smp_groups.os_mgmt->start_task_stats(&task_list);
 
         if (started == true)
         {
-            lbl_OS_Status->setText("Task list command sent...");
+            if (mode == ACTION_OS_TASK_PROFILE)
+            {
+                task_profiling = true;
+                task_profile_timer.start(edit_OS_Tasks_Interval->value());
+                btn_OS_Go->setText("Stop");
+                lbl_OS_Status->setText("Profiling...");
+            }
+            else
+            {
+                lbl_OS_Status->setText("Task list command sent...");
+            }
+        }
+    }
+    else if (selector_OS->currentWidget() == tab_OS_Link)
+    {
+        link_stats.set_payload_range(edit_OS_Link_Minimum->value(), edit_OS_Link_Maximum->value(), edit_OS_Link_Step->value());
+        link_stats.clear();
+        edit_OS_Link_Log->clear();
+        lbl_OS_Link_Summary->clear();
+        started = link_probe_send();
+
+        if (started == true)
+        {
+            link_probing = true;
+            link_probe_timer.start(edit_OS_Link_Interval->value());
+            btn_OS_Go->setText("Stop");
+            lbl_OS_Status->setText("Probing link...");
         }
     }
     else if (selector_OS->currentWidget() == tab_OS_Memory)
@@ -2362,65 +2964,890 @@ void plugin_mcumgr::on_btn_OS_Go_clicked()
     }
 }
 
-void plugin_mcumgr::on_btn_STAT_Go_clicked()
+void plugin_mcumgr::task_profile_timeout()
 {
     bool started = false;
 
-    if (claim_transport(lbl_STAT_Status) == false)
+    if (mode != ACTION_IDLE)
     {
+        //Previous task list or another command is still in progress, skip this interval
+        log_debug() << "Skipping task profile, busy";
         return;
     }
 
-    if (radio_STAT_List->isChecked())
+    if (claim_transport(lbl_OS_Status) == false)
     {
-        //Execute stat list command
-        mode = ACTION_STAT_LIST_GROUPS;
-        processor->set_transport(active_transport());
-        smp_groups.stat_mgmt->set_parameters((check_V2_Protocol->isChecked() ? 1 : 0), edit_MTU->value(), retries, timeout_ms, mode);
-        started = smp_groups.stat_mgmt->start_list_groups(&group_list);
-
-        if (started == true)
-        {
-            lbl_STAT_Status->setText("Stat list command sent...");
-        }
+        return;
     }
-    else if (radio_STAT_Fetch->isChecked())
-    {
-        //Execute stat get command
-        if (combo_STAT_Group->currentText().isEmpty())
-        {
-            lbl_STAT_Status->setText("Error: No group name provided");
-        }
-        else
-        {
-            mode = ACTION_STAT_GROUP_DATA;
-            processor->set_transport(active_transport());
-            smp_groups.stat_mgmt->set_parameters((check_V2_Protocol->isChecked() ? 1 : 0), edit_MTU->value(), retries, timeout_ms, mode);
-            started = smp_groups.stat_mgmt->start_group_data(combo_STAT_Group->currentText(), &stat_list);
 
-            if (started == true)
-            {
-                lbl_STAT_Status->setText("Stat get command sent...");
-            }
-        }
-    }
+    mode = ACTION_OS_TASK_PROFILE;
+    processor->set_transport(active_transport());
+    smp_groups.os_mgmt->set_parameters((check_V2_Protocol->isChecked() ? 1 : 0), edit_MTU->value(), retries, timeout_ms, mode);
+    started = smp_groups.os_mgmt->start_task_stats(&task_list);
 
     if (started == false)
     {
+        mode = ACTION_IDLE;
         relase_transport();
     }
 }
 
-void plugin_mcumgr::on_btn_SHELL_Clear_clicked()
+void plugin_mcumgr::link_probe_timeout()
 {
-    edit_SHELL_Output->clear_dat_in();
+    if (mode != ACTION_IDLE)
+    {
+        //Previous echo or another command is still in progress, skip this interval
+        log_debug() << "Skipping link probe, busy";
+        return;
+    }
+
+    if (claim_transport(lbl_OS_Status) == false)
+    {
+        return;
+    }
+
+    if (link_probe_send() == false)
+    {
+        mode = ACTION_IDLE;
+        relase_transport();
+    }
 }
 
-void plugin_mcumgr::on_btn_SHELL_Copy_clicked()
+//Sends an echo of the next payload size, a known pattern is used so that corrupted responses can be detected
+bool plugin_mcumgr::link_probe_send()
+{
+    fill_echo_payload(&link_probe_payload, link_stats.payload_size());
+
+    //No retries are used so that a lost message is counted as lost rather than hidden by a resend
+    mode = ACTION_OS_LINK_PROBE;
+    processor->set_transport(active_transport());
+    smp_groups.os_mgmt->set_parameters((check_V2_Protocol->isChecked() ? 1 : 0), edit_MTU->value(), 0, timeout_ms, mode);
+    link_probe_rtt.start();
+
+    return smp_groups.os_mgmt->start_echo(link_probe_payload);
+}
+
+void plugin_mcumgr::fill_echo_payload(QString *payload, uint16_t size)
+{
+    static const char pattern[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz";
+    uint16_t i = 0;
+
+    payload->resize(size);
+
+    while (i < size)
+    {
+        (*payload)[i] = pattern[i % (sizeof(pattern) - 1)];
+        ++i;
+    }
+}
+
+void plugin_mcumgr::on_btn_OS_Tasks_Baseline_clicked()
+{
+    if (task_profile.snapshot_count() == 0)
+    {
+        lbl_OS_Status->setText("Error: No task list has been received");
+        return;
+    }
+
+    emit plugin_save_setting("mcumgr_task_stack_baseline", task_profile.baseline_from_current());
+    lbl_OS_Status->setText("Stack baseline saved");
+}
+
+void plugin_mcumgr::on_btn_STAT_Go_clicked()
+{
+    bool started = false;
+
+    if (stat_sampling == true)
+    {
+        //Stop sampling, an outstanding sample request will still be added when it completes
+        stat_sample_timer.stop();
+        stat_sampling = false;
+        btn_STAT_Go->setText("Go");
+        lbl_STAT_Status->setText(QString("Sampling stopped, ").append(QString::number(stat_samples.sample_count())).append(" samples held"));
+        return;
+    }
+
+    if (claim_transport(lbl_STAT_Status) == false)
+    {
+        return;
+    }
+
+    if (radio_STAT_List->isChecked())
+    {
+        //Execute stat list command
+        mode = ACTION_STAT_LIST_GROUPS;
+        processor->set_transport(active_transport());
+        smp_groups.stat_mgmt->set_parameters((check_V2_Protocol->isChecked() ? 1 : 0), edit_MTU->value(), retries, timeout_ms, mode);
+        started = smp_groups.stat_mgmt->start_list_groups(&group_list);
+
+        if (started == true)
+        {
+            lbl_STAT_Status->setText("Stat list command sent...");
+        }
+    }
+    else if (radio_STAT_Fetch->isChecked())
+    {
+        //Execute stat get command
+        if (combo_STAT_Group->currentText().isEmpty())
+        {
+            lbl_STAT_Status->setText("Error: No group name provided");
+        }
+        else
+        {
+            mode = ACTION_STAT_GROUP_DATA;
+            processor->set_transport(active_transport());
+            smp_groups.stat_mgmt->set_parameters((check_V2_Protocol->isChecked() ? 1 : 0), edit_MTU->value(), retries, timeout_ms, mode);
+            started = smp_groups.stat_mgmt->start_group_data(combo_STAT_Group->currentText(), &stat_list);
+
+            if (started == true)
+            {
+                lbl_STAT_Status->setText("Stat get command sent...");
+            }
+        }
+    }
+    else if (radio_STAT_Sample->isChecked())
+    {
+        //Periodically fetch stats of the groups (comma separated), samples are kept if the groups are the same as the
+        //previous sampling run
+        QStringList groups;
+        QStringList entries = combo_STAT_Group->currentText().split(',');
+        uint16_t i = 0;
+
+        while (i < entries.length())
+        {
+            if (!entries.at(i).trimmed().isEmpty() && !groups.contains(entries.at(i).trimmed()))
+            {
+                groups.append(entries.at(i).trimmed());
+            }
+
+            ++i;
+        }
+
+        if (groups.isEmpty())
+        {
+            lbl_STAT_Status->setText("Error: No group name provided");
+        }
+        else
+        {
+            stat_samples.set_groups(groups);
+            started = stat_sample_start();
+
+            if (started == true)
+            {
+                stat_sampling = true;
+                stat_sample_timer.start(edit_STAT_Interval->value());
+                btn_STAT_Go->setText("Stop");
+                lbl_STAT_Status->setText("Sampling...");
+            }
+        }
+    }
+
+    if (started == false)
+    {
+        relase_transport();
+    }
+}
+
+void plugin_mcumgr::stat_sample_timeout()
+{
+    bool started = false;
+
+    if (mode != ACTION_IDLE)
+    {
+        //Previous sample or another command is still in progress, skip this interval
+        log_debug() << "Skipping stat sample, busy";
+        return;
+    }
+
+    if (claim_transport(lbl_STAT_Status) == false)
+    {
+        return;
+    }
+
+    started = stat_sample_start();
+
+    if (started == false)
+    {
+        mode = ACTION_IDLE;
+        relase_transport();
+    }
+}
+
+//Starts a sample, the groups are fetched one after another and their counters are added as a single sample
+bool plugin_mcumgr::stat_sample_start()
+{
+    stat_sample_time = QDateTime::currentMSecsSinceEpoch();
+    stat_sample_group = 0;
+    stat_sample_values.clear();
+    mode = ACTION_STAT_SAMPLE;
+    processor->set_transport(active_transport());
+    smp_groups.stat_mgmt->set_parameters((check_V2_Protocol->isChecked() ? 1 : 0), edit_MTU->value(), retries, timeout_ms, mode);
+
+    return smp_groups.stat_mgmt->start_group_data(stat_samples.groups().at(stat_sample_group), &stat_list);
+}
+
+void plugin_mcumgr::stat_sample_next_deferred()
+{
+    if (mode != ACTION_STAT_SAMPLE)
+    {
+        //Cancelled
+        return;
+    }
+
+    if (smp_groups.stat_mgmt->start_group_data(stat_samples.groups().at(stat_sample_group), &stat_list) == true)
+    {
+        return;
+    }
+
+    mode = ACTION_IDLE;
+    relase_transport();
+    lbl_STAT_Status->setText(QString("Error: Failed to fetch stat group ").append(stat_samples.groups().at(stat_sample_group)));
+}
+
+void plugin_mcumgr::on_btn_STAT_Export_clicked()
+{
+    QString filename;
+    QString error;
+
+    if (stat_samples.sample_count() == 0)
+    {
+        lbl_STAT_Status->setText("Error: No samples to export");
+        return;
+    }
+
+    filename = QFileDialog::getSaveFileName(parent_window, "Export stat samples", "", "CSV Files (*.csv);;All Files (*)");
+
+    if (filename.isEmpty())
+    {
+        return;
+    }
+
+    if (stat_samples.export_csv(filename, &error) == false)
+    {
+        lbl_STAT_Status->setText(QString("Error: Export failed: ").append(error));
+    }
+    else
+    {
+        lbl_STAT_Status->setText(QString("Exported ").append(QString::number(stat_samples.sample_count())).append(" samples"));
+    }
+}
+
+void plugin_mcumgr::on_table_STAT_Values_itemSelectionChanged()
+{
+    //Graph the selected counters, or all counters if none are selected
+    QStringList counters;
+    QList<QTableWidgetItem *> items = table_STAT_Values->selectedItems();
+    uint16_t i = 0;
+
+    while (i < items.length())
+    {
+        QTableWidgetItem *name = table_STAT_Values->item(items.at(i)->row(), 0);
+
+        if (name != nullptr && !counters.contains(name->text()))
+        {
+            counters.append(name->text());
+        }
+
+        ++i;
+    }
+
+    graph_STAT->set_counters(counters);
+}
+
+void plugin_mcumgr::on_btn_SHELL_Clear_clicked()
+{
+    edit_SHELL_Output->clear_dat_in();
+}
+
+void plugin_mcumgr::on_btn_SHELL_Copy_clicked()
 {
     QApplication::clipboard()->setText(edit_SHELL_Output->toPlainText());
 }
 
+void plugin_mcumgr::on_btn_SHELL_Batch_clicked()
+{
+    QString filename;
+    QString error;
+
+    if (shell_batch_running == true)
+    {
+        if (shell_batch_next_pending == true)
+        {
+            //Between commands, stop the batch here
+            shell_batch_next_pending = false;
+            shell_batch_finish(&error);
+            mode = ACTION_IDLE;
+            relase_transport();
+            lbl_SHELL_Status->setText(error);
+            return;
+        }
+
+        //Cancel the running command, the batch is stopped and results written from the status handler
+        smp_groups.shell_mgmt->cancel();
+        return;
+    }
+
+    filename = QFileDialog::getOpenFileName(parent_window, "Select shell batch file", "", "Text Files (*.txt);;All Files (*)");
+
+    if (filename.isEmpty())
+    {
+        return;
+    }
+
+    if (shell_commands.load(filename, timeout_ms, &error) == false)
+    {
+        lbl_SHELL_Status->setText(QString("Error: Failed to load batch file: ").append(error));
+        return;
+    }
+
+    shell_batch_results_file = QFileDialog::getSaveFileName(parent_window, "Select shell batch results file", "", "JSON Files (*.json);;All Files (*)");
+
+    if (shell_batch_results_file.isEmpty())
+    {
+        return;
+    }
+
+    if (claim_transport(lbl_SHELL_Status) == false)
+    {
+        return;
+    }
+
+    if (shell_batch_start_next() == false)
+    {
+        relase_transport();
+        return;
+    }
+
+    shell_batch_running = true;
+    btn_SHELL_Batch->setText("Stop batch");
+}
+
+//Starts the next command of the shell batch, returns false if there are no more commands or it could not be sent
+bool plugin_mcumgr::shell_batch_start_next()
+{
+    shell_batch_command_t *command = shell_commands.next(QDateTime::currentMSecsSinceEpoch());
+
+    if (command == nullptr)
+    {
+        return false;
+    }
+
+    //Commands are sent one at a time, the device shell runs them in order and later commands may rely on earlier ones
+    mode = ACTION_SHELL_BATCH;
+    processor->set_transport(active_transport());
+    smp_groups.shell_mgmt->set_parameters((check_V2_Protocol->isChecked() ? 1 : 0), edit_MTU->value(), retries, command->timeout_ms, mode);
+
+    if (smp_groups.shell_mgmt->start_execute(&command->arguments, &shell_rc) == false)
+    {
+        shell_commands.set_result(QDateTime::currentMSecsSinceEpoch(), SHELL_BATCH_RESULT_ERROR, 0, QString(), "Failed to send command");
+        return false;
+    }
+
+    edit_SHELL_Output->add_dat_in_text(QString(command->command).append("\n").toUtf8());
+    lbl_SHELL_Status->setText(QString("Batch command ").append(QString::number(shell_commands.current_index() + 1)).append("/").append(QString::number(shell_commands.command_count())).append("..."));
+
+    return true;
+}
+
+void plugin_mcumgr::shell_batch_next_deferred()
+{
+    QString status_message;
+
+    if (shell_batch_next_pending == false)
+    {
+        return;
+    }
+
+    shell_batch_next_pending = false;
+
+    if (shell_batch_start_next() == true)
+    {
+        return;
+    }
+
+    shell_batch_finish(&status_message);
+    mode = ACTION_IDLE;
+    relase_transport();
+    lbl_SHELL_Status->setText(status_message);
+}
+
+void plugin_mcumgr::shell_batch_finish(QString *status_message)
+{
+    QString error;
+
+    shell_batch_running = false;
+    btn_SHELL_Batch->setText("Run batch...");
+    *status_message = QString("Batch finished, ").append(QString::number(shell_commands.count_result(SHELL_BATCH_RESULT_OK))).append("/").append(QString::number(shell_commands.command_count())).append(" commands successful");
+
+    if (shell_commands.save_results(shell_batch_results_file, &error) == false)
+    {
+        status_message->append(", failed to write results: ").append(error);
+    }
+}
+
+void plugin_mcumgr::on_btn_JOB_File_clicked()
+{
+    QString filename = QFileDialog::getOpenFileName(parent_window, "Select job file", "", "Text Files (*.txt);;All Files (*)");
+
+    if (!filename.isEmpty())
+    {
+        edit_JOB_File->setText(filename);
+    }
+}
+
+void plugin_mcumgr::on_btn_JOB_Go_clicked()
+{
+    QString error;
+
+    if (job_running == true)
+    {
+        //Cancel the running job, the remaining jobs are not run
+        job_cancel();
+        return;
+    }
+
+    if (edit_JOB_File->text().isEmpty())
+    {
+        lbl_JOB_Status->setText("Error: Job file is required");
+        return;
+    }
+
+    if (jobs.load(edit_JOB_File->text(), &error) == false)
+    {
+        lbl_JOB_Status->setText(QString("Error: Failed to load job file: ").append(error));
+        return;
+    }
+
+    if (claim_transport(lbl_JOB_Status) == false)
+    {
+        return;
+    }
+
+    edit_JOB_Log->clear();
+    progress_JOB_Complete->setValue(0);
+    job_running = true;
+
+    if (job_start_next() == false)
+    {
+        QString status_message;
+
+        job_finish(&status_message);
+        mode = ACTION_IDLE;
+        relase_transport();
+        lbl_JOB_Status->setText(status_message);
+        return;
+    }
+
+    btn_JOB_Go->setText("Stop");
+}
+
+void plugin_mcumgr::job_wait_timeout()
+{
+    QString status_message;
+
+    if (job_running == false)
+    {
+        return;
+    }
+
+    //Wait jobs do not use a group, completion is handled the same way as a group finishing
+    if (job_complete(STATUS_COMPLETE, &status_message) == true)
+    {
+        mode = ACTION_IDLE;
+        relase_transport();
+        lbl_JOB_Status->setText(status_message);
+    }
+}
+
+smp_group *plugin_mcumgr::job_group(job_type type)
+{
+    switch (type)
+    {
+        case JOB_TYPE_IMG_UPLOAD:
+        case JOB_TYPE_IMG_TEST:
+        case JOB_TYPE_IMG_CONFIRM:
+        case JOB_TYPE_IMG_LIST:
+        case JOB_TYPE_IMG_ERASE:
+        {
+            return smp_groups.img_mgmt;
+        }
+
+        case JOB_TYPE_FS_UPLOAD:
+        case JOB_TYPE_FS_DOWNLOAD:
+        case JOB_TYPE_FS_STATUS:
+        case JOB_TYPE_FS_HASH:
+        {
+            return smp_groups.fs_mgmt;
+        }
+
+        default:
+        {
+            return smp_groups.os_mgmt;
+        }
+    }
+}
+
+bool plugin_mcumgr::job_start(job_t *job)
+{
+    bool started = false;
+
+    mode = ACTION_JOB;
+
+    if (job->type == JOB_TYPE_WAIT)
+    {
+        job_wait_timer.start(job->arguments.at(0).toUInt());
+        return true;
+    }
+
+    job_hash.clear();
+    job_file_size = 0;
+    processor->set_transport(active_transport());
+    job_group(job->type)->set_parameters((check_V2_Protocol->isChecked() ? 1 : 0), edit_MTU->value(), retries, (job->type == JOB_TYPE_IMG_ERASE ? timeout_erase_ms : timeout_ms), mode);
+
+    //Groups can report errors whilst a job is being started, these are recorded by job_complete() without moving on
+    job_starting = true;
+
+    switch (job->type)
+    {
+        case JOB_TYPE_IMG_UPLOAD:
+        {
+            started = smp_groups.img_mgmt->start_firmware_update(job->arguments.at(0).toUShort(), job->arguments.at(1), false, &job_hash);
+            break;
+        }
+
+        case JOB_TYPE_IMG_TEST:
+        case JOB_TYPE_IMG_CONFIRM:
+        {
+            if (job->hash.isEmpty())
+            {
+                //Hash is from an earlier upload job, which this job depends on so has completed
+                job->hash = jobs.find(job->arguments.at(0).mid(1).toUShort())->hash;
+            }
+
+            started = smp_groups.img_mgmt->start_image_set(&job->hash, (job->type == JOB_TYPE_IMG_CONFIRM), nullptr);
+            break;
+        }
+
+        case JOB_TYPE_IMG_LIST:
+        {
+            job_images.clear();
+            started = smp_groups.img_mgmt->start_image_get(&job_images);
+            break;
+        }
+
+        case JOB_TYPE_IMG_ERASE:
+        {
+            started = smp_groups.img_mgmt->start_image_erase(job->arguments.at(0).toUShort());
+            break;
+        }
+
+        case JOB_TYPE_FS_UPLOAD:
+        {
+            started = smp_groups.fs_mgmt->start_upload(job->arguments.at(0), job->arguments.at(1), (job->arguments.length() > 2 ? job->arguments.at(2) : QString()), &job_hash);
+            break;
+        }
+
+        case JOB_TYPE_FS_DOWNLOAD:
+        {
+            started = smp_groups.fs_mgmt->start_download(job->arguments.at(0), job->arguments.at(1), (job->arguments.length() > 2 ? job->arguments.at(2) : QString()), &job_hash);
+            break;
+        }
+
+        case JOB_TYPE_FS_STATUS:
+        {
+            started = smp_groups.fs_mgmt->start_status(job->arguments.at(0), &job_file_size);
+            break;
+        }
+
+        case JOB_TYPE_FS_HASH:
+        {
+            started = smp_groups.fs_mgmt->start_hash_checksum(job->arguments.at(0), (job->arguments.length() > 1 ? job->arguments.at(1) : QString()), &job_hash, &job_file_size);
+            break;
+        }
+
+        case JOB_TYPE_OS_ECHO:
+        {
+            started = smp_groups.os_mgmt->start_echo(job->arguments.join(" "));
+            break;
+        }
+
+        case JOB_TYPE_OS_INFO:
+        {
+            started = smp_groups.os_mgmt->start_os_application_info((job->arguments.length() > 0 ? job->arguments.at(0) : QString()));
+            break;
+        }
+
+        case JOB_TYPE_OS_RESET:
+        {
+            started = smp_groups.os_mgmt->start_reset(false);
+            break;
+        }
+
+        default:
+        {
+        }
+    }
+
+    job_starting = false;
+
+    if (started == false && job->state == JOB_STATE_RUNNING)
+    {
+        jobs.set_result(QDateTime::currentMSecsSinceEpoch(), JOB_STATE_FAILED, "Failed to start");
+    }
+
+    return started;
+}
+
+//Starts the next job which can be run, returns false if there are no more jobs or the queue should stop
+bool plugin_mcumgr::job_start_next()
+{
+    job_t *job = jobs.next(QDateTime::currentMSecsSinceEpoch(), check_JOB_Reorder->isChecked());
+
+    while (job != nullptr)
+    {
+        if (job_start(job) == true)
+        {
+            lbl_JOB_Status->setText(QString("Job %1/%2: %3...").arg(QString::number(job->id), QString::number(jobs.job_count()), job->command));
+            return true;
+        }
+
+        edit_JOB_Log->appendPlainText(jobs.describe(job));
+
+        if (check_JOB_Continue->isChecked() == false)
+        {
+            break;
+        }
+
+        job = jobs.next(QDateTime::currentMSecsSinceEpoch(), check_JOB_Reorder->isChecked());
+    }
+
+    return false;
+}
+
+//Records the outcome of the running job and starts the next one, returns true if the queue has finished
+bool plugin_mcumgr::job_complete(group_status status, QString *status_message)
+{
+    job_t *job = jobs.current();
+    job_state state = JOB_STATE_FAILED;
+    QString result;
+
+    if (job_running == false || job == nullptr)
+    {
+        return true;
+    }
+
+    if (job_starting == true)
+    {
+        jobs.set_result(QDateTime::currentMSecsSinceEpoch(), JOB_STATE_FAILED, *status_message);
+        *status_message = nullptr;
+        return false;
+    }
+
+    if (status == STATUS_COMPLETE)
+    {
+        state = JOB_STATE_DONE;
+
+        switch (job->type)
+        {
+            case JOB_TYPE_IMG_UPLOAD:
+            {
+                job->hash = job_hash;
+                result = QString("hash ").append(job_hash.toHex());
+                break;
+            }
+
+            case JOB_TYPE_IMG_LIST:
+            {
+                QStringList slot_descriptions;
+
+                while (job_images.length() > 0)
+                {
+                    image_state_t image = job_images.takeFirst();
+                    uint8_t i = 0;
+
+                    while (i < image.slot_list.length())
+                    {
+                        const slot_state_t *slot = &image.slot_list.at(i);
+
+                        slot_descriptions << QString("image %1 slot %2 %3%4%5%6").arg(QString::number(image.image), QString::number(slot->slot), QString(slot->version), QString(slot->active ? " active" : ""), QString(slot->confirmed ? " confirmed" : ""), QString(slot->pending ? " pending" : ""));
+                        ++i;
+                    }
+
+                    //Image state items are not displayed, free them
+                    delete image.item;
+                }
+
+                result = slot_descriptions.join(", ");
+                break;
+            }
+
+            case JOB_TYPE_FS_STATUS:
+            {
+                result = QString::number(job_file_size).append(" bytes");
+                break;
+            }
+
+            case JOB_TYPE_FS_HASH:
+            {
+                result = QString("%1 %2, %3 bytes").arg(*status_message, job_hash.toHex(), QString::number(job_file_size));
+                break;
+            }
+
+            default:
+            {
+                result = *status_message;
+            }
+        }
+    }
+    else if (status == STATUS_CANCELLED)
+    {
+        state = JOB_STATE_CANCELLED;
+    }
+    else if (status_message->isEmpty() == false)
+    {
+        result = *status_message;
+    }
+    else if (status == STATUS_TIMEOUT)
+    {
+        result = "Command timed out";
+    }
+    else if (status == STATUS_UNSUPPORTED)
+    {
+        result = "Unsupported";
+    }
+    else
+    {
+        result = "Error";
+    }
+
+    jobs.set_result(QDateTime::currentMSecsSinceEpoch(), state, result);
+    edit_JOB_Log->appendPlainText(jobs.describe(job));
+    progress_JOB_Complete->setValue(jobs.progress(0));
+
+    if (state == JOB_STATE_DONE || (state == JOB_STATE_FAILED && check_JOB_Continue->isChecked() == true))
+    {
+        //Start the next job from the event loop rather than going back to idle, groups return to idle after they have
+        //emitted their status so a job started from here for the same group would have its mode reset
+        job_next_pending = true;
+        QTimer::singleShot(0, this, SLOT(job_next_deferred()));
+        *status_message = nullptr;
+        return false;
+    }
+
+    job_finish(status_message);
+
+    return true;
+}
+
+void plugin_mcumgr::img_upload_deferred()
+{
+    if (mode != ACTION_IMG_UPLOAD)
+    {
+        return;
+    }
+
+    //Errors starting the upload are reported to the status handler, which finishes the upload
+    processor->set_transport(active_transport());
+    smp_groups.img_mgmt->set_parameters((check_V2_Protocol->isChecked() ? 1 : 0), edit_MTU->value(), retries, timeout_ms, mode);
+    smp_groups.img_mgmt->start_firmware_update(edit_IMG_Image->value(), edit_IMG_Local->text(), check_IMG_Upgrade->isChecked(), &upload_hash);
+}
+
+void plugin_mcumgr::job_next_deferred()
+{
+    QString status_message;
+
+    if (job_next_pending == false)
+    {
+        return;
+    }
+
+    job_next_pending = false;
+
+    if (job_start_next() == true)
+    {
+        return;
+    }
+
+    job_finish(&status_message);
+    mode = ACTION_IDLE;
+    relase_transport();
+    lbl_JOB_Status->setText(status_message);
+}
+
+void plugin_mcumgr::job_finish(QString *status_message)
+{
+    uint16_t i = 1;
+    job_t *job;
+
+    job_running = false;
+    btn_JOB_Go->setText("Go");
+
+    //Jobs which were skipped because a dependency did not complete were never started, so have not been logged
+    while ((job = jobs.find(i)) != nullptr)
+    {
+        if (job->state == JOB_STATE_SKIPPED)
+        {
+            edit_JOB_Log->appendPlainText(jobs.describe(job));
+        }
+
+        ++i;
+    }
+
+    *status_message = QString("Jobs finished, %1/%2 successful").arg(QString::number(jobs.count_state(JOB_STATE_DONE)), QString::number(jobs.job_count()));
+
+    if (jobs.count_state(JOB_STATE_FAILED) > 0)
+    {
+        status_message->append(QString(", %1 failed").arg(QString::number(jobs.count_state(JOB_STATE_FAILED))));
+    }
+
+    if (jobs.count_state(JOB_STATE_SKIPPED) + jobs.count_state(JOB_STATE_PENDING) + jobs.count_state(JOB_STATE_CANCELLED) > 0)
+    {
+        status_message->append(QString(", %1 not run").arg(QString::number(jobs.count_state(JOB_STATE_SKIPPED) + jobs.count_state(JOB_STATE_PENDING) + jobs.count_state(JOB_STATE_CANCELLED))));
+    }
+}
+
+//Stops the job queue, the running job is cancelled and the remaining jobs are not run
+void plugin_mcumgr::job_cancel()
+{
+    job_t *job = jobs.current();
+
+    if (job_running == false || job == nullptr)
+    {
+        return;
+    }
+
+    if (job_next_pending == true)
+    {
+        //Between jobs, no group is running so stop the queue here
+        QString status_message;
+
+        job_next_pending = false;
+        job_finish(&status_message);
+        mode = ACTION_IDLE;
+        relase_transport();
+        lbl_JOB_Status->setText(status_message);
+        return;
+    }
+
+    if (job->type == JOB_TYPE_WAIT)
+    {
+        QString status_message;
+
+        job_wait_timer.stop();
+        jobs.set_result(QDateTime::currentMSecsSinceEpoch(), JOB_STATE_CANCELLED, QString());
+        edit_JOB_Log->appendPlainText(jobs.describe(job));
+        job_finish(&status_message);
+        mode = ACTION_IDLE;
+        relase_transport();
+        lbl_JOB_Status->setText(status_message);
+    }
+    else
+    {
+        //The group reports the cancellation to the status handler, which stops the queue
+        job_group(job->type)->cancel();
+    }
+}
+
 void plugin_mcumgr::on_colview_IMG_Images_updatePreviewWidget(const QModelIndex &index)
 {
     uint8_t i = 0;
@@ -2478,11 +3905,54 @@ void plugin_mcumgr::status(uint8_t user_data, group_status status, QString error
 
     log_debug() << "Status: " << status;
 
-    if (sender() == smp_groups.img_mgmt)
+    if (user_data == ACTION_JOB)
+    {
+        //Jobs can be for any group, the job queue handles the outcome
+        label_status = lbl_JOB_Status;
+        finished = job_complete(status, &error_string);
+    }
+    else if (sender() == smp_groups.img_mgmt)
     {
         log_debug() << "img sender";
         label_status = lbl_IMG_Status;
 
+        if (user_data == ACTION_IMG_UPLOAD)
+        {
+            save_resume_records();
+            save_image_cache();
+        }
+        else if (user_data == ACTION_IMG_UPLOAD_CHECK)
+        {
+            bool present = false;
+
+            if (status == STATUS_COMPLETE)
+            {
+                present = smp_groups.img_mgmt->image_present(edit_IMG_Local->text(), edit_IMG_Image->value(), &upload_check_images, &upload_hash);
+                save_image_cache();
+            }
+
+            //Image state items are not displayed, free them
+            while (upload_check_images.length() > 0)
+            {
+                delete upload_check_images.takeFirst().item;
+            }
+
+            if (present == true)
+            {
+                error_string = QString("Image already present on device, upload skipped");
+            }
+            else if (status == STATUS_COMPLETE || status == STATUS_ERROR || status == STATUS_UNSUPPORTED)
+            {
+                //Image is not on the device (or image state could not be read, e.g. in serial recovery mode), upload it.
+                //The upload is started from the event loop, img mgmt returns to idle after it has emitted its status so an
+                //upload started from here would have its mode reset
+                finished = false;
+                mode = ACTION_IMG_UPLOAD;
+                error_string = QString("Uploading...");
+                QTimer::singleShot(0, this, SLOT(img_upload_deferred()));
+            }
+        }
+
         if (status == STATUS_COMPLETE)
         {
             log_debug() << "complete";
@@ -2593,7 +4063,76 @@ void plugin_mcumgr::status(uint8_t user_data, group_status status, QString error
         log_debug() << "os sender";
         label_status = lbl_OS_Status;
 
-        if (status == STATUS_COMPLETE)
+        if (user_data == ACTION_OS_LINK_PROBE && status != STATUS_CANCELLED)
+        {
+            qint64 rtt_us = link_probe_rtt.nsecsElapsed() / 1000;
+            uint16_t size = link_stats.payload_size();
+            bool success = (status == STATUS_COMPLETE && error_string == link_probe_payload);
+            QString result;
+
+            if (success == true)
+            {
+                result = QString::number((double)rtt_us / 1000.0, 'f', 1).append(" ms");
+            }
+            else if (status == STATUS_COMPLETE)
+            {
+                result = "corrupt response";
+            }
+            else if (status == STATUS_TIMEOUT)
+            {
+                result = "lost";
+            }
+            else
+            {
+                result = QString("error: ").append(error_string);
+            }
+
+            link_stats.add_result(success, rtt_us);
+            result.prepend(QString("%1 bytes: ").arg(QString::number(size)));
+            result.prepend(QDateTime::currentDateTime().toString("hh:mm:ss.zzz "));
+            edit_OS_Link_Log->appendPlainText(result);
+            lbl_OS_Link_Summary->setText(link_stats.summary());
+            log_information() << "Link probe " << result;
+            error_string = QString("Probing link, ").append(QString::number(link_stats.sent())).append(" echoes sent");
+        }
+        else if ((user_data == ACTION_MTU_DISCOVER_PARAMETERS || user_data == ACTION_MTU_DISCOVER_ECHO) && status != STATUS_CANCELLED)
+        {
+            if (user_data == ACTION_MTU_DISCOVER_PARAMETERS)
+            {
+                if (status == STATUS_COMPLETE)
+                {
+                    mtu_search.set_buffer_parameters(mtu_buffer_size, mtu_buffer_count);
+                }
+
+#if defined(PLUGIN_MCUMGR_TRANSPORT_UDP)
+                //UDP datagrams are not split, find the largest message which makes it to the device and back
+                if (active_transport() == udp_transport && status != STATUS_TIMEOUT)
+                {
+                    mtu_search.start_search();
+                }
+#endif
+            }
+            else
+            {
+                mtu_search.add_result((status == STATUS_COMPLETE && error_string == mtu_probe_payload));
+            }
+
+            if (mtu_search.searching() == true)
+            {
+                //Send the next probe from the event loop, os mgmt returns to idle after it has emitted its status (e.g.
+                //after a timed out probe) so a probe sent from here would have its response rejected
+                finished = false;
+                error_string = QString("Discovering MTU, trying ").append(QString::number(mtu_search.message_size()));
+                QTimer::singleShot(0, this, SLOT(mtu_discover_next_deferred()));
+            }
+            else
+            {
+                edit_MTU->setValue(mtu_search.result());
+                error_string = mtu_search.summary();
+                log_information() << "MTU discovery " << error_string;
+            }
+        }
+        else if (status == STATUS_COMPLETE)
         {
             log_debug() << "complete";
 
@@ -2650,15 +4189,47 @@ void plugin_mcumgr::status(uint8_t user_data, group_status status, QString error
 
                 table_OS_Memory->setSortingEnabled(true);
             }
-            else if (user_data == ACTION_OS_TASK_STATS)
+            else if (user_data == ACTION_OS_TASK_STATS || user_data == ACTION_OS_TASK_PROFILE)
             {
                 uint16_t i = 0;
                 uint16_t l = table_OS_Tasks->rowCount();
+                uint16_t regressions = 0;
 
+                task_profile.add_snapshot(QDateTime::currentMSecsSinceEpoch(), &task_list);
                 table_OS_Tasks->setSortingEnabled(false);
 
                 while (i < task_list.length())
                 {
+                    const task_profile_t *profile = task_profile.profile(task_list[i].name);
+                    QString cpu_text;
+                    QString switch_rate_text;
+                    QString stack_peak_text;
+                    QString stack_baseline_text;
+                    uint32_t baseline_peak = 0;
+
+                    if (profile != nullptr)
+                    {
+                        if (profile->rates_valid == true)
+                        {
+                            cpu_text = QString::number(profile->cpu_percent, 'f', 1);
+                            switch_rate_text = QString::number(profile->context_switch_rate, 'f', 1);
+                        }
+
+                        stack_peak_text = QString::number(profile->stack_peak * sizeof(uint32_t));
+
+                        if (task_profile.stack_regression(task_list[i].name, &baseline_peak) == true)
+                        {
+                            //Stack high-water mark has grown beyond the saved baseline
+                            stack_peak_text.append(" !");
+                            ++regressions;
+                        }
+
+                        if (task_profile.get_baseline(task_list[i].name, &baseline_peak) == true)
+                        {
+                            stack_baseline_text = QString::number(baseline_peak * sizeof(uint32_t));
+                        }
+                    }
+
                     if (i >= l)
                     {
                         table_OS_Tasks->insertRow(i);
@@ -2671,6 +4242,10 @@ void plugin_mcumgr::status(uint8_t user_data, group_status status, QString error
                         QTableWidgetItem *row_runtime = new QTableWidgetItem(QString::number(task_list[i].runtime));
                         QTableWidgetItem *row_stack_size = new QTableWidgetItem(QString::number(task_list[i].stack_size * 4));
                         QTableWidgetItem *row_stack_usage = new QTableWidgetItem(QString::number(task_list[i].stack_usage * 4));
+                        QTableWidgetItem *row_cpu = new QTableWidgetItem(cpu_text);
+                        QTableWidgetItem *row_switch_rate = new QTableWidgetItem(switch_rate_text);
+                        QTableWidgetItem *row_stack_peak = new QTableWidgetItem(stack_peak_text);
+                        QTableWidgetItem *row_stack_baseline = new QTableWidgetItem(stack_baseline_text);
 
                         table_OS_Tasks->setItem(i, 0, row_name);
                         table_OS_Tasks->setItem(i, 1, row_id);
@@ -2680,6 +4255,10 @@ void plugin_mcumgr::status(uint8_t user_data, group_status status, QString error
                         table_OS_Tasks->setItem(i, 5, row_runtime);
                         table_OS_Tasks->setItem(i, 6, row_stack_size);
                         table_OS_Tasks->setItem(i, 7, row_stack_usage);
+                        table_OS_Tasks->setItem(i, 8, row_cpu);
+                        table_OS_Tasks->setItem(i, 9, row_switch_rate);
+                        table_OS_Tasks->setItem(i, 10, row_stack_peak);
+                        table_OS_Tasks->setItem(i, 11, row_stack_baseline);
                     }
                     else
                     {
@@ -2691,6 +4270,10 @@ void plugin_mcumgr::status(uint8_t user_data, group_status status, QString error
                         table_OS_Tasks->item(i, 5)->setText(QString::number(task_list[i].runtime));
                         table_OS_Tasks->item(i, 6)->setText(QString::number(task_list[i].stack_size * sizeof(uint32_t)));
                         table_OS_Tasks->item(i, 7)->setText(QString::number(task_list[i].stack_usage * sizeof(uint32_t)));
+                        table_OS_Tasks->item(i, 8)->setText(cpu_text);
+                        table_OS_Tasks->item(i, 9)->setText(switch_rate_text);
+                        table_OS_Tasks->item(i, 10)->setText(stack_peak_text);
+                        table_OS_Tasks->item(i, 11)->setText(stack_baseline_text);
                     }
 
                     ++i;
@@ -2703,6 +4286,21 @@ void plugin_mcumgr::status(uint8_t user_data, group_status status, QString error
                 }
 
                 table_OS_Tasks->setSortingEnabled(true);
+
+                if (user_data == ACTION_OS_TASK_PROFILE)
+                {
+                    error_string = QString("Profiling, ").append(QString::number(task_profile.snapshot_count())).append(" snapshots");
+                }
+
+                if (regressions > 0)
+                {
+                    if (error_string != nullptr)
+                    {
+                        error_string.append(", ");
+                    }
+
+                    error_string.append(QString::number(regressions)).append(" task(s) exceed stack baseline");
+                }
             }
             else if (user_data == ACTION_OS_MCUMGR_BUFFER)
             {
@@ -2807,8 +4405,63 @@ void plugin_mcumgr::status(uint8_t user_data, group_status status, QString error
                 }
                 else
                 {
-                    error_string = QString("Finished, error (ret): ").append(QString::number(shell_rc));
+                    error_string = QString("Finished, error (ret): ").append(QString::number(shell_rc));
+                }
+            }
+        }
+
+        if (user_data == ACTION_SHELL_BATCH)
+        {
+            shell_batch_result result;
+            bool next = false;
+
+            switch (status)
+            {
+                case STATUS_COMPLETE:
+                {
+                    edit_SHELL_Output->add_dat_in_text(error_string.toUtf8());
+                    result = (shell_rc == 0 ? SHELL_BATCH_RESULT_OK : SHELL_BATCH_RESULT_FAILED);
+                    shell_commands.set_result(QDateTime::currentMSecsSinceEpoch(), result, shell_rc, error_string, QString());
+                    break;
+                }
+                case STATUS_TIMEOUT:
+                {
+                    result = SHELL_BATCH_RESULT_TIMEOUT;
+                    shell_commands.set_result(QDateTime::currentMSecsSinceEpoch(), result, 0, QString(), error_string);
+                    break;
+                }
+                case STATUS_CANCELLED:
+                {
+                    result = SHELL_BATCH_RESULT_CANCELLED;
+                    shell_commands.set_result(QDateTime::currentMSecsSinceEpoch(), result, 0, QString(), "Cancelled");
+                    break;
+                }
+                default:
+                {
+                    result = SHELL_BATCH_RESULT_ERROR;
+                    shell_commands.set_result(QDateTime::currentMSecsSinceEpoch(), result, 0, QString(), error_string);
                 }
+            };
+
+            edit_SHELL_Output->update_display();
+
+            if (result != SHELL_BATCH_RESULT_CANCELLED && (result == SHELL_BATCH_RESULT_OK || check_SHELL_Batch_Continue->isChecked()))
+            {
+                //Send the next command from the event loop rather than going back to idle, shell mgmt returns to idle
+                //after it has emitted its status so a command sent from here would have its mode reset
+                shell_batch_next_pending = true;
+                QTimer::singleShot(0, this, SLOT(shell_batch_next_deferred()));
+                next = true;
+            }
+
+            if (next == true)
+            {
+                finished = false;
+                error_string = nullptr;
+            }
+            else
+            {
+                shell_batch_finish(&error_string);
             }
         }
     }
@@ -2821,30 +4474,92 @@ void plugin_mcumgr::status(uint8_t user_data, group_status status, QString error
         {
             log_debug() << "complete";
 
-            if (user_data == ACTION_STAT_GROUP_DATA)
+            if (user_data == ACTION_STAT_SAMPLE)
+            {
+                uint16_t i = 0;
+
+                //Counters are prefixed with the group name when sampling more than one group
+                while (i < stat_list.length())
+                {
+                    stat_value_t value = stat_list.at(i);
+
+                    if (stat_samples.groups().length() > 1)
+                    {
+                        value.name.prepend(".").prepend(stat_samples.groups().at(stat_sample_group));
+                    }
+
+                    stat_sample_values.append(value);
+                    ++i;
+                }
+
+                ++stat_sample_group;
+
+                if (stat_sample_group < stat_samples.groups().length())
+                {
+                    //Fetch the next group from the event loop, stat mgmt returns to idle after it has emitted its status
+                    finished = false;
+                    error_string = nullptr;
+                    QTimer::singleShot(0, this, SLOT(stat_sample_next_deferred()));
+                }
+            }
+
+            if (user_data == ACTION_STAT_GROUP_DATA || (user_data == ACTION_STAT_SAMPLE && finished == true))
             {
+                const QList<stat_value_t> *values = (user_data == ACTION_STAT_SAMPLE ? &stat_sample_values : &stat_list);
                 uint16_t i = 0;
                 uint16_t l = table_STAT_Values->rowCount();
 
+                if (user_data == ACTION_STAT_SAMPLE)
+                {
+                    stat_samples.add_sample(stat_sample_time, values);
+                    graph_STAT->update();
+                    error_string = QString("Sampling, ").append(QString::number(stat_samples.sample_count())).append(" samples");
+                }
+
                 table_STAT_Values->setSortingEnabled(false);
 
-                while (i < stat_list.length())
+                while (i < values->length())
                 {
+                    QString delta_text;
+                    QString rate_text;
+
+                    if (user_data == ACTION_STAT_SAMPLE)
+                    {
+                        int32_t counter = stat_samples.counter_index(values->at(i).name);
+                        uint32_t delta;
+                        double rate;
+
+                        if (counter != -1 && stat_samples.delta(counter, (stat_samples.sample_count() - 1), &delta) == true)
+                        {
+                            delta_text = QString::number(delta);
+                        }
+
+                        if (counter != -1 && stat_samples.rate(counter, (stat_samples.sample_count() - 1), &rate) == true)
+                        {
+                            rate_text = QString::number(rate, 'f', 2);
+                        }
+                    }
+
                     if (i >= l)
                     {
                         table_STAT_Values->insertRow(i);
 
-                        QTableWidgetItem *row_name = new QTableWidgetItem(stat_list[i].name);
-                        QTableWidgetItem *row_value = new QTableWidgetItem(QString::number(stat_list[i].value));
-
+                        QTableWidgetItem *row_name = new QTableWidgetItem(values->at(i).name);
+                        QTableWidgetItem *row_value = new QTableWidgetItem(QString::number(values->at(i).value));
+                        QTableWidgetItem *row_delta = new QTableWidgetItem(delta_text);
+                        QTableWidgetItem *row_rate = new QTableWidgetItem(rate_text);
 
                         table_STAT_Values->setItem(i, 0, row_name);
                         table_STAT_Values->setItem(i, 1, row_value);
+                        table_STAT_Values->setItem(i, 2, row_delta);
+                        table_STAT_Values->setItem(i, 3, row_rate);
                     }
                     else
                     {
-                        table_STAT_Values->item(i, 0)->setText(stat_list[i].name);
-                        table_STAT_Values->item(i, 1)->setText(QString::number(stat_list[i].value));
+                        table_STAT_Values->item(i, 0)->setText(values->at(i).name);
+                        table_STAT_Values->item(i, 1)->setText(QString::number(values->at(i).value));
+                        table_STAT_Values->item(i, 2)->setText(delta_text);
+                        table_STAT_Values->item(i, 3)->setText(rate_text);
                     }
 
                     ++i;
@@ -2870,17 +4585,19 @@ void plugin_mcumgr::status(uint8_t user_data, group_status status, QString error
         log_debug() << "fs sender";
         label_status = lbl_FS_Status;
 
+        if (user_data == ACTION_FS_DOWNLOAD)
+        {
+            save_resume_records();
+        }
+
         if (status == STATUS_COMPLETE)
         {
             log_debug() << "complete";
 
-            if (user_data == ACTION_FS_UPLOAD)
+            if (user_data == ACTION_FS_UPLOAD || user_data == ACTION_FS_DOWNLOAD)
             {
-                //edit_FS_Log->appendPlainText("todo");
-            }
-            else if (user_data == ACTION_FS_DOWNLOAD)
-            {
-                //edit_FS_Log->appendPlainText("todo2");
+                //Hash/checksum of the file on the device, if the transfer was verified
+                edit_FS_Result->setText(fs_hash_checksum_response.toHex());
             }
             else if (user_data == ACTION_FS_HASH_CHECKSUM)
             {
@@ -2928,6 +4645,59 @@ void plugin_mcumgr::status(uint8_t user_data, group_status status, QString error
             else if (user_data == ACTION_SETTINGS_WRITE || user_data == ACTION_SETTINGS_DELETE || user_data == ACTION_SETTINGS_COMMIT || user_data == ACTION_SETTINGS_LOAD || user_data == ACTION_SETTINGS_SAVE)
             {
             }
+            else if (user_data == ACTION_SETTINGS_SNAPSHOT)
+            {
+                //Keys which could not be read for a reason other than not existing are left out of the snapshot
+                settings_snapshot snapshot;
+                QString error;
+
+                snapshot.set_from_entries(&settings_bulk_entries);
+
+                if (snapshot.save(settings_snapshot_file, &error) == false)
+                {
+                    error_string = QString("Error: Failed to save snapshot: ").append(error);
+                }
+                else
+                {
+                    error_string = QString("Snapshot saved, ").append(error_string);
+                }
+            }
+            else if (user_data == ACTION_SETTINGS_APPLY_READ)
+            {
+                settings_snapshot current;
+                uint16_t changes;
+
+                current.set_from_entries(&settings_bulk_entries);
+                changes = settings_bulk_target.diff(&current, &settings_bulk_entries);
+
+                if (changes == 0)
+                {
+                    error_string = QString("No changes required, device matches ").append(QString::number(settings_bulk_target.count())).append(" keys");
+                }
+                else
+                {
+                    //Write the changed keys, then commit and save them
+                    finished = false;
+
+                    mode = ACTION_SETTINGS_APPLY_WRITE;
+                    processor->set_transport(active_transport());
+                    smp_groups.settings_mgmt->set_parameters((check_V2_Protocol->isChecked() ? 1 : 0), edit_MTU->value(), retries, timeout_ms, mode);
+
+                    if (smp_groups.settings_mgmt->start_bulk(&settings_bulk_entries, 0, true) == true)
+                    {
+                        error_string = QString("Writing %1 changed keys...").arg(QString::number(changes));
+                    }
+                    else
+                    {
+                        finished = true;
+                        error_string = "Error: Failed to start writing changes";
+                    }
+                }
+            }
+            else if (user_data == ACTION_SETTINGS_APPLY_WRITE)
+            {
+                error_string = QString("Changes applied, ").append(error_string);
+            }
         }
     }
     else if (sender() == smp_groups.zephyr_mgmt)
@@ -2981,11 +4751,13 @@ void plugin_mcumgr::status(uint8_t user_data, group_status status, QString error
 
 void plugin_mcumgr::progress(uint8_t user_data, uint8_t percent)
 {
-    Q_UNUSED(user_data);
-
     log_debug() << "Progress " << percent << " from " << this->sender();
 
-    if (this->sender() == smp_groups.img_mgmt)
+    if (user_data == ACTION_JOB)
+    {
+        progress_JOB_Complete->setValue(jobs.progress(percent));
+    }
+    else if (this->sender() == smp_groups.img_mgmt)
     {
         log_debug() << "img sender";
         progress_IMG_Complete->setValue(percent);
@@ -2995,6 +4767,11 @@ void plugin_mcumgr::progress(uint8_t user_data, uint8_t percent)
         log_debug() << "fs sender";
         progress_FS_Complete->setValue(percent);
     }
+    else if (this->sender() == smp_groups.settings_mgmt)
+    {
+        //Settings has no progress bar, only bulk operations report progress
+        lbl_settings_status->setText(QString((user_data == ACTION_SETTINGS_APPLY_WRITE ? "Writing... " : "Reading... ")).append(QString::number(percent)).append("%"));
+    }
 }
 
 void plugin_mcumgr::group_to_hex(QByteArray *data)
@@ -3021,6 +4798,121 @@ void plugin_mcumgr::on_btn_transport_connect_clicked()
     }
 }
 
+void plugin_mcumgr::on_btn_MTU_Discover_clicked()
+{
+    mtu_discover_start();
+}
+
+void plugin_mcumgr::transport_connected()
+{
+    if (sender() == active_transport() && mode == ACTION_IDLE && check_MTU_Auto->isChecked() == true)
+    {
+        mtu_discover_start();
+    }
+}
+
+void plugin_mcumgr::on_check_Transport_Reconnect_toggled(bool checked)
+{
+    reconnect_transport->set_enabled(checked);
+}
+
+void plugin_mcumgr::uart_reopen(bool *opened)
+{
+    emit plugin_serial_open_close(0);
+    emit plugin_serial_is_open(opened);
+}
+
+void plugin_mcumgr::transport_link_lost()
+{
+    log_information() << "Link to device lost, reconnecting";
+}
+
+void plugin_mcumgr::transport_link_restored()
+{
+    log_information() << "Link to device restored";
+}
+
+//Outstanding messages have already been failed by the processor, finish the clean up of a UART whose port could not be reopened
+void plugin_mcumgr::transport_link_failed()
+{
+    log_error() << "Could not reconnect to device";
+
+    if (uart_reconnecting == true)
+    {
+        uart_reconnecting = false;
+        serial_closed();
+    }
+}
+
+//Queries the device buffer parameters, then on transports which cannot split messages searches for the largest echo which
+//round-trips, the MTU used by all groups is updated once discovery has finished
+bool plugin_mcumgr::mtu_discover_start()
+{
+    if (mode != ACTION_IDLE)
+    {
+        lbl_OS_Status->setText("Error: Cannot discover MTU whilst another command is in progress");
+        return false;
+    }
+
+    if (claim_transport(lbl_OS_Status) == false)
+    {
+        return false;
+    }
+
+    mtu_search.clear(edit_MTU->value());
+    mtu_search.set_transport_mtu(active_transport()->get_mtu());
+    mtu_buffer_size = 0;
+    mtu_buffer_count = 0;
+    mode = ACTION_MTU_DISCOVER_PARAMETERS;
+    processor->set_transport(active_transport());
+    smp_groups.os_mgmt->set_parameters((check_V2_Protocol->isChecked() ? 1 : 0), edit_MTU->value(), retries, timeout_ms, mode);
+
+    if (smp_groups.os_mgmt->start_mcumgr_parameters(&mtu_buffer_size, &mtu_buffer_count) == false)
+    {
+        mode = ACTION_IDLE;
+        relase_transport();
+        return false;
+    }
+
+    lbl_OS_Status->setText("Discovering MTU...");
+
+    return true;
+}
+
+//Sends an echo which gives a message of the size being tried, no retries are used so that a failed size is not resent
+bool plugin_mcumgr::mtu_discover_send()
+{
+    fill_echo_payload(&mtu_probe_payload, mtu_search.payload_size());
+
+    mode = ACTION_MTU_DISCOVER_ECHO;
+    processor->set_transport(active_transport());
+    smp_groups.os_mgmt->set_parameters((check_V2_Protocol->isChecked() ? 1 : 0), mtu_search.message_size(), 0, timeout_ms, mode);
+
+    return smp_groups.os_mgmt->start_echo(mtu_probe_payload);
+}
+
+void plugin_mcumgr::mtu_discover_next_deferred()
+{
+    QString summary;
+
+    if (mode != ACTION_MTU_DISCOVER_PARAMETERS && mode != ACTION_MTU_DISCOVER_ECHO)
+    {
+        return;
+    }
+
+    if (mtu_discover_send() == true)
+    {
+        return;
+    }
+
+    edit_MTU->setValue(mtu_search.result());
+    summary = mtu_search.summary();
+    log_information() << "MTU discovery " << summary;
+    mode = ACTION_IDLE;
+    relase_transport();
+    lbl_OS_Status->setText(summary);
+}
+
 smp_transport *plugin_mcumgr::active_transport()
 {
     if (0)
@@ -3171,6 +5063,8 @@ void plugin_mcumgr::on_radio_settings_read_toggled(bool checked)
         edit_settings_key->setEnabled(true);
         edit_settings_value->setEnabled(true);
         edit_settings_value->setReadOnly(true);
+        edit_settings_file->setEnabled(false);
+        btn_settings_file->setEnabled(false);
     }
 }
 
@@ -3181,6 +5075,8 @@ void plugin_mcumgr::on_radio_settings_write_toggled(bool checked)
         edit_settings_key->setEnabled(true);
         edit_settings_value->setEnabled(true);
         edit_settings_value->setReadOnly(false);
+        edit_settings_file->setEnabled(false);
+        btn_settings_file->setEnabled(false);
     }
 }
 
@@ -3190,6 +5086,8 @@ void plugin_mcumgr::on_radio_settings_delete_toggled(bool checked)
     {
         edit_settings_key->setEnabled(true);
         edit_settings_value->setEnabled(false);
+        edit_settings_file->setEnabled(false);
+        btn_settings_file->setEnabled(false);
     }
 }
 
@@ -3199,6 +5097,8 @@ void plugin_mcumgr::on_radio_settings_commit_toggled(bool checked)
     {
         edit_settings_key->setEnabled(false);
         edit_settings_value->setEnabled(false);
+        edit_settings_file->setEnabled(false);
+        btn_settings_file->setEnabled(false);
     }
 }
 
@@ -3208,6 +5108,8 @@ void plugin_mcumgr::on_radio_settings_load_toggled(bool checked)
     {
         edit_settings_key->setEnabled(false);
         edit_settings_value->setEnabled(false);
+        edit_settings_file->setEnabled(false);
+        btn_settings_file->setEnabled(false);
     }
 }
 
@@ -3217,6 +5119,40 @@ void plugin_mcumgr::on_radio_settings_save_toggled(bool checked)
     {
         edit_settings_key->setEnabled(false);
         edit_settings_value->setEnabled(false);
+        edit_settings_file->setEnabled(false);
+        btn_settings_file->setEnabled(false);
+    }
+}
+
+void plugin_mcumgr::on_radio_settings_snapshot_toggled(bool checked)
+{
+    if (checked == true)
+    {
+        edit_settings_key->setEnabled(false);
+        edit_settings_value->setEnabled(false);
+        edit_settings_file->setEnabled(true);
+        btn_settings_file->setEnabled(true);
+    }
+}
+
+void plugin_mcumgr::on_radio_settings_apply_toggled(bool checked)
+{
+    if (checked == true)
+    {
+        edit_settings_key->setEnabled(false);
+        edit_settings_value->setEnabled(false);
+        edit_settings_file->setEnabled(true);
+        btn_settings_file->setEnabled(true);
+    }
+}
+
+void plugin_mcumgr::on_btn_settings_file_clicked()
+{
+    QString filename = QFileDialog::getOpenFileName(parent_window, (radio_settings_apply->isChecked() ? "Select settings snapshot to apply" : "Select list of keys or settings snapshot"), edit_settings_file->text(), "Settings snapshot (*.json);;Key list (*.txt);;All Files (*)");
+
+    if (!filename.isEmpty())
+    {
+        edit_settings_file->setText(filename);
     }
 }
 
@@ -3323,6 +5259,41 @@ void plugin_mcumgr::on_btn_settings_go_clicked()
             lbl_settings_status->setText("Saving...");
         }
     }
+    else if (radio_settings_snapshot->isChecked() || radio_settings_apply->isChecked())
+    {
+        QString error;
+
+        if (edit_settings_file->text().isEmpty())
+        {
+            lbl_settings_status->setText("Error: Bulk file is required");
+        }
+        else if (settings_bulk_target.load(edit_settings_file->text(), &error) == false)
+        {
+            lbl_settings_status->setText(QString("Error: Failed to load bulk file: ").append(error));
+        }
+        else
+        {
+            if (radio_settings_snapshot->isChecked())
+            {
+                settings_snapshot_file = QFileDialog::getSaveFileName(parent_window, "Select file to save settings snapshot to", "", "Settings snapshot (*.json);;All Files (*)");
+            }
+
+            if (radio_settings_apply->isChecked() || !settings_snapshot_file.isEmpty())
+            {
+                //Both snapshot and apply start by reading the current value of every key, apply then writes only the keys which differ
+                mode = (radio_settings_snapshot->isChecked() ? ACTION_SETTINGS_SNAPSHOT : ACTION_SETTINGS_APPLY_READ);
+                settings_bulk_target.read_entries(&settings_bulk_entries);
+                processor->set_transport(active_transport());
+                smp_groups.settings_mgmt->set_parameters((check_V2_Protocol->isChecked() ? 1 : 0), edit_MTU->value(), retries, timeout_ms, mode);
+                started = smp_groups.settings_mgmt->start_bulk(&settings_bulk_entries, 0, false);
+
+                if (started == true)
+                {
+                    lbl_settings_status->setText(QString("Reading %1 keys...").arg(QString::number(settings_bulk_entries.length())));
+                }
+            }
+        }
+    }
 
     if (started == false)
     {
@@ -3339,6 +5310,145 @@ void plugin_mcumgr::setup_finished()
 #if defined(PLUGIN_MCUMGR_TRANSPORT_UDP)
     udp_transport->setup_finished();
 #endif
+
+    load_resume_records();
+    load_image_cache();
+    load_task_baseline();
+
+    //The plugin is set up when its tab is first opened, by which time the serial port may already be open
+    show_transport_open_status();
+}
+
+void plugin_mcumgr::save_resume_records()
+{
+    img_mgmt_resume_t img_resume;
+    fs_mgmt_resume_t fs_resume;
+
+    if (smp_groups.img_mgmt->get_resume(&img_resume) == true)
+    {
+        emit plugin_save_setting("mcumgr_img_resume", QStringList() << img_resume.file_name << img_resume.session_hash.toHex() << QString::number(img_resume.image) << QString::number(img_resume.offset));
+    }
+    else
+    {
+        emit plugin_save_setting("mcumgr_img_resume", QStringList());
+    }
+
+    if (smp_groups.fs_mgmt->get_resume(&fs_resume) == true)
+    {
+        emit plugin_save_setting("mcumgr_fs_resume", QStringList() << fs_resume.device_file_name << fs_resume.local_file_name << QString::number(fs_resume.file_size) << QString::number(fs_resume.offset));
+    }
+    else
+    {
+        emit plugin_save_setting("mcumgr_fs_resume", QStringList());
+    }
+}
+
+void plugin_mcumgr::save_image_cache()
+{
+    QStringList entries;
+    uint8_t i = 0;
+
+    while (i < image_cache.length())
+    {
+        entries << QStringList({image_cache.at(i).file_name, QString::number(image_cache.at(i).file_size), QString::number(image_cache.at(i).modified), QString::number(image_cache.at(i).endian), QString(image_cache.at(i).hash.toHex()), QString(image_cache.at(i).session_hash.toHex()), image_cache.at(i).version}).join("\t");
+        ++i;
+    }
+
+    emit plugin_save_setting("mcumgr_img_cache", entries);
+}
+
+void plugin_mcumgr::load_image_cache()
+{
+    QVariant data;
+    bool found = false;
+
+    emit plugin_load_setting("mcumgr_img_cache", &data, &found);
+
+    if (found == true)
+    {
+        QStringList entries = data.toStringList();
+        uint8_t i = 0;
+
+        image_cache.clear();
+
+        while (i < entries.length() && i < MAX_IMAGE_CACHE)
+        {
+            QStringList fields = entries.at(i).split("\t");
+
+            if (fields.length() == 7)
+            {
+                image_cache_t entry;
+
+                entry.file_name = fields.at(0);
+                entry.file_size = fields.at(1).toLongLong();
+                entry.modified = fields.at(2).toLongLong();
+                entry.endian = (image_endian_t)fields.at(3).toUInt();
+                entry.hash = QByteArray::fromHex(fields.at(4).toLatin1());
+                entry.session_hash = QByteArray::fromHex(fields.at(5).toLatin1());
+                entry.version = fields.at(6);
+                image_cache.append(entry);
+            }
+
+            ++i;
+        }
+    }
+}
+
+void plugin_mcumgr::load_task_baseline()
+{
+    QVariant data;
+    bool found = false;
+
+    emit plugin_load_setting("mcumgr_task_stack_baseline", &data, &found);
+
+    if (found == true)
+    {
+        task_profile.set_baseline(data.toStringList());
+    }
+}
+
+void plugin_mcumgr::load_resume_records()
+{
+    QVariant data;
+    QStringList record;
+    bool found = false;
+
+    emit plugin_load_setting("mcumgr_img_resume", &data, &found);
+
+    if (found == true)
+    {
+        record = data.toStringList();
+
+        if (record.length() == 4)
+        {
+            img_mgmt_resume_t img_resume;
+
+            img_resume.file_name = record.at(0);
+            img_resume.session_hash = QByteArray::fromHex(record.at(1).toLatin1());
+            img_resume.image = record.at(2).toUInt();
+            img_resume.offset = record.at(3).toUInt();
+            smp_groups.img_mgmt->set_resume(&img_resume);
+        }
+    }
+
+    found = false;
+    emit plugin_load_setting("mcumgr_fs_resume", &data, &found);
+
+    if (found == true)
+    {
+        record = data.toStringList();
+
+        if (record.length() == 4)
+        {
+            fs_mgmt_resume_t fs_resume;
+
+            fs_resume.device_file_name = record.at(0);
+            fs_resume.local_file_name = record.at(1);
+            fs_resume.file_size = record.at(2).toUInt();
+            fs_resume.offset = record.at(3).toUInt();
+            smp_groups.fs_mgmt->set_resume(&fs_resume);
+        }
+    }
 }
 
 void plugin_mcumgr::flip_endian(uint8_t *data, uint8_t size)
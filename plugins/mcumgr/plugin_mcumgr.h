@@ -28,6 +28,7 @@
 #include <QMainWindow>
 #include <QCryptographicHash>
 #include <QElapsedTimer>
+#include <QTimer>
 #include <QCborStreamReader>
 #include <QCborStreamWriter>
 #include <QCborArray>
@@ -85,11 +86,19 @@
 #include <QtWidgets/QVBoxLayout>
 #include <QtWidgets/QWidget>
 #include "AutScrollEdit.h"
+#include "stat_graph.h"
 ///AUTOGEN_END_INCLUDES
+#include "task_profiler.h"
+#include "shell_batch.h"
+#include "settings_snapshot.h"
+#include "link_probe.h"
+#include "mtu_discovery.h"
+#include "job_queue.h"
 
 enum mcumgr_action_t {
     ACTION_IDLE,
 
+    ACTION_IMG_UPLOAD_CHECK,
     ACTION_IMG_UPLOAD,
     ACTION_IMG_UPLOAD_SET,
     ACTION_OS_UPLOAD_RESET,
@@ -99,6 +108,8 @@ enum mcumgr_action_t {
 
     ACTION_OS_ECHO,
     ACTION_OS_TASK_STATS,
+    ACTION_OS_TASK_PROFILE,
+    ACTION_OS_LINK_PROBE,
     ACTION_OS_MEMORY_POOL,
     ACTION_OS_RESET,
     ACTION_OS_DATETIME_GET,
@@ -108,9 +119,11 @@ enum mcumgr_action_t {
     ACTION_OS_BOOTLOADER_INFO,
 
     ACTION_SHELL_EXECUTE,
+    ACTION_SHELL_BATCH,
 
     ACTION_STAT_GROUP_DATA,
     ACTION_STAT_LIST_GROUPS,
+    ACTION_STAT_SAMPLE,
 
     ACTION_FS_UPLOAD,
     ACTION_FS_DOWNLOAD,
@@ -124,8 +137,16 @@ enum mcumgr_action_t {
     ACTION_SETTINGS_COMMIT,
     ACTION_SETTINGS_LOAD,
     ACTION_SETTINGS_SAVE,
+    ACTION_SETTINGS_SNAPSHOT,
+    ACTION_SETTINGS_APPLY_READ,
+    ACTION_SETTINGS_APPLY_WRITE,
 
     ACTION_ZEPHYR_STORAGE_ERASE,
+
+    ACTION_MTU_DISCOVER_PARAMETERS,
+    ACTION_MTU_DISCOVER_ECHO,
+
+    ACTION_JOB,
 };
 
 class plugin_mcumgr : public QObject, AutPlugin
@@ -150,9 +171,12 @@ signals:
     void plugin_to_hex(QByteArray *data);
     void plugin_serial_open_close(uint8_t mode);
     void plugin_serial_is_open(bool *open);
+    void plugin_save_setting(QString name, QVariant data);
+    void plugin_load_setting(QString name, QVariant *data, bool *found);
+    void plugin_data_subscribe(QObject *receiver, quint32 flags, qint32 queue_limit);
 
 private slots:
-    void serial_receive(QByteArray *data);
+    void plugin_data(QByteArray data, quint8 direction);
     void serial_error(QSerialPort::SerialPortError speErrorCode);
     void serial_bytes_written(qint64 intByteCount);
     void serial_about_to_close();
@@ -179,10 +203,25 @@ private slots:
     void on_radio_IMG_No_Action_toggled(bool checked);
     void on_btn_IMG_Preview_Copy_clicked();
     void on_btn_OS_Go_clicked();
+    void on_btn_OS_Tasks_Baseline_clicked();
+    void task_profile_timeout();
+    void link_probe_timeout();
     void on_btn_STAT_Go_clicked();
+    void on_btn_STAT_Export_clicked();
+    void on_table_STAT_Values_itemSelectionChanged();
+    void stat_sample_timeout();
+    void stat_sample_next_deferred();
     void on_btn_SHELL_Clear_clicked();
     void on_btn_SHELL_Copy_clicked();
+    void on_btn_SHELL_Batch_clicked();
     void on_btn_transport_connect_clicked();
+    void on_btn_MTU_Discover_clicked();
+    void transport_connected();
+    void on_check_Transport_Reconnect_toggled(bool checked);
+    void uart_reopen(bool *opened);
+    void transport_link_lost();
+    void transport_link_restored();
+    void transport_link_failed();
     void on_colview_IMG_Images_updatePreviewWidget(const QModelIndex &index);
     void on_radio_transport_uart_toggled(bool checked);
 #if defined(PLUGIN_MCUMGR_TRANSPORT_UDP)
@@ -201,6 +240,9 @@ private slots:
     void on_radio_settings_commit_toggled(bool checked);
     void on_radio_settings_load_toggled(bool checked);
     void on_radio_settings_save_toggled(bool checked);
+    void on_radio_settings_snapshot_toggled(bool checked);
+    void on_radio_settings_apply_toggled(bool checked);
+    void on_btn_settings_file_clicked();
     void on_btn_settings_go_clicked();
     void on_radio_settings_none_toggled(bool checked);
     void on_radio_settings_text_toggled(bool checked);
@@ -208,6 +250,13 @@ private slots:
     void on_check_settings_big_endian_toggled(bool checked);
     void on_check_settings_signed_decimal_value_toggled(bool checked);
     void on_btn_zephyr_go_clicked();
+    void on_btn_JOB_File_clicked();
+    void on_btn_JOB_Go_clicked();
+    void job_wait_timeout();
+    void img_upload_deferred();
+    void job_next_deferred();
+    void shell_batch_next_deferred();
+    void mtu_discover_next_deferred();
     void on_check_os_datetime_use_pc_date_time_toggled(bool checked);
     void on_radio_os_datetime_get_toggled(bool checked);
     void on_radio_os_datetime_set_toggled(bool checked);
@@ -220,6 +269,24 @@ private:
     void flip_endian(uint8_t *data, uint8_t size);
     bool update_settings_display();
     void show_transport_open_status();
+    void save_resume_records();
+    void load_resume_records();
+    void save_image_cache();
+    void load_image_cache();
+    void load_task_baseline();
+    bool link_probe_send();
+    void fill_echo_payload(QString *payload, uint16_t size);
+    bool mtu_discover_start();
+    bool mtu_discover_send();
+    bool stat_sample_start();
+    bool shell_batch_start_next();
+    void shell_batch_finish(QString *status_message);
+    smp_group *job_group(job_type type);
+    bool job_start(job_t *job);
+    bool job_start_next();
+    bool job_complete(group_status status, QString *status_message);
+    void job_finish(QString *status_message);
+    void job_cancel();
 
     //Form items
 ///AUTOGEN_START_OBJECTS
@@ -230,6 +297,9 @@ private:
     QHBoxLayout *horizontalLayout_7;
     QLabel *label;
     QSpinBox *edit_MTU;
+    QCheckBox *check_MTU_Auto;
+    QPushButton *btn_MTU_Discover;
+    QCheckBox *check_Transport_Reconnect;
     QCheckBox *check_V2_Protocol;
     QRadioButton *radio_transport_uart;
     QRadioButton *radio_transport_udp;
@@ -244,6 +314,10 @@ private:
     QGridLayout *gridLayout_4;
     QLabel *label_4;
     QCheckBox *check_IMG_Reset;
+    QLabel *label_IMG_Skip;
+    QCheckBox *check_IMG_Skip_Present;
+    QLabel *label_IMG_Upgrade;
+    QCheckBox *check_IMG_Upgrade;
     QLabel *label_6;
     QHBoxLayout *horizontalLayout_5;
     QLineEdit *edit_IMG_Local;
@@ -319,9 +393,29 @@ private:
     QPlainTextEdit *edit_OS_Echo_Input;
     QLabel *label_11;
     QPlainTextEdit *edit_OS_Echo_Output;
+    QWidget *tab_OS_Link;
+    QGridLayout *gridLayout_19;
+    QLabel *label_33;
+    QHBoxLayout *horizontalLayout_22;
+    QSpinBox *edit_OS_Link_Minimum;
+    QLabel *label_34;
+    QSpinBox *edit_OS_Link_Maximum;
+    QLabel *label_35;
+    QSpinBox *edit_OS_Link_Step;
+    QLabel *label_36;
+    QSpinBox *edit_OS_Link_Interval;
+    QLabel *label_37;
+    QLabel *lbl_OS_Link_Summary;
+    QLabel *label_38;
+    QPlainTextEdit *edit_OS_Link_Log;
     QWidget *tab_OS_Tasks;
     QGridLayout *gridLayout_14;
     QTableWidget *table_OS_Tasks;
+    QHBoxLayout *horizontalLayout_20;
+    QCheckBox *check_OS_Tasks_Profile;
+    QSpinBox *edit_OS_Tasks_Interval;
+    QSpacerItem *horizontalSpacer_21;
+    QPushButton *btn_OS_Tasks_Baseline;
     QWidget *tab_OS_Memory;
     QVBoxLayout *verticalLayout_4;
     QTableWidget *table_OS_Memory;
@@ -363,14 +457,19 @@ private:
     QHBoxLayout *horizontalLayout_9;
     QRadioButton *radio_STAT_List;
     QRadioButton *radio_STAT_Fetch;
+    QRadioButton *radio_STAT_Sample;
+    QSpinBox *edit_STAT_Interval;
     QComboBox *combo_STAT_Group;
     QHBoxLayout *horizontalLayout_14;
     QSpacerItem *horizontalSpacer_19;
     QPushButton *btn_STAT_Go;
+    QPushButton *btn_STAT_Export;
     QSpacerItem *horizontalSpacer_20;
     QLabel *label_16;
     QLabel *label_15;
     QTableWidget *table_STAT_Values;
+    QLabel *label_STAT_Graph;
+    stat_graph *graph_STAT;
     QWidget *tab_Shell;
     QGridLayout *gridLayout_9;
     QLabel *lbl_SHELL_Status;
@@ -379,10 +478,12 @@ private:
     QSpacerItem *horizontalSpacer_7;
     QToolButton *btn_SHELL_Clear;
     QToolButton *btn_SHELL_Copy;
+    QToolButton *btn_SHELL_Batch;
     QSpacerItem *horizontalSpacer_8;
     QHBoxLayout *horizontalLayout_17;
     QCheckBox *check_shell_vt100_decoding;
     QCheckBox *check_shel_unescape_strings;
+    QCheckBox *check_SHELL_Batch_Continue;
     QSpacerItem *horizontalSpacer_12;
     QWidget *tab_Settings;
     QGridLayout *gridLayout_15;
@@ -413,6 +514,12 @@ private:
     QRadioButton *radio_settings_commit;
     QRadioButton *radio_settings_load;
     QRadioButton *radio_settings_save;
+    QRadioButton *radio_settings_snapshot;
+    QRadioButton *radio_settings_apply;
+    QLabel *label_32;
+    QHBoxLayout *horizontalLayout_21;
+    QLineEdit *edit_settings_file;
+    QToolButton *btn_settings_file;
     QLineEdit *edit_settings_value;
     QLineEdit *edit_settings_decoded;
     QFrame *line_2;
@@ -428,6 +535,23 @@ private:
     QLabel *label_12;
     QSpacerItem *verticalSpacer_7;
     QLabel *lbl_zephyr_status;
+    QWidget *tab_Jobs;
+    QGridLayout *gridLayout_20;
+    QLabel *label_39;
+    QHBoxLayout *horizontalLayout_23;
+    QLineEdit *edit_JOB_File;
+    QToolButton *btn_JOB_File;
+    QHBoxLayout *horizontalLayout_24;
+    QCheckBox *check_JOB_Reorder;
+    QCheckBox *check_JOB_Continue;
+    QSpacerItem *horizontalSpacer_22;
+    QPlainTextEdit *edit_JOB_Log;
+    QProgressBar *progress_JOB_Complete;
+    QLabel *lbl_JOB_Status;
+    QHBoxLayout *horizontalLayout_25;
+    QSpacerItem *horizontalSpacer_23;
+    QPushButton *btn_JOB_Go;
+    QSpacerItem *horizontalSpacer_24;
     QWidget *tab_2;
     QWidget *verticalLayoutWidget;
     QVBoxLayout *verticalLayout;
@@ -460,12 +584,43 @@ private:
     QList<memory_pool_t> memory_list;
     int32_t shell_rc;
     QStringList group_list;
+    task_profiler task_profile;
+    QTimer task_profile_timer;
+    bool task_profiling;
+    link_probe link_stats;
+    QTimer link_probe_timer;
+    QElapsedTimer link_probe_rtt;
+    QString link_probe_payload;
+    bool link_probing;
+    mtu_discovery mtu_search;
+    uint32_t mtu_buffer_size;
+    uint32_t mtu_buffer_count;
+    QString mtu_probe_payload;
+    shell_batch shell_commands;
+    QString shell_batch_results_file;
+    bool shell_batch_running;
+    bool shell_batch_next_pending;
+    job_queue jobs;
+    QTimer job_wait_timer;
+    QByteArray job_hash;
+    uint32_t job_file_size;
+    QList<image_state_t> job_images;
+    bool job_running;
+    bool job_next_pending;
+    bool job_starting;
     QList<stat_value_t> stat_list;
+    stat_sampler stat_samples;
+    QTimer stat_sample_timer;
+    bool stat_sampling;
+    QList<stat_value_t> stat_sample_values;
+    uint16_t stat_sample_group;
+    qint64 stat_sample_time;
     QStandardItemModel model_image_state;
     error_lookup *error_lookup_form;
     smp_processor *processor;
     smp_group_array smp_groups;
     class smp_uart *uart_transport;
+    smp_reconnect *reconnect_transport;
 
 #if defined(PLUGIN_MCUMGR_TRANSPORT_UDP)
     class smp_udp *udp_transport;
@@ -476,15 +631,21 @@ private:
 #endif
 
     QList<image_state_t> images_list;
+    QList<image_state_t> upload_check_images;
+    QList<image_cache_t> image_cache;
     QList<hash_checksum_t> supported_hash_checksum_list;
     QVariant bootloader_info_response;
     QByteArray settings_read_response;
+    QList<settings_bulk_entry_t> settings_bulk_entries;
+    settings_snapshot settings_bulk_target;
+    QString settings_snapshot_file;
     QByteArray fs_hash_checksum_response;
     uint32_t fs_size_response;
 #ifndef SKIPPLUGIN_LOGGER
     debug_logger *logger;
 #endif
     bool uart_transport_locked;
+    bool uart_reconnecting;
     QDateTime rtc_time_date_response;
 };
 
@@ -0,0 +1,290 @@
+/******************************************************************************
+** Copyright (C) 2023 Jamie M.
+**
+** Project: AuTerm
+**
+** Module:  settings_snapshot.cpp
+**
+** Notes:
+**
+** License: This program is free software: you can redistribute it and/or
+**          modify it under the terms of the GNU General Public License as
+**          published by the Free Software Foundation, version 3.
+**
+**          This program is distributed in the hope that it will be useful,
+**          but WITHOUT ANY WARRANTY; without even the implied warranty of
+**          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**          GNU General Public License for more details.
+**
+**          You should have received a copy of the GNU General Public License
+**          along with this program.  If not, see http://www.gnu.org/licenses/
+**
+*******************************************************************************/
+#include "settings_snapshot.h"
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QDateTime>
+
+settings_snapshot::settings_snapshot()
+{
+    clear();
+}
+
+void settings_snapshot::clear()
+{
+    entries.clear();
+    manifest = false;
+}
+
+bool settings_snapshot::load(QString filename, QString *error)
+{
+    QFile file(filename);
+    QByteArray data;
+    QJsonParseError parse_error;
+    QJsonDocument document;
+
+    clear();
+
+    if (!file.open(QFile::ReadOnly))
+    {
+        *error = file.errorString();
+        return false;
+    }
+
+    data = file.readAll();
+    file.close();
+    document = QJsonDocument::fromJson(data, &parse_error);
+
+    if (parse_error.error == QJsonParseError::NoError && document.isObject())
+    {
+        QJsonObject settings = document.object().value("settings").toObject();
+        QJsonObject::const_iterator it = settings.constBegin();
+
+        while (it != settings.constEnd())
+        {
+            if (it.value().isNull())
+            {
+                set(it.key(), QByteArray(), false);
+            }
+            else if (it.value().isString())
+            {
+                set(it.key(), QByteArray::fromHex(it.value().toString().toLatin1()), true);
+            }
+            else
+            {
+                *error = QString("Invalid value for key ").append(it.key());
+                clear();
+                return false;
+            }
+
+            ++it;
+        }
+    }
+    else
+    {
+        //Not JSON, treat as a list of keys
+        QStringList lines = QString::fromUtf8(data).split('\n');
+        uint16_t i = 0;
+
+        manifest = true;
+
+        while (i < lines.length())
+        {
+            QString line = lines.at(i).trimmed();
+
+            if (!line.isEmpty() && line.at(0) != '#')
+            {
+                set(line, QByteArray(), false);
+            }
+
+            ++i;
+        }
+    }
+
+    if (entries.isEmpty())
+    {
+        *error = "No keys in file";
+        return false;
+    }
+
+    return true;
+}
+
+bool settings_snapshot::save(QString filename, QString *error)
+{
+    QFile file(filename);
+    QJsonObject root;
+    QJsonObject settings;
+    uint16_t i = 0;
+
+    while (i < entries.length())
+    {
+        if (entries.at(i).present == true)
+        {
+            settings.insert(entries.at(i).name, QString(entries.at(i).value.toHex()));
+        }
+        else
+        {
+            settings.insert(entries.at(i).name, QJsonValue::Null);
+        }
+
+        ++i;
+    }
+
+    root.insert("created", QDateTime::currentDateTime().toString(Qt::ISODate));
+    root.insert("settings", settings);
+
+    if (!file.open(QFile::WriteOnly | QFile::Truncate))
+    {
+        *error = file.errorString();
+        return false;
+    }
+
+    if (file.write(QJsonDocument(root).toJson(QJsonDocument::Indented)) == -1)
+    {
+        *error = file.errorString();
+        file.close();
+        return false;
+    }
+
+    file.close();
+
+    return true;
+}
+
+uint16_t settings_snapshot::count()
+{
+    return entries.length();
+}
+
+QStringList settings_snapshot::keys()
+{
+    QStringList names;
+    uint16_t i = 0;
+
+    while (i < entries.length())
+    {
+        names << entries.at(i).name;
+        ++i;
+    }
+
+    return names;
+}
+
+const settings_snapshot_entry_t *settings_snapshot::find(QString name)
+{
+    uint16_t i = 0;
+
+    while (i < entries.length())
+    {
+        if (entries.at(i).name == name)
+        {
+            return &entries.at(i);
+        }
+
+        ++i;
+    }
+
+    return nullptr;
+}
+
+void settings_snapshot::set(QString name, QByteArray value, bool present)
+{
+    uint16_t i = 0;
+
+    while (i < entries.length())
+    {
+        if (entries.at(i).name == name)
+        {
+            entries[i].value = value;
+            entries[i].present = present;
+            return;
+        }
+
+        ++i;
+    }
+
+    settings_snapshot_entry_t entry;
+
+    entry.name = name;
+    entry.value = value;
+    entry.present = present;
+    entries.append(entry);
+}
+
+//Creates a bulk read request for every key
+void settings_snapshot::read_entries(QList<settings_bulk_entry_t> *bulk_entries)
+{
+    uint16_t i = 0;
+
+    bulk_entries->clear();
+
+    while (i < entries.length())
+    {
+        settings_bulk_entry_t entry;
+
+        entry.name = entries.at(i).name;
+        entry.action = SETTINGS_BULK_ACTION_READ;
+        entry.result = SETTINGS_BULK_RESULT_PENDING;
+        bulk_entries->append(entry);
+        ++i;
+    }
+}
+
+//Updates the snapshot with the results of a bulk read, keys which failed to be read for a reason other than not existing are left unchanged
+void settings_snapshot::set_from_entries(const QList<settings_bulk_entry_t> *bulk_entries)
+{
+    uint16_t i = 0;
+
+    while (i < bulk_entries->length())
+    {
+        if (bulk_entries->at(i).result == SETTINGS_BULK_RESULT_OK)
+        {
+            set(bulk_entries->at(i).name, bulk_entries->at(i).value, true);
+        }
+        else if (bulk_entries->at(i).result == SETTINGS_BULK_RESULT_NOT_FOUND)
+        {
+            set(bulk_entries->at(i).name, QByteArray(), false);
+        }
+
+        ++i;
+    }
+}
+
+//Creates the writes and deletes needed to change current into this snapshot, returns the number of changes
+uint16_t settings_snapshot::diff(settings_snapshot *current, QList<settings_bulk_entry_t> *changes)
+{
+    uint16_t i = 0;
+
+    changes->clear();
+
+    while (i < entries.length())
+    {
+        const settings_snapshot_entry_t *existing = current->find(entries.at(i).name);
+        settings_bulk_entry_t change;
+
+        change.name = entries.at(i).name;
+        change.result = SETTINGS_BULK_RESULT_PENDING;
+
+        if (entries.at(i).present == true)
+        {
+            if (existing == nullptr || existing->present == false || existing->value != entries.at(i).value)
+            {
+                change.action = SETTINGS_BULK_ACTION_WRITE;
+                change.value = entries.at(i).value;
+                changes->append(change);
+            }
+        }
+        else if (manifest == false && (existing == nullptr || existing->present == true))
+        {
+            change.action = SETTINGS_BULK_ACTION_DELETE;
+            changes->append(change);
+        }
+
+        ++i;
+    }
+
+    return changes->length();
+}
@@ -0,0 +1,60 @@
+/******************************************************************************
+** Copyright (C) 2023 Jamie M.
+**
+** Project: AuTerm
+**
+** Module:  settings_snapshot.h
+**
+** Notes:
+**
+** License: This program is free software: you can redistribute it and/or
+**          modify it under the terms of the GNU General Public License as
+**          published by the Free Software Foundation, version 3.
+**
+**          This program is distributed in the hope that it will be useful,
+**          but WITHOUT ANY WARRANTY; without even the implied warranty of
+**          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**          GNU General Public License for more details.
+**
+**          You should have received a copy of the GNU General Public License
+**          along with this program.  If not, see http://www.gnu.org/licenses/
+**
+*******************************************************************************/
+#ifndef SETTINGS_SNAPSHOT_H
+#define SETTINGS_SNAPSHOT_H
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include "smp_group_settings_mgmt.h"
+
+//Value of a single key, a key which is not present on the device (or is to be deleted) has present set to false
+struct settings_snapshot_entry_t {
+    QString name;
+    QByteArray value;
+    bool present;
+};
+
+//Set of setting keys and values. Stored as a JSON file of hex encoded values (null for keys which are not present),
+//a plain text file with one key per line can also be loaded as a manifest of keys to read
+class settings_snapshot
+{
+public:
+    settings_snapshot();
+    void clear();
+    bool load(QString filename, QString *error);
+    bool save(QString filename, QString *error);
+    uint16_t count();
+    QStringList keys();
+    const settings_snapshot_entry_t *find(QString name);
+    void set(QString name, QByteArray value, bool present);
+    void read_entries(QList<settings_bulk_entry_t> *entries);
+    void set_from_entries(const QList<settings_bulk_entry_t> *entries);
+    uint16_t diff(settings_snapshot *current, QList<settings_bulk_entry_t> *changes);
+
+private:
+    QList<settings_snapshot_entry_t> entries;
+    bool manifest;
+};
+
+#endif // SETTINGS_SNAPSHOT_H
@@ -0,0 +1,263 @@
+/******************************************************************************
+** Copyright (C) 2023 Jamie M.
+**
+** Project: AuTerm
+**
+** Module:  shell_batch.cpp
+**
+** Notes:
+**
+** License: This program is free software: you can redistribute it and/or
+**          modify it under the terms of the GNU General Public License as
+**          published by the Free Software Foundation, version 3.
+**
+**          This program is distributed in the hope that it will be useful,
+**          but WITHOUT ANY WARRANTY; without even the implied warranty of
+**          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**          GNU General Public License for more details.
+**
+**          You should have received a copy of the GNU General Public License
+**          along with this program.  If not, see http://www.gnu.org/licenses/
+**
+*******************************************************************************/
+#include "shell_batch.h"
+#include <QFile>
+#include <QTextStream>
+#include <QRegularExpression>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QDateTime>
+
+shell_batch::shell_batch()
+{
+    clear();
+}
+
+void shell_batch::clear()
+{
+    batch_file.clear();
+    commands.clear();
+    index = -1;
+    started_at = 0;
+}
+
+bool shell_batch::load(QString filename, uint32_t default_timeout_ms, QString *error)
+{
+    QFile file(filename);
+    QRegularExpression argument_split("\\s+");
+    uint32_t timeout = default_timeout_ms;
+    uint32_t line_number = 0;
+
+    clear();
+
+    if (!file.open(QFile::ReadOnly | QFile::Text))
+    {
+        *error = file.errorString();
+        return false;
+    }
+
+    QTextStream stream(&file);
+
+    while (!stream.atEnd())
+    {
+        QString line = stream.readLine().trimmed();
+
+        ++line_number;
+
+        if (line.isEmpty())
+        {
+            continue;
+        }
+
+        if (line.at(0) == '#')
+        {
+            QStringList directive = line.mid(1).trimmed().split(argument_split);
+
+            if (directive.length() == 2 && directive.at(0) == "timeout")
+            {
+                bool converted = false;
+                uint32_t new_timeout = directive.at(1).toUInt(&converted);
+
+                if (converted == false || new_timeout == 0)
+                {
+                    *error = QString("Invalid timeout on line ").append(QString::number(line_number));
+                    commands.clear();
+                    return false;
+                }
+
+                timeout = new_timeout;
+            }
+
+            continue;
+        }
+
+        shell_batch_command_t command;
+
+        command.line = line_number;
+        command.command = line;
+        command.arguments = line.split(argument_split);
+        command.timeout_ms = timeout;
+        command.result = SHELL_BATCH_RESULT_NOT_RUN;
+        command.ret = 0;
+        command.duration_ms = 0;
+        commands.append(command);
+    }
+
+    file.close();
+
+    if (commands.isEmpty())
+    {
+        *error = "No commands in file";
+        return false;
+    }
+
+    batch_file = filename;
+
+    return true;
+}
+
+uint16_t shell_batch::command_count()
+{
+    return commands.length();
+}
+
+int32_t shell_batch::current_index()
+{
+    return index;
+}
+
+shell_batch_command_t *shell_batch::current()
+{
+    if (index < 0 || index >= commands.length())
+    {
+        return nullptr;
+    }
+
+    return &commands[index];
+}
+
+//Advances to the next command, returns nullptr when all commands have been run
+shell_batch_command_t *shell_batch::next(qint64 timestamp_ms)
+{
+    if (index < commands.length())
+    {
+        ++index;
+    }
+
+    started_at = timestamp_ms;
+
+    return current();
+}
+
+void shell_batch::set_result(qint64 timestamp_ms, shell_batch_result result, int32_t ret, QString output, QString error)
+{
+    shell_batch_command_t *command = current();
+
+    if (command == nullptr)
+    {
+        return;
+    }
+
+    command->result = result;
+    command->ret = ret;
+    command->output = output;
+    command->error = error;
+    command->duration_ms = timestamp_ms - started_at;
+}
+
+uint16_t shell_batch::count_result(shell_batch_result result)
+{
+    uint16_t count = 0;
+    uint16_t i = 0;
+
+    while (i < commands.length())
+    {
+        if (commands.at(i).result == result)
+        {
+            ++count;
+        }
+
+        ++i;
+    }
+
+    return count;
+}
+
+bool shell_batch::save_results(QString filename, QString *error)
+{
+    QFile file(filename);
+    QJsonObject root;
+    QJsonArray results;
+    uint16_t i = 0;
+
+    while (i < commands.length())
+    {
+        QJsonObject entry;
+
+        entry.insert("line", (qint64)commands.at(i).line);
+        entry.insert("command", commands.at(i).command);
+        entry.insert("timeout_ms", (qint64)commands.at(i).timeout_ms);
+        entry.insert("result", result_to_string(commands.at(i).result));
+
+        if (commands.at(i).result != SHELL_BATCH_RESULT_NOT_RUN)
+        {
+            entry.insert("ret", commands.at(i).ret);
+            entry.insert("duration_ms", commands.at(i).duration_ms);
+            entry.insert("output", commands.at(i).output);
+
+            if (!commands.at(i).error.isEmpty())
+            {
+                entry.insert("error", commands.at(i).error);
+            }
+        }
+
+        results.append(entry);
+        ++i;
+    }
+
+    root.insert("batch_file", batch_file);
+    root.insert("finished", QDateTime::currentDateTime().toString(Qt::ISODate));
+    root.insert("commands", (qint64)commands.length());
+    root.insert("ok", count_result(SHELL_BATCH_RESULT_OK));
+    root.insert("not_run", count_result(SHELL_BATCH_RESULT_NOT_RUN));
+    root.insert("results", results);
+
+    if (!file.open(QFile::WriteOnly | QFile::Truncate))
+    {
+        *error = file.errorString();
+        return false;
+    }
+
+    if (file.write(QJsonDocument(root).toJson(QJsonDocument::Indented)) == -1)
+    {
+        *error = file.errorString();
+        file.close();
+        return false;
+    }
+
+    file.close();
+
+    return true;
+}
+
+QString shell_batch::result_to_string(shell_batch_result result)
+{
+    switch (result)
+    {
+    case SHELL_BATCH_RESULT_NOT_RUN:
+        return "not_run";
+    case SHELL_BATCH_RESULT_OK:
+        return "ok";
+    case SHELL_BATCH_RESULT_FAILED:
+        return "failed";
+    case SHELL_BATCH_RESULT_ERROR:
+        return "error";
+    case SHELL_BATCH_RESULT_TIMEOUT:
+        return "timeout";
+    case SHELL_BATCH_RESULT_CANCELLED:
+        return "cancelled";
+    default:
+        return "invalid";
+    }
+}
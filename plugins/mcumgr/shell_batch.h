@@ -0,0 +1,77 @@
+/******************************************************************************
+** Copyright (C) 2023 Jamie M.
+**
+** Project: AuTerm
+**
+** Module:  shell_batch.h
+**
+** Notes:
+**
+** License: This program is free software: you can redistribute it and/or
+**          modify it under the terms of the GNU General Public License as
+**          published by the Free Software Foundation, version 3.
+**
+**          This program is distributed in the hope that it will be useful,
+**          but WITHOUT ANY WARRANTY; without even the implied warranty of
+**          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**          GNU General Public License for more details.
+**
+**          You should have received a copy of the GNU General Public License
+**          along with this program.  If not, see http://www.gnu.org/licenses/
+**
+*******************************************************************************/
+#ifndef SHELL_BATCH_H
+#define SHELL_BATCH_H
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+
+enum shell_batch_result : uint8_t {
+    SHELL_BATCH_RESULT_NOT_RUN = 0,
+    SHELL_BATCH_RESULT_OK,
+    SHELL_BATCH_RESULT_FAILED,
+    SHELL_BATCH_RESULT_ERROR,
+    SHELL_BATCH_RESULT_TIMEOUT,
+    SHELL_BATCH_RESULT_CANCELLED,
+};
+
+//A single command of a batch file and the outcome of running it
+struct shell_batch_command_t {
+    uint32_t line;
+    QString command;
+    QStringList arguments;
+    uint32_t timeout_ms;
+    shell_batch_result result;
+    int32_t ret;
+    QString output;
+    QString error;
+    qint64 duration_ms;
+};
+
+//List of shell commands loaded from a file and run one after another.
+//Lines starting with # are comments, a "#timeout <ms>" line sets the timeout of the commands which follow it
+class shell_batch
+{
+public:
+    shell_batch();
+    void clear();
+    bool load(QString filename, uint32_t default_timeout_ms, QString *error);
+    uint16_t command_count();
+    int32_t current_index();
+    shell_batch_command_t *current();
+    shell_batch_command_t *next(qint64 timestamp_ms);
+    void set_result(qint64 timestamp_ms, shell_batch_result result, int32_t ret, QString output, QString error);
+    uint16_t count_result(shell_batch_result result);
+    bool save_results(QString filename, QString *error);
+
+private:
+    QString result_to_string(shell_batch_result result);
+
+    QString batch_file;
+    QList<shell_batch_command_t> commands;
+    int32_t index;
+    qint64 started_at;
+};
+
+#endif // SHELL_BATCH_H
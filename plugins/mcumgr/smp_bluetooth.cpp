@@ -66,6 +66,7 @@ smp_bluetooth::smp_bluetooth(QObject *parent)
     QObject::connect(discoveryAgent, SIGNAL(deviceDiscovered(QBluetoothDeviceInfo)), this, SLOT(deviceDiscovered(QBluetoothDeviceInfo)));
     QObject::connect(discoveryAgent, SIGNAL(finished()), this, SLOT(finished()));
     device_connected = false;
+    disconnect_requested = false;
 
     QObject::connect(&retry_timer, SIGNAL(timeout()), this, SLOT(timeout_timer()));
     retry_timer.setInterval(500);
@@ -145,6 +146,8 @@ void smp_bluetooth::connected()
 
 void smp_bluetooth::disconnected()
 {
+    bool link_lost = (device_connected == true && disconnect_requested == false);
+
     bluetooth_window->add_debug("Disconnected!");
     device_connected = false;
     mtu_max_worked = 0;
@@ -174,6 +177,12 @@ void smp_bluetooth::disconnected()
 
         controller = nullptr;
     }
+
+    if (link_lost == true)
+    {
+        //Connection dropped without being requested (e.g. device out of range or rebooted)
+        emit transport_disconnected();
+    }
 }
 
 void smp_bluetooth::discovery_finished()
@@ -293,6 +302,14 @@ void smp_bluetooth::mcumgr_service_state_changed(QLowEnergyService::ServiceState
 
             //Enable Tx descriptor notifications
             bluetooth_service_mcumgr->writeDescriptor(descTXDesc, QByteArray::fromHex("0100"));
+
+            //Write using the negotiated ATT MTU (less the 3 byte ATT header) so each write fits in a single packet
+            if (controller->mtu() > 3)
+            {
+                mtu = controller->mtu() - 3;
+            }
+
+            emit transport_connected();
         }
     }
 }
@@ -320,8 +337,14 @@ void smp_bluetooth::connection_updated(QLowEnergyConnectionParameters parameters
 
 int smp_bluetooth::send(smp_message *message)
 {
+    if (sendbuffer.length() > 0)
+    {
+        //A message is still being written, queue this one to be written after it
+        sendbuffer.append(*message->data());
+        return 0;
+    }
+
     retry_count = 0;
-    sendbuffer.clear();
 
     if (mtu < mtu_max_worked)
     {
@@ -388,6 +411,14 @@ void smp_bluetooth::form_refresh_devices()
 
 void smp_bluetooth::form_connect_to_device(uint16_t index)
 {
+    last_device = bluetooth_device_list.at(index);
+    connect_to_device(last_device);
+}
+
+void smp_bluetooth::connect_to_device(const QBluetoothDeviceInfo &device)
+{
+    disconnect_requested = false;
+
     if (controller)
     {
         QObject::disconnect(controller, SIGNAL(connected()), this, SLOT(connected()));
@@ -403,7 +434,7 @@ void smp_bluetooth::form_connect_to_device(uint16_t index)
 
             // Connecting signals and slots for connecting to LE services.
         //        QBluetoothAddress bluetooth_device_list = QBluetoothAddress(item->text().left(item->text().indexOf(" ")));
-        controller = QLowEnergyController::createCentral(bluetooth_device_list.at(index));
+        controller = QLowEnergyController::createCentral(device);
         //        controller = QLowEnergyController::createCentral();
         QObject::connect(controller, SIGNAL(connected()), this, SLOT(connected()));
         QObject::connect(controller, SIGNAL(disconnected()), this, SLOT(disconnected()));
@@ -425,6 +456,7 @@ void smp_bluetooth::form_connect_to_device(uint16_t index)
 
 void smp_bluetooth::form_disconnect_from_device()
 {
+    disconnect_requested = true;
     controller->disconnectFromDevice();
 }
 
@@ -440,6 +472,7 @@ int smp_bluetooth::disconnect(bool force)
 {
     if (controller != nullptr && device_connected == true)
     {
+        disconnect_requested = true;
         controller->disconnectFromDevice();
     }
 
@@ -473,3 +506,37 @@ void smp_bluetooth::close_connect_dialog()
         bluetooth_window->close();
     }
 }
+
+//Connects to the last device again, the service is rediscovered and transport_connected() is emitted once it is ready
+int smp_bluetooth::reconnect(void)
+{
+    if (last_device.isValid() == false)
+    {
+        return SMP_TRANSPORT_ERROR_NOT_CONNECTED;
+    }
+
+    if (device_connected == true)
+    {
+        return SMP_TRANSPORT_ERROR_ALREADY_CONNECTED;
+    }
+
+    if (controller != nullptr && controller->state() != QLowEnergyController::UnconnectedState)
+    {
+        //Previous attempt is still in progress
+        return SMP_TRANSPORT_ERROR_OK;
+    }
+
+    connect_to_device(last_device);
+
+    return SMP_TRANSPORT_ERROR_OK;
+}
+
+uint16_t smp_bluetooth::get_mtu(void)
+{
+    if (device_connected == false || controller == nullptr || controller->mtu() <= 3)
+    {
+        return 0;
+    }
+
+    return controller->mtu() - 3;
+}
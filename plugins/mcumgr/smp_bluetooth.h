@@ -48,6 +48,8 @@ public:
     int is_connected();
     int send(smp_message *message);
     void close_connect_dialog();
+    uint16_t get_mtu(void);
+    int reconnect(void);
 
 private slots:
     void deviceDiscovered(const QBluetoothDeviceInfo &info);
@@ -76,12 +78,15 @@ signals:
 
 private:
     void form_min_params();
+    void connect_to_device(const QBluetoothDeviceInfo &device);
 
 //    Ui::bluetooth *ui;
     QBluetoothDeviceDiscoveryAgent *discoveryAgent = nullptr;
 //    DeviceInfo currentDevice;
     QLowEnergyController *controller = nullptr;
     bool device_connected;
+    bool disconnect_requested;
+    QBluetoothDeviceInfo last_device;
     smp_message received_data;
 };
 
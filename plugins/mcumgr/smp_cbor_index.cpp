@@ -0,0 +1,347 @@
+/******************************************************************************
+** Copyright (C) 2023 Jamie M.
+**
+** Project: AuTerm
+**
+** Module:  smp_cbor_index.cpp
+**
+** Notes:
+**
+** License: This program is free software: you can redistribute it and/or
+**          modify it under the terms of the GNU General Public License as
+**          published by the Free Software Foundation, version 3.
+**
+**          This program is distributed in the hope that it will be useful,
+**          but WITHOUT ANY WARRANTY; without even the implied warranty of
+**          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**          GNU General Public License for more details.
+**
+**          You should have received a copy of the GNU General Public License
+**          along with this program.  If not, see http://www.gnu.org/licenses/
+**
+*******************************************************************************/
+#include "smp_cbor_index.h"
+
+smp_cbor_index::smp_cbor_index()
+{
+    clear();
+}
+
+void smp_cbor_index::clear()
+{
+    source.clear();
+    entries.clear();
+    response_error.type = SMP_ERROR_NONE;
+    response_error.rc = 0;
+    response_error.group = 0;
+}
+
+//Note: data is not copied if it is a raw data view, it must remain valid whilst values are being read from the index
+bool smp_cbor_index::parse(const QByteArray &data, uint8_t version)
+{
+    clear();
+    source = data;
+
+    QCborStreamReader reader(source);
+
+    if (reader.type() != QCborStreamReader::Map)
+    {
+        return false;
+    }
+
+    reader.enterContainer();
+
+    while (!reader.lastError() && reader.hasNext())
+    {
+        smp_cbor_index_entry_t entry;
+
+        if (read_key(reader, &entry.key) == false)
+        {
+            //Not a text key, skip the key and value
+            reader.next();
+
+            if (!reader.lastError() && reader.hasNext())
+            {
+                reader.next();
+            }
+
+            continue;
+        }
+
+        if (reader.lastError() || !reader.hasNext())
+        {
+            break;
+        }
+
+        entry.type = reader.type();
+        entry.offset = reader.currentOffset();
+        entry.value = 0;
+
+        switch (entry.type)
+        {
+            case QCborStreamReader::UnsignedInteger:
+            {
+                entry.value = reader.toUnsignedInteger();
+                reader.next();
+
+                if (entry.key == SMP_CBOR_KEY_RC)
+                {
+                    response_error.rc = (int32_t)entry.value;
+                    response_error.type = SMP_ERROR_RC;
+                }
+
+                break;
+            }
+            case QCborStreamReader::NegativeInteger:
+            {
+                entry.value = (quint64)reader.toInteger();
+                reader.next();
+
+                if (entry.key == SMP_CBOR_KEY_RC)
+                {
+                    response_error.rc = (int32_t)(qint64)entry.value;
+                    response_error.type = SMP_ERROR_RC;
+                }
+
+                break;
+            }
+            case QCborStreamReader::SimpleType:
+            {
+                if (reader.isBool())
+                {
+                    entry.value = (reader.toBool() ? 1 : 0);
+                }
+
+                reader.next();
+                break;
+            }
+            case QCborStreamReader::Map:
+            {
+                if (entry.key == SMP_CBOR_KEY_ERR && version == 1)
+                {
+                    //SMP version 2 error response
+                    parse_error_map(reader);
+                }
+                else
+                {
+                    reader.next();
+                }
+
+                break;
+            }
+            default:
+            {
+                //Skips the whole element, including any nested containers
+                reader.next();
+                break;
+            }
+        }
+
+        entries.append(entry);
+    }
+
+    if (reader.lastError())
+    {
+        return false;
+    }
+
+    //Check if an error was received with value 0, which is not an error and is a success code
+    if (response_error.type != SMP_ERROR_NONE && response_error.rc == 0)
+    {
+        response_error.type = SMP_ERROR_NONE;
+    }
+
+    return true;
+}
+
+bool smp_cbor_index::read_key(QCborStreamReader &reader, uint32_t *key)
+{
+    uint32_t hash = 2166136261u;
+
+    if (!reader.isString())
+    {
+        return false;
+    }
+
+    auto r = reader.readString();
+
+    while (r.status == QCborStreamReader::Ok)
+    {
+        int i = 0;
+
+        while (i < r.data.length())
+        {
+            hash ^= (uint8_t)r.data.at(i).unicode();
+            hash *= 16777619u;
+            ++i;
+        }
+
+        r = reader.readString();
+    }
+
+    *key = hash;
+
+    return (r.status != QCborStreamReader::Error);
+}
+
+void smp_cbor_index::parse_error_map(QCborStreamReader &reader)
+{
+    reader.enterContainer();
+
+    while (!reader.lastError() && reader.hasNext())
+    {
+        uint32_t key;
+
+        if (read_key(reader, &key) == false)
+        {
+            //Not a text key, skip the key and value
+            reader.next();
+
+            if (!reader.lastError() && reader.hasNext())
+            {
+                reader.next();
+            }
+
+            continue;
+        }
+
+        if (reader.lastError() || !reader.hasNext())
+        {
+            break;
+        }
+
+        if (reader.isUnsignedInteger() && key == SMP_CBOR_KEY_RC)
+        {
+            response_error.rc = (int32_t)reader.toUnsignedInteger();
+            response_error.type = SMP_ERROR_RET;
+        }
+        else if (reader.isUnsignedInteger() && key == SMP_CBOR_KEY_GROUP)
+        {
+            response_error.group = (uint16_t)reader.toUnsignedInteger();
+            response_error.type = SMP_ERROR_RET;
+        }
+
+        reader.next();
+    }
+
+    if (!reader.lastError())
+    {
+        reader.leaveContainer();
+    }
+}
+
+const smp_cbor_index_entry_t *smp_cbor_index::find(uint32_t key) const
+{
+    int i = 0;
+
+    while (i < entries.length())
+    {
+        if (entries.at(i).key == key)
+        {
+            return &entries.at(i);
+        }
+
+        ++i;
+    }
+
+    return nullptr;
+}
+
+bool smp_cbor_index::contains(uint32_t key) const
+{
+    return (find(key) != nullptr);
+}
+
+bool smp_cbor_index::get_unsigned(uint32_t key, quint64 *value) const
+{
+    const smp_cbor_index_entry_t *entry = find(key);
+
+    if (entry == nullptr || entry->type != QCborStreamReader::UnsignedInteger)
+    {
+        return false;
+    }
+
+    *value = entry->value;
+
+    return true;
+}
+
+bool smp_cbor_index::get_integer(uint32_t key, qint64 *value) const
+{
+    const smp_cbor_index_entry_t *entry = find(key);
+
+    if (entry == nullptr || (entry->type != QCborStreamReader::UnsignedInteger && entry->type != QCborStreamReader::NegativeInteger))
+    {
+        return false;
+    }
+
+    *value = (qint64)entry->value;
+
+    return true;
+}
+
+bool smp_cbor_index::get_bool(uint32_t key, bool *value) const
+{
+    const smp_cbor_index_entry_t *entry = find(key);
+
+    if (entry == nullptr || entry->type != QCborStreamReader::SimpleType)
+    {
+        return false;
+    }
+
+    *value = (entry->value == 1 ? true : false);
+
+    return true;
+}
+
+bool smp_cbor_index::get_byte_array(uint32_t key, QByteArray *value) const
+{
+    const smp_cbor_index_entry_t *entry = find(key);
+
+    if (entry == nullptr || entry->type != QCborStreamReader::ByteArray)
+    {
+        return false;
+    }
+
+    //Decode only this value, starting from the recorded offset
+    QCborStreamReader reader(QByteArray::fromRawData((source.constData() + entry->offset), (source.length() - entry->offset)));
+    auto r = reader.readByteArray();
+
+    value->clear();
+
+    while (r.status == QCborStreamReader::Ok)
+    {
+        value->append(r.data);
+        r = reader.readByteArray();
+    }
+
+    return (r.status != QCborStreamReader::Error);
+}
+
+bool smp_cbor_index::get_string(uint32_t key, QString *value) const
+{
+    const smp_cbor_index_entry_t *entry = find(key);
+
+    if (entry == nullptr || entry->type != QCborStreamReader::String)
+    {
+        return false;
+    }
+
+    QCborStreamReader reader(QByteArray::fromRawData((source.constData() + entry->offset), (source.length() - entry->offset)));
+    auto r = reader.readString();
+
+    value->clear();
+
+    while (r.status == QCborStreamReader::Ok)
+    {
+        value->append(r.data);
+        r = reader.readString();
+    }
+
+    return (r.status != QCborStreamReader::Error);
+}
+
+smp_error_t smp_cbor_index::error() const
+{
+    return response_error;
+}
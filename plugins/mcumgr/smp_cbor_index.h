@@ -0,0 +1,88 @@
+/******************************************************************************
+** Copyright (C) 2023 Jamie M.
+**
+** Project: AuTerm
+**
+** Module:  smp_cbor_index.h
+**
+** Notes:
+**
+** License: This program is free software: you can redistribute it and/or
+**          modify it under the terms of the GNU General Public License as
+**          published by the Free Software Foundation, version 3.
+**
+**          This program is distributed in the hope that it will be useful,
+**          but WITHOUT ANY WARRANTY; without even the implied warranty of
+**          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**          GNU General Public License for more details.
+**
+**          You should have received a copy of the GNU General Public License
+**          along with this program.  If not, see http://www.gnu.org/licenses/
+**
+*******************************************************************************/
+#ifndef SMP_CBOR_INDEX_H
+#define SMP_CBOR_INDEX_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVarLengthArray>
+#include <QCborStreamReader>
+#include "smp_error.h"
+
+//FNV-1a hash of a map key, allows keys to be matched against constants without string comparisons
+constexpr uint32_t smp_cbor_key(const char *key)
+{
+    uint32_t hash = 2166136261u;
+
+    while (*key != 0)
+    {
+        hash ^= (uint8_t)*key;
+        hash *= 16777619u;
+        ++key;
+    }
+
+    return hash;
+}
+
+constexpr uint32_t SMP_CBOR_KEY_RC = smp_cbor_key("rc");
+constexpr uint32_t SMP_CBOR_KEY_ERR = smp_cbor_key("err");
+constexpr uint32_t SMP_CBOR_KEY_GROUP = smp_cbor_key("group");
+constexpr uint32_t SMP_CBOR_KEY_OFF = smp_cbor_key("off");
+constexpr uint32_t SMP_CBOR_KEY_LEN = smp_cbor_key("len");
+constexpr uint32_t SMP_CBOR_KEY_DATA = smp_cbor_key("data");
+constexpr uint32_t SMP_CBOR_KEY_MATCH = smp_cbor_key("match");
+constexpr uint32_t SMP_CBOR_KEY_VAL = smp_cbor_key("val");
+
+struct smp_cbor_index_entry_t {
+    uint32_t key;
+    QCborStreamReader::Type type;
+    qint64 offset;
+    quint64 value;
+};
+
+//Index of the top-level map of a response, built in a single pass. Integer and boolean values are stored directly, other values are decoded from their recorded offset on request
+class smp_cbor_index
+{
+public:
+    smp_cbor_index();
+    bool parse(const QByteArray &data, uint8_t version);
+    void clear();
+    bool contains(uint32_t key) const;
+    bool get_unsigned(uint32_t key, quint64 *value) const;
+    bool get_integer(uint32_t key, qint64 *value) const;
+    bool get_bool(uint32_t key, bool *value) const;
+    bool get_byte_array(uint32_t key, QByteArray *value) const;
+    bool get_string(uint32_t key, QString *value) const;
+    smp_error_t error() const;
+
+private:
+    const smp_cbor_index_entry_t *find(uint32_t key) const;
+    bool read_key(QCborStreamReader &reader, uint32_t *key);
+    void parse_error_map(QCborStreamReader &reader);
+
+    QByteArray source;
+    QVarLengthArray<smp_cbor_index_entry_t, 16> entries;
+    smp_error_t response_error;
+};
+
+#endif // SMP_CBOR_INDEX_H
@@ -113,6 +113,12 @@ public:
     virtual void timeout(smp_message *message) = 0;
     virtual void cancel() = 0;
 
+    //Called when a message has not been responded to in time and is being sent again
+    virtual void retry(smp_message *message)
+    {
+        Q_UNUSED(message);
+    }
+
 protected:
     static enum group_status status_error_return(smp_error_t error)
     {
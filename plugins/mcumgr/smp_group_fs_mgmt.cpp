@@ -21,6 +21,8 @@
 **
 *******************************************************************************/
 #include "smp_group_fs_mgmt.h"
+#include <QFileInfo>
+#include "AutCrc.h"
 
 enum modes : uint8_t {
     MODE_IDLE = 0,
@@ -29,7 +31,8 @@ enum modes : uint8_t {
     MODE_STATUS,
     MODE_HASH_CHECKSUM,
     MODE_SUPPORTED_HASHES_CHECKSUMS,
-    MODE_FILE_CLOSE
+    MODE_FILE_CLOSE,
+    MODE_VERIFY
 };
 
 enum fs_mgmt_commands : uint8_t {
@@ -60,6 +63,10 @@ enum fs_mgmt_errs : uint16_t {
     FS_MGMT_ERR_FILE_EMPTY
 };
 
+//Number of download requests which can be outstanding at once, this is adjusted whilst downloading depending upon retries
+static const uint8_t download_window_initial = 2;
+static const uint8_t download_window_max = SMP_MAX_PENDING_MESSAGES;
+
 static QStringList smp_error_defines = QStringList() <<
     //Error index starts from 2 (no error and unknown error are common and handled in the base code)
     "FILE_INVALID_NAME" <<
@@ -96,200 +103,51 @@ static QStringList smp_error_values = QStringList() <<
     "The specified mount point is that of a read-only filesystem" <<
     "The operation cannot be performed because the file is empty with no contents";
 
-smp_group_fs_mgmt::smp_group_fs_mgmt(smp_processor *parent) : smp_group(parent, "FS", SMP_GROUP_ID_FS, error_lookup, error_define_lookup)
+smp_group_fs_mgmt::smp_group_fs_mgmt(smp_processor *parent) : smp_group(parent, "FS", SMP_GROUP_ID_FS, error_lookup, error_define_lookup), verify_sha256(QCryptographicHash::Sha256)
 {
     mode = MODE_IDLE;
+    resume_valid = false;
+    download_window = download_window_initial;
+    download_window_responses = 0;
+    download_request_off = 0;
+    download_chunk_size = 0;
+    verify_crc32 = 0;
+    verify_offset = 0;
+    verify_valid = false;
 }
 
-bool smp_group_fs_mgmt::parse_upload_response(QCborStreamReader &reader, uint32_t *off, bool *off_found)
+bool smp_group_fs_mgmt::parse_upload_response(const smp_cbor_index *response, uint32_t *off, bool *off_found)
 {
-    //    qDebug() << reader.lastError() << reader.hasNext();
-
-    QString key = "";
-    bool keyset = true;
+    quint64 value;
 
-    while (!reader.lastError() && reader.hasNext())
+    if (response->get_unsigned(SMP_CBOR_KEY_OFF, &value))
     {
-        if (keyset == false && !key.isEmpty())
-        {
-            key.clear();
-        }
-
-        keyset = false;
-
-        switch (reader.type())
-        {
-            case QCborStreamReader::UnsignedInteger:
-            {
-                if (key == "off")
-                {
-                    *off = (uint32_t)reader.toUnsignedInteger();
-                    *off_found = true;
-                }
-
-                reader.next();
-                break;
-            }
-            case QCborStreamReader::String:
-            {
-                QString data;
-                auto r = reader.readString();
-                while (r.status == QCborStreamReader::Ok)
-                {
-                    data.append(r.data);
-                    r = reader.readString();
-                }
-
-                if (r.status == QCborStreamReader::Error)
-                {
-                    data.clear();
-                    log_error() << "Error decoding string";
-                }
-                else
-                {
-                    if (key.isEmpty())
-                    {
-                        key = data;
-                        keyset = true;
-                    }
-                }
-
-                break;
-            }
-            case QCborStreamReader::Array:
-            case QCborStreamReader::Map:
-            {
-                reader.enterContainer();
-
-                while (reader.lastError() == QCborError::NoError && reader.hasNext())
-                {
-                    parse_upload_response(reader, off, off_found);
-                }
-
-                if (reader.lastError() == QCborError::NoError)
-                {
-                    reader.leaveContainer();
-                }
-
-                break;
-            }
-            default:
-            {
-                reader.next();
-                continue;
-            }
-        };
+        *off = (uint32_t)value;
+        *off_found = true;
     }
 
     return true;
 }
 
-bool smp_group_fs_mgmt::parse_download_response(QCborStreamReader &reader, uint32_t *off, uint32_t *len, QByteArray *file_data)
+bool smp_group_fs_mgmt::parse_download_response(const smp_cbor_index *response, uint32_t *off, uint32_t *len, QByteArray *file_data)
 {
-    //    qDebug() << reader.lastError() << reader.hasNext();
+    quint64 value;
 
-    QString key = "";
-    bool keyset = true;
-
-    while (!reader.lastError() && reader.hasNext())
+    if (response->get_unsigned(SMP_CBOR_KEY_OFF, &value))
     {
-        if (keyset == false && !key.isEmpty())
-        {
-            key.clear();
-        }
-
-        keyset = false;
-
-        switch (reader.type())
-        {
-            case QCborStreamReader::UnsignedInteger:
-            {
-                if (key == "off")
-                {
-                    *off = (uint32_t)reader.toUnsignedInteger();
-                }
-                else if (key == "len")
-                {
-                    *len = (uint32_t)reader.toUnsignedInteger();
-                }
-
-                reader.next();
-                break;
-            }
-            case QCborStreamReader::String:
-            {
-                QString data;
-                auto r = reader.readString();
-                while (r.status == QCborStreamReader::Ok)
-                {
-                    data.append(r.data);
-                    r = reader.readString();
-                }
-
-                if (r.status == QCborStreamReader::Error)
-                {
-                    data.clear();
-                    log_error() << "Error decoding string";
-                }
-                else
-                {
-                    if (key.isEmpty())
-                    {
-                        key = data;
-                        keyset = true;
-                    }
-                }
-
-                break;
-            }
-            case QCborStreamReader::ByteArray:
-            {
-                QByteArray data;
-                auto r = reader.readByteArray();
-                while (r.status == QCborStreamReader::Ok)
-                {
-                    data.append(r.data);
-                    r = reader.readByteArray();
-                }
-
-                if (r.status == QCborStreamReader::Error)
-                {
-                    data.clear();
-                    log_error() << "Error decoding byte array";
-                }
-                else
-                {
-                    if (key == "data")
-                    {
-                        *file_data = data;
-                    }
-                }
-
-                break;
-            }
-            case QCborStreamReader::Array:
-            case QCborStreamReader::Map:
-            {
-                reader.enterContainer();
-
-                while (reader.lastError() == QCborError::NoError && reader.hasNext())
-                {
-                    parse_download_response(reader, off, len, file_data);
-                }
+        *off = (uint32_t)value;
+    }
 
-                if (reader.lastError() == QCborError::NoError)
-                {
-                    reader.leaveContainer();
-                }
+    if (response->get_unsigned(SMP_CBOR_KEY_LEN, &value))
+    {
+        *len = (uint32_t)value;
+    }
 
-                break;
-            }
-            default:
-            {
-                reader.next();
-                continue;
-            }
-        };
+    if (response->contains(SMP_CBOR_KEY_DATA) && !response->get_byte_array(SMP_CBOR_KEY_DATA, file_data))
+    {
+        file_data->clear();
+        log_error() << "Error decoding byte array";
+        return false;
     }
 
     return true;
@@ -631,8 +489,7 @@ void smp_group_fs_mgmt::receive_ok(uint8_t version, uint8_t op, uint16_t group,
         {
             //Response to upload
             bool off_found = false;
-            QCborStreamReader cbor_reader(data);
-            bool good = parse_upload_response(cbor_reader, &file_upload_area, &off_found);
+            bool good = parse_upload_response(processor->response_index(), &file_upload_area, &off_found);
 
             //todo
             if (off_found == true)
@@ -646,6 +503,8 @@ void smp_group_fs_mgmt::receive_ok(uint8_t version, uint8_t op, uint16_t group,
                 else
                 {
                     //Upload complete
+                    QString file_name = device_file_name;
+
                     mode = MODE_IDLE;
                     local_file.close();
                     local_file_size = 0;
@@ -655,7 +514,7 @@ void smp_group_fs_mgmt::receive_ok(uint8_t version, uint8_t op, uint16_t group,
                     device_file_name.clear();
 
                     emit progress(smp_user_data, 100);
-                    emit status(smp_user_data, STATUS_COMPLETE, "Upload complete");
+                    verify_finish(file_name, "Upload complete");
                 }
             }
             else
@@ -672,40 +531,86 @@ void smp_group_fs_mgmt::receive_ok(uint8_t version, uint8_t op, uint16_t group,
         }
         else if (mode == MODE_DOWNLOAD && command == COMMAND_UPLOAD_DOWNLOAD)
         {
-            //Response to download
-            uint32_t off;
+            //Response to download, responses can arrive out of order when multiple requests are outstanding
+            uint32_t off = 0;
             uint32_t len = 0;
             QByteArray file_data;
-            QCborStreamReader cbor_reader(data);
-            bool good = parse_download_response(cbor_reader, &off, &len, &file_data);
+            bool good = parse_download_response(processor->response_index(), &off, &len, &file_data);
 
             if (len > 0)
             {
                 local_file_size = len;
             }
 
-            if (file_upload_area != off)
+            download_outstanding.removeOne(off);
+
+            if (file_data.isEmpty() == false)
             {
-                log_error() << "Error: mismatch!";
+                if (download_chunk_size == 0 || ((off + file_data.length()) < (uint32_t)local_file_size && (uint32_t)file_data.length() < download_chunk_size))
+                {
+                    //Use the amount of data the device returns as the size of subsequent requests
+                    download_chunk_size = file_data.length();
+                }
+
+                download_received.insert(off, file_data);
+
+                //Grow the window after a full window of responses has been received without retries
+                ++download_window_responses;
+
+                if (download_window_responses >= download_window && download_window < download_window_max)
+                {
+                    ++download_window;
+                    download_window_responses = 0;
+                }
             }
 
-            if (file_data.isEmpty() == false)
+            //Write all data which is now contiguous with the end of the local file
+            while (download_received.isEmpty() == false && download_received.firstKey() <= file_upload_area)
             {
-                local_file.write(file_data);
+                uint32_t chunk_off = download_received.firstKey();
+                QByteArray chunk = download_received.take(chunk_off);
+
+                if ((chunk_off + chunk.length()) > file_upload_area)
+                {
+                    chunk = chunk.mid(file_upload_area - chunk_off);
+                    local_file.write(chunk);
+                    verify_update(file_upload_area, chunk);
+                    file_upload_area += chunk.length();
+                }
             }
 
-            file_upload_area += file_data.length();
+            if (file_data.isEmpty() == true && off < (uint32_t)local_file_size)
+            {
+                //No progress can be made, the file on the device is likely to have changed
+                store_resume();
+                processor->cleanup();
+                mode = MODE_IDLE;
+                local_file.close();
+                local_file_size = 0;
+                file_upload_area = 0;
+                upload_tmr.invalidate();
+                device_file_name.clear();
+                download_outstanding.clear();
+                download_received.clear();
 
-            if (file_upload_area < local_file_size)
+                emit status(smp_user_data, STATUS_ERROR, "Download did not advance");
+            }
+            else if (file_upload_area < local_file_size)
             {
-                //Download next chunk
-                download_chunk();
+                //Download next chunks
+                download_request_chunks();
 
                 emit progress(smp_user_data, file_upload_area * 100 / local_file_size);
             }
+            else if (download_outstanding.length() > 0)
+            {
+                //File is complete, wait for responses to remaining (duplicate) requests
+            }
             else
             {
                 //Download complete
+                QString file_name = device_file_name;
+
                 mode = MODE_IDLE;
                 local_file.close();
                 local_file_size = 0;
@@ -713,9 +618,12 @@ void smp_group_fs_mgmt::receive_ok(uint8_t version, uint8_t op, uint16_t group,
                 //todo:
                 upload_tmr.invalidate();
                 device_file_name.clear();
+                download_received.clear();
+
+                clear_resume();
 
                 emit progress(smp_user_data, 100);
-                emit status(smp_user_data, STATUS_COMPLETE, "Download complete");
+                verify_finish(file_name, "Download complete");
             }
         }
         else if (mode == MODE_STATUS && command == COMMAND_STATUS)
@@ -751,6 +659,36 @@ void smp_group_fs_mgmt::receive_ok(uint8_t version, uint8_t op, uint16_t group,
             log_debug() << "supported hash/checksum done";
             emit status(smp_user_data, STATUS_COMPLETE, nullptr);
         }
+        else if (mode == MODE_VERIFY && command == COMMAND_HASH_CHECKSUM)
+        {
+            QString type;
+            QByteArray device_result;
+            uint32_t device_size = 0;
+            QByteArray local_result = verify_result();
+
+            QCborStreamReader cbor_reader(data);
+            bool good = parse_hash_checksum_response(cbor_reader, &type, &device_result, &device_size);
+            mode = MODE_IDLE;
+
+            if (hash_checksum_result_object != nullptr)
+            {
+                *hash_checksum_result_object = device_result;
+            }
+
+            if (good == false || type != verify_type)
+            {
+                emit status(smp_user_data, STATUS_COMPLETE, QString("%1, unable to verify: invalid hash/checksum response").arg(verify_complete_message));
+            }
+            else if (device_result == local_result)
+            {
+                emit status(smp_user_data, STATUS_COMPLETE, QString("%1, %2 verified").arg(verify_complete_message, verify_type));
+            }
+            else
+            {
+                log_error() << "Verification failed, local: " << local_result.toHex() << ", device: " << device_result.toHex();
+                emit status(smp_user_data, STATUS_ERROR, QString("%1 mismatch, local: %2, device: %3").arg(verify_type, local_result.toHex(), device_result.toHex()));
+            }
+        }
         else if (mode == MODE_FILE_CLOSE && command == COMMAND_FILE_CLOSE)
         {
             mode = MODE_IDLE;
@@ -800,6 +738,11 @@ void smp_group_fs_mgmt::receive_error(uint8_t version, uint8_t op, uint16_t grou
         //TODO
         emit status(smp_user_data, status_error_return(error), smp_error::error_lookup_string(&error));
     }
+    else if (command == COMMAND_HASH_CHECKSUM && mode == MODE_VERIFY)
+    {
+        //The transfer itself completed, only the verification could not be performed
+        emit status(smp_user_data, STATUS_COMPLETE, QString("%1, unable to verify: %2").arg(verify_complete_message, smp_error::error_lookup_string(&error)));
+    }
     else if (command == COMMAND_SUPPORTED_HASHES_CHECKSUMS && mode == MODE_SUPPORTED_HASHES_CHECKSUMS)
     {
         //TODO
@@ -818,6 +761,22 @@ void smp_group_fs_mgmt::receive_error(uint8_t version, uint8_t op, uint16_t grou
 
     if (cleanup == true)
     {
+        if (mode == MODE_DOWNLOAD)
+        {
+            store_resume();
+        }
+
+        if (mode == MODE_UPLOAD || mode == MODE_DOWNLOAD)
+        {
+            local_file.close();
+            local_file_size = 0;
+            file_upload_area = 0;
+            upload_tmr.invalidate();
+            device_file_name.clear();
+            download_outstanding.clear();
+            download_received.clear();
+        }
+
         mode = MODE_IDLE;
     }
 }
@@ -826,6 +785,22 @@ void smp_group_fs_mgmt::timeout(smp_message *message)
 {
     log_error() << "timeout :(";
 
+    if (mode == MODE_DOWNLOAD)
+    {
+        store_resume();
+    }
+
+    if (mode == MODE_UPLOAD || mode == MODE_DOWNLOAD)
+    {
+        local_file.close();
+        local_file_size = 0;
+        file_upload_area = 0;
+        upload_tmr.invalidate();
+        device_file_name.clear();
+        download_outstanding.clear();
+        download_received.clear();
+    }
+
     //TODO:
     emit status(smp_user_data, STATUS_TIMEOUT, QString("Timeout (Mode: %1)").arg(mode_to_string(mode)));
 
@@ -836,6 +811,25 @@ void smp_group_fs_mgmt::cancel()
 {
     if (mode != MODE_IDLE)
     {
+        if (mode == MODE_DOWNLOAD)
+        {
+            store_resume();
+
+            //Discard any other outstanding read requests
+            processor->cleanup();
+        }
+
+        if (mode == MODE_UPLOAD || mode == MODE_DOWNLOAD)
+        {
+            local_file.close();
+            local_file_size = 0;
+            file_upload_area = 0;
+            upload_tmr.invalidate();
+            device_file_name.clear();
+            download_outstanding.clear();
+            download_received.clear();
+        }
+
         mode = MODE_IDLE;
 
         emit status(smp_user_data, STATUS_CANCELLED, nullptr);
@@ -844,7 +838,7 @@ void smp_group_fs_mgmt::cancel()
 
 void smp_group_fs_mgmt::upload_chunk()
 {
-    smp_message *tmp_message = new smp_message();
+    smp_message *tmp_message = processor->get_message(smp_mtu);
     tmp_message->start_message(SMP_OP_WRITE, smp_version, SMP_GROUP_ID_FS, COMMAND_UPLOAD_DOWNLOAD);
 
     if (local_file.pos() != file_upload_area)
@@ -854,46 +848,114 @@ void smp_group_fs_mgmt::upload_chunk()
 
     if (file_upload_area == 0)
     {
-        tmp_message->writer()->append("len");
-        tmp_message->writer()->append(local_file_size);
+        tmp_message->append_key(smp_cbor_key_len);
+        tmp_message->append_unsigned(local_file_size);
     }
 
-    //TODO: Deal with size
-    tmp_message->writer()->append("name");
-    tmp_message->writer()->append(device_file_name);
-    tmp_message->writer()->append("off");
-    tmp_message->writer()->append(file_upload_area);
-    tmp_message->writer()->append("data");
-    tmp_message->writer()->append(local_file.read(64));
+    tmp_message->append_key(smp_cbor_key_name);
+    tmp_message->append_string(device_file_name);
+    tmp_message->append_key(smp_cbor_key_off);
+    tmp_message->append_unsigned(file_upload_area);
+    tmp_message->append_key(smp_cbor_key_data);
+
+    //Fill the remainder of the message exactly, leaving space for the 1 byte map end token
+    uint16_t max_size = processor->max_message_data_size(smp_mtu);
+    uint32_t data_size = 0;
+
+    if (max_size > (tmp_message->size() + 1))
+    {
+        data_size = smp_cbor_max_byte_array_size(max_size - tmp_message->size() - 1);
+    }
+
+    QByteArray file_data = local_file.read(data_size);
+    verify_update(file_upload_area, file_data);
+    tmp_message->append_byte_array(file_data.constData(), file_data.length());
     tmp_message->end_message();
 
-    //TODO: Not always true
-    file_upload_area += 64;
+    file_upload_area += file_data.length();
 
     processor->send(tmp_message, smp_timeout, smp_retries, true);
 }
 
-void smp_group_fs_mgmt::download_chunk()
+void smp_group_fs_mgmt::download_chunk(uint32_t offset)
 {
-    smp_message *tmp_message = new smp_message();
+    smp_message *tmp_message = processor->get_message(smp_mtu);
     tmp_message->start_message(SMP_OP_READ, smp_version, SMP_GROUP_ID_FS, COMMAND_UPLOAD_DOWNLOAD);
 
-/*    if (local_file.pos() != file_upload_area)
+    tmp_message->append_key(smp_cbor_key_name);
+    tmp_message->append_string(device_file_name);
+    tmp_message->append_key(smp_cbor_key_off);
+    tmp_message->append_unsigned(offset);
+    tmp_message->end_message();
+
+    if (processor->send(tmp_message, smp_timeout, smp_retries, true) == false)
     {
-        local_file.seek(file_upload_area);
-    }*/
+        processor->release_message(tmp_message);
+        return;
+    }
 
-    //TODO: Deal with size
-    tmp_message->writer()->append("name");
-    tmp_message->writer()->append(device_file_name);
-    tmp_message->writer()->append("off");
-    tmp_message->writer()->append(file_upload_area);
-    tmp_message->end_message();
+    download_outstanding.append(offset);
+}
 
-    processor->send(tmp_message, smp_timeout, smp_retries, true);
+void smp_group_fs_mgmt::download_request_chunks()
+{
+    bool gap_requested = false;
+    uint8_t i = 0;
+
+    if (download_request_off < file_upload_area)
+    {
+        download_request_off = file_upload_area;
+    }
+
+    //If a response was shorter than expected, there will be a gap which no outstanding request covers
+    while (i < download_outstanding.length())
+    {
+        if (download_outstanding.at(i) <= file_upload_area)
+        {
+            gap_requested = true;
+            break;
+        }
+
+        ++i;
+    }
+
+    if (gap_requested == false && download_request_off > file_upload_area)
+    {
+        download_chunk(file_upload_area);
+    }
+
+    if (download_chunk_size == 0)
+    {
+        //Size of data the device returns is not yet known, only a single request can be outstanding
+        if (download_outstanding.length() == 0)
+        {
+            download_chunk(download_request_off);
+        }
+
+        return;
+    }
+
+    while (download_outstanding.length() < download_window && download_request_off < (uint32_t)local_file_size)
+    {
+        download_chunk(download_request_off);
+        download_request_off += download_chunk_size;
+    }
 }
 
-bool smp_group_fs_mgmt::start_upload(QString file_name, QString destination_name)
+void smp_group_fs_mgmt::retry(smp_message *message)
+{
+    Q_UNUSED(message);
+
+    if (mode == MODE_DOWNLOAD && download_window > 1)
+    {
+        //Link is losing messages, reduce the number of outstanding requests
+        download_window /= 2;
+        download_window_responses = 0;
+        log_debug() << "Download window reduced to " << download_window;
+    }
+}
+
+bool smp_group_fs_mgmt::start_upload(QString file_name, QString destination_name, QString hash_checksum, QByteArray *hash_checksum_result)
 {
     local_file.setFileName(file_name);
 
@@ -907,6 +969,8 @@ bool smp_group_fs_mgmt::start_upload(QString file_name, QString destination_name
     device_file_name = destination_name;
     local_file_size = local_file.size();
     file_upload_area = 0;
+    hash_checksum_result_object = hash_checksum_result;
+    verify_start(hash_checksum);
     upload_tmr.start();
 
     //	    qDebug() << "len: " << message.length();
@@ -916,11 +980,49 @@ bool smp_group_fs_mgmt::start_upload(QString file_name, QString destination_name
     return true;
 }
 
-bool smp_group_fs_mgmt::start_download(QString file_name, QString destination_name)
+bool smp_group_fs_mgmt::start_download(QString file_name, QString destination_name, QString hash_checksum, QByteArray *hash_checksum_result)
 {
+    bool resume = false;
+
+    if (resume_valid == true)
+    {
+        //Only continue if the local file is exactly as it was left when the previous download was interrupted
+        if (resume_data.device_file_name == file_name && resume_data.local_file_name == destination_name && QFileInfo(destination_name).size() == resume_data.offset && resume_data.offset < resume_data.file_size)
+        {
+            resume = true;
+        }
+        else
+        {
+            clear_resume();
+        }
+    }
+
+    hash_checksum_result_object = hash_checksum_result;
+    verify_start(hash_checksum);
+
+    if (resume == true && !verify_type.isEmpty())
+    {
+        //Data which has already been downloaded needs to be included in the hash/checksum
+        QFile existing_file(destination_name);
+
+        if (existing_file.open(QFile::ReadOnly))
+        {
+            while (!existing_file.atEnd())
+            {
+                //The position must be read before the data, the order arguments are evaluated in is unspecified
+                qint64 pos = existing_file.pos();
+                QByteArray chunk = existing_file.read(65536);
+
+                verify_update(pos, chunk);
+            }
+
+            existing_file.close();
+        }
+    }
+
     local_file.setFileName(destination_name);
 
-    if (!local_file.open(QFile::WriteOnly | QFile::Truncate))
+    if (!local_file.open(resume == true ? (QFile::WriteOnly | QFile::Append) : (QFile::WriteOnly | QFile::Truncate)))
     {
         emit status(smp_user_data, STATUS_ERROR, "File could not be opened in write mode");
         return false;
@@ -928,12 +1030,31 @@ bool smp_group_fs_mgmt::start_download(QString file_name, QString destination_na
 
     mode = MODE_DOWNLOAD;
     device_file_name = file_name;
-    file_upload_area = 0;
+
+    if (resume == true)
+    {
+        log_debug() << "Resuming download from offset: " << resume_data.offset;
+        local_file_size = resume_data.file_size;
+        file_upload_area = resume_data.offset;
+        emit progress(smp_user_data, file_upload_area * 100 / local_file_size);
+    }
+    else
+    {
+        local_file_size = 0;
+        file_upload_area = 0;
+    }
+
+    download_window = download_window_initial;
+    download_window_responses = 0;
+    download_request_off = file_upload_area;
+    download_chunk_size = 0;
+    download_outstanding.clear();
+    download_received.clear();
     upload_tmr.start();
 
     //	    qDebug() << "len: " << message.length();
 
-    download_chunk();
+    download_request_chunks();
 
     return true;
 }
@@ -1004,6 +1125,153 @@ bool smp_group_fs_mgmt::start_file_close()
     return true;
 }
 
+void smp_group_fs_mgmt::store_resume()
+{
+    if (file_upload_area == 0 || local_file_size <= 0 || file_upload_area >= (uint32_t)local_file_size)
+    {
+        //Nothing has been received yet or the download has already finished
+        return;
+    }
+
+    local_file.flush();
+    resume_data.device_file_name = device_file_name;
+    resume_data.local_file_name = local_file.fileName();
+    resume_data.file_size = local_file_size;
+    resume_data.offset = file_upload_area;
+    resume_valid = true;
+
+    log_debug() << "Stored download resume offset: " << resume_data.offset;
+}
+
+void smp_group_fs_mgmt::verify_start(QString hash_checksum)
+{
+    verify_type = hash_checksum;
+    verify_sha256.reset();
+    verify_crc32 = 0;
+    verify_offset = 0;
+    verify_valid = true;
+    verify_unsupported.clear();
+
+    if (!verify_type.isEmpty() && verify_type != "sha256" && verify_type != "crc32")
+    {
+        //Only sha256 and crc32 can be calculated locally, the completion status reports that the transfer was not verified
+        log_error() << "Hash/checksum " << verify_type << " is not supported locally, transfer will not be verified";
+        verify_unsupported = verify_type;
+        verify_type.clear();
+    }
+}
+
+void smp_group_fs_mgmt::verify_update(uint32_t offset, QByteArray data)
+{
+    if (verify_type.isEmpty() || verify_valid == false)
+    {
+        return;
+    }
+
+    if (offset > verify_offset)
+    {
+        //Data has been skipped, the hash/checksum cannot be calculated
+        log_error() << "Hash/checksum data skipped at offset " << offset;
+        verify_valid = false;
+        return;
+    }
+    else if ((offset + data.length()) <= verify_offset)
+    {
+        //Data being repeated has already been included
+        return;
+    }
+
+    data = data.mid(verify_offset - offset);
+
+    if (verify_type == "sha256")
+    {
+        verify_sha256.addData(data);
+    }
+    else
+    {
+        verify_crc32 = AutCrc::crc32((const quint8 *)data.constData(), data.length(), verify_crc32);
+    }
+
+    verify_offset += data.length();
+}
+
+QByteArray smp_group_fs_mgmt::verify_result()
+{
+    if (verify_type == "sha256")
+    {
+        return verify_sha256.result();
+    }
+
+    uint32_t tmp_hash_checksum = verify_crc32;
+
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+    //Flip endian for little endian systems to match the order of the device response
+    flip_endian((uint8_t *)&tmp_hash_checksum, sizeof(uint32_t));
+#endif
+
+    return QByteArray((char *)&tmp_hash_checksum, sizeof(uint32_t));
+}
+
+void smp_group_fs_mgmt::verify_finish(QString file_name, QString complete_message)
+{
+    if (!verify_unsupported.isEmpty())
+    {
+        emit status(smp_user_data, STATUS_COMPLETE, QString("%1, not verified: %2 is not supported locally").arg(complete_message, verify_unsupported));
+        return;
+    }
+    else if (!verify_type.isEmpty() && verify_valid == false)
+    {
+        emit status(smp_user_data, STATUS_COMPLETE, QString("%1, not verified: data was skipped").arg(complete_message));
+        return;
+    }
+    else if (verify_type.isEmpty())
+    {
+        emit status(smp_user_data, STATUS_COMPLETE, complete_message);
+        return;
+    }
+
+    //Request the hash/checksum of the file on the device to compare against the locally calculated one
+    smp_message *tmp_message = new smp_message();
+    tmp_message->start_message(SMP_OP_READ, smp_version, SMP_GROUP_ID_FS, COMMAND_HASH_CHECKSUM);
+    tmp_message->writer()->append("name");
+    tmp_message->writer()->append(file_name);
+    tmp_message->writer()->append("type");
+    tmp_message->writer()->append(verify_type);
+    tmp_message->end_message();
+
+    mode = MODE_VERIFY;
+    verify_complete_message = complete_message;
+
+    processor->send(tmp_message, smp_timeout, smp_retries, true);
+}
+
+bool smp_group_fs_mgmt::get_resume(fs_mgmt_resume_t *resume)
+{
+    if (resume_valid == false)
+    {
+        return false;
+    }
+
+    *resume = resume_data;
+
+    return true;
+}
+
+void smp_group_fs_mgmt::set_resume(fs_mgmt_resume_t *resume)
+{
+    resume_data = *resume;
+    resume_valid = true;
+}
+
+void smp_group_fs_mgmt::clear_resume()
+{
+    resume_data.device_file_name.clear();
+    resume_data.local_file_name.clear();
+    resume_data.file_size = 0;
+    resume_data.offset = 0;
+    resume_valid = false;
+}
+
 QString smp_group_fs_mgmt::mode_to_string(uint8_t mode)
 {
     switch (mode)
@@ -1022,6 +1290,8 @@ QString smp_group_fs_mgmt::mode_to_string(uint8_t mode)
         return "Supported hashes/checksums";
     case MODE_FILE_CLOSE:
         return "Closing file";
+    case MODE_VERIFY:
+        return "Verifying";
     default:
         return "Invalid";
     }
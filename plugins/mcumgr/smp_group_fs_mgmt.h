@@ -31,6 +31,8 @@
 #include <QCborMap>
 #include <QCborValue>
 #include <QFile>
+#include <QMap>
+#include <QCryptographicHash>
 
 struct hash_checksum_t {
     QString name;
@@ -38,6 +40,14 @@ struct hash_checksum_t {
     uint16_t size;
 };
 
+//Details of an interrupted file download, used to continue the download from the last received offset
+struct fs_mgmt_resume_t {
+    QString device_file_name;
+    QString local_file_name;
+    uint32_t file_size;
+    uint32_t offset;
+};
+
 class smp_group_fs_mgmt : public smp_group
 {
     Q_OBJECT
@@ -48,25 +58,35 @@ public:
     void receive_error(uint8_t version, uint8_t op, uint16_t group, uint8_t command, smp_error_t error);
     void timeout(smp_message *message);
     void cancel();
-    bool start_upload(QString file_name, QString destination_name);
-    bool start_download(QString file_name, QString destination_name);
+    void retry(smp_message *message);
+    bool start_upload(QString file_name, QString destination_name, QString hash_checksum, QByteArray *hash_checksum_result);
+    bool start_download(QString file_name, QString destination_name, QString hash_checksum, QByteArray *hash_checksum_result);
     bool start_status(QString file_name, uint32_t *file_size);
     bool start_hash_checksum(QString file_name, QString hash_checksum, QByteArray *result, uint32_t *file_size);
     bool start_supported_hashes_checksums(QList<hash_checksum_t> *hash_checksum_list);
     bool start_file_close();
+    bool get_resume(fs_mgmt_resume_t *resume);
+    void set_resume(fs_mgmt_resume_t *resume);
+    void clear_resume();
     static bool error_lookup(int32_t rc, QString *error);
     static bool error_define_lookup(int32_t rc, QString *error);
 
 private:
-    bool parse_upload_response(QCborStreamReader &reader, uint32_t *off, bool *off_found);
-    bool parse_download_response(QCborStreamReader &reader, uint32_t *off, uint32_t *len, QByteArray *file_data);
+    bool parse_upload_response(const smp_cbor_index *response, uint32_t *off, bool *off_found);
+    bool parse_download_response(const smp_cbor_index *response, uint32_t *off, uint32_t *len, QByteArray *file_data);
     bool parse_status_response(QCborStreamReader &reader, uint32_t *len);
     bool parse_hash_checksum_response(QCborStreamReader &reader, QString *type, QByteArray *hash_checksum, uint32_t *file_size);
     bool parse_supported_hashes_checksums_response(QCborStreamReader &reader, bool in_data, QString *key_name, hash_checksum_t *current_item);
 //    bool parse_file_close_response(QCborStreamReader &reader, int32_t *ret, QString *response);
     void upload_chunk();
-    void download_chunk();
+    void download_chunk(uint32_t offset);
+    void download_request_chunks();
     void flip_endian(uint8_t *data, uint8_t size);
+    void store_resume();
+    void verify_start(QString hash_checksum);
+    void verify_update(uint32_t offset, QByteArray data);
+    QByteArray verify_result();
+    void verify_finish(QString file_name, QString complete_message);
 
     QString mode_to_string(uint8_t mode);
     QString command_to_string(uint8_t command);
@@ -82,6 +102,21 @@ private:
     QList<hash_checksum_t> *hash_checksum_object;
     QByteArray *hash_checksum_result_object;
     uint32_t *file_size_object;
+    fs_mgmt_resume_t resume_data;
+    bool resume_valid;
+    uint8_t download_window;
+    uint8_t download_window_responses;
+    uint32_t download_request_off;
+    uint32_t download_chunk_size;
+    QList<uint32_t> download_outstanding;
+    QMap<uint32_t, QByteArray> download_received;
+    QString verify_type;
+    QCryptographicHash verify_sha256;
+    uint32_t verify_crc32;
+    uint32_t verify_offset;
+    bool verify_valid;
+    QString verify_complete_message;
+    QString verify_unsupported;
 };
 
 #endif // SMP_GROUP_FS_MGMT_H
@@ -22,6 +22,8 @@
 *******************************************************************************/
 #include "smp_group_img_mgmt.h"
 #include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
 #include <QCryptographicHash>
 #include "smp_message.h"
 
@@ -56,6 +58,8 @@ static const uint8_t ih_magic_v1[] = { 0x96, 0xf3, 0xb8, 0x3c };
 static const uint8_t ih_magic_v2[] = { 0x96, 0xf3, 0xb8, 0x3d };
 static const uint8_t ih_hdr_size_offs = 8;
 static const uint8_t ih_img_size_offs = 12;
+static const uint8_t ih_ver_offs = 20;
+static const uint8_t ih_ver_size = 8;
 
 static QStringList smp_error_defines = QStringList() <<
     //Error index starts from 2 (no error and unknown error are common and handled in the base code)
@@ -133,6 +137,9 @@ slot_state_t slot_state_buffer;
 smp_group_img_mgmt::smp_group_img_mgmt(smp_processor *parent) : smp_group(parent, "IMG", SMP_GROUP_ID_IMG, error_lookup, error_define_lookup)
 {
     mode = MODE_IDLE;
+    resume_valid = false;
+    upload_repeated_parts = 0;
+    image_cache = nullptr;
 }
 
 bool smp_group_img_mgmt::extract_header(QByteArray *file_data, image_endian_t *endian)
@@ -301,121 +308,171 @@ bool smp_group_img_mgmt::extract_hash(QByteArray *file_data, QByteArray *hash)
     return hash_found;
 }
 
-bool smp_group_img_mgmt::parse_upload_response(QCborStreamReader &reader, int64_t *new_off, img_mgmt_upload_match *match)
+void smp_group_img_mgmt::extract_version(QByteArray *file_data, QString *version)
 {
-    QString key = "";
-    bool keyset = true;
+    uint8_t major;
+    uint8_t minor;
+    uint16_t revision;
+    uint32_t build;
 
-    while (!reader.lastError() && reader.hasNext())
+    if (file_data->length() < (ih_ver_offs + ih_ver_size))
     {
-        if (keyset == false && !key.isEmpty())
-        {
-            key.clear();
-        }
+        version->clear();
+        return;
+    }
 
-        keyset = false;
+    major = (uint8_t)file_data->at(ih_ver_offs);
+    minor = (uint8_t)file_data->at(ih_ver_offs + 1);
 
-        //	    qDebug() << "Key: " << key;
-        //	    qDebug() << "Type: " << reader.type();
-        switch (reader.type())
-        {
-            case QCborStreamReader::SimpleType:
-            {
-                if (key == "match")
-                {
-                    bool match_value = reader.toBool();
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+    if (upload_endian != ENDIAN_BIG)
+#else
+    if (upload_endian != ENDIAN_LITTLE)
+#endif
+    {
+        revision = (uint8_t)file_data->at(ih_ver_offs + 2);
+        revision |= (uint16_t)((uint8_t)file_data->at(ih_ver_offs + 3)) << 8;
 
-                    if (match_value == true)
-                    {
-                        *match = MATCH_FAILED;
-                    }
-                    else
-                    {
-                        *match = MATCH_PASSED;
-                    }
-                }
+        build = (uint8_t)file_data->at(ih_ver_offs + 4);
+        build |= (uint32_t)((uint8_t)file_data->at(ih_ver_offs + 5)) << 8;
+        build |= (uint32_t)((uint8_t)file_data->at(ih_ver_offs + 6)) << 16;
+        build |= (uint32_t)((uint8_t)file_data->at(ih_ver_offs + 7)) << 24;
+    }
+    else
+    {
+        revision = (uint8_t)file_data->at(ih_ver_offs + 3);
+        revision |= (uint16_t)((uint8_t)file_data->at(ih_ver_offs + 2)) << 8;
 
-                reader.next();
-                break;
-            }
+        build = (uint8_t)file_data->at(ih_ver_offs + 7);
+        build |= (uint32_t)((uint8_t)file_data->at(ih_ver_offs + 6)) << 8;
+        build |= (uint32_t)((uint8_t)file_data->at(ih_ver_offs + 5)) << 16;
+        build |= (uint32_t)((uint8_t)file_data->at(ih_ver_offs + 4)) << 24;
+    }
 
-            case QCborStreamReader::UnsignedInteger:
-            case QCborStreamReader::NegativeInteger:
+    *version = QString("%1.%2.%3").arg(QString::number(major), QString::number(minor), QString::number(revision));
+
+    if (build != 0)
+    {
+        version->append("+").append(QString::number(build));
+    }
+}
+
+bool smp_group_img_mgmt::load_image_details(QString filename, image_cache_t *details, QByteArray *file_data, QString *error)
+{
+    QFileInfo file_info(filename);
+    QByteArray local_data;
+    QByteArray *data = (file_data != nullptr ? file_data : &local_data);
+    qint64 modified = file_info.lastModified().toMSecsSinceEpoch();
+    bool cached = false;
+
+    if (image_cache != nullptr)
+    {
+        int i = 0;
+
+        while (i < image_cache->length())
+        {
+            if (image_cache->at(i).file_name == file_info.absoluteFilePath() && image_cache->at(i).file_size == file_info.size() && image_cache->at(i).modified == modified)
             {
-                if (key == "off")
-                {
-                    //			    qDebug() << "found off";
-                    *new_off = reader.toInteger();
-                }
+                *details = image_cache->at(i);
+                cached = true;
 
-                reader.next();
+                //Keep most recently used entries at the start of the list
+                image_cache->move(i, 0);
                 break;
             }
 
-            case QCborStreamReader::ByteArray:
-            {
-                auto r = reader.readByteArray();
+            ++i;
+        }
+    }
 
-                while (r.status == QCborStreamReader::Ok)
-                {
-                    r = reader.readByteArray();
-                }
+    if (cached == true && file_data == nullptr)
+    {
+        //Only the details of the file are needed, no need to read it
+        return true;
+    }
 
-                break;
-            }
+    QFile file(filename);
 
-            case QCborStreamReader::String:
-            {
-                QString data;
-                auto r = reader.readString();
-                while (r.status == QCborStreamReader::Ok)
-                {
-                    data.append(r.data);
-                    r = reader.readString();
-                }
+    if (!file.open(QFile::ReadOnly))
+    {
+        *error = "File open failed";
+        return false;
+    }
 
-                if (r.status == QCborStreamReader::Error)
-                {
-                    data.clear();
-                    log_error() << "Error decoding string";
-                }
-                else
-                {
-                    if (key.isEmpty())
-                    {
-                        key = data;
-                        keyset = true;
-                    }
-                }
+    data->clear();
+    data->append(file.readAll());
+    file.close();
 
-                break;
-            }
+    if (cached == true)
+    {
+        if (data->length() == details->file_size)
+        {
+            log_debug() << "Using cached image details for " << filename;
+            return true;
+        }
 
-            case QCborStreamReader::Array:
-            case QCborStreamReader::Map:
-            {
-                reader.enterContainer();
-                while (reader.lastError() == QCborError::NoError && reader.hasNext())
-                {
-                    parse_upload_response(reader, new_off, match);
-                }
-                if (reader.lastError() == QCborError::NoError)
-                {
-                    reader.leaveContainer();
-                }
-                break;
-            }
+        //File has changed since it was checked, parse it again
+        image_cache->removeFirst();
+    }
 
-            default:
-            {
-                reader.next();
-            }
+    if (extract_header(data, &upload_endian) == false)
+    {
+        data->clear();
+        *error = "MCUboot header was not found";
+        return false;
+    }
+    else if (extract_hash(data, &details->hash) == false)
+    {
+        data->clear();
+        *error = "Hash was not found";
+        return false;
+    }
+
+    details->file_name = file_info.absoluteFilePath();
+    details->file_size = data->length();
+    details->modified = modified;
+    details->endian = upload_endian;
+    details->session_hash = QCryptographicHash::hash(*data, QCryptographicHash::Sha256);
+    extract_version(data, &details->version);
+
+    if (image_cache != nullptr)
+    {
+        image_cache->prepend(*details);
+
+        while (image_cache->length() > MAX_IMAGE_CACHE)
+        {
+            image_cache->removeLast();
         }
     }
 
     return true;
 }
 
+bool smp_group_img_mgmt::parse_upload_response(const smp_cbor_index *response, int64_t *new_off, img_mgmt_upload_match *match)
+{
+    qint64 value;
+    bool match_value;
+
+    if (response->get_bool(SMP_CBOR_KEY_MATCH, &match_value))
+    {
+        if (match_value == true)
+        {
+            *match = MATCH_FAILED;
+        }
+        else
+        {
+            *match = MATCH_PASSED;
+        }
+    }
+
+    if (response->get_integer(SMP_CBOR_KEY_OFF, &value))
+    {
+        *new_off = value;
+    }
+
+    return true;
+}
+
 bool smp_group_img_mgmt::parse_state_response(QCborStreamReader &reader, QString array_name)
 {
     QString array_name_dupe = array_name;
@@ -630,16 +687,15 @@ bool smp_group_img_mgmt::parse_state_response(QCborStreamReader &reader, QString
     return (reader.lastError() ? false : true);
 }
 
-void smp_group_img_mgmt::file_upload(QByteArray *message)
+void smp_group_img_mgmt::file_upload(const smp_cbor_index *response)
 {
     int64_t off = -1;
     bool good = true;
 
-    if (message != nullptr)
+    if (response != nullptr)
     {
         img_mgmt_upload_match match = MATCH_NOT_PRESENT;
-        QCborStreamReader cbor_reader(*message);
-        good = parse_upload_response(cbor_reader, &off, &match);
+        good = parse_upload_response(response, &off, &match);
 
     //    qDebug() << "rc = " << rc << ", off = " << off;
 
@@ -741,6 +797,9 @@ log_error() << "Going in circles...";
             this->upload_hash.clear();
             this->file_upload_area = 0;
             this->upgrade_only = false;
+            this->upload_file_name.clear();
+            this->upload_session_hash.clear();
+            clear_resume();
 //                emit plugin_set_status(false, false);
 //                lbl_IMG_Status->setText("Finished.");
             emit progress(smp_user_data, 100);
@@ -749,40 +808,48 @@ log_error() << "Going in circles...";
             return;
         }
 
-        smp_message *tmp_message = new smp_message();
+        smp_message *tmp_message = processor->get_message(smp_mtu);
         tmp_message->start_message(SMP_OP_WRITE, smp_version, SMP_GROUP_ID_IMG, COMMAND_UPLOAD);
 
         if (this->file_upload_area == 0)
         {
-            //Initial packet, extra data is needed: generate upload hash
-            QByteArray session_hash = QCryptographicHash::hash(this->file_upload_data, QCryptographicHash::Sha256);
-
+            //Initial packet, extra data is needed. The session hash allows the device to continue a previously interrupted upload of the same file, in which case it will respond with the offset it has reached
             if (this->upload_image != 0)
             {
-                tmp_message->writer()->append("image");
-                tmp_message->writer()->append(this->upload_image);
+                tmp_message->append_key(smp_cbor_key_image);
+                tmp_message->append_unsigned(this->upload_image);
             }
 
-            tmp_message->writer()->append("len");
-            tmp_message->writer()->append(this->file_upload_data.length());
-            tmp_message->writer()->append("sha");
-            tmp_message->writer()->append(session_hash);
+            tmp_message->append_key(smp_cbor_key_len);
+            tmp_message->append_unsigned(this->file_upload_data.length());
+            tmp_message->append_key(smp_cbor_key_sha);
+            tmp_message->append_byte_array(this->upload_session_hash.constData(), this->upload_session_hash.length());
 
             if (this->upgrade_only == true)
             {
-                tmp_message->writer()->append("upgrade");
-                tmp_message->writer()->append(true);
+                tmp_message->append_key(smp_cbor_key_upgrade);
+                tmp_message->append_bool(true);
             }
         }
 
-        tmp_message->writer()->append("off");
-        tmp_message->writer()->append(this->file_upload_area);
-        tmp_message->writer()->append("data");
+        tmp_message->append_key(smp_cbor_key_off);
+        tmp_message->append_unsigned(this->file_upload_area);
+        tmp_message->append_key(smp_cbor_key_data);
+
+        //Exact space left for the data element (header and data) after the 1 byte map end token
+        uint32_t data_size = 0;
+
+        if (max_size > (uint)(tmp_message->size() + 1))
+        {
+            data_size = smp_cbor_max_byte_array_size(max_size - tmp_message->size() - 1);
+        }
 
-        //CBOR element header is 2 bytes with 1 byte end token
-        max_size = max_size - tmp_message->size() - 3;
+        if (data_size > (uint32_t)(this->file_upload_data.length() - this->file_upload_area))
+        {
+            data_size = this->file_upload_data.length() - this->file_upload_area;
+        }
 
-        tmp_message->writer()->append(this->file_upload_data.mid(this->file_upload_area, max_size));
+        tmp_message->append_byte_array((this->file_upload_data.constData() + this->file_upload_area), data_size);
 
         //	    qDebug() << "off: " << this->file_upload_area << ", left: " << this->file_upload_data.length();
 
@@ -844,7 +911,7 @@ void smp_group_img_mgmt::receive_ok(uint8_t version, uint8_t op, uint16_t group,
                 emit plugin_set_status(false, false);
             }
 #endif
-            file_upload(&data);
+            file_upload(processor->response_index());
         }
         else if (mode == MODE_SET_IMAGE && command == COMMAND_STATE)
         {
@@ -941,6 +1008,7 @@ void smp_group_img_mgmt::receive_error(uint8_t version, uint8_t op, uint16_t gro
     {
         if (mode == MODE_UPLOAD_FIRMWARE)
         {
+            store_resume();
             upload_image = 0;
             file_upload_data.clear();
             file_upload_area = 0;
@@ -959,6 +1027,7 @@ void smp_group_img_mgmt::timeout(smp_message *message)
 
     if (mode == MODE_UPLOAD_FIRMWARE)
     {
+        store_resume();
         upload_image = 0;
         file_upload_data.clear();
         file_upload_area = 0;
@@ -979,6 +1048,7 @@ void smp_group_img_mgmt::cancel()
     {
         if (mode == MODE_UPLOAD_FIRMWARE)
         {
+            store_resume();
             upload_image = 0;
             file_upload_data.clear();
             file_upload_area = 0;
@@ -1044,36 +1114,40 @@ bool smp_group_img_mgmt::start_image_set(QByteArray *hash, bool confirm, QList<i
 bool smp_group_img_mgmt::start_firmware_update(uint8_t image, QString filename, bool upgrade, QByteArray *image_hash)
 {
     //Upload
-    QFile file(filename);
+    image_cache_t details;
+    QString error;
 
-    if (!file.open(QFile::ReadOnly))
+    if (load_image_details(filename, &details, &this->file_upload_data, &error) == false)
     {
-        emit status(smp_user_data, STATUS_ERROR, "File open failed");
+        emit status(smp_user_data, STATUS_ERROR, error);
         return false;
     }
 
-    this->file_upload_data.clear();
-    this->file_upload_data.append(file.readAll());
+    this->upload_endian = details.endian;
+    this->upload_hash = details.hash;
+    this->upload_session_hash = details.session_hash;
+    this->upload_file_name = filename;
 
-    file.close();
-
-    if (extract_header(&this->file_upload_data, &upload_endian) == false)
+    if (resume_valid == true)
     {
-        this->file_upload_data.clear();
-        emit status(smp_user_data, STATUS_ERROR, "MCUboot header was not found");
-        return false;
-    }
-    else if (extract_hash(&this->file_upload_data, &this->upload_hash) == false)
-    {
-        this->file_upload_data.clear();
-        emit status(smp_user_data, STATUS_ERROR, "Hash was not found");
-        return false;
+        if (resume_data.file_name == filename && resume_data.image == image && resume_data.session_hash == this->upload_session_hash && resume_data.offset < (uint32_t)this->file_upload_data.length())
+        {
+            //The device will report the offset to continue from in response to the initial packet
+            log_debug() << "Resuming upload, last acknowledged offset: " << resume_data.offset;
+            emit progress(smp_user_data, resume_data.offset * 100 / this->file_upload_data.length());
+        }
+        else
+        {
+            //File or target has changed, the previous upload cannot be continued
+            clear_resume();
+        }
     }
 
     //Send start
     mode = MODE_UPLOAD_FIRMWARE;
     this->upload_image = image;
     this->file_upload_area = 0;
+    this->upload_repeated_parts = 0;
     this->upgrade_only = upgrade;
     this->upload_tmr.start();
 
@@ -1105,6 +1179,96 @@ bool smp_group_img_mgmt::start_image_erase(uint8_t slot)
     return true;
 }
 
+bool smp_group_img_mgmt::image_present(QString filename, uint8_t image, QList<image_state_t> *images, QByteArray *image_hash)
+{
+    image_cache_t details;
+    QString error;
+    uint8_t i = 0;
+
+    if (load_image_details(filename, &details, nullptr, &error) == false)
+    {
+        log_error() << "Unable to check image: " << error;
+        return false;
+    }
+
+    if (image_hash != nullptr)
+    {
+        *image_hash = details.hash;
+    }
+
+    while (i < images->length())
+    {
+        if (images->at(i).image_set == false || images->at(i).image == image)
+        {
+            uint8_t l = 0;
+
+            while (l < images->at(i).slot_list.length())
+            {
+                if (images->at(i).slot_list.at(l).hash == details.hash)
+                {
+                    log_debug() << "Image " << details.version << " already present in slot " << images->at(i).slot_list.at(l).slot;
+                    return true;
+                }
+
+                ++l;
+            }
+        }
+
+        ++i;
+    }
+
+    return false;
+}
+
+void smp_group_img_mgmt::set_image_cache(QList<image_cache_t> *cache)
+{
+    image_cache = cache;
+}
+
+void smp_group_img_mgmt::store_resume()
+{
+    if (this->file_upload_area == 0 || this->upload_session_hash.isEmpty())
+    {
+        //Nothing has been acknowledged by the device yet
+        return;
+    }
+
+    resume_data.file_name = this->upload_file_name;
+    resume_data.session_hash = this->upload_session_hash;
+    resume_data.image = this->upload_image;
+    resume_data.offset = this->file_upload_area;
+    resume_valid = true;
+
+    log_debug() << "Stored upload resume offset: " << resume_data.offset;
+}
+
+bool smp_group_img_mgmt::get_resume(img_mgmt_resume_t *resume)
+{
+    if (resume_valid == false)
+    {
+        return false;
+    }
+
+    *resume = resume_data;
+
+    return true;
+}
+
+void smp_group_img_mgmt::set_resume(img_mgmt_resume_t *resume)
+{
+    resume_data = *resume;
+    resume_valid = true;
+}
+
+void smp_group_img_mgmt::clear_resume()
+{
+    resume_data.file_name.clear();
+    resume_data.session_hash.clear();
+    resume_data.image = 0;
+    resume_data.offset = 0;
+    resume_valid = false;
+}
+
 QString smp_group_img_mgmt::mode_to_string(uint8_t mode)
 {
     switch (mode)
@@ -32,6 +32,8 @@
 #include <QCborValue>
 #include <QStandardItem>
 
+#define MAX_IMAGE_CACHE 32
+
 struct slot_state_t {
     uint32_t slot;
     QByteArray version;
@@ -65,6 +67,25 @@ enum image_endian_t {
     ENDIAN_UNKNOWN
 };
 
+//Parsed details of a local image file, identified by the path, size and modification time of the file
+struct image_cache_t {
+    QString file_name;
+    qint64 file_size;
+    qint64 modified;
+    image_endian_t endian;
+    QByteArray hash;
+    QByteArray session_hash;
+    QString version;
+};
+
+//Details of an interrupted firmware upload, used to continue the upload from the last acknowledged offset
+struct img_mgmt_resume_t {
+    QString file_name;
+    QByteArray session_hash;
+    uint8_t image;
+    uint32_t offset;
+};
+
 class smp_group_img_mgmt : public smp_group
 {
     Q_OBJECT
@@ -79,6 +100,11 @@ public:
     bool start_image_set(QByteArray *hash, bool confirm, QList<image_state_t> *images);
     bool start_firmware_update(uint8_t image, QString filename, bool upgrade, QByteArray *image_hash);
     bool start_image_erase(uint8_t slot);
+    bool image_present(QString filename, uint8_t image, QList<image_state_t> *images, QByteArray *image_hash);
+    void set_image_cache(QList<image_cache_t> *cache);
+    bool get_resume(img_mgmt_resume_t *resume);
+    void set_resume(img_mgmt_resume_t *resume);
+    void clear_resume();
     static bool error_lookup(int32_t rc, QString *error);
     static bool error_define_lookup(int32_t rc, QString *error);
 
@@ -88,9 +114,12 @@ signals:
 private:
     bool extract_header(QByteArray *file_data, image_endian_t *endian);
     bool extract_hash(QByteArray *file_data, QByteArray *hash);
-    bool parse_upload_response(QCborStreamReader &reader, int64_t *new_off, img_mgmt_upload_match *match);
+    void extract_version(QByteArray *file_data, QString *version);
+    bool load_image_details(QString filename, image_cache_t *details, QByteArray *file_data, QString *error);
+    bool parse_upload_response(const smp_cbor_index *response, int64_t *new_off, img_mgmt_upload_match *match);
     bool parse_state_response(QCborStreamReader &reader, QString array_name);
-    void file_upload(QByteArray *message);
+    void file_upload(const smp_cbor_index *response);
+    void store_resume();
     QString mode_to_string(uint8_t mode);
     QString command_to_string(uint8_t command);
 
@@ -105,6 +134,11 @@ private:
     bool upgrade_only;
     uint8_t upload_repeated_parts;
     QList<image_state_t> *host_images;
+    QString upload_file_name;
+    QByteArray upload_session_hash;
+    img_mgmt_resume_t resume_data;
+    bool resume_valid;
+    QList<image_cache_t> *image_cache;
 };
 
 #endif // SMP_GROUP_IMG_MGMT_H
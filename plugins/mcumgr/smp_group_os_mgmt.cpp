@@ -59,6 +59,8 @@ static QStringList smp_error_values = QStringList() <<
 smp_group_os_mgmt::smp_group_os_mgmt(smp_processor *parent) : smp_group(parent, "OS", SMP_GROUP_ID_OS, error_lookup, error_define_lookup)
 {
     mode = MODE_IDLE;
+    mcumgr_buffer_size = nullptr;
+    mcumgr_buffer_count = nullptr;
 }
 
 bool smp_group_os_mgmt::parse_echo_response(QCborStreamReader &reader, QString *response)
@@ -845,12 +847,22 @@ void smp_group_os_mgmt::receive_ok(uint8_t version, uint8_t op, uint16_t group,
         {
             //Response to MCUmgr buffer parameters
             QCborStreamReader cbor_reader(data);
-            uint32_t buffer_size;
-            uint32_t buffer_count;
+            uint32_t buffer_size = 0;
+            uint32_t buffer_count = 0;
             bool good = parse_mcumgr_parameters_response(cbor_reader, &buffer_size, &buffer_count);
 
             log_debug() << "buffer size: " << buffer_size << ", buffer count: " << buffer_count;
 
+            if (mcumgr_buffer_size != nullptr)
+            {
+                *mcumgr_buffer_size = buffer_size;
+            }
+
+            if (mcumgr_buffer_count != nullptr)
+            {
+                *mcumgr_buffer_count = buffer_count;
+            }
+
             emit status(smp_user_data, STATUS_COMPLETE, QString("Buffer size: %1\nBuffer count: %2").arg(QString::number(buffer_size), QString::number(buffer_count)));
         }
         else if (finished_mode == MODE_OS_APPLICATION_INFO && command == COMMAND_OS_APPLICATION_INFO)
@@ -1037,13 +1049,15 @@ bool smp_group_os_mgmt::start_reset(bool force)
     return true;
 }
 
-bool smp_group_os_mgmt::start_mcumgr_parameters()
+bool smp_group_os_mgmt::start_mcumgr_parameters(uint32_t *buffer_size, uint32_t *buffer_count)
 {
     smp_message *tmp_message = new smp_message();
     tmp_message->start_message(SMP_OP_READ, smp_version, SMP_GROUP_ID_OS, COMMAND_MCUMGR_PARAMETERS);
     tmp_message->end_message();
 
     mode = MODE_MCUMGR_PARAMETERS;
+    mcumgr_buffer_size = buffer_size;
+    mcumgr_buffer_count = buffer_count;
 
     //	    qDebug() << "len: " << message.length();
 
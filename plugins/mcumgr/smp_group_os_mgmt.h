@@ -64,7 +64,7 @@ public:
     bool start_task_stats(QList<task_list_t> *tasks);
     bool start_memory_pool(QList<memory_pool_t> *memory);
     bool start_reset(bool force);
-    bool start_mcumgr_parameters();
+    bool start_mcumgr_parameters(uint32_t *buffer_size = nullptr, uint32_t *buffer_count = nullptr);
     bool start_os_application_info(QString format);
     bool start_date_time_get(QDateTime *date_time);
     bool start_date_time_set(QDateTime date_time);
@@ -91,6 +91,8 @@ private:
     QString bootloader_query_value;
     QVariant *bootloader_info_response;
     QDateTime *rtc_get_date_time;
+    uint32_t *mcumgr_buffer_size;
+    uint32_t *mcumgr_buffer_count;
 };
 
 #endif // SMP_GROUP_OS_MGMT_H
@@ -30,6 +30,9 @@ enum modes : uint8_t {
     MODE_COMMIT,
     MODE_LOAD,
     MODE_SAVE,
+    MODE_BULK,
+    MODE_BULK_COMMIT,
+    MODE_BULK_SAVE,
 };
 
 enum settings_mgmt_commands : uint8_t {
@@ -39,6 +42,13 @@ enum settings_mgmt_commands : uint8_t {
     COMMAND_LOAD_SAVE,
 };
 
+//SMP version 2 error code returned when a key does not exist
+static const int32_t settings_mgmt_error_key_not_found = (smp_version_2_error_code_start + 1);
+
+//Number of bulk requests which can be outstanding at once, this is adjusted during a bulk operation depending upon retries
+static const uint8_t bulk_window_initial = 2;
+static const uint8_t bulk_window_max = SMP_MAX_PENDING_MESSAGES;
+
 static QStringList smp_error_defines = QStringList() <<
     //Error index starts from 2 (no error and unknown error are common and handled in the base code)
     "KEY_TOO_LONG" <<
@@ -60,6 +70,13 @@ static QStringList smp_error_values = QStringList() <<
 smp_group_settings_mgmt::smp_group_settings_mgmt(smp_processor *parent) : smp_group(parent, "SETTINGS", SMP_GROUP_ID_SETTINGS, error_lookup, error_define_lookup)
 {
     mode = MODE_IDLE;
+    bulk_entries = nullptr;
+    bulk_completed = 0;
+    bulk_changed = 0;
+    bulk_max_length = 0;
+    bulk_commit_save = false;
+    bulk_window = bulk_window_initial;
+    bulk_window_responses = 0;
 }
 
 bool smp_group_settings_mgmt::parse_read_response(QCborStreamReader &reader, QByteArray *value)
@@ -229,6 +246,22 @@ void smp_group_settings_mgmt::receive_ok(uint8_t version, uint8_t op, uint16_t g
             //Response to save
             emit status(smp_user_data, STATUS_COMPLETE, nullptr);
         }
+        else if (finished_mode == MODE_BULK && (command == COMMAND_READ_WRITE || command == COMMAND_DELETE))
+        {
+            //Response to one of the outstanding bulk requests
+            mode = MODE_BULK;
+            bulk_response(true, nullptr);
+        }
+        else if (finished_mode == MODE_BULK_COMMIT && command == COMMAND_COMMIT)
+        {
+            //Changes have been applied, now persist them
+            start_save();
+            mode = MODE_BULK_SAVE;
+        }
+        else if (finished_mode == MODE_BULK_SAVE && command == COMMAND_LOAD_SAVE)
+        {
+            bulk_finish();
+        }
         else
         {
             log_error() << "Unsupported command received";
@@ -246,7 +279,18 @@ void smp_group_settings_mgmt::receive_error(uint8_t version, uint8_t op, uint16_
     bool cleanup = true;
     log_error() << "error :(";
 
-    if (command == COMMAND_READ_WRITE && mode == MODE_READ)
+    if (mode == MODE_BULK && (command == COMMAND_READ_WRITE || command == COMMAND_DELETE))
+    {
+        //Errors for individual keys are recorded and the bulk operation continues
+        bulk_response(false, &error);
+        cleanup = false;
+    }
+    else if ((command == COMMAND_COMMIT && mode == MODE_BULK_COMMIT) || (command == COMMAND_LOAD_SAVE && mode == MODE_BULK_SAVE))
+    {
+        bulk_cleanup();
+        emit status(smp_user_data, status_error_return(error), QString((mode == MODE_BULK_COMMIT ? "Commit" : "Save")).append(" failed: ").append(smp_error::error_lookup_string(&error)));
+    }
+    else if (command == COMMAND_READ_WRITE && mode == MODE_READ)
     {
         //TODO
         emit status(smp_user_data, status_error_return(error), smp_error::error_lookup_string(&error));
@@ -295,6 +339,7 @@ void smp_group_settings_mgmt::timeout(smp_message *message)
     //TODO:
     emit status(smp_user_data, STATUS_TIMEOUT, QString("Timeout (Mode: %1)").arg(mode_to_string(mode)));
 
+    bulk_cleanup();
     mode = MODE_IDLE;
 }
 
@@ -302,6 +347,12 @@ void smp_group_settings_mgmt::cancel()
 {
     if (mode != MODE_IDLE)
     {
+        if (mode == MODE_BULK || mode == MODE_BULK_COMMIT || mode == MODE_BULK_SAVE)
+        {
+            processor->cleanup();
+            bulk_cleanup();
+        }
+
         mode = MODE_IDLE;
 
         emit status(smp_user_data, STATUS_CANCELLED, nullptr);
@@ -414,6 +465,252 @@ bool smp_group_settings_mgmt::start_save(void)
     return true;
 }
 
+//Reads, writes or deletes a list of keys with multiple requests outstanding, the result of each key is stored in its entry.
+//If commit_save is set and any keys were changed, a commit and save is performed once all keys have been processed
+bool smp_group_settings_mgmt::start_bulk(QList<settings_bulk_entry_t> *entries, uint32_t max_length, bool commit_save)
+{
+    uint16_t i = 0;
+
+    if (entries->isEmpty())
+    {
+        return false;
+    }
+
+    bulk_entries = entries;
+    bulk_queue.clear();
+    bulk_outstanding.clear();
+
+    while (i < bulk_entries->length())
+    {
+        (*bulk_entries)[i].result = SETTINGS_BULK_RESULT_PENDING;
+        (*bulk_entries)[i].error.clear();
+        bulk_queue.append(i);
+        ++i;
+    }
+
+    bulk_completed = 0;
+    bulk_changed = 0;
+    bulk_max_length = max_length;
+    bulk_commit_save = commit_save;
+    bulk_window = bulk_window_initial;
+    bulk_window_responses = 0;
+    mode = MODE_BULK;
+
+    bulk_send_next();
+
+    return true;
+}
+
+bool smp_group_settings_mgmt::bulk_send(uint16_t entry)
+{
+    const settings_bulk_entry_t *item = &bulk_entries->at(entry);
+    smp_message *tmp_message = processor->get_message(smp_mtu);
+    settings_bulk_outstanding_t outstanding;
+
+    if (item->action == SETTINGS_BULK_ACTION_DELETE)
+    {
+        tmp_message->start_message(SMP_OP_WRITE, smp_version, SMP_GROUP_ID_SETTINGS, COMMAND_DELETE);
+        tmp_message->append_key(smp_cbor_key_name);
+        tmp_message->append_string(item->name);
+    }
+    else if (item->action == SETTINGS_BULK_ACTION_WRITE)
+    {
+        tmp_message->start_message(SMP_OP_WRITE, smp_version, SMP_GROUP_ID_SETTINGS, COMMAND_READ_WRITE);
+        tmp_message->append_key(smp_cbor_key_name);
+        tmp_message->append_string(item->name);
+        tmp_message->append_key(smp_cbor_key_val);
+        tmp_message->append_byte_array(item->value.constData(), item->value.length());
+    }
+    else
+    {
+        tmp_message->start_message(SMP_OP_READ, smp_version, SMP_GROUP_ID_SETTINGS, COMMAND_READ_WRITE);
+        tmp_message->append_key(smp_cbor_key_name);
+        tmp_message->append_string(item->name);
+
+        if (bulk_max_length > 0)
+        {
+            tmp_message->append_key(smp_cbor_key_max_size);
+            tmp_message->append_unsigned(bulk_max_length);
+        }
+    }
+
+    tmp_message->end_message();
+
+    if (processor->send(tmp_message, smp_timeout, smp_retries, true) == false)
+    {
+        processor->release_message(tmp_message);
+        return false;
+    }
+
+    //The sequence number is assigned when the message is sent, responses are matched to keys using it
+    outstanding.sequence = tmp_message->get_header()->nh_seq;
+    outstanding.entry = entry;
+    bulk_outstanding.append(outstanding);
+
+    return true;
+}
+
+void smp_group_settings_mgmt::bulk_send_next()
+{
+    while (bulk_outstanding.length() < bulk_window && bulk_queue.isEmpty() == false)
+    {
+        if (bulk_send(bulk_queue.first()) == false)
+        {
+            if (bulk_outstanding.isEmpty())
+            {
+                bulk_cleanup();
+                mode = MODE_IDLE;
+                emit status(smp_user_data, STATUS_ERROR, "Unable to send bulk request");
+                return;
+            }
+
+            //Processor is full, remaining keys are sent as responses arrive
+            break;
+        }
+
+        bulk_queue.removeFirst();
+    }
+
+    if (bulk_outstanding.isEmpty() && bulk_queue.isEmpty())
+    {
+        //All keys processed
+        if (bulk_commit_save == true && bulk_changed > 0)
+        {
+            start_commit();
+            mode = MODE_BULK_COMMIT;
+        }
+        else
+        {
+            bulk_finish();
+        }
+    }
+}
+
+void smp_group_settings_mgmt::bulk_response(bool success, const smp_error_t *error)
+{
+    uint8_t sequence = processor->response_sequence();
+    settings_bulk_entry_t *item;
+    uint8_t i = 0;
+
+    while (i < bulk_outstanding.length())
+    {
+        if (bulk_outstanding.at(i).sequence == sequence)
+        {
+            break;
+        }
+
+        ++i;
+    }
+
+    if (i == bulk_outstanding.length())
+    {
+        log_error() << "Response to unknown bulk request, sequence " << sequence;
+        return;
+    }
+
+    item = &(*bulk_entries)[bulk_outstanding.takeAt(i).entry];
+
+    if (success == true)
+    {
+        item->result = SETTINGS_BULK_RESULT_OK;
+
+        if (item->action == SETTINGS_BULK_ACTION_READ)
+        {
+            item->value.clear();
+            processor->response_index()->get_byte_array(SMP_CBOR_KEY_VAL, &item->value);
+        }
+        else
+        {
+            ++bulk_changed;
+        }
+
+        //Grow the window after a full window of responses has been received without retries
+        ++bulk_window_responses;
+
+        if (bulk_window_responses >= bulk_window && bulk_window < bulk_window_max)
+        {
+            ++bulk_window;
+            bulk_window_responses = 0;
+        }
+    }
+    else
+    {
+        smp_error_t key_error = *error;
+
+        if ((key_error.type == SMP_ERROR_RET && key_error.group == SMP_GROUP_ID_SETTINGS && key_error.rc == settings_mgmt_error_key_not_found) || (key_error.type == SMP_ERROR_RC && key_error.rc == SMP_RC_ERROR_ENOENT))
+        {
+            item->result = SETTINGS_BULK_RESULT_NOT_FOUND;
+        }
+        else
+        {
+            item->result = SETTINGS_BULK_RESULT_ERROR;
+        }
+
+        item->error = smp_error::error_lookup_string(&key_error);
+
+        //An error response aborts all other outstanding messages in the processor, send those keys again
+        i = bulk_outstanding.length();
+
+        while (i > 0)
+        {
+            --i;
+            bulk_queue.prepend(bulk_outstanding.at(i).entry);
+        }
+
+        bulk_outstanding.clear();
+    }
+
+    ++bulk_completed;
+    emit progress(smp_user_data, (bulk_completed * 100) / bulk_entries->length());
+
+    bulk_send_next();
+}
+
+void smp_group_settings_mgmt::bulk_finish()
+{
+    uint16_t failed = 0;
+    uint16_t not_found = 0;
+    uint16_t i = 0;
+
+    while (i < bulk_entries->length())
+    {
+        if (bulk_entries->at(i).result == SETTINGS_BULK_RESULT_ERROR)
+        {
+            ++failed;
+        }
+        else if (bulk_entries->at(i).result == SETTINGS_BULK_RESULT_NOT_FOUND)
+        {
+            ++not_found;
+        }
+
+        ++i;
+    }
+
+    bulk_cleanup();
+    mode = MODE_IDLE;
+
+    emit status(smp_user_data, STATUS_COMPLETE, QString("%1 keys processed, %2 not found, %3 failed").arg(QString::number(bulk_completed), QString::number(not_found), QString::number(failed)));
+}
+
+void smp_group_settings_mgmt::bulk_cleanup()
+{
+    bulk_queue.clear();
+    bulk_outstanding.clear();
+}
+
+void smp_group_settings_mgmt::retry(smp_message *message)
+{
+    Q_UNUSED(message);
+
+    if (mode == MODE_BULK && bulk_window > 1)
+    {
+        //Link is losing messages, reduce the number of outstanding requests
+        bulk_window /= 2;
+        bulk_window_responses = 0;
+        log_debug() << "Bulk window reduced to " << bulk_window;
+    }
+}
+
 QString smp_group_settings_mgmt::mode_to_string(uint8_t mode)
 {
     switch (mode)
@@ -432,6 +729,12 @@ QString smp_group_settings_mgmt::mode_to_string(uint8_t mode)
         return "Loading";
     case MODE_SAVE:
         return "Saving";
+    case MODE_BULK:
+        return "Bulk";
+    case MODE_BULK_COMMIT:
+        return "Bulk committing";
+    case MODE_BULK_SAVE:
+        return "Bulk saving";
     default:
         return "Invalid";
     }
@@ -31,6 +31,32 @@
 #include <QCborMap>
 #include <QCborValue>
 
+enum settings_bulk_action : uint8_t {
+    SETTINGS_BULK_ACTION_READ = 0,
+    SETTINGS_BULK_ACTION_WRITE,
+    SETTINGS_BULK_ACTION_DELETE,
+};
+
+enum settings_bulk_result : uint8_t {
+    SETTINGS_BULK_RESULT_PENDING = 0,
+    SETTINGS_BULK_RESULT_OK,
+    SETTINGS_BULK_RESULT_NOT_FOUND,
+    SETTINGS_BULK_RESULT_ERROR,
+};
+
+struct settings_bulk_entry_t {
+    QString name;
+    QByteArray value;
+    settings_bulk_action action;
+    settings_bulk_result result;
+    QString error;
+};
+
+struct settings_bulk_outstanding_t {
+    uint8_t sequence;
+    uint16_t entry;
+};
+
 class smp_group_settings_mgmt : public smp_group
 {
     Q_OBJECT
@@ -47,11 +73,18 @@ public:
     bool start_commit(void);
     bool start_load(void);
     bool start_save(void);
+    bool start_bulk(QList<settings_bulk_entry_t> *entries, uint32_t max_length, bool commit_save);
+    void retry(smp_message *message);
     static bool error_lookup(int32_t rc, QString *error);
     static bool error_define_lookup(int32_t rc, QString *error);
 
 private:
     bool parse_read_response(QCborStreamReader &reader, QByteArray *value);
+    bool bulk_send(uint16_t entry);
+    void bulk_send_next();
+    void bulk_response(bool success, const smp_error_t *error);
+    void bulk_finish();
+    void bulk_cleanup();
 
     QString mode_to_string(uint8_t mode);
     QString command_to_string(uint8_t command);
@@ -59,6 +92,15 @@ private:
     //
     uint8_t mode;
     QByteArray *return_value;
+    QList<settings_bulk_entry_t> *bulk_entries;
+    QList<uint16_t> bulk_queue;
+    QList<settings_bulk_outstanding_t> bulk_outstanding;
+    uint16_t bulk_completed;
+    uint16_t bulk_changed;
+    uint32_t bulk_max_length;
+    bool bulk_commit_save;
+    uint8_t bulk_window;
+    uint8_t bulk_window_responses;
 };
 
 #endif // SMP_GROUP_SETTINGS_MGMT_H
@@ -70,10 +70,16 @@ void smp_message::append(const QByteArray *data)
 
 void smp_message::clear()
 {
-    this->buffer.clear();
+    //Keep the allocated buffer so that the message can be reused without reallocating
+    this->buffer.resize(0);
     this->header_added = false;
 }
 
+void smp_message::reserve(int size)
+{
+    this->buffer.reserve(size);
+}
+
 smp_hdr *smp_message::get_header(void)
 {
     if (this->buffer.size() < (int)sizeof(struct smp_hdr))
@@ -185,6 +191,17 @@ QByteArray smp_message::contents(void)
     return this->buffer.mid(sizeof(smp_hdr));
 }
 
+//Returns the payload without copying it, only valid whilst the message exists and is not modified
+QByteArray smp_message::contents_view(void)
+{
+    if (this->buffer.size() < (int)sizeof(smp_hdr))
+    {
+        return QByteArray();
+    }
+
+    return QByteArray::fromRawData((this->buffer.constData() + sizeof(smp_hdr)), (this->buffer.size() - sizeof(smp_hdr)));
+}
+
 smp_op_t smp_message::response_op(smp_op_t op)
 {
     return op == SMP_OP_READ ? SMP_OP_READ_RESPONSE : SMP_OP_WRITE_RESPONSE;
@@ -211,3 +228,57 @@ QCborStreamWriter *smp_message::writer()
 {
     return &cbor_writer;
 }
+
+//The following functions write pre-encoded CBOR directly to the buffer and can be mixed with the writer, which is moved to the end of the buffer after each one
+void smp_message::append_cbor_header(uint8_t major_type, uint64_t value)
+{
+    uint8_t size = smp_cbor_header_size(value);
+
+    if (size == 1)
+    {
+        this->buffer.append((char)(major_type | value));
+        return;
+    }
+
+    this->buffer.append((char)(major_type | (size == 2 ? 24 : (size == 3 ? 25 : (size == 5 ? 26 : 27)))));
+
+    //Integers are big endian
+    while (size > 1)
+    {
+        --size;
+        this->buffer.append((char)(value >> ((size - 1) * 8)));
+    }
+}
+
+void smp_message::sync_writer()
+{
+    cbor_writer.device()->seek(this->buffer.length());
+}
+
+void smp_message::append_unsigned(uint64_t value)
+{
+    append_cbor_header(SMP_CBOR_MAJOR_UNSIGNED, value);
+    sync_writer();
+}
+
+void smp_message::append_bool(bool value)
+{
+    this->buffer.append((char)(value == true ? SMP_CBOR_SIMPLE_TRUE : SMP_CBOR_SIMPLE_FALSE));
+    sync_writer();
+}
+
+void smp_message::append_byte_array(const char *data, uint32_t length)
+{
+    append_cbor_header(SMP_CBOR_MAJOR_BYTE_ARRAY, length);
+    this->buffer.append(data, length);
+    sync_writer();
+}
+
+void smp_message::append_string(const QString &value)
+{
+    QByteArray encoded = value.toUtf8();
+
+    append_cbor_header(SMP_CBOR_MAJOR_TEXT, encoded.length());
+    this->buffer.append(encoded);
+    sync_writer();
+}
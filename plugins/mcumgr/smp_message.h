@@ -54,6 +54,64 @@ struct smp_hdr {
 //Ensure header size is correct
 static_assert(sizeof(smp_hdr) == 8);
 
+//CBOR major types used by the pre-encoded message helpers
+const uint8_t SMP_CBOR_MAJOR_UNSIGNED = 0x00;
+const uint8_t SMP_CBOR_MAJOR_BYTE_ARRAY = 0x40;
+const uint8_t SMP_CBOR_MAJOR_TEXT = 0x60;
+const uint8_t SMP_CBOR_SIMPLE_FALSE = 0xf4;
+const uint8_t SMP_CBOR_SIMPLE_TRUE = 0xf5;
+const uint8_t SMP_CBOR_BREAK = 0xff;
+
+//Pre-encoded CBOR text string (header byte followed by the string), used for constant map keys
+template <size_t N>
+struct smp_cbor_key_t {
+    char data[N];
+};
+
+template <size_t N>
+constexpr smp_cbor_key_t<N> smp_cbor_encode_key(const char (&key)[N])
+{
+    static_assert((N - 1) < 24, "Key is too long to be encoded with a single byte header");
+
+    smp_cbor_key_t<N> encoded = {};
+    size_t i = 0;
+
+    encoded.data[0] = (char)(SMP_CBOR_MAJOR_TEXT | (N - 1));
+
+    while (i < (N - 1))
+    {
+        encoded.data[i + 1] = key[i];
+        ++i;
+    }
+
+    return encoded;
+}
+
+constexpr auto smp_cbor_key_off = smp_cbor_encode_key("off");
+constexpr auto smp_cbor_key_data = smp_cbor_encode_key("data");
+constexpr auto smp_cbor_key_len = smp_cbor_encode_key("len");
+constexpr auto smp_cbor_key_name = smp_cbor_encode_key("name");
+constexpr auto smp_cbor_key_sha = smp_cbor_encode_key("sha");
+constexpr auto smp_cbor_key_image = smp_cbor_encode_key("image");
+constexpr auto smp_cbor_key_upgrade = smp_cbor_encode_key("upgrade");
+constexpr auto smp_cbor_key_val = smp_cbor_encode_key("val");
+constexpr auto smp_cbor_key_max_size = smp_cbor_encode_key("max_size");
+
+//Size of the CBOR header needed to encode an integer value or the length of a string/byte array
+constexpr uint8_t smp_cbor_header_size(uint64_t value)
+{
+    return (value < 24 ? 1 : (value <= 0xff ? 2 : (value <= 0xffff ? 3 : (value <= 0xffffffff ? 5 : 9))));
+}
+
+//Largest byte array which, including its header, fits in the available number of bytes
+constexpr uint32_t smp_cbor_max_byte_array_size(uint32_t available)
+{
+    return (available <= 1 ? 0 : (available <= 24 ? (available - 1) : (available <= (0xff + 2) ? (available - 2) : (available <= (0xffff + 3) ? (available - 3) : (available - 5)))));
+}
+
+static_assert(smp_cbor_key_off.data[0] == 0x63 && smp_cbor_key_off.data[3] == 'f');
+static_assert(smp_cbor_max_byte_array_size(25) == 23 && smp_cbor_max_byte_array_size(26) == 24);
+
 class smp_message
 {
 public:
@@ -63,6 +121,7 @@ public:
     void append(const QByteArray data);
     void append(const QByteArray *data);
     void clear();
+    void reserve(int size);
     smp_hdr *get_header(void);
     int size(void);
     int data_size(void);
@@ -72,11 +131,27 @@ public:
     void set_header(const smp_op_t operation, const uint8_t version, const uint8_t flags, const uint16_t length, const uint16_t group, const uint8_t sequence, const uint8_t command);
     QByteArray *data(void);
     QByteArray contents(void);
+    QByteArray contents_view(void);
     static smp_op_t response_op(smp_op_t op);
     void end_message();
     QCborStreamWriter *writer();
 
+    template <size_t N>
+    void append_key(const smp_cbor_key_t<N> &key)
+    {
+        this->buffer.append(key.data, N);
+        sync_writer();
+    }
+
+    void append_unsigned(uint64_t value);
+    void append_bool(bool value);
+    void append_byte_array(const char *data, uint32_t length);
+    void append_string(const QString &value);
+
 private:
+    void append_cbor_header(uint8_t major_type, uint64_t value);
+    void sync_writer();
+
     QByteArray buffer;
     bool header_added;
     QCborStreamWriter cbor_writer = QCborStreamWriter(&buffer);
@@ -29,10 +29,10 @@ smp_processor::smp_processor(QObject *parent)
     Q_UNUSED(parent);
 
     sequence = 0;
-    last_message = nullptr;
-    last_message_header = nullptr;
-    repeat_times = 0;
-    busy = false;
+    index_sequence = 0;
+    transport = nullptr;
+    reconnect = nullptr;
+    paused = false;
 
     connect(&repeat_timer, SIGNAL(timeout()), this, SLOT(message_timeout()));
     repeat_timer.setSingleShot(true);
@@ -44,12 +44,9 @@ smp_processor::~smp_processor()
     disconnect(this, SLOT(message_timeout()));
     group_handlers.clear();
 
-    //Ensure object is deleted if it was part-way through creation
-    if (last_message != nullptr)
+    while (message_pool.length() > 0)
     {
-        delete last_message;
-        last_message = nullptr;
-        last_message_header = nullptr;
+        delete message_pool.takeFirst();
     }
 }
 
@@ -62,32 +59,46 @@ void smp_processor::set_logger(debug_logger *object)
 
 bool smp_processor::send(smp_message *message, uint32_t timeout_ms, uint8_t repeats, bool allow_version_check)
 {
-    if (busy)
+    smp_pending_message_t pending;
+
+    if (pending_list.length() >= SMP_MAX_PENDING_MESSAGES)
     {
         return false;
     }
 
-    last_message = message;
-    last_message_header = message->get_header();
+    pending.message = message;
+    pending.header = message->get_header();
 
     //Set message sequence
-    last_message_header->nh_seq = sequence;
-    last_message_version_check = allow_version_check;
-    last_message_version = last_message_header->nh_version;
-    repeat_timer.setInterval(timeout_ms);
-    repeat_times = repeats;
-    busy = true;
-
-    transport->send(last_message);
-    repeat_timer.start();
+    pending.header->nh_seq = sequence;
+    pending.version_check = allow_version_check;
+    pending.version = pending.header->nh_version;
+    pending.repeat_times = repeats;
+    pending.timeout_ms = timeout_ms;
+    pending.sent_timer.start();
+    pending_list.append(pending);
     ++sequence;
 
+    if (paused == true)
+    {
+        //Link is down, the message will be sent once it has been re-established
+        return true;
+    }
+
+    transport->send(message);
+    update_timer();
+
     return true;
 }
 
 bool smp_processor::is_busy()
 {
-    return busy;
+    return (pending_list.length() > 0);
+}
+
+uint8_t smp_processor::pending_messages()
+{
+    return pending_list.length();
 }
 
 void smp_processor::register_handler(uint16_t group, smp_group *handler)
@@ -110,103 +121,199 @@ void smp_processor::unregister_handler(uint16_t group)
     }
 }
 
-void smp_processor::cleanup()
+smp_group *smp_processor::find_handler(uint16_t group)
 {
-    if (!busy)
+    uint8_t i = 0;
+
+    while (i < group_handlers.length())
     {
-        return;
+        if (group_handlers[i].group == group)
+        {
+            return group_handlers[i].handler;
+        }
+
+        ++i;
     }
 
+    return nullptr;
+}
+
+void smp_processor::cleanup()
+{
     repeat_timer.stop();
 
-    if (last_message != nullptr)
+    while (pending_list.length() > 0)
     {
-        delete last_message;
-        last_message = nullptr;
-        last_message_header = nullptr;
+        release_message(pending_list.takeFirst().message);
     }
+}
+
+smp_message *smp_processor::get_message(uint16_t size)
+{
+    smp_message *message;
+
+    if (message_pool.length() > 0)
+    {
+        message = message_pool.takeLast();
+    }
+    else
+    {
+        message = new smp_message();
+    }
+
+    //Reserve space for the header and the full payload so the buffer does not need to grow whilst the message is encoded
+    message->reserve(sizeof(smp_hdr) + size);
 
-    repeat_times = 0;
-    busy = false;
+    return message;
 }
 
-void smp_processor::message_timeout()
+void smp_processor::release_message(smp_message *message)
 {
-    if (!busy)
+    if (message_pool.length() >= SMP_MESSAGE_POOL_SIZE)
     {
-        //No longer busy
+        delete message;
         return;
     }
 
-    if (repeat_times == 0)
+    message->clear();
+    message_pool.append(message);
+}
+
+void smp_processor::update_timer()
+{
+    //Run the timer until the next outstanding message times out
+    int64_t next_timeout = -1;
+    uint8_t i = 0;
+
+    if (paused == true)
     {
-        uint16_t group = last_message_header->nh_group;
-        uint8_t i = 0;
+        //Outstanding messages do not time out whilst the link is down
+        repeat_timer.stop();
+        return;
+    }
 
-#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
-        group = ((group & 0xff) << 8) | ((group & 0xff00) >> 8);
-#endif
+    while (i < pending_list.length())
+    {
+        int64_t remaining = (int64_t)pending_list[i].timeout_ms - pending_list[i].sent_timer.elapsed();
 
-        //Search for the handler for this group
-        while (i < group_handlers.length())
+        if (remaining < 0)
         {
-            if (group_handlers[i].group == group)
-            {
-                break;
-            }
-
-            ++i;
+            remaining = 0;
         }
 
-        if (i == group_handlers.length())
+        if (next_timeout == -1 || remaining < next_timeout)
         {
-            //There is no registered handler for this group
-            log_error() << "No registered handler for group " << group << ", cannot send timeout message.";
-            cleanup();
+            next_timeout = remaining;
         }
-        else
-        {
-            //Keep message pointer valid but cleanup so callback can send a message
-            smp_message *backup_message = last_message;
-            last_message = nullptr;
-            last_message_header = nullptr;
 
-            cleanup();
-            group_handlers[i].handler->timeout(backup_message);
+        ++i;
+    }
 
-            //Delete backup pointer
-            delete backup_message;
-        }
+    if (next_timeout == -1)
+    {
+        repeat_timer.stop();
+    }
+    else
+    {
+        repeat_timer.start(next_timeout);
+    }
+}
 
-        return;
+//Removes an outstanding message and notifies the handler that it timed out, a failed message aborts any other outstanding messages
+void smp_processor::fail_message(uint8_t index)
+{
+    uint16_t group = pending_list[index].header->nh_group;
+    smp_group *handler;
+
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+    group = ((group & 0xff) << 8) | ((group & 0xff00) >> 8);
+#endif
+
+    //Search for the handler for this group
+    handler = find_handler(group);
+
+    //Keep message pointer valid but cleanup so callback can send a message
+    smp_message *backup_message = pending_list.takeAt(index).message;
+    cleanup();
+
+    if (handler == nullptr)
+    {
+        //There is no registered handler for this group
+        log_error() << "No registered handler for group " << group << ", cannot send timeout message.";
+    }
+    else
+    {
+        handler->timeout(backup_message);
     }
 
-    //If this is a version 2 message, try sending a version 1 packet to see if version 2 is unsupported by the server
-    if (last_message_version_check == true && last_message_version == 1)
+    //Release backup pointer
+    release_message(backup_message);
+}
+
+void smp_processor::message_timeout()
+{
+    uint8_t i = 0;
+
+    while (i < pending_list.length())
     {
-        if (last_message_header->nh_version == last_message_version)
+        if (pending_list[i].sent_timer.elapsed() < pending_list[i].timeout_ms)
         {
-            last_message_header->nh_version = 0;
+            ++i;
+            continue;
         }
-        else
+
+        if (pending_list[i].repeat_times == 0)
+        {
+            fail_message(i);
+            return;
+        }
+
+        //If this is a version 2 message, try sending a version 1 packet to see if version 2 is unsupported by the server
+        if (pending_list[i].version_check == true && pending_list[i].version == 1)
         {
-            last_message_header->nh_version = 1;
+            if (pending_list[i].header->nh_version == pending_list[i].version)
+            {
+                pending_list[i].header->nh_version = 0;
+            }
+            else
+            {
+                pending_list[i].header->nh_version = 1;
+            }
         }
+
+        //Resend message
+        --pending_list[i].repeat_times;
+        pending_list[i].sent_timer.restart();
+        transport->send(pending_list[i].message);
+
+        //Notify the handler so that it can adapt to the link (e.g. reduce the number of outstanding messages)
+        uint16_t group = pending_list[i].header->nh_group;
+
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+        group = ((group & 0xff) << 8) | ((group & 0xff00) >> 8);
+#endif
+
+        smp_group *handler = find_handler(group);
+
+        if (handler != nullptr)
+        {
+            handler->retry(pending_list[i].message);
+        }
+
+        ++i;
     }
 
-    //Resend message
-    --repeat_times;
-    repeat_timer.start();
-    transport->send(last_message);
+    update_timer();
 }
 
 void smp_processor::message_received(smp_message *response)
 {
     const smp_hdr *response_header = nullptr;
+    uint8_t i = 0;
 
     log_debug() << "got message";
 
-    if (!busy)
+    if (pending_list.length() == 0)
     {
         //Not busy so this message probably isn't wanted anymore
         log_error() << "Received message when not awaiting for a repsonse";
@@ -220,22 +327,35 @@ void smp_processor::message_received(smp_message *response)
     {
         //Cannot do anything without a header
         log_error() << "Invalid response header";
+        return;
+    }
+
+    //Find the outstanding message this is a response to
+    while (i < pending_list.length())
+    {
+        if (pending_list[i].header->nh_seq == response_header->nh_seq)
+        {
+            break;
+        }
+
+        ++i;
     }
-    else if (response_header->nh_group != last_message_header->nh_group)
+
+    if (i == pending_list.length())
     {
-        log_error() << "Invalid group, expected " << last_message_header->nh_group << " got " << response_header->nh_group;
+        log_error() << "Invalid sequence, got " << response_header->nh_seq << " which is not awaiting a response";
     }
-    else if (response_header->nh_id != last_message_header->nh_id)
+    else if (response_header->nh_group != pending_list[i].header->nh_group)
     {
-        log_error() << "Invalid command, expected " << last_message_header->nh_id << " got " << response_header->nh_id;
+        log_error() << "Invalid group, expected " << pending_list[i].header->nh_group << " got " << response_header->nh_group;
     }
-    else if (response_header->nh_seq != last_message_header->nh_seq)
+    else if (response_header->nh_id != pending_list[i].header->nh_id)
     {
-        log_error() << "Invalid sequence, expected " << last_message_header->nh_seq << " got " << response_header->nh_seq;
+        log_error() << "Invalid command, expected " << pending_list[i].header->nh_id << " got " << response_header->nh_id;
     }
-    else if (response_header->nh_op != smp_message::response_op(last_message_header->nh_op))
+    else if (response_header->nh_op != smp_message::response_op(pending_list[i].header->nh_op))
     {
-        log_error() << "Invalid op, expected " << smp_message::response_op(last_message_header->nh_op) << " got " << response_header->nh_op;
+        log_error() << "Invalid op, expected " << smp_message::response_op(pending_list[i].header->nh_op) << " got " << response_header->nh_op;
     }
     else
     {
@@ -244,24 +364,16 @@ void smp_processor::message_received(smp_message *response)
         uint8_t op = response_header->nh_op;
         uint16_t group = response_header->nh_group;
         uint8_t command = response_header->nh_id;
-        uint8_t i = 0;
+        smp_group *handler;
 
 #if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
         group = ((group & 0xff) << 8) | ((group & 0xff00) >> 8);
 #endif
 
         //Search for the handler for this group
-        while (i < group_handlers.length())
-        {
-            if (group_handlers[i].group == group)
-            {
-                break;
-            }
+        handler = find_handler(group);
 
-            ++i;
-        }
-
-        if (i == group_handlers.length())
+        if (handler == nullptr)
         {
             //There is no registered handler for this group, clean up
             log_error() << "No registered handler for group " << group << ", dropping response.";
@@ -269,136 +381,124 @@ void smp_processor::message_received(smp_message *response)
             return;
         }
 
-        QCborStreamReader cbor_reader(response->contents());
-        smp_error_t error;
-        error.type = SMP_ERROR_NONE;
-        bool parsed = decode_message(cbor_reader, version, 0, nullptr, &error);
+        //Decode the response once, the index is shared with the group handler for the duration of the callback
+        QByteArray payload = response->contents_view();
+        index_sequence = response_header->nh_seq;
+        bool parsed = index.parse(payload, version);
+        smp_error_t error = index.error();
 
         if (!parsed)
         {
             log_error() << "parse failed";
+            index.clear();
             return;
         }
 
-        //Clean up before triggering callback
-        this->cleanup();
-
         if (error.type != SMP_ERROR_NONE)
         {
+            //Clean up before triggering callback, an error aborts any other outstanding messages
+            this->cleanup();
+
             //Received either "rc" (legacy/SMP version 1) error or "err" error (SMP version 2)
-            group_handlers[i].handler->receive_error(version, op, group, command, error);
+            index.clear();
+            handler->receive_error(version, op, group, command, error);
         }
         else
         {
+            //Clean up before triggering callback
+            release_message(pending_list.takeAt(i).message);
+            update_timer();
+
             //No error, good response
-            group_handlers[i].handler->receive_ok(version, op, group, command, response->contents());
+            handler->receive_ok(version, op, group, command, payload);
+            index.clear();
         }
     }
 }
 
-bool smp_processor::decode_message(QCborStreamReader &reader, uint8_t version, uint16_t level, QString *parent, smp_error_t *error)
+void smp_processor::set_transport(smp_transport *transport_object)
 {
-    QString key = "";
-    bool keyset = true;
+    if (reconnect != nullptr)
+    {
+        //Route messages through the reconnect wrapper so that a lost link can be recovered
+        reconnect->set_transport(transport_object);
+        transport = reconnect;
+        return;
+    }
+
+    transport = transport_object;
+}
 
-    while (!reader.lastError() && reader.hasNext())
+void smp_processor::set_reconnect(smp_reconnect *reconnect_object)
+{
+    if (reconnect != nullptr)
     {
-        if (keyset == false && !key.isEmpty())
-        {
-            key = "";
-        }
+        disconnect(reconnect, SIGNAL(link_lost()), this, SLOT(link_lost()));
+        disconnect(reconnect, SIGNAL(link_restored()), this, SLOT(link_restored()));
+        disconnect(reconnect, SIGNAL(link_failed()), this, SLOT(link_failed()));
+    }
 
-        keyset = false;
+    reconnect = reconnect_object;
 
-        switch (reader.type())
-        {
-            case QCborStreamReader::UnsignedInteger:
-            case QCborStreamReader::NegativeInteger:
-            {
-                if (key == "rc" && version == 1 && level == 2 && parent != nullptr && *parent == "err")
-                {
-                    error->rc = reader.toUnsignedInteger();
-                    error->type = SMP_ERROR_RET;
-                }
-                else if (key == "group" && version == 1 && level == 2 && parent != nullptr && *parent == "err")
-                {
-                    error->group = reader.toUnsignedInteger();
-                    error->type = SMP_ERROR_RET;
-                }
-                else if (key == "rc" && level == 1)
-                {
-                    error->rc = reader.toInteger();
-                    error->type = SMP_ERROR_RC;
-                }
-
-                reader.next();
-                break;
-            }
-            case QCborStreamReader::String:
-            {
-                QString data;
-                auto r = reader.readString();
-                while (r.status == QCborStreamReader::Ok)
-                {
-                    data.append(r.data);
-                    r = reader.readString();
-                }
-
-                if (r.status == QCborStreamReader::Error)
-                {
-                    data.clear();
-                    log_error() << "Error decoding string";
-                }
-                else
-                {
-                    if (key.isEmpty())
-                    {
-                        key = data;
-                        keyset = true;
-                    }
-                }
-                break;
-            }
-            case QCborStreamReader::Array:
-            case QCborStreamReader::Map:
-            {
-                reader.enterContainer();
-                while (reader.lastError() == QCborError::NoError && reader.hasNext())
-                {
-                    decode_message(reader, version, (level + 1), &key, error);
-                }
-                if (reader.lastError() == QCborError::NoError)
-                {
-                    reader.leaveContainer();
-                }
-                break;
-            }
-            default:
-            {
-                reader.next();
-                break;
-            }
-        }
+    if (reconnect != nullptr)
+    {
+        connect(reconnect, SIGNAL(link_lost()), this, SLOT(link_lost()));
+        connect(reconnect, SIGNAL(link_restored()), this, SLOT(link_restored()));
+        connect(reconnect, SIGNAL(link_failed()), this, SLOT(link_failed()));
     }
+}
+
+bool smp_processor::is_paused()
+{
+    return paused;
+}
+
+//The link to the device has gone down, outstanding messages are held without timing out until it is back
+void smp_processor::link_lost()
+{
+    paused = true;
+    repeat_timer.stop();
+}
 
-    if (reader.lastError())
+//The link to the device is back, replay every outstanding message unchanged so that the sequence numbers match any
+//responses which the device may already have sent, the timeouts restart from now
+void smp_processor::link_restored()
+{
+    uint8_t i = 0;
+
+    paused = false;
+
+    while (i < pending_list.length())
     {
-        log_error() << "Failed to parse CBOR message: " << reader.lastError().toString();
-        return false;
+        pending_list[i].sent_timer.restart();
+        transport->send(pending_list[i].message);
+        ++i;
     }
 
-    //Check if an error was received with value 0, which is not an error and is a success code
-    if (level == 0 && error->type != SMP_ERROR_NONE && error->rc == 0)
+    update_timer();
+}
+
+//The link could not be re-established, fail the outstanding messages so that the operation finishes
+void smp_processor::link_failed()
+{
+    paused = false;
+
+    if (pending_list.length() > 0)
     {
-        error->type = SMP_ERROR_NONE;
+        fail_message(0);
     }
+}
 
-    return true;
+//Index of the response currently being processed, only valid from within a receive_ok() callback
+const smp_cbor_index *smp_processor::response_index()
+{
+    return &index;
 }
 
-void smp_processor::set_transport(smp_transport *transport_object)
+//Sequence number of the response currently being processed, only valid from within a receive_ok() or receive_error() callback
+uint8_t smp_processor::response_sequence()
 {
-    transport = transport_object;
+    return index_sequence;
 }
 
 uint16_t smp_processor::max_message_data_size(uint16_t mtu)
@@ -25,7 +25,9 @@
 
 #include <QObject>
 #include "smp_message.h"
+#include "smp_cbor_index.h"
 #include "smp_uart.h"
+#include "smp_reconnect.h"
 #include "debug_logger.h"
 
 #include <QTimer>
@@ -40,6 +42,22 @@ struct smp_group_match_t {
     smp_group *handler;
 };
 
+//Maximum number of messages which can be awaiting a response at the same time
+#define SMP_MAX_PENDING_MESSAGES 8
+
+//Maximum number of unused messages kept for reuse
+#define SMP_MESSAGE_POOL_SIZE (SMP_MAX_PENDING_MESSAGES + 2)
+
+struct smp_pending_message_t {
+    smp_message *message;
+    smp_hdr *header;
+    bool version_check;
+    uint8_t version;
+    uint8_t repeat_times;
+    uint32_t timeout_ms;
+    QElapsedTimer sent_timer;
+};
+
 class smp_processor : public QObject
 {
     Q_OBJECT
@@ -52,30 +70,42 @@ public:
 #endif
     bool send(smp_message *message, uint32_t timeout_ms, uint8_t repeats, bool allow_version_check);
     bool is_busy();
+    uint8_t pending_messages();
     void register_handler(uint16_t group, smp_group *handler);
     void unregister_handler(uint16_t group);
     void set_transport(smp_transport *transport_object);
+    void set_reconnect(smp_reconnect *reconnect_object);
+    bool is_paused();
     uint16_t max_message_data_size(uint16_t mtu);
+    void cleanup();
+    smp_message *get_message(uint16_t size);
+    void release_message(smp_message *message);
+    const smp_cbor_index *response_index();
+    uint8_t response_sequence();
 
 private:
-    void cleanup();
-    bool decode_message(QCborStreamReader &reader, uint8_t version, uint16_t level, QString *parent, smp_error_t *error);
+    void update_timer();
+    smp_group *find_handler(uint16_t group);
+    void fail_message(uint8_t index);
 
 public slots:
     void message_timeout();
     void message_received(smp_message *message);
+    void link_lost();
+    void link_restored();
+    void link_failed();
 
 private:
     uint8_t sequence;
     smp_transport *transport;
-    smp_message *last_message;
-    smp_hdr *last_message_header;
-    bool last_message_version_check;
-    uint8_t last_message_version;
+    smp_reconnect *reconnect;
+    bool paused;
+    QList<smp_pending_message_t> pending_list;
     QTimer repeat_timer;
-    uint8_t repeat_times;
-    bool busy;
     QList<smp_group_match_t> group_handlers;
+    QList<smp_message *> message_pool;
+    smp_cbor_index index;
+    uint8_t index_sequence;
 
 #ifndef SKIPPLUGIN_LOGGER
     debug_logger *logger;
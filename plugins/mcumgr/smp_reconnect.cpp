@@ -0,0 +1,264 @@
+/******************************************************************************
+** Copyright (C) 2023 Jamie M.
+**
+** Project: AuTerm
+**
+** Module:  smp_reconnect.cpp
+**
+** Notes:
+**
+** License: This program is free software: you can redistribute it and/or
+**          modify it under the terms of the GNU General Public License as
+**          published by the Free Software Foundation, version 3.
+**
+**          This program is distributed in the hope that it will be useful,
+**          but WITHOUT ANY WARRANTY; without even the implied warranty of
+**          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**          GNU General Public License for more details.
+**
+**          You should have received a copy of the GNU General Public License
+**          along with this program.  If not, see http://www.gnu.org/licenses/
+**
+*******************************************************************************/
+#include "smp_reconnect.h"
+
+smp_reconnect::smp_reconnect(QObject *parent)
+{
+    Q_UNUSED(parent);
+
+    transport = nullptr;
+    backoff_ms = reconnect_backoff_initial_ms;
+    reconnect_timeout_ms = reconnect_timeout_default_ms;
+    reconnect_enabled = false;
+    reconnecting = false;
+
+    retry_timer.setSingleShot(true);
+    QObject::connect(&retry_timer, SIGNAL(timeout()), this, SLOT(retry_timer_timeout()));
+}
+
+smp_reconnect::~smp_reconnect()
+{
+    retry_timer.stop();
+    QObject::disconnect(this, SLOT(retry_timer_timeout()));
+}
+
+void smp_reconnect::set_transport(smp_transport *transport_object)
+{
+    if (transport_object == transport)
+    {
+        return;
+    }
+
+    if (transport != nullptr)
+    {
+        QObject::disconnect(transport, SIGNAL(transport_disconnected()), this, SLOT(transport_lost()));
+        QObject::disconnect(transport, SIGNAL(transport_connected()), this, SLOT(transport_restored()));
+    }
+
+    //Messages held for the previous transport cannot be replayed on a different one
+    if (reconnecting == true)
+    {
+        give_up();
+    }
+
+    transport = transport_object;
+
+    if (transport != nullptr)
+    {
+        QObject::connect(transport, SIGNAL(transport_disconnected()), this, SLOT(transport_lost()));
+        QObject::connect(transport, SIGNAL(transport_connected()), this, SLOT(transport_restored()));
+    }
+}
+
+smp_transport *smp_reconnect::get_transport()
+{
+    return transport;
+}
+
+void smp_reconnect::set_enabled(bool enabled)
+{
+    reconnect_enabled = enabled;
+
+    if (enabled == false && reconnecting == true)
+    {
+        give_up();
+    }
+}
+
+void smp_reconnect::set_timeout(uint32_t timeout_ms)
+{
+    reconnect_timeout_ms = timeout_ms;
+}
+
+bool smp_reconnect::is_reconnecting()
+{
+    return reconnecting;
+}
+
+//Stops trying to reconnect, used when the user aborts the operation which is waiting for the link
+void smp_reconnect::cancel()
+{
+    if (reconnecting == true)
+    {
+        give_up();
+    }
+}
+
+int smp_reconnect::connect(void)
+{
+    if (transport == nullptr)
+    {
+        return SMP_TRANSPORT_ERROR_NOT_CONNECTED;
+    }
+
+    return transport->connect();
+}
+
+int smp_reconnect::disconnect(bool force)
+{
+    if (transport == nullptr)
+    {
+        return SMP_TRANSPORT_ERROR_NOT_CONNECTED;
+    }
+
+    //A requested disconnect must not be undone
+    cancel();
+
+    return transport->disconnect(force);
+}
+
+int smp_reconnect::is_connected(void)
+{
+    if (transport == nullptr || reconnecting == true)
+    {
+        return 0;
+    }
+
+    return transport->is_connected();
+}
+
+int smp_reconnect::send(smp_message *message)
+{
+    if (transport == nullptr || reconnecting == true)
+    {
+        //The processor replays outstanding messages once the link is back
+        return SMP_TRANSPORT_ERROR_NOT_CONNECTED;
+    }
+
+    return transport->send(message);
+}
+
+void smp_reconnect::close_connect_dialog()
+{
+    if (transport != nullptr)
+    {
+        transport->close_connect_dialog();
+    }
+}
+
+uint16_t smp_reconnect::max_message_data_size(uint16_t mtu)
+{
+    if (transport == nullptr)
+    {
+        return mtu;
+    }
+
+    return transport->max_message_data_size(mtu);
+}
+
+uint16_t smp_reconnect::get_mtu(void)
+{
+    if (transport == nullptr)
+    {
+        return 0;
+    }
+
+    return transport->get_mtu();
+}
+
+int smp_reconnect::reconnect(void)
+{
+    if (transport == nullptr)
+    {
+        return SMP_TRANSPORT_ERROR_NOT_CONNECTED;
+    }
+
+    return transport->reconnect();
+}
+
+void smp_reconnect::transport_lost()
+{
+    if (reconnect_enabled == false || reconnecting == true)
+    {
+        return;
+    }
+
+    log_debug() << "Link lost, reconnecting";
+
+    reconnecting = true;
+
+    //A link which drops again straight after coming back is treated as the same outage so that the timeout still applies
+    if (restored_timer.isValid() == false || restored_timer.elapsed() >= reconnect_backoff_maximum_ms)
+    {
+        backoff_ms = reconnect_backoff_initial_ms;
+        outage_timer.start();
+    }
+
+    emit link_lost();
+
+    retry_timer.start(backoff_ms);
+}
+
+void smp_reconnect::transport_restored()
+{
+    if (reconnecting == false)
+    {
+        return;
+    }
+
+    log_debug() << "Link restored after " << outage_timer.elapsed() << "ms";
+
+    retry_timer.stop();
+    reconnecting = false;
+    restored_timer.start();
+    emit link_restored();
+}
+
+void smp_reconnect::retry_timer_timeout()
+{
+    if (reconnecting == false)
+    {
+        return;
+    }
+
+    if (outage_timer.elapsed() >= reconnect_timeout_ms)
+    {
+        log_error() << "Giving up reconnecting after " << outage_timer.elapsed() << "ms";
+        give_up();
+        return;
+    }
+
+    if (transport->reconnect() == SMP_TRANSPORT_ERROR_UNSUPPORTED)
+    {
+        give_up();
+        return;
+    }
+
+    //Wait for transport_connected(), if it does not arrive then try again after a longer delay
+    backoff_ms *= 2;
+
+    if (backoff_ms > reconnect_backoff_maximum_ms)
+    {
+        backoff_ms = reconnect_backoff_maximum_ms;
+    }
+
+    retry_timer.start(backoff_ms);
+}
+
+void smp_reconnect::give_up()
+{
+    retry_timer.stop();
+    restored_timer.invalidate();
+    reconnecting = false;
+    emit link_failed();
+}
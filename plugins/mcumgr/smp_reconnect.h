@@ -0,0 +1,84 @@
+/******************************************************************************
+** Copyright (C) 2023 Jamie M.
+**
+** Project: AuTerm
+**
+** Module:  smp_reconnect.h
+**
+** Notes:
+**
+** License: This program is free software: you can redistribute it and/or
+**          modify it under the terms of the GNU General Public License as
+**          published by the Free Software Foundation, version 3.
+**
+**          This program is distributed in the hope that it will be useful,
+**          but WITHOUT ANY WARRANTY; without even the implied warranty of
+**          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**          GNU General Public License for more details.
+**
+**          You should have received a copy of the GNU General Public License
+**          along with this program.  If not, see http://www.gnu.org/licenses/
+**
+*******************************************************************************/
+#ifndef SMP_RECONNECT_H
+#define SMP_RECONNECT_H
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+#include "smp_transport.h"
+
+//Delay before the first reconnection attempt, this doubles after each failed attempt up to the maximum
+const uint16_t reconnect_backoff_initial_ms = 50;
+const uint16_t reconnect_backoff_maximum_ms = 2000;
+const uint32_t reconnect_timeout_default_ms = 10000;
+
+//Wraps another transport and, when the link to the device is lost unexpectedly, tries to re-establish it with an increasing
+//delay between attempts. The processor is told when the link goes down and comes back so that outstanding messages can be
+//held and then replayed unchanged (with the same sequence numbers) instead of failing
+class smp_reconnect : public smp_transport
+{
+    Q_OBJECT
+
+public:
+    smp_reconnect(QObject *parent = nullptr);
+    ~smp_reconnect();
+    void set_transport(smp_transport *transport_object);
+    smp_transport *get_transport();
+    void set_enabled(bool enabled);
+    void set_timeout(uint32_t timeout_ms);
+    bool is_reconnecting();
+    void cancel();
+    int connect(void) override;
+    int disconnect(bool force) override;
+    int is_connected(void) override;
+    int send(smp_message *message) override;
+    void close_connect_dialog() override;
+    uint16_t max_message_data_size(uint16_t mtu) override;
+    uint16_t get_mtu(void) override;
+    int reconnect(void) override;
+
+signals:
+    void link_lost();
+    void link_restored();
+    void link_failed();
+
+private slots:
+    void transport_lost();
+    void transport_restored();
+    void retry_timer_timeout();
+
+private:
+    void give_up();
+
+    smp_transport *transport;
+    QTimer retry_timer;
+    QElapsedTimer outage_timer;
+    QElapsedTimer restored_timer;
+    uint32_t backoff_ms;
+    uint32_t reconnect_timeout_ms;
+    bool reconnect_enabled;
+    bool reconnecting;
+};
+
+#endif // SMP_RECONNECT_H
@@ -72,13 +72,27 @@ public:
     {
     }
 
+    //Re-establishes a link which has been lost to the last device, completion is signalled with transport_connected()
+    virtual int reconnect(void)
+    {
+        return SMP_TRANSPORT_ERROR_UNSUPPORTED;
+    }
+
     virtual uint16_t max_message_data_size(uint16_t mtu)
     {
         return mtu;
     }
 
+    //MTU of the underlying link if it is known, 0 if the transport does not know it
+    virtual uint16_t get_mtu(void)
+    {
+        return 0;
+    }
+
 signals:
 //    void connected();
+    void transport_connected();
+    void transport_disconnected();
 //    void disconnected();
 //    void error(int error_code);
 //    void send_complete();
@@ -21,7 +21,7 @@
 **
 *******************************************************************************/
 #include "smp_uart.h"
-#include "crc16.h"
+#include "AutCrc.h"
 #include <math.h>
 
 smp_uart::smp_uart(QObject *parent)
@@ -82,7 +82,7 @@ void smp_uart::serial_read(QByteArray *rec_data)
                 if (SMPBuffer.length() >= (waiting_packet_length))
                 {
                     //We have a full packet, check the checksum
-                    uint16_t crc = crc16(&SMPBuffer, 0, SMPBuffer.length() - 2, 0x1021, 0, true);
+                    uint16_t crc = AutCrc::crc16((const quint8 *)SMPBuffer.constData(), SMPBuffer.length() - 2);
                     uint16_t message_crc = ((uint16_t)SMPBuffer[(SMPBuffer.length() - 2)]) << 8;
                     message_crc |= SMPBuffer[(SMPBuffer.length() - 1)] & 0xff;
 
@@ -135,7 +135,7 @@ void smp_uart::serial_read(QByteArray *rec_data)
                 if (SMPBufferActualData.length() >= (waiting_packet_length /*+ 2*/))
                 {
                     //We have a full packet, check the checksum
-                    uint16_t crc = crc16(&SMPBufferActualData, 0, SMPBufferActualData.length() - 2, 0x1021, 0, true);
+                    uint16_t crc = AutCrc::crc16((const quint8 *)SMPBufferActualData.constData(), SMPBufferActualData.length() - 2);
                     uint16_t message_crc = ((uint16_t)SMPBufferActualData[(SMPBufferActualData.length() - 2)]) << 8;
                     message_crc |= SMPBufferActualData[(SMPBufferActualData.length() - 1)] & 0xff;
 
@@ -200,7 +200,7 @@ int smp_uart::send(smp_message *message)
     size += 2;
     output.append((uint8_t)((size & 0xff00) >> 8));
     output.append((uint8_t)(size & 0xff));
-    uint16_t crc = crc16(message->data(), 0, message->size(), 0x1021, 0, true);
+    uint16_t crc = AutCrc::crc16((const quint8 *)message->data()->constData(), message->size());
 
     QByteArray inbase;
     inbase.append(smp_first_header);
@@ -270,3 +270,31 @@ uint16_t smp_uart::max_message_data_size(uint16_t mtu)
 
     return (uint16_t)available_mtu;
 }
+
+//The serial port is owned by the main window, so ask for it to be opened again
+int smp_uart::reconnect(void)
+{
+    bool opened = false;
+
+    emit serial_reopen(&opened);
+
+    return (opened == true ? SMP_TRANSPORT_ERROR_OK : SMP_TRANSPORT_ERROR_NOT_CONNECTED);
+}
+
+void smp_uart::port_opened()
+{
+    emit transport_connected();
+}
+
+//Called when the serial port has been closed due to an error (e.g. the device re-enumerating) rather than by the user
+void smp_uart::port_lost()
+{
+    //Discard partially received data, outstanding requests are replayed once the port has been reopened
+    SerialData.clear();
+    SMPBuffer.clear();
+    SMPBufferActualData.clear();
+    SMPWaitingForContinuation = false;
+    waiting_packet_length = 0;
+
+    emit transport_disconnected();
+}
@@ -37,12 +37,16 @@ public:
     ~smp_uart();
     int send(smp_message *message);
     uint16_t max_message_data_size(uint16_t mtu);
+    int reconnect(void) override;
+    void port_opened();
+    void port_lost();
 
 private:
     void data_received(QByteArray *message);
 
 signals:
     void serial_write(QByteArray *data);
+    void serial_reopen(bool *opened);
 
 public slots:
     void serial_read(QByteArray *rec_data);
@@ -37,12 +37,17 @@ smp_udp::smp_udp(QObject *parent)
 
     socket = new QUdpSocket(this);
     socket_is_connected = false;
+    device_port = 0;
 
     QObject::connect(socket, SIGNAL(readyRead()), this, SLOT(socket_readyread()));
 //    QObject::connect(socket, SIGNAL(connected()), this, SLOT(socket_connected()));
 //    QObject::connect(socket, SIGNAL(disconnected()), this, SLOT(socket_disconnected()));
 //    QObject::connect(socket, SIGNAL(stateChanged(QAbstractSocket::SocketState)), this, SLOT(socket_statechanged(QAbstractSocket::SocketState)));
-//    QObject::connect(socket, SIGNAL(error(QAbstractSocket::SocketError)), this, SLOT(socket_error(QAbstractSocket::SocketError)));
+#if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)
+    QObject::connect(socket, SIGNAL(errorOccurred(QAbstractSocket::SocketError)), this, SLOT(socket_error(QAbstractSocket::SocketError)));
+#else
+    QObject::connect(socket, SIGNAL(error(QAbstractSocket::SocketError)), this, SLOT(socket_error(QAbstractSocket::SocketError)));
+#endif
 //    QObject::connect(socket, SIGNAL(readChannelFinished()), this, SLOT(socket_readchannelfinished()));
 
     QObject::connect(udp_window, SIGNAL(connect_to_device(QString,uint16_t)), this, SLOT(connect_to_device(QString,uint16_t)));
@@ -56,7 +61,7 @@ smp_udp::~smp_udp()
 //    QObject::disconnect(this, SLOT(socket_connected()));
 //    QObject::disconnect(this, SLOT(socket_disconnected()));
 //    QObject::disconnect(this, SLOT(socket_statechanged(QAbstractSocket::SocketState)));
-//    QObject::disconnect(this, SLOT(socket_error(QAbstractSocket::SocketError)));
+    QObject::disconnect(this, SLOT(socket_error(QAbstractSocket::SocketError)));
 //    QObject::disconnect(this, SLOT(socket_readchannelfinished()));
 
     QObject::disconnect(this, SLOT(connect_to_device(QString,uint16_t)));
@@ -229,11 +234,6 @@ void smp_udp::socket_statechanged(QAbstractSocket::SocketState state)
 
 }
 
-void smp_udp::socket_error(QAbstractSocket::SocketError error)
-{
-
-}
-
 void smp_udp::socket_readchannelfinished()
 {
 
@@ -264,9 +264,43 @@ int smp_udp::has_data(void)
 
 void smp_udp::connect_to_device(QString host, uint16_t port)
 {
+    device_host = host;
+    device_port = port;
     socket->connectToHost(host, port);
     socket_is_connected = true;
-    //TODO: need to alert parent
+    emit transport_connected();
+}
+
+//Reconnects to the last device, UDP has no connection state so this only re-creates the socket association
+int smp_udp::reconnect(void)
+{
+    if (device_host.isEmpty())
+    {
+        return SMP_TRANSPORT_ERROR_NOT_CONNECTED;
+    }
+
+    socket->abort();
+    received_data.clear();
+    connect_to_device(device_host, device_port);
+
+    return SMP_TRANSPORT_ERROR_OK;
+}
+
+void smp_udp::socket_error(QAbstractSocket::SocketError error)
+{
+    if (socket_is_connected == false)
+    {
+        return;
+    }
+
+    //These indicate the device or network has gone away (e.g. an ICMP port unreachable response whilst the device reboots)
+    if (error == QAbstractSocket::ConnectionRefusedError || error == QAbstractSocket::NetworkError || error == QAbstractSocket::HostNotFoundError)
+    {
+        log_error() << "UDP socket error: " << error;
+        socket->abort();
+        socket_is_connected = false;
+        emit transport_disconnected();
+    }
 }
 
 void smp_udp::close_connect_dialog()
@@ -40,6 +40,7 @@ public:
     int send(smp_message *message);
     void close_connect_dialog();
     void setup_finished();
+    int reconnect(void) override;
 /*    int receive(QByteArray *data, uint16_t max_size) override;
     int receive_data_size() override;
     int get_mtu() override;
@@ -56,7 +57,7 @@ private slots:
 //    void socket_connected();
 //    void socket_disconnected();
 //    void socket_statechanged(QAbstractSocket::SocketState state);
-//    void socket_error(QAbstractSocket::SocketError error);
+    void socket_error(QAbstractSocket::SocketError error);
 //    void socket_readchannelfinished();
 
 signals:
@@ -65,6 +66,8 @@ signals:
 private:
     QUdpSocket *socket;
     bool socket_is_connected;
+    QString device_host;
+    uint16_t device_port;
 //    QByteArray socket_received_data;
     smp_message received_data;
 
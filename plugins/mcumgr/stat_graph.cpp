@@ -0,0 +1,166 @@
+/******************************************************************************
+** Copyright (C) 2023 Jamie M.
+**
+** Project: AuTerm
+**
+** Module:  stat_graph.cpp
+**
+** Notes:
+**
+** License: This program is free software: you can redistribute it and/or
+**          modify it under the terms of the GNU General Public License as
+**          published by the Free Software Foundation, version 3.
+**
+**          This program is distributed in the hope that it will be useful,
+**          but WITHOUT ANY WARRANTY; without even the implied warranty of
+**          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**          GNU General Public License for more details.
+**
+**          You should have received a copy of the GNU General Public License
+**          along with this program.  If not, see http://www.gnu.org/licenses/
+**
+*******************************************************************************/
+#include "stat_graph.h"
+#include <QPainter>
+#include <QPainterPath>
+
+//Colours cycled through for each plotted counter
+static const Qt::GlobalColor graph_colours[] = {
+    Qt::blue,
+    Qt::red,
+    Qt::darkGreen,
+    Qt::magenta,
+    Qt::darkCyan,
+    Qt::darkYellow,
+    Qt::black,
+    Qt::darkRed,
+};
+
+stat_graph::stat_graph(QWidget *parent) : QWidget(parent)
+{
+    sampler = nullptr;
+    setMinimumHeight(100);
+}
+
+void stat_graph::set_sampler(stat_sampler *sampler)
+{
+    this->sampler = sampler;
+    update();
+}
+
+//Sets the counters to plot, if empty then all counters are plotted
+void stat_graph::set_counters(QStringList counters)
+{
+    this->counters = counters;
+    update();
+}
+
+void stat_graph::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event);
+
+    QPainter painter(this);
+    QList<uint16_t> plot;
+    QRect area = rect().adjusted(4, (fontMetrics().height() + 4), -4, -4);
+    double max_rate = 0.0;
+    uint32_t sample;
+    uint16_t i = 0;
+
+    painter.fillRect(rect(), palette().base());
+    painter.setPen(palette().mid().color());
+    painter.drawRect(area);
+
+    if (sampler == nullptr || sampler->sample_count() < 2 || area.width() <= 0 || area.height() <= 0)
+    {
+        return;
+    }
+
+    while (i < sampler->counter_count())
+    {
+        if (counters.isEmpty() || counters.contains(sampler->counter_name(i)))
+        {
+            plot.append(i);
+        }
+
+        ++i;
+    }
+
+    //Find the scale of the graph
+    i = 0;
+
+    while (i < plot.length())
+    {
+        sample = 1;
+
+        while (sample < sampler->sample_count())
+        {
+            double rate;
+
+            if (sampler->rate(plot.at(i), sample, &rate) == true && rate > max_rate)
+            {
+                max_rate = rate;
+            }
+
+            ++sample;
+        }
+
+        ++i;
+    }
+
+    if (max_rate <= 0.0)
+    {
+        max_rate = 1.0;
+    }
+
+    painter.setRenderHint(QPainter::Antialiasing, true);
+    i = 0;
+
+    while (i < plot.length())
+    {
+        QPainterPath path;
+        bool started = false;
+
+        sample = 1;
+
+        while (sample < sampler->sample_count())
+        {
+            double rate;
+
+            if (sampler->rate(plot.at(i), sample, &rate) == true)
+            {
+                QPointF point((area.left() + (double)area.width() * (sample - 1) / (sampler->sample_count() - 2 > 0 ? sampler->sample_count() - 2 : 1)), (area.bottom() - (double)area.height() * rate / max_rate));
+
+                if (started == false)
+                {
+                    path.moveTo(point);
+                    started = true;
+                }
+                else
+                {
+                    path.lineTo(point);
+                }
+            }
+            else
+            {
+                //Gap in the data
+                started = false;
+            }
+
+            ++sample;
+        }
+
+        painter.setPen(QPen(graph_colours[i % (sizeof(graph_colours) / sizeof(graph_colours[0]))], 1.5));
+        painter.drawPath(path);
+        ++i;
+    }
+
+    //Legend and scale
+    painter.setPen(palette().text().color());
+    painter.drawText(4, fontMetrics().ascent() + 1, QString("Max: ").append(QString::number(max_rate, 'f', 2)).append("/s"));
+
+    if (plot.length() == 1)
+    {
+        painter.setPen(graph_colours[0]);
+        painter.drawText(rect().adjusted(4, 1, -4, 0), (Qt::AlignRight | Qt::AlignTop), sampler->counter_name(plot.at(0)));
+    }
+}
@@ -0,0 +1,48 @@
+/******************************************************************************
+** Copyright (C) 2023 Jamie M.
+**
+** Project: AuTerm
+**
+** Module:  stat_graph.h
+**
+** Notes:
+**
+** License: This program is free software: you can redistribute it and/or
+**          modify it under the terms of the GNU General Public License as
+**          published by the Free Software Foundation, version 3.
+**
+**          This program is distributed in the hope that it will be useful,
+**          but WITHOUT ANY WARRANTY; without even the implied warranty of
+**          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**          GNU General Public License for more details.
+**
+**          You should have received a copy of the GNU General Public License
+**          along with this program.  If not, see http://www.gnu.org/licenses/
+**
+*******************************************************************************/
+#ifndef STAT_GRAPH_H
+#define STAT_GRAPH_H
+
+#include <QWidget>
+#include <QStringList>
+#include "stat_sampler.h"
+
+//Plots the rate of change of stat counters held in a stat_sampler
+class stat_graph : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit stat_graph(QWidget *parent = nullptr);
+    void set_sampler(stat_sampler *sampler);
+    void set_counters(QStringList counters);
+
+protected:
+    void paintEvent(QPaintEvent *event);
+
+private:
+    stat_sampler *sampler;
+    QStringList counters;
+};
+
+#endif // STAT_GRAPH_H
@@ -0,0 +1,277 @@
+/******************************************************************************
+** Copyright (C) 2023 Jamie M.
+**
+** Project: AuTerm
+**
+** Module:  stat_sampler.cpp
+**
+** Notes:
+**
+** License: This program is free software: you can redistribute it and/or
+**          modify it under the terms of the GNU General Public License as
+**          published by the Free Software Foundation, version 3.
+**
+**          This program is distributed in the hope that it will be useful,
+**          but WITHOUT ANY WARRANTY; without even the implied warranty of
+**          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**          GNU General Public License for more details.
+**
+**          You should have received a copy of the GNU General Public License
+**          along with this program.  If not, see http://www.gnu.org/licenses/
+**
+*******************************************************************************/
+#include "stat_sampler.h"
+#include <QFile>
+#include <QTextStream>
+#include <QDateTime>
+
+stat_sampler::stat_sampler(uint32_t capacity)
+{
+    this->capacity = (capacity == 0 ? 1 : capacity);
+    timestamps.resize(this->capacity);
+    clear();
+}
+
+void stat_sampler::clear()
+{
+    head = 0;
+    count = 0;
+    columns.clear();
+}
+
+void stat_sampler::set_groups(QStringList groups)
+{
+    if (groups != group_names)
+    {
+        clear();
+        group_names = groups;
+    }
+}
+
+QStringList stat_sampler::groups()
+{
+    return group_names;
+}
+
+void stat_sampler::add_sample(qint64 timestamp_ms, const QList<stat_value_t> *values)
+{
+    uint16_t i = 0;
+
+    timestamps[head] = timestamp_ms;
+
+    //Mark the slot as empty for all counters, counters in this sample will set it again
+    while (i < columns.length())
+    {
+        columns[i].present.clearBit(head);
+        ++i;
+    }
+
+    i = 0;
+
+    while (i < values->length())
+    {
+        int32_t column = counter_index(values->at(i).name);
+
+        if (column == -1)
+        {
+            //New counter, earlier samples are not present for it
+            stat_sampler_column_t new_column;
+            new_column.name = values->at(i).name;
+            new_column.values.resize(capacity);
+            new_column.present.resize(capacity);
+            columns.append(new_column);
+            column = columns.length() - 1;
+        }
+
+        columns[column].values[head] = values->at(i).value;
+        columns[column].present.setBit(head);
+        ++i;
+    }
+
+    head = (head + 1) % capacity;
+
+    if (count < capacity)
+    {
+        ++count;
+    }
+}
+
+uint32_t stat_sampler::sample_count()
+{
+    return count;
+}
+
+uint16_t stat_sampler::counter_count()
+{
+    return columns.length();
+}
+
+int32_t stat_sampler::counter_index(QString name)
+{
+    int32_t i = 0;
+
+    while (i < columns.length())
+    {
+        if (columns[i].name == name)
+        {
+            return i;
+        }
+
+        ++i;
+    }
+
+    return -1;
+}
+
+QString stat_sampler::counter_name(uint16_t counter)
+{
+    return columns.at(counter).name;
+}
+
+uint32_t stat_sampler::ring_index(uint32_t sample)
+{
+    return (head + capacity - count + sample) % capacity;
+}
+
+qint64 stat_sampler::timestamp(uint32_t sample)
+{
+    return timestamps.at(ring_index(sample));
+}
+
+bool stat_sampler::value(uint16_t counter, uint32_t sample, uint32_t *value)
+{
+    uint32_t index;
+
+    if (counter >= columns.length() || sample >= count)
+    {
+        return false;
+    }
+
+    index = ring_index(sample);
+
+    if (columns[counter].present.testBit(index) == false)
+    {
+        return false;
+    }
+
+    *value = columns[counter].values.at(index);
+
+    return true;
+}
+
+bool stat_sampler::delta(uint16_t counter, uint32_t sample, uint32_t *delta)
+{
+    uint32_t current;
+    uint32_t previous;
+
+    if (sample == 0 || value(counter, sample, &current) == false || value(counter, (sample - 1), &previous) == false)
+    {
+        return false;
+    }
+
+    //Counters are 32-bit unsigned, unsigned subtraction handles wrapping
+    *delta = current - previous;
+
+    return true;
+}
+
+bool stat_sampler::rate(uint16_t counter, uint32_t sample, double *rate)
+{
+    uint32_t change;
+    qint64 elapsed;
+
+    if (delta(counter, sample, &change) == false)
+    {
+        return false;
+    }
+
+    elapsed = timestamp(sample) - timestamp(sample - 1);
+
+    if (elapsed <= 0)
+    {
+        return false;
+    }
+
+    *rate = (double)change * 1000.0 / (double)elapsed;
+
+    return true;
+}
+
+bool stat_sampler::export_csv(QString filename, QString *error)
+{
+    QFile file(filename);
+    uint32_t sample = 0;
+    uint16_t counter;
+
+    if (!file.open(QFile::WriteOnly | QFile::Truncate | QFile::Text))
+    {
+        *error = file.errorString();
+        return false;
+    }
+
+    QTextStream stream(&file);
+
+    //Each counter has value, delta and rate columns
+    stream << "timestamp,time";
+    counter = 0;
+
+    while (counter < columns.length())
+    {
+        stream << "," << columns[counter].name << "," << columns[counter].name << "_delta," << columns[counter].name << "_rate";
+        ++counter;
+    }
+
+    stream << "\n";
+
+    while (sample < count)
+    {
+        qint64 sample_time = timestamp(sample);
+
+        stream << sample_time << "," << QDateTime::fromMSecsSinceEpoch(sample_time).toString(Qt::ISODateWithMs);
+        counter = 0;
+
+        while (counter < columns.length())
+        {
+            uint32_t current;
+            uint32_t change;
+            double change_rate;
+
+            stream << ",";
+
+            if (value(counter, sample, &current) == true)
+            {
+                stream << current;
+            }
+
+            stream << ",";
+
+            if (delta(counter, sample, &change) == true)
+            {
+                stream << change;
+            }
+
+            stream << ",";
+
+            if (rate(counter, sample, &change_rate) == true)
+            {
+                stream << QString::number(change_rate, 'f', 3);
+            }
+
+            ++counter;
+        }
+
+        stream << "\n";
+        ++sample;
+    }
+
+    stream.flush();
+    file.close();
+
+    if (stream.status() != QTextStream::Ok)
+    {
+        *error = "Failed writing to file";
+        return false;
+    }
+
+    return true;
+}
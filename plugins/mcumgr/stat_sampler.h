@@ -0,0 +1,73 @@
+/******************************************************************************
+** Copyright (C) 2023 Jamie M.
+**
+** Project: AuTerm
+**
+** Module:  stat_sampler.h
+**
+** Notes:
+**
+** License: This program is free software: you can redistribute it and/or
+**          modify it under the terms of the GNU General Public License as
+**          published by the Free Software Foundation, version 3.
+**
+**          This program is distributed in the hope that it will be useful,
+**          but WITHOUT ANY WARRANTY; without even the implied warranty of
+**          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**          GNU General Public License for more details.
+**
+**          You should have received a copy of the GNU General Public License
+**          along with this program.  If not, see http://www.gnu.org/licenses/
+**
+*******************************************************************************/
+#ifndef STAT_SAMPLER_H
+#define STAT_SAMPLER_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QBitArray>
+#include "smp_group_stat_mgmt.h"
+
+//Number of samples kept for each counter, older samples are overwritten
+#define STAT_SAMPLER_DEFAULT_CAPACITY 3600
+
+//Samples of a single counter, stored in the same ring positions as the sample timestamps
+struct stat_sampler_column_t {
+    QString name;
+    QVector<uint32_t> values;
+    QBitArray present;
+};
+
+//Columnar ring buffer of stat group samples. Sample index 0 is the oldest sample held. A sample can hold counters of
+//several groups, in which case counter names are prefixed with the group name
+class stat_sampler
+{
+public:
+    stat_sampler(uint32_t capacity = STAT_SAMPLER_DEFAULT_CAPACITY);
+    void clear();
+    void set_groups(QStringList groups);
+    QStringList groups();
+    void add_sample(qint64 timestamp_ms, const QList<stat_value_t> *values);
+    uint32_t sample_count();
+    uint16_t counter_count();
+    int32_t counter_index(QString name);
+    QString counter_name(uint16_t counter);
+    qint64 timestamp(uint32_t sample);
+    bool value(uint16_t counter, uint32_t sample, uint32_t *value);
+    bool delta(uint16_t counter, uint32_t sample, uint32_t *delta);
+    bool rate(uint16_t counter, uint32_t sample, double *rate);
+    bool export_csv(QString filename, QString *error);
+
+private:
+    uint32_t ring_index(uint32_t sample);
+
+    QStringList group_names;
+    uint32_t capacity;
+    uint32_t head;
+    uint32_t count;
+    QVector<qint64> timestamps;
+    QList<stat_sampler_column_t> columns;
+};
+
+#endif // STAT_SAMPLER_H
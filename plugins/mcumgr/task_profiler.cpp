@@ -0,0 +1,215 @@
+/******************************************************************************
+** Copyright (C) 2023 Jamie M.
+**
+** Project: AuTerm
+**
+** Module:  task_profiler.cpp
+**
+** Notes:
+**
+** License: This program is free software: you can redistribute it and/or
+**          modify it under the terms of the GNU General Public License as
+**          published by the Free Software Foundation, version 3.
+**
+**          This program is distributed in the hope that it will be useful,
+**          but WITHOUT ANY WARRANTY; without even the implied warranty of
+**          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**          GNU General Public License for more details.
+**
+**          You should have received a copy of the GNU General Public License
+**          along with this program.  If not, see http://www.gnu.org/licenses/
+**
+*******************************************************************************/
+#include "task_profiler.h"
+
+task_profiler::task_profiler()
+{
+    clear();
+}
+
+void task_profiler::clear()
+{
+    tasks.clear();
+    last_timestamp = 0;
+    snapshots = 0;
+}
+
+void task_profiler::add_snapshot(qint64 timestamp_ms, const QList<task_list_t> *snapshot)
+{
+    QList<uint32_t> runtime_deltas;
+    uint64_t total_runtime = 0;
+    qint64 elapsed = timestamp_ms - last_timestamp;
+    uint16_t i = 0;
+
+    //Tasks which are not in this snapshot (e.g. have exited) keep their peak but have no rates
+    while (i < tasks.length())
+    {
+        tasks[i].seen = false;
+        tasks[i].rates_valid = false;
+        ++i;
+    }
+
+    //First pass, update counters and find the total runtime of all tasks since the previous snapshot
+    i = 0;
+
+    while (i < snapshot->length())
+    {
+        const task_list_t *task = &snapshot->at(i);
+        task_profile_t *profile = find(task->name);
+
+        if (profile == nullptr)
+        {
+            task_profile_t new_profile;
+
+            new_profile.name = task->name;
+            new_profile.stack_peak = 0;
+            new_profile.cpu_percent = 0.0;
+            new_profile.context_switch_rate = 0.0;
+            new_profile.rates_valid = false;
+            new_profile.runtime = task->runtime;
+            new_profile.context_switches = task->context_switches;
+            tasks.append(new_profile);
+            profile = &tasks.last();
+            runtime_deltas.append(0);
+        }
+        else
+        {
+            //Counters are 32-bit, unsigned subtraction handles wrapping
+            uint32_t runtime_delta = task->runtime - profile->runtime;
+            uint32_t context_switch_delta = task->context_switches - profile->context_switches;
+
+            if (snapshots > 0 && elapsed > 0)
+            {
+                profile->context_switch_rate = (double)context_switch_delta * 1000.0 / (double)elapsed;
+                profile->rates_valid = true;
+            }
+
+            total_runtime += runtime_delta;
+            runtime_deltas.append(runtime_delta);
+            profile->runtime = task->runtime;
+            profile->context_switches = task->context_switches;
+        }
+
+        profile->seen = true;
+        profile->stack_size = task->stack_size;
+
+        if (task->stack_usage > profile->stack_peak)
+        {
+            profile->stack_peak = task->stack_usage;
+        }
+
+        ++i;
+    }
+
+    //Second pass, work out the share of the runtime used by each task
+    i = 0;
+
+    while (i < snapshot->length())
+    {
+        task_profile_t *profile = find(snapshot->at(i).name);
+
+        if (profile != nullptr && profile->rates_valid == true)
+        {
+            profile->cpu_percent = (total_runtime > 0 ? (double)runtime_deltas.at(i) * 100.0 / (double)total_runtime : 0.0);
+        }
+
+        ++i;
+    }
+
+    last_timestamp = timestamp_ms;
+    ++snapshots;
+}
+
+uint32_t task_profiler::snapshot_count()
+{
+    return snapshots;
+}
+
+task_profile_t *task_profiler::find(QString name)
+{
+    uint16_t i = 0;
+
+    while (i < tasks.length())
+    {
+        if (tasks.at(i).name == name)
+        {
+            return &tasks[i];
+        }
+
+        ++i;
+    }
+
+    return nullptr;
+}
+
+const task_profile_t *task_profiler::profile(QString name)
+{
+    return find(name);
+}
+
+//Returns true if the stack high-water mark of the task exceeds the saved baseline for it
+bool task_profiler::stack_regression(QString name, uint32_t *baseline_peak)
+{
+    const task_profile_t *task = profile(name);
+
+    if (task == nullptr || get_baseline(name, baseline_peak) == false)
+    {
+        return false;
+    }
+
+    return (task->stack_peak > *baseline_peak);
+}
+
+bool task_profiler::get_baseline(QString name, uint32_t *baseline_peak)
+{
+    if (baseline.contains(name) == false)
+    {
+        return false;
+    }
+
+    *baseline_peak = baseline.value(name);
+
+    return true;
+}
+
+//Baseline entries are in the format "<task name>\t<stack peak in words>"
+void task_profiler::set_baseline(QStringList entries)
+{
+    uint16_t i = 0;
+
+    baseline.clear();
+
+    while (i < entries.length())
+    {
+        int split = entries.at(i).lastIndexOf('\t');
+
+        if (split > 0)
+        {
+            baseline.insert(entries.at(i).left(split), entries.at(i).mid(split + 1).toUInt());
+        }
+
+        ++i;
+    }
+}
+
+QStringList task_profiler::baseline_from_current()
+{
+    QStringList entries;
+    uint16_t i = 0;
+
+    baseline.clear();
+
+    while (i < tasks.length())
+    {
+        baseline.insert(tasks.at(i).name, tasks.at(i).stack_peak);
+        entries << QString(tasks.at(i).name).append("\t").append(QString::number(tasks.at(i).stack_peak));
+        ++i;
+    }
+
+    return entries;
+}
+
+bool task_profiler::has_baseline()
+{
+    return !baseline.isEmpty();
+}
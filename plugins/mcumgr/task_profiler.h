@@ -0,0 +1,68 @@
+/******************************************************************************
+** Copyright (C) 2023 Jamie M.
+**
+** Project: AuTerm
+**
+** Module:  task_profiler.h
+**
+** Notes:
+**
+** License: This program is free software: you can redistribute it and/or
+**          modify it under the terms of the GNU General Public License as
+**          published by the Free Software Foundation, version 3.
+**
+**          This program is distributed in the hope that it will be useful,
+**          but WITHOUT ANY WARRANTY; without even the implied warranty of
+**          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**          GNU General Public License for more details.
+**
+**          You should have received a copy of the GNU General Public License
+**          along with this program.  If not, see http://www.gnu.org/licenses/
+**
+*******************************************************************************/
+#ifndef TASK_PROFILER_H
+#define TASK_PROFILER_H
+
+#include <QString>
+#include <QStringList>
+#include <QMap>
+#include "smp_group_os_mgmt.h"
+
+//Derived statistics of a single task, stack values are in 32-bit words as reported by the device
+struct task_profile_t {
+    QString name;
+    uint32_t runtime;
+    uint32_t context_switches;
+    uint32_t stack_size;
+    uint32_t stack_peak;
+    double cpu_percent;
+    double context_switch_rate;
+    bool rates_valid;
+    bool seen;
+};
+
+//Tracks task statistics over successive task stat snapshots, tasks are identified by name as IDs are not stable across reboots
+class task_profiler
+{
+public:
+    task_profiler();
+    void clear();
+    void add_snapshot(qint64 timestamp_ms, const QList<task_list_t> *snapshot);
+    uint32_t snapshot_count();
+    const task_profile_t *profile(QString name);
+    bool stack_regression(QString name, uint32_t *baseline_peak);
+    bool get_baseline(QString name, uint32_t *baseline_peak);
+    void set_baseline(QStringList entries);
+    QStringList baseline_from_current();
+    bool has_baseline();
+
+private:
+    task_profile_t *find(QString name);
+
+    QList<task_profile_t> tasks;
+    QMap<QString, uint32_t> baseline;
+    qint64 last_timestamp;
+    uint32_t snapshots;
+};
+
+#endif // TASK_PROFILER_H
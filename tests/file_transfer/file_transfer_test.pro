@@ -0,0 +1,21 @@
+# AuTerm file transfer test, sends files using the AuTerm file transfer engine to a serial port so that it can be tested
+# against lrzsz over a pseudo terminal pair, see run_lrzsz_test.sh
+
+QT += core serialport
+QT -= gui
+
+CONFIG += console
+CONFIG -= app_bundle
+
+TARGET = file_transfer_test
+TEMPLATE = app
+
+INCLUDEPATH += ../../AuTerm
+
+SOURCES += main.cpp \
+    ../../AuTerm/AutCrc.cpp \
+    ../../AuTerm/AutFileTransfer.cpp
+
+HEADERS += \
+    ../../AuTerm/AutCrc.h \
+    ../../AuTerm/AutFileTransfer.h
@@ -0,0 +1,145 @@
+/******************************************************************************
+** Copyright (C) 2023 Jamie M.
+**
+** Project: AuTerm
+**
+** Module:  main.cpp (file transfer test)
+**
+** Notes:
+**
+** License: This program is free software: you can redistribute it and/or
+**          modify it under the terms of the GNU General Public License as
+**          published by the Free Software Foundation, version 3.
+**
+**          This program is distributed in the hope that it will be useful,
+**          but WITHOUT ANY WARRANTY; without even the implied warranty of
+**          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**          GNU General Public License for more details.
+**
+**          You should have received a copy of the GNU General Public License
+**          along with this program.  If not, see http://www.gnu.org/licenses/
+**
+*******************************************************************************/
+
+/******************************************************************************/
+// Include Files
+/******************************************************************************/
+#include <QCoreApplication>
+#include <QThread>
+#include <QSerialPort>
+#include <QStringList>
+#include <QTextStream>
+#include "AutFileTransfer.h"
+
+/******************************************************************************/
+// Local Functions or Private Members
+/******************************************************************************/
+
+//=============================================================================
+//=============================================================================
+static int usage()
+{
+    QTextStream(stderr) << "Usage: file_transfer_test <xmodem-crc|xmodem-1k|ymodem|zmodem> <port> [--resume] <file>...\n";
+    return 2;
+}
+
+//=============================================================================
+//=============================================================================
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QStringList arguments = app.arguments();
+    QStringList files;
+    QSerialPort port;
+    QThread transfer_thread;
+    AutFileTransfer *transfer;
+    int protocol;
+    bool resume = false;
+    bool success = false;
+    int i = 3;
+
+    if (arguments.length() < 4)
+    {
+        return usage();
+    }
+
+    if (arguments.at(1) == "xmodem-crc")
+    {
+        protocol = TransferXmodemCrc;
+    }
+    else if (arguments.at(1) == "xmodem-1k")
+    {
+        protocol = TransferXmodem1k;
+    }
+    else if (arguments.at(1) == "ymodem")
+    {
+        protocol = TransferYmodem;
+    }
+    else if (arguments.at(1) == "zmodem")
+    {
+        protocol = TransferZmodem;
+    }
+    else
+    {
+        return usage();
+    }
+
+    while (i < arguments.length())
+    {
+        if (arguments.at(i) == "--resume")
+        {
+            resume = true;
+        }
+        else
+        {
+            files << arguments.at(i);
+        }
+
+        ++i;
+    }
+
+    if (files.isEmpty())
+    {
+        return usage();
+    }
+
+    port.setPortName(arguments.at(2));
+
+    if (!port.open(QIODevice::ReadWrite))
+    {
+        QTextStream(stderr) << "Failed to open " << arguments.at(2) << ": " << port.errorString() << "\n";
+        return 1;
+    }
+
+    //The port and engine are used the same way as in the main window, the port is handed to the transfer thread
+    transfer = new AutFileTransfer();
+    transfer->moveToThread(&transfer_thread);
+    QObject::connect(&transfer_thread, SIGNAL(finished()), transfer, SLOT(deleteLater()));
+    QObject::connect(transfer, &AutFileTransfer::progress, [](QString file, qint64 position, qint64 size, qint64 rate)
+    {
+        QTextStream(stdout) << file << " " << position << "/" << size << " " << rate << " B/s\n";
+    });
+    QObject::connect(transfer, &AutFileTransfer::finished, &app, [&](bool transfer_success, QString message)
+    {
+        success = transfer_success;
+        QMetaObject::invokeMethod(transfer, "stop", Qt::BlockingQueuedConnection);
+        QTextStream(stdout) << (success ? "Transfer complete: " : "Transfer failed: ") << message << "\n";
+        app.quit();
+    });
+    transfer_thread.start();
+
+    port.moveToThread(&transfer_thread);
+    QMetaObject::invokeMethod(transfer, "start", Qt::QueuedConnection, Q_ARG(int, protocol), Q_ARG(QStringList, files), Q_ARG(bool, resume), Q_ARG(QSerialPort*, &port));
+
+    app.exec();
+
+    transfer_thread.quit();
+    transfer_thread.wait();
+    port.close();
+
+    return (success ? 0 : 1);
+}
+
+/******************************************************************************/
+// END OF FILE
+/******************************************************************************/
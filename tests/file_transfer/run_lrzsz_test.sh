@@ -0,0 +1,157 @@
+#!/bin/sh
+# Tests the AuTerm file transfer engine against lrzsz over a pseudo terminal pair created by socat. Build
+# file_transfer_test.pro first (qmake && make), then run: run_lrzsz_test.sh [path to file_transfer_test]
+# The lrzsz receivers can be overridden with the RX, RB and RZ environment variables (e.g. RZ=lrz)
+
+TEST=$(realpath "${1:-./file_transfer_test}")
+RX=${RX:-rx}
+RB=${RB:-rb}
+RZ=${RZ:-rz}
+TIMEOUT=${TIMEOUT:-120}
+WORK=$(mktemp -d)
+SOCAT_PID=
+FAILED=0
+
+cleanup()
+{
+    if [ -n "$SOCAT_PID" ]; then
+        kill "$SOCAT_PID" 2>/dev/null
+    fi
+
+    rm -rf "$WORK"
+}
+
+trap cleanup EXIT
+
+for TOOL in socat "$RX" "$RB" "$RZ"; do
+    if ! command -v "$TOOL" >/dev/null 2>&1; then
+        echo "$TOOL is required"
+        exit 2
+    fi
+done
+
+if [ ! -x "$TEST" ]; then
+    echo "file_transfer_test not found at $TEST"
+    exit 2
+fi
+
+#Starts a new pseudo terminal pair, the sender uses $WORK/sender and the receiver uses $WORK/receiver
+start_pty()
+{
+    rm -f "$WORK/sender" "$WORK/receiver"
+    socat pty,raw,echo=0,link="$WORK/sender" pty,raw,echo=0,link="$WORK/receiver" &
+    SOCAT_PID=$!
+
+    while [ ! -e "$WORK/sender" ] || [ ! -e "$WORK/receiver" ]; do
+        sleep 0.1
+    done
+}
+
+stop_pty()
+{
+    kill "$SOCAT_PID" 2>/dev/null
+    wait "$SOCAT_PID" 2>/dev/null
+    SOCAT_PID=
+}
+
+#Runs a transfer: name, receiver directory, receiver command, sender arguments
+run_transfer()
+{
+    NAME=$1
+    RECEIVE_DIR=$2
+    RECEIVER=$3
+    shift 3
+
+    echo "=== $NAME"
+    start_pty
+    (cd "$RECEIVE_DIR" && exec timeout "$TIMEOUT" $RECEIVER <"$WORK/receiver" >"$WORK/receiver" 2>"$WORK/receiver.log") &
+    RECEIVER_PID=$!
+    timeout "$TIMEOUT" "$TEST" "$@" >"$WORK/sender.log" 2>&1
+    SENDER_RESULT=$?
+    wait "$RECEIVER_PID"
+    RECEIVER_RESULT=$?
+    stop_pty
+
+    if [ "$SENDER_RESULT" -ne 0 ] || [ "$RECEIVER_RESULT" -ne 0 ]; then
+        echo "FAIL: $NAME (sender $SENDER_RESULT, receiver $RECEIVER_RESULT)"
+        tail -n 5 "$WORK/sender.log" "$WORK/receiver.log"
+        return 1
+    fi
+
+    return 0
+}
+
+#Compares a received file with the original: original, received, allow XMODEM padding
+check_file()
+{
+    SIZE=$(stat -c %s "$1")
+
+    if [ "$3" = "padded" ]; then
+        #XMODEM does not send the file size, the last block is padded
+        RECEIVED_SIZE=$(stat -c %s "$2")
+
+        if [ "$RECEIVED_SIZE" -lt "$SIZE" ] || [ $((RECEIVED_SIZE - SIZE)) -ge 1024 ] || ! cmp -s -n "$SIZE" "$1" "$2"; then
+            echo "FAIL: $2 does not match $1"
+            return 1
+        fi
+    elif ! cmp -s "$1" "$2"; then
+        echo "FAIL: $2 does not match $1"
+        return 1
+    fi
+
+    return 0
+}
+
+mkdir -p "$WORK/files"
+head -c 100000 /dev/urandom >"$WORK/files/large.bin"
+head -c 1 /dev/urandom >"$WORK/files/one.bin"
+head -c 4093 /dev/urandom >"$WORK/files/odd.bin"
+head -c 300000 /dev/urandom >"$WORK/files/resume.bin"
+
+#XMODEM-1K, a single file which is mostly sent in 1024 byte blocks
+mkdir -p "$WORK/xmodem"
+if run_transfer "XMODEM-1K" "$WORK/xmodem" "$RX -c large.bin" xmodem-1k "$WORK/sender" "$WORK/files/large.bin"; then
+    check_file "$WORK/files/large.bin" "$WORK/xmodem/large.bin" padded || FAILED=1
+else
+    FAILED=1
+fi
+
+#YMODEM batch, file names and sizes are sent so files must match exactly
+mkdir -p "$WORK/ymodem"
+if run_transfer "YMODEM batch" "$WORK/ymodem" "$RB" ymodem "$WORK/sender" "$WORK/files/large.bin" "$WORK/files/one.bin" "$WORK/files/odd.bin"; then
+    for FILE in large.bin one.bin odd.bin; do
+        check_file "$WORK/files/$FILE" "$WORK/ymodem/$FILE" exact || FAILED=1
+    done
+else
+    FAILED=1
+fi
+
+#ZMODEM batch
+mkdir -p "$WORK/zmodem"
+if run_transfer "ZMODEM batch" "$WORK/zmodem" "$RZ" zmodem "$WORK/sender" "$WORK/files/large.bin" "$WORK/files/odd.bin"; then
+    for FILE in large.bin odd.bin; do
+        check_file "$WORK/files/$FILE" "$WORK/zmodem/$FILE" exact || FAILED=1
+    done
+else
+    FAILED=1
+fi
+
+#ZMODEM resume, the receiver already has the first part of the file and asks for the rest with ZRPOS. The existing part
+#is deliberately different from the original so that a resumed file can be told apart from one sent from the start
+mkdir -p "$WORK/zmodem_resume"
+head -c 123457 /dev/urandom >"$WORK/zmodem_resume/resume.bin"
+cp "$WORK/zmodem_resume/resume.bin" "$WORK/files/resume_expected.bin"
+tail -c +123458 "$WORK/files/resume.bin" >>"$WORK/files/resume_expected.bin"
+if run_transfer "ZMODEM resume" "$WORK/zmodem_resume" "$RZ --resume" zmodem "$WORK/sender" --resume "$WORK/files/resume.bin"; then
+    check_file "$WORK/files/resume_expected.bin" "$WORK/zmodem_resume/resume.bin" exact || FAILED=1
+else
+    FAILED=1
+fi
+
+if [ "$FAILED" -ne 0 ]; then
+    echo "File transfer tests failed"
+    exit 1
+fi
+
+echo "File transfer tests passed"
+exit 0